@@ -0,0 +1,268 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie host benchmarks, QF/QS callbacks and utilities
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*****************************************************************************/
+#define _GNU_SOURCE  /* for syscall() */
+
+#include "qpc.h"
+#include "bench.h"
+
+#include <stdio.h>   /* for fprintf(), printf() */
+#include <stdlib.h>  /* for exit(), strtoul(), getenv() */
+#include <string.h>  /* for memset() */
+#include <time.h>    /* for clock_gettime() */
+
+#ifdef __linux__
+#include <linux/perf_event.h> /* for the hardware counters, see NOTE1 */
+#include <sys/ioctl.h>        /* for ioctl() */
+#include <sys/syscall.h>      /* for SYS_perf_event_open */
+#include <unistd.h>           /* for syscall(), read(), close() */
+#endif
+
+/* the directory of the build, set by the Makefile */
+#ifndef BENCH_BUILD
+#define BENCH_BUILD "unknown"
+#endif
+
+static int  l_perfFd = -1;  /* the leader of the group of the counters */
+static bool l_jsonFirst;    /* the first result of the JSON report? */
+
+/*..........................................................................*/
+uint64_t BENCH_now(void) {
+    struct timespec t;
+    (void)clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t)t.tv_sec * 1000000000U) + (uint64_t)t.tv_nsec;
+}
+/*..........................................................................*/
+uint32_t BENCH_iterations(int argc, char *argv[], uint32_t dflt) {
+    return (argc > 1) ? (uint32_t)strtoul(argv[1], (char **)0, 0) : dflt;
+}
+
+/* hardware counters ======================================================*/
+#ifdef __linux__
+static int perf_open(uint32_t type, uint64_t config, int group) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group == -1) ? 1U : 0U; /* the leader starts the group */
+    attr.exclude_kernel = 1U;
+    attr.exclude_hv = 1U;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0UL);
+}
+#endif
+/*..........................................................................*/
+bool BENCH_countersOpen(void) {
+#ifdef __linux__
+    int fd;
+
+    if (l_perfFd != -1) {
+        return true;
+    }
+    l_perfFd = perf_open(PERF_TYPE_HW_CACHE,
+                         (uint64_t)PERF_COUNT_HW_CACHE_L1D
+                         | ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8)
+                         | ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                         -1);
+    if (l_perfFd == -1) {
+        return false;
+    }
+    fd = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, l_perfFd);
+    if (fd == -1) {
+        (void)close(l_perfFd);
+        l_perfFd = -1;
+        return false;
+    }
+    (void)ioctl(l_perfFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    return false;
+#endif
+}
+/*..........................................................................*/
+static void counters_read(uint64_t miss[BENCH_N_COUNTERS]) {
+#ifdef __linux__
+    if (l_perfFd != -1) {
+        uint64_t buf[1U + BENCH_N_COUNTERS]; /* nr, values[nr] */
+        if (read(l_perfFd, buf, sizeof(buf)) == (ssize_t)sizeof(buf)) {
+            uint_fast8_t i;
+            for (i = 0U; i < BENCH_N_COUNTERS; ++i) {
+                miss[i] = buf[1U + i];
+            }
+            return;
+        }
+    }
+#endif
+    memset(miss, 0, BENCH_N_COUNTERS * sizeof(miss[0]));
+}
+/*..........................................................................*/
+void BENCH_meterReset(BenchMeter * const m) {
+    memset(m, 0, sizeof(*m));
+}
+/*..........................................................................*/
+void BENCH_meterStart(BenchMeter * const m) {
+    counters_read(m->miss0); /* the syscall stays out of the time */
+    m->t0 = BENCH_now();
+}
+/*..........................................................................*/
+void BENCH_meterStop(BenchMeter * const m) {
+    uint64_t const t1 = BENCH_now();
+    uint64_t miss[BENCH_N_COUNTERS];
+    uint_fast8_t i;
+
+    counters_read(miss);
+    m->ns += t1 - m->t0;
+    for (i = 0U; i < BENCH_N_COUNTERS; ++i) {
+        m->miss[i] += miss[i] - m->miss0[i];
+    }
+}
+
+/* JSON report ============================================================*/
+static void json_str(char const *s) {
+    putchar('"');
+    for (; *s != '\0'; ++s) {
+        if ((*s == '"') || (*s == '\\')) {
+            putchar('\\');
+        }
+        putchar(((unsigned char)*s < 0x20U) ? ' ' : *s);
+    }
+    putchar('"');
+}
+/*..........................................................................*/
+void BENCH_jsonBegin(char const *suite, uint32_t iterations) {
+    char const *rev = getenv("BENCH_REV");
+
+    printf("{\n  \"suite\": ");
+    json_str(suite);
+    printf(",\n  \"build\": ");
+    json_str(BENCH_BUILD);
+    printf(",\n  \"cc\": ");
+    json_str(__VERSION__);
+    printf(",\n  \"rev\": ");
+    if (rev != (char const *)0) {
+        json_str(rev);
+    }
+    else {
+        printf("null");
+    }
+    printf(",\n  \"iterations\": %lu", (unsigned long)iterations);
+    printf(",\n  \"counters\": %s", (l_perfFd != -1) ? "true" : "false");
+    printf(",\n  \"results\": [");
+    l_jsonFirst = true;
+}
+/*..........................................................................*/
+void BENCH_jsonResult(char const *op, char const *variant, uint32_t param,
+                      uint32_t ops, BenchMeter const * const m)
+{
+    static char const * const name[BENCH_N_COUNTERS] = {
+        "l1d_miss_per_op", "llc_miss_per_op"
+    };
+    uint_fast8_t i;
+
+    printf("%s\n    {\"op\": ", l_jsonFirst ? "" : ",");
+    json_str(op);
+    printf(", \"variant\": ");
+    json_str(variant);
+    printf(", \"param\": %lu, \"ops\": %lu, \"ns_per_op\": %.3f",
+           (unsigned long)param, (unsigned long)ops,
+           (double)m->ns / (double)ops);
+    for (i = 0U; i < BENCH_N_COUNTERS; ++i) {
+        if (l_perfFd != -1) {
+            printf(", \"%s\": %.4f", name[i],
+                   (double)m->miss[i] / (double)ops);
+        }
+        else {
+            printf(", \"%s\": null", name[i]);
+        }
+    }
+    putchar('}');
+    l_jsonFirst = false;
+}
+/*..........................................................................*/
+void BENCH_jsonEnd(void) {
+    printf("\n  ]\n}\n");
+    (void)fflush(stdout);
+}
+
+/* QF callbacks ============================================================*/
+void QF_onStartup(void) {
+    QF_setTickRate(0U); /* the benchmarks drive the clock tick themselves */
+}
+/*..........................................................................*/
+void QF_onCleanup(void) {
+}
+/*..........................................................................*/
+void QF_onClockTick(void) {
+}
+#ifdef QV_CPU_SLEEP /* cooperative QV kernel? (ports/posix/qv) */
+/*..........................................................................*/
+void QV_onIdle(void) {  /* called with the QF mutex locked */
+    QV_CPU_SLEEP();
+}
+#endif /* QV_CPU_SLEEP */
+#ifdef QF_VIRTUAL_TIME /* the QV port in virtual time (make VTIME=1)? */
+/*..........................................................................*/
+uint32_t QF_onVirtualIdle(uint32_t nTicks) {
+    return nTicks; /* no stimuli, run until no time event is armed */
+}
+#endif /* QF_VIRTUAL_TIME */
+#ifdef QV_RTC_STEP_TIMING /* the RTC steps timed (make REPLAY=1)? */
+/*..........................................................................*/
+void QV_onRtcStep(QActive const *act, QSignal sig, uint32_t ns) {
+    (void)act; /* the benchmarks measure the steps themselves */
+    (void)sig;
+    (void)ns;
+}
+#endif /* QV_RTC_STEP_TIMING */
+/*..........................................................................*/
+void Q_onAssert(char_t const Q_ROM * const module, int_t location) {
+    fprintf(stderr, "Assertion failed in %s:%d\n", module, (int)location);
+    exit(-1);
+}
+
+/* QS callbacks ============================================================*/
+#ifdef Q_SPY
+/*..........................................................................*/
+uint8_t QS_onStartup(void const *arg) {
+    static uint8_t qsBuf[1024]; /* the benchmarks do not produce QS output */
+    (void)arg;
+    QS_initBuf(qsBuf, sizeof(qsBuf));
+    return (uint8_t)1;
+}
+/*..........................................................................*/
+void QS_onCleanup(void) {
+}
+/*..........................................................................*/
+QSTimeCtr QS_onGetTime(void) {
+    return (QSTimeCtr)BENCH_now();
+}
+/*..........................................................................*/
+void QS_onFlush(void) {
+}
+#endif /* Q_SPY */
+
+/*****************************************************************************
+* NOTE1:
+* The cache misses are counted with the Linux perf events of the calling
+* thread in the user mode only: the L1 data cache read misses and the
+* generic last-level cache misses, read together as one group. The counters
+* are often unavailable, e.g., in a virtual machine without the virtual PMU
+* or with /proc/sys/kernel/perf_event_paranoid above 2, and then the report
+* gives null for the misses. The counters are read outside of the timed part
+* of a section, but the read() system call still costs a microsecond or so,
+* so the measured sections should be at least a few hundred operations.
+*
+* NOTE2:
+* The report is one JSON object with the build (the build directory of the
+* Makefile, e.g., "build_rel/qv"), the compiler, the revision from the
+* BENCH_REV environment variable (set by "make bench_json") and the results,
+* one object per benchmark:
+* {"op": "QF_publish_", "variant": "static", "param": 8, "ops": 1000000,
+*  "ns_per_op": 101.234, "l1d_miss_per_op": 0.0012, "llc_miss_per_op": 0}
+* where the param is the depth, fan-out, number of timers, etc. of the op,
+* so that the results of two runs can be joined on (op, variant, param).
+*/
@@ -0,0 +1,59 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie host benchmarks, common definitions
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The benchmarks link the QP/C framework compiled for the selected host port
+* (ports/posix/<PORT>) with bench.c, which provides the QF/QS callbacks that
+* the framework requires, instead of the application BSP.
+*****************************************************************************/
+#ifndef bench_h
+#define bench_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* monotonic time in nanoseconds */
+uint64_t BENCH_now(void);
+
+/* number of iterations from the command line, or the default */
+uint32_t BENCH_iterations(int argc, char *argv[], uint32_t dflt);
+
+/* the hardware cache counters: L1 data cache read misses and last-level
+* cache misses, see NOTE1 of bench.c
+*/
+#define BENCH_N_COUNTERS 2U
+
+/* the time and the cache misses of the measured sections of a benchmark */
+typedef struct {
+    uint64_t ns;                      /* the measured time [ns] */
+    uint64_t miss[BENCH_N_COUNTERS];  /* the measured cache misses */
+    uint64_t t0;                      /* the start of the current section */
+    uint64_t miss0[BENCH_N_COUNTERS]; /* the counters at the start */
+} BenchMeter;
+
+/* open the hardware cache counters of the calling thread, returns false
+* when they are not available (the meters then count only the time)
+*/
+bool BENCH_countersOpen(void);
+
+/* reset the meter m before the measurement */
+void BENCH_meterReset(BenchMeter * const m);
+
+/* start and stop a measured section, the meter accumulates the sections */
+void BENCH_meterStart(BenchMeter * const m);
+void BENCH_meterStop(BenchMeter * const m);
+
+/* the JSON report on stdout: the header with the build, the results of the
+* benchmarks (op, its variant and parameter, the measured operations and
+* the meter) and the closing of the report, see NOTE2 of bench.c
+*/
+void BENCH_jsonBegin(char const *suite, uint32_t iterations);
+void BENCH_jsonResult(char const *op, char const *variant, uint32_t param,
+                      uint32_t ops, BenchMeter const * const m);
+void BENCH_jsonEnd(void);
+
+/* keep the compiler from optimizing away the value x_ */
+#define BENCH_USE(x_) __asm__ volatile ("" : : "g"(x_) : "memory")
+
+#endif /* bench_h */
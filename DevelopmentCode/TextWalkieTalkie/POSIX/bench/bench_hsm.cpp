@@ -0,0 +1,245 @@
+/*****************************************************************************
+* Product: benchmark of the compile-time C++ state machine engine (qct)
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: bench_hsm [iterations]
+*
+* The same state machine, with two branches A1..A5 and B1..B5 of five
+* nested states under the top state, is implemented as a QHsm and with the
+* qct engine (qhsm_ct.hpp), both as a plain qct::Hsm and as a qct::Active.
+* For every event the benchmark measures the cost of one dispatch:
+*
+* DEEP - the transition between the leaf states A5 and B5, which exits five
+*        and enters five states (the LCA is the top state)
+* UP   - the internal transition in A1 or B1, four levels above the leaf
+* SELF - the self-transition of the leaf state A5 or B5
+*
+* The QHsm and the qct::Active are dispatched through the virtual table
+* (QMSM_DISPATCH()), as the QF kernel does; the qct::Hsm is dispatched
+* directly. All state machines record the sequence of their entry and exit
+* actions, which must be identical. Built with the QHsm transition path
+* cache (make TCACHE=<n>) or the handled-signal map (make SIGMAP=<n>), the
+* QHsm uses them.
+*****************************************************************************/
+#include "qpc.h"
+#include "qhsm_ct.hpp"
+extern "C" {
+#include "bench.h"
+}
+
+#include <cstdio>  /* for printf() */
+
+Q_DEFINE_THIS_FILE
+
+namespace {
+
+enum BenchSignals {
+    DEEP_SIG = Q_USER_SIG,
+    UP_SIG,
+    SELF_SIG
+};
+
+enum { DEPTH = 5 };
+
+/* the sequence of the entry (+) and exit (-) actions of state (b, l) */
+inline uint32_t trace(uint32_t t, int b, int l, int kind) {
+    return (t * 31U) + static_cast<uint32_t>((kind * 64) + (b * 8) + l);
+}
+
+/* the QHsm implementation =================================================*/
+struct Ref {
+    QHsm super;
+    uint32_t trace;
+};
+
+/* state (b, l), where b is the branch (0 for A, 1 for B) and l the level;
+* the template arguments are parenthesized in the QEP macros because of
+* the commas
+*/
+template<int B, int L>
+QState ref(Ref * const me, QEvt const * const e) {
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            me->trace = trace(me->trace, B, L, 1);
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            me->trace = trace(me->trace, B, L, 2);
+            return Q_HANDLED();
+        }
+        case Q_INIT_SIG: {
+            if constexpr (L < DEPTH) {
+                return Q_TRAN((&ref<B, L + 1>));
+            }
+            break;
+        }
+        case DEEP_SIG: {
+            if constexpr (L == DEPTH) {
+                return Q_TRAN((&ref<1 - B, DEPTH>));
+            }
+            break;
+        }
+        case UP_SIG: {
+            if constexpr (L == 1) {
+                return Q_HANDLED();
+            }
+            break;
+        }
+        case SELF_SIG: {
+            if constexpr (L == DEPTH) {
+                return Q_TRAN((&ref<B, DEPTH>));
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    if constexpr (L == 1) {
+        return Q_SUPER(&QHsm_top);
+    }
+    else {
+        return Q_SUPER((&ref<B, L - 1>));
+    }
+}
+/*..........................................................................*/
+QState refInitial(Ref * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN((&ref<0, 1>));
+}
+
+/* the qct implementation ==================================================*/
+template<int B, int L> struct S;
+
+template<int B, int L>
+using Parent = std::conditional_t<L == 1, qct::Top, S<B, L - 1>>;
+
+template<int B, int L>
+struct S : qct::State<S<B, L>, Parent<B, L>> {
+    using Initial = std::conditional_t<L < DEPTH, S<B, L + 1>, void>;
+
+    template<typename Me> static void entry(Me &me) {
+        me.trace = trace(me.trace, B, L, 1);
+    }
+    template<typename Me> static void exit(Me &me) {
+        me.trace = trace(me.trace, B, L, 2);
+    }
+    template<typename X, typename Me>
+    static qct::Ret handle(Me &me, QEvt const *e) {
+        using Base = qct::State<S<B, L>, Parent<B, L>>;
+        switch (e->sig) {
+            case DEEP_SIG: {
+                if constexpr (L == DEPTH) {
+                    return Base::template tran<X, S<1 - B, DEPTH>>(me);
+                }
+                break;
+            }
+            case UP_SIG: {
+                if constexpr (L == 1) {
+                    return Base::handled();
+                }
+                break;
+            }
+            case SELF_SIG: {
+                if constexpr (L == DEPTH) {
+                    return Base::template tran<X, S<B, DEPTH>>(me);
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+        return Base::super();
+    }
+};
+
+struct CtHsm : qct::Hsm<CtHsm> {
+    using Initial = S<0, 1>;
+    uint32_t trace = 0U;
+};
+
+struct CtActive : qct::Active<CtActive> {
+    using Initial = S<0, 1>;
+    uint32_t trace = 0U;
+};
+
+/*..........................................................................*/
+QEvt const l_evt[] = {
+    { static_cast<QSignal>(DEEP_SIG), 0U, 0U },
+    { static_cast<QSignal>(UP_SIG),   0U, 0U },
+    { static_cast<QSignal>(SELF_SIG), 0U, 0U }
+};
+char const * const l_name[] = { "DEEP", "UP", "SELF" };
+
+/*..........................................................................*/
+template<typename F>
+double measure(uint32_t n, F dispatch) {
+    uint64_t const t0 = BENCH_now();
+    for (uint32_t i = 0U; i < n; ++i) {
+        dispatch();
+    }
+    return double(BENCH_now() - t0) / double(n);
+}
+
+} // namespace
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    uint32_t const n = BENCH_iterations(argc, argv, 1000000U);
+
+    QF_init();
+
+    static Ref ref;
+    static CtHsm ct;
+    static CtActive act;
+
+    ref.trace = 0U;
+    QHsm_ctor(&ref.super, Q_STATE_CAST(&refInitial));
+#ifdef QHSM_TRAN_CACHE
+    static QHsmTranCache cache;
+    QHsm_setTranCache(&ref.super, &cache);
+#endif
+#ifdef QHSM_SIG_MAP
+    static QHsmSigMap sigMap;
+    QHsm_setSigMap(&ref.super, &sigMap);
+#endif
+    QMSM_INIT(&ref.super, static_cast<QEvt const *>(0));
+    ct.init(static_cast<QEvt const *>(0));
+    QMSM_INIT(&act.ao()->super, static_cast<QEvt const *>(0));
+
+    Q_ALLEGE((ct.isIn<S<0, 5>>() && act.isIn<S<0, 1>>()));
+
+    std::printf("%6s %12s %12s %12s  [ns/dispatch]\n",
+                "event", "QHsm", "qct::Hsm", "qct::Active");
+    for (unsigned k = 0U; k < Q_DIM(l_evt); ++k) {
+        QEvt const * const e = &l_evt[k];
+        double const tRef = measure(n, [&]() {
+            QMSM_DISPATCH(&ref.super, e);
+        });
+        double const tCt = measure(n, [&]() {
+            (void)ct.dispatch(e);
+        });
+        double const tAct = measure(n, [&]() {
+            QMSM_DISPATCH(&act.ao()->super, e);
+        });
+        std::printf("%6s %12.2f %12.2f %12.2f\n", l_name[k], tRef, tCt, tAct);
+
+        /* the same sequence of entry/exit actions in all the machines */
+        Q_ALLEGE((ref.trace == ct.trace) && (ct.trace == act.trace));
+    }
+#ifdef QHSM_TRAN_CACHE
+    std::printf("QHsm transition cache of %u: %lu hits, %lu misses\n",
+                unsigned(QHSM_TRAN_CACHE), (unsigned long)cache.hits,
+                (unsigned long)cache.misses);
+#endif
+#ifdef QHSM_SIG_MAP
+    Q_ALLEGE(QHsm_isIn(&ref.super, Q_STATE_CAST((&::ref<0, 1>)))
+             != QHsm_isIn(&ref.super, Q_STATE_CAST((&::ref<1, 1>))));
+    std::printf("QHsm handled-signal map of %u: %lu handler calls skipped\n",
+                unsigned(QHSM_SIG_MAP), (unsigned long)sigMap.skipped);
+#endif
+    BENCH_USE(ref.trace);
+    return 0;
+}
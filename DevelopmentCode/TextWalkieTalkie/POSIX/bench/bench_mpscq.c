@@ -0,0 +1,153 @@
+/*****************************************************************************
+* Product: benchmark of the lock-free QMpscQueue against the QEQueue
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: bench_mpscq [iterations]
+*
+* 1. single thread: bursts of post() followed by the same number of get(),
+*    which measures the raw cost of one post/get pair without contention.
+* 2. 1, 2, 4 and 8 producer threads streaming events to one consumer thread,
+*    which measures how the producer throughput scales with the number of
+*    producers (the QEQueue serializes all of them on the QF critical
+*    section). The scaling is visible only on a host with enough cores.
+*****************************************************************************/
+#include "qpc.h"
+#include "qmpscq.h"
+#include "bench.h"
+
+#include <stdio.h>   /* for printf() */
+#include <sched.h>   /* for sched_yield() */
+
+Q_DEFINE_THIS_FILE
+
+#define QLEN      64U
+#define MAX_PROD  8U
+
+static QEvt const l_evt[QLEN] = {
+    { (QSignal)Q_USER_SIG, 0U, 0U }
+};
+
+static QEvt const *l_qeqSto[QLEN];
+static QEvt const *l_mpscSto[QLEN];
+static QEQueue    l_qeq;
+static QMpscQueue l_mpsc;
+static uint32_t   l_nEvts; /* events per producer */
+
+/*..........................................................................*/
+static void burst_qeq(uint32_t n, uint32_t burst) {
+    uint64_t t0;
+    uint32_t i;
+    uint32_t j;
+
+    QEQueue_init(&l_qeq, l_qeqSto, Q_DIM(l_qeqSto));
+    t0 = BENCH_now();
+    for (i = 0U; i < n; i += burst) {
+        for (j = 0U; j < burst; ++j) {
+            (void)QEQueue_post(&l_qeq, &l_evt[j], (uint_fast16_t)0);
+        }
+        for (j = 0U; j < burst; ++j) {
+            BENCH_USE(QEQueue_get(&l_qeq));
+        }
+    }
+    printf("QEQueue     burst %2u: %7.2f ns/post+get\n", (unsigned)burst,
+           (double)(BENCH_now() - t0) / (double)n);
+}
+/*..........................................................................*/
+static void burst_mpsc(uint32_t n, uint32_t burst) {
+    uint64_t t0;
+    uint32_t i;
+    uint32_t j;
+
+    QMpscQueue_init(&l_mpsc, l_mpscSto, Q_DIM(l_mpscSto));
+    t0 = BENCH_now();
+    for (i = 0U; i < n; i += burst) {
+        for (j = 0U; j < burst; ++j) {
+            (void)QMpscQueue_post(&l_mpsc, &l_evt[j], (uint_fast16_t)0);
+        }
+        for (j = 0U; j < burst; ++j) {
+            BENCH_USE(QMpscQueue_get(&l_mpsc));
+        }
+    }
+    printf("QMpscQueue  burst %2u: %7.2f ns/post+get\n", (unsigned)burst,
+           (double)(BENCH_now() - t0) / (double)n);
+}
+
+/*..........................................................................*/
+static void *producer_qeq(void *arg) {
+    uint32_t i;
+    (void)arg;
+    for (i = 0U; i < l_nEvts; ++i) {
+        while (!QEQueue_post(&l_qeq, &l_evt[0], 1U)) {
+            (void)sched_yield(); /* queue full */
+        }
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static void *producer_mpsc(void *arg) {
+    uint32_t i;
+    (void)arg;
+    for (i = 0U; i < l_nEvts; ++i) {
+        while (!QMpscQueue_post(&l_mpsc, &l_evt[0], 1U)) {
+            (void)sched_yield(); /* queue full */
+        }
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static void stream(char const *name, uint32_t nProd,
+                   void *(*producer)(void *), QEvt const *(*get)(void))
+{
+    pthread_t thread[MAX_PROD];
+    uint32_t total = l_nEvts * nProd;
+    uint64_t t0 = BENCH_now();
+    uint32_t i;
+
+    for (i = 0U; i < nProd; ++i) {
+        Q_ALLEGE(pthread_create(&thread[i], (pthread_attr_t *)0,
+                                producer, (void *)0) == 0);
+    }
+    for (i = 0U; i < total; ) {
+        if (get() != (QEvt const *)0) {
+            ++i;
+        }
+        else {
+            (void)sched_yield(); /* queue empty */
+        }
+    }
+    for (i = 0U; i < nProd; ++i) {
+        (void)pthread_join(thread[i], (void **)0);
+    }
+    printf("%-11s stream %u producer(s): %7.2f ns/event\n", name,
+           (unsigned)nProd, (double)(BENCH_now() - t0) / (double)total);
+}
+/*..........................................................................*/
+static QEvt const *get_qeq(void)  { return QEQueue_get(&l_qeq); }
+static QEvt const *get_mpsc(void) { return QMpscQueue_get(&l_mpsc); }
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    uint32_t n = BENCH_iterations(argc, argv, 10000000U);
+    uint32_t nProd;
+
+    QF_init();
+
+    burst_qeq(n, 1U);
+    burst_mpsc(n, 1U);
+    burst_qeq(n, 16U);
+    burst_mpsc(n, 16U);
+
+    for (nProd = 1U; nProd <= MAX_PROD; nProd *= 2U) {
+        l_nEvts = n / 4U / nProd;
+
+        QEQueue_init(&l_qeq, l_qeqSto, Q_DIM(l_qeqSto));
+        stream("QEQueue", nProd, &producer_qeq, &get_qeq);
+
+        QMpscQueue_init(&l_mpsc, l_mpscSto, Q_DIM(l_mpscSto));
+        stream("QMpscQueue", nProd, &producer_mpsc, &get_mpsc);
+        Q_ASSERT(QMpscQueue_getNFree(&l_mpsc) == QLEN);
+    }
+
+    return 0;
+}
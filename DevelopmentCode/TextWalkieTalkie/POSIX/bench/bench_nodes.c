@@ -0,0 +1,121 @@
+/*****************************************************************************
+* Product: benchmark of many active objects ("simulated nodes") in a ring
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: bench_nodes [hops] [workers]
+*
+* The nodes form a ring, in which a number of tokens (dynamic events) are
+* passed from each node to the next one, until every token has made the
+* given number of hops. This measures the throughput of the RTC steps of
+* the QF port, including posting, event allocation and garbage collection.
+* With the work-stealing executor (make PORT=ws) the ring has 1024 nodes,
+* which share the 63 QF priority levels, and the optional second argument
+* sets the number of worker threads. The other ports are limited to
+* QF_MAX_ACTIVE nodes with unique priorities.
+*****************************************************************************/
+#include "qpc.h"
+#include "bench.h"
+
+#include <stdio.h>   /* for printf() */
+#include <stdlib.h>  /* for strtoul() */
+
+#ifdef QF_WS_MAX_WORKERS /* work-stealing executor? */
+    #define N_NODES  1024U
+#else
+    #define N_NODES  QF_MAX_ACTIVE
+#endif
+#define N_TOKENS     64U
+#define QLEN         N_TOKENS /* a node can hold all tokens at once */
+
+enum { TOKEN_SIG = Q_USER_SIG };
+
+typedef struct {
+    QEvt super;
+    uint32_t hops;  /* hops left to make */
+} TokenEvt;
+
+typedef struct {
+    QActive super;
+    QActive *next;  /* next node in the ring */
+} Node;
+
+static Node l_node[N_NODES];
+static QEvt const *l_nodeQSto[N_NODES][QLEN];
+static QF_MPOOL_EL(TokenEvt) l_poolSto[2U * N_TOKENS];
+static uint32_t l_nDone; /* tokens that made all the hops (atomic) */
+
+static QState Node_initial(Node * const me, QEvt const * const e);
+static QState Node_active (Node * const me, QEvt const * const e);
+
+/*..........................................................................*/
+static QState Node_initial(Node * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(&Node_active);
+}
+/*..........................................................................*/
+static QState Node_active(Node * const me, QEvt const * const e) {
+    QState status;
+    switch (e->sig) {
+        case TOKEN_SIG: {
+            uint32_t hops = ((TokenEvt const *)e)->hops;
+            if (hops > 1U) {
+                TokenEvt *te = Q_NEW(TokenEvt, TOKEN_SIG);
+                te->hops = hops - 1U;
+                QACTIVE_POST(me->next, &te->super, me);
+            }
+            else if (__atomic_add_fetch(&l_nDone, 1U, __ATOMIC_ACQ_REL)
+                     == N_TOKENS)
+            {
+                QF_stop(); /* all tokens made all their hops */
+            }
+            status = Q_HANDLED();
+            break;
+        }
+        default: {
+            status = Q_SUPER(&QHsm_top);
+            break;
+        }
+    }
+    return status;
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    uint32_t hops = BENCH_iterations(argc, argv, 10000U);
+    uint64_t t0;
+    uint32_t i;
+
+    QF_init();
+#ifdef QF_WS_MAX_WORKERS
+    if (argc > 2) {
+        QF_setWorkers((uint_fast8_t)strtoul(argv[2], (char **)0, 0));
+    }
+#endif
+    QF_poolInit(l_poolSto, sizeof(l_poolSto), sizeof(l_poolSto[0]));
+
+    for (i = 0U; i < N_NODES; ++i) {
+        QActive_ctor(&l_node[i].super, Q_STATE_CAST(&Node_initial));
+        l_node[i].next = &l_node[(i + 1U) % N_NODES].super;
+        QACTIVE_START(&l_node[i].super,
+                      (uint_fast8_t)(1U + (i % QF_MAX_ACTIVE)),
+                      l_nodeQSto[i], Q_DIM(l_nodeQSto[i]),
+                      (void *)0, 0U, (QEvt *)0);
+    }
+
+    /* spread the tokens evenly over the ring */
+    for (i = 0U; i < N_TOKENS; ++i) {
+        TokenEvt *te = Q_NEW(TokenEvt, TOKEN_SIG);
+        te->hops = hops;
+        QACTIVE_POST(&l_node[(i * N_NODES) / N_TOKENS].super,
+                     &te->super, (void *)0);
+    }
+
+    t0 = BENCH_now();
+    (void)QF_run(); /* returns when all tokens made all their hops */
+    printf("%u nodes, %u tokens x %u hops: %7.2f ns/RTC step\n",
+           (unsigned)N_NODES, (unsigned)N_TOKENS, (unsigned)hops,
+           (double)(BENCH_now() - t0) / ((double)N_TOKENS * (double)hops));
+
+    return 0;
+}
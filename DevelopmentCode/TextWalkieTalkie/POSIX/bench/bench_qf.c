@@ -0,0 +1,767 @@
+/*****************************************************************************
+* Product: microbenchmarks of the QP/C framework, JSON report
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: bench_qf [iterations] > report.json
+*
+* Measures the time and the cache misses per operation of the framework
+* services that every event goes through (the param of each is in []):
+*
+* QHsm_dispatch_, QMsm_dispatch_ - one dispatch of an event of the given
+*     shape (see below) through the virtual table, in a state machine with
+*     two branches of nested states [the nesting depth 1..5]
+* QActive_post_, QActive_get_    - one event to/from the queue of an AO
+* QEQueue_post, QEQueue_get      - one event to/from a raw event queue
+* QMPool_get, QMPool_put         - one block of a memory pool
+* QF_newX_, QF_gc                - one dynamic event (Q_NEW())
+* QF_publish_                    - one event [to 1..63 subscribers]
+* QPSet64_findMax                - the highest priority in a set
+* QF_tickX_                      - one clock tick [with 0..1000 armed time
+*                                  events, none of which expires]
+*
+* The shapes of the dispatched events:
+* internal - the internal transition in the leaf state
+* up       - the internal transition in the top-most state of the branch,
+*            depth - 1 levels above the leaf
+* self     - the self-transition of the leaf state
+* deep     - the transition between the leaves of the two branches, which
+*            exits and enters depth states
+* ignored  - the event not handled in any state
+*
+* Every benchmark runs once to warm up and then REPEAT times, of which the
+* fastest run is reported; the iterations are rounded up to whole sections
+* of NBLOCKS operations. The QHsm and the QMsm record the sequence of their
+* entry and exit actions, which must be identical. The benchmarks of the
+* active objects (QActive_post_, QActive_get_, QF_publish_) need the QV
+* kernel (make PORT=qv), which does not run the active objects before
+* QF_run(); the other ports give every active object its own thread or
+* worker. The report is described in NOTE2 of bench.c and "make bench_json"
+* writes it into a file.
+*****************************************************************************/
+#include "qpc.h"
+#include "bench.h"
+
+#include <stdlib.h>  /* for rand() */
+
+Q_DEFINE_THIS_FILE
+
+#define REPEAT        5U     /* the measured runs of every benchmark */
+#define DEPTH_MAX     5U     /* the deepest transition QHsm supports */
+#define QLEN          128U   /* the event queues (one measured section) */
+#define NBLOCKS       1024U  /* the memory pools (one measured section) */
+#define N_SETS        256U   /* the random priority sets (power of 2) */
+#define N_TIMERS_MAX  1000U
+#define TICKS_MAX     10000U /* shorter than TIMEOUT_MIN */
+#define TIMEOUT_MIN   20000U
+#define TIMEOUT_RANGE 40000U
+
+enum BenchSignals {
+    INTERNAL_SIG = Q_USER_SIG,
+    UP_SIG,
+    SELF_SIG,
+    DEEP_SIG,
+    IGNORED_SIG,
+    EVT_SIG,
+    TIMEOUT_SIG,
+    MAX_SIG
+};
+
+/* a benchmark of n operations, measured by the meter m */
+typedef void (*BenchFun)(void *ctx, uint32_t n, BenchMeter * const m);
+
+/*..........................................................................*/
+static void measure(char const *op, char const *variant, uint32_t param,
+                    BenchFun fun, void *ctx, uint32_t n)
+{
+    BenchMeter best;
+    BenchMeter m;
+    uint_fast8_t r;
+
+    BENCH_meterReset(&m);
+    (*fun)(ctx, n, &m); /* warm up the caches and the branch predictors */
+    BENCH_meterReset(&best);
+    for (r = 0U; r < REPEAT; ++r) {
+        BENCH_meterReset(&m);
+        (*fun)(ctx, n, &m);
+        if ((r == 0U) || (m.ns < best.ns)) {
+            best = m;
+        }
+    }
+    BENCH_jsonResult(op, variant, param, n, &best);
+}
+
+/* the state machines of the dispatch benchmarks ==========================*/
+/* the sequence of the entry (1) and exit (2) actions of the state (b, l),
+* where b is the branch (0 or 1) and l the level (1..DEPTH_MAX); the levels
+* below the depth of a state machine are not used
+*/
+static uint32_t trace(uint32_t t, uint_fast8_t b, uint_fast8_t l,
+                      uint_fast8_t kind)
+{
+    return (t * 31U) + (uint32_t)((kind * 64U) + (b * 8U) + l);
+}
+
+/* the QHsm ...............................................................*/
+typedef struct {
+    QHsm super;
+    uint8_t depth;   /* the level of the leaf states */
+    uint32_t trace;  /* the sequence of the entry and exit actions */
+} Hsm;
+
+static QStateHandler const l_hsmState[2][DEPTH_MAX + 1U];
+
+/*..........................................................................*/
+static QState Hsm_initial(Hsm * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(l_hsmState[0][1]);
+}
+/*..........................................................................*/
+static QState Hsm_state(Hsm * const me, QEvt const * const e,
+                        uint_fast8_t b, uint_fast8_t l)
+{
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            me->trace = trace(me->trace, b, l, 1U);
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            me->trace = trace(me->trace, b, l, 2U);
+            return Q_HANDLED();
+        }
+        case Q_INIT_SIG: {
+            if (l < me->depth) {
+                return Q_TRAN(l_hsmState[b][l + 1U]);
+            }
+            break;
+        }
+        case INTERNAL_SIG: {
+            if (l == me->depth) {
+                return Q_HANDLED();
+            }
+            break;
+        }
+        case UP_SIG: {
+            if (l == 1U) {
+                return Q_HANDLED();
+            }
+            break;
+        }
+        case SELF_SIG: {
+            if (l == me->depth) {
+                return Q_TRAN(l_hsmState[b][l]);
+            }
+            break;
+        }
+        case DEEP_SIG: {
+            if (l == me->depth) {
+                return Q_TRAN(l_hsmState[1U - b][l]);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    return Q_SUPER(l_hsmState[b][l - 1U]);
+}
+
+#define HSM_STATE(b_, l_) \
+static QState Hsm_##b_##l_(Hsm * const me, QEvt const * const e) { \
+    return Hsm_state(me, e, b_##U, l_##U); \
+}
+
+HSM_STATE(0, 1) HSM_STATE(0, 2) HSM_STATE(0, 3) HSM_STATE(0, 4) HSM_STATE(0, 5)
+HSM_STATE(1, 1) HSM_STATE(1, 2) HSM_STATE(1, 3) HSM_STATE(1, 4) HSM_STATE(1, 5)
+
+static QStateHandler const l_hsmState[2][DEPTH_MAX + 1U] = {
+    { Q_STATE_CAST(&QHsm_top),
+      Q_STATE_CAST(&Hsm_01), Q_STATE_CAST(&Hsm_02), Q_STATE_CAST(&Hsm_03),
+      Q_STATE_CAST(&Hsm_04), Q_STATE_CAST(&Hsm_05) },
+    { Q_STATE_CAST(&QHsm_top),
+      Q_STATE_CAST(&Hsm_11), Q_STATE_CAST(&Hsm_12), Q_STATE_CAST(&Hsm_13),
+      Q_STATE_CAST(&Hsm_14), Q_STATE_CAST(&Hsm_15) }
+};
+
+/*..........................................................................*/
+static void Hsm_ctor(Hsm * const me, uint8_t depth) {
+    QHsm_ctor(&me->super, Q_STATE_CAST(&Hsm_initial));
+    me->depth = depth;
+    me->trace = 0U;
+}
+
+/* the equivalent QMsm, coded as qmgen would generate it ..................*/
+typedef struct {
+    QMState const *target;
+    QActionHandler act[(2U * DEPTH_MAX) + 1U];
+} MsmTatbl; /* transition-action table of up to 2 * DEPTH_MAX actions */
+
+typedef struct {
+    QMsm super;
+    uint8_t depth;      /* the level of the leaf states */
+    uint32_t trace;     /* the sequence of the entry and exit actions */
+    MsmTatbl init;      /* the initial transition to the leaf of branch 0 */
+    MsmTatbl self[2];   /* the self-transitions of the leaves */
+    MsmTatbl deep[2];   /* the transitions to the leaf of the other branch */
+} Msm;
+
+static QMState const l_msmState[2][DEPTH_MAX];
+
+/*..........................................................................*/
+static QState Msm_initial(Msm * const me, QEvt const * const e) {
+    (void)e;
+    return QM_TRAN_INIT(&me->init);
+}
+/*..........................................................................*/
+static QState Msm_state(Msm * const me, QEvt const * const e,
+                        uint_fast8_t b, uint_fast8_t l)
+{
+    switch (e->sig) {
+        case INTERNAL_SIG: {
+            if (l == me->depth) {
+                return QM_HANDLED();
+            }
+            break;
+        }
+        case UP_SIG: {
+            if (l == 1U) {
+                return QM_HANDLED();
+            }
+            break;
+        }
+        case SELF_SIG: {
+            if (l == me->depth) {
+                return QM_TRAN(&me->self[b]);
+            }
+            break;
+        }
+        case DEEP_SIG: {
+            if (l == me->depth) {
+                return QM_TRAN(&me->deep[b]);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    return QM_SUPER();
+}
+/*..........................................................................*/
+static QState Msm_entry(Msm * const me, uint_fast8_t b, uint_fast8_t l) {
+    me->trace = trace(me->trace, b, l, 1U);
+    return QM_ENTRY(&l_msmState[b][l - 1U]);
+}
+/*..........................................................................*/
+static QState Msm_exit(Msm * const me, uint_fast8_t b, uint_fast8_t l) {
+    me->trace = trace(me->trace, b, l, 2U);
+    return QM_EXIT(&l_msmState[b][l - 1U]);
+}
+
+#define MSM_STATE(b_, l_) \
+static QState Msm_##b_##l_(Msm * const me, QEvt const * const e) { \
+    return Msm_state(me, e, b_##U, l_##U); \
+} \
+static QState Msm_##b_##l_##_e(Msm * const me) { \
+    return Msm_entry(me, b_##U, l_##U); \
+} \
+static QState Msm_##b_##l_##_x(Msm * const me) { \
+    return Msm_exit(me, b_##U, l_##U); \
+}
+
+MSM_STATE(0, 1) MSM_STATE(0, 2) MSM_STATE(0, 3) MSM_STATE(0, 4) MSM_STATE(0, 5)
+MSM_STATE(1, 1) MSM_STATE(1, 2) MSM_STATE(1, 3) MSM_STATE(1, 4) MSM_STATE(1, 5)
+
+#define MSM_QMSTATE(b_, l_, super_) { \
+    (super_), \
+    Q_STATE_CAST(&Msm_##b_##l_), \
+    Q_ACTION_CAST(&Msm_##b_##l_##_e), \
+    Q_ACTION_CAST(&Msm_##b_##l_##_x), \
+    Q_ACTION_CAST(0) \
+}
+
+static QMState const l_msmState[2][DEPTH_MAX] = {
+    { MSM_QMSTATE(0, 1, (QMState const *)0),
+      MSM_QMSTATE(0, 2, &l_msmState[0][0]),
+      MSM_QMSTATE(0, 3, &l_msmState[0][1]),
+      MSM_QMSTATE(0, 4, &l_msmState[0][2]),
+      MSM_QMSTATE(0, 5, &l_msmState[0][3]) },
+    { MSM_QMSTATE(1, 1, (QMState const *)0),
+      MSM_QMSTATE(1, 2, &l_msmState[1][0]),
+      MSM_QMSTATE(1, 3, &l_msmState[1][1]),
+      MSM_QMSTATE(1, 4, &l_msmState[1][2]),
+      MSM_QMSTATE(1, 5, &l_msmState[1][3]) }
+};
+
+/*..........................................................................*/
+static void Msm_ctor(Msm * const me, uint8_t depth) {
+    uint_fast8_t b;
+    uint_fast8_t l;
+    uint_fast8_t n;
+
+    QMsm_ctor(&me->super, Q_STATE_CAST(&Msm_initial));
+    me->depth = depth;
+    me->trace = 0U;
+
+    /* the tables list all the exit and entry actions, see NOTE1 of tr.c */
+    me->init.target = &l_msmState[0][depth - 1U];
+    for (l = 0U; l < depth; ++l) {
+        me->init.act[l] = l_msmState[0][l].entryAction;
+    }
+    me->init.act[depth] = Q_ACTION_CAST(0);
+
+    for (b = 0U; b < 2U; ++b) {
+        QMState const * const leaf = &l_msmState[b][depth - 1U];
+
+        me->self[b].target = leaf;
+        me->self[b].act[0] = leaf->exitAction;
+        me->self[b].act[1] = leaf->entryAction;
+        me->self[b].act[2] = Q_ACTION_CAST(0);
+
+        me->deep[b].target = &l_msmState[1U - b][depth - 1U];
+        n = 0U;
+        for (l = depth; l > 0U; --l) {
+            me->deep[b].act[n] = l_msmState[b][l - 1U].exitAction;
+            ++n;
+        }
+        for (l = 0U; l < depth; ++l) {
+            me->deep[b].act[n] = l_msmState[1U - b][l].entryAction;
+            ++n;
+        }
+        me->deep[b].act[n] = Q_ACTION_CAST(0);
+    }
+}
+
+/* dispatch ...............................................................*/
+typedef struct {
+    QMsm *sm;
+    QEvt const *e;
+} DispatchCtx;
+
+static QEvt const l_dispatchEvt[] = {
+    { (QSignal)INTERNAL_SIG, 0U, 0U },
+    { (QSignal)UP_SIG,       0U, 0U },
+    { (QSignal)SELF_SIG,     0U, 0U },
+    { (QSignal)DEEP_SIG,     0U, 0U },
+    { (QSignal)IGNORED_SIG,  0U, 0U }
+};
+static char const * const l_dispatchName[] = {
+    "internal", "up", "self", "deep", "ignored"
+};
+
+/*..........................................................................*/
+static void dispatch(void *ctx, uint32_t n, BenchMeter * const m) {
+    DispatchCtx const * const c = (DispatchCtx const *)ctx;
+    uint32_t i;
+
+    BENCH_meterStart(m);
+    for (i = 0U; i < n; ++i) {
+        QMSM_DISPATCH(c->sm, c->e);
+    }
+    BENCH_meterStop(m);
+}
+/*..........................................................................*/
+static void bench_dispatch(uint32_t n) {
+    static uint8_t const depth[] = { 1U, 2U, 3U, 4U, DEPTH_MAX };
+    static Hsm l_hsm[Q_DIM(depth)];
+    static Msm l_msm[Q_DIM(depth)];
+#ifdef QHSM_TRAN_CACHE
+    static QHsmTranCache l_cache[Q_DIM(depth)];
+#endif
+#ifdef QHSM_SIG_MAP
+    static QHsmSigMap l_sigMap[Q_DIM(depth)];
+#endif
+    uint_fast8_t d;
+    uint_fast8_t k;
+
+    for (d = 0U; d < Q_DIM(depth); ++d) {
+        Hsm_ctor(&l_hsm[d], depth[d]);
+#ifdef QHSM_TRAN_CACHE
+        QHsm_setTranCache(&l_hsm[d].super, &l_cache[d]);
+#endif
+#ifdef QHSM_SIG_MAP
+        if ((2U * depth[d]) < QHSM_SIG_MAP) { /* room for all the states? */
+            QHsm_setSigMap(&l_hsm[d].super, &l_sigMap[d]);
+        }
+#endif
+        Msm_ctor(&l_msm[d], depth[d]);
+        QMSM_INIT(&l_hsm[d].super, (QEvt const *)0);
+        QMSM_INIT(&l_msm[d].super, (QEvt const *)0);
+
+        for (k = 0U; k < Q_DIM(l_dispatchEvt); ++k) {
+            DispatchCtx c;
+
+            c.e = &l_dispatchEvt[k];
+            c.sm = &l_hsm[d].super;
+            measure("QHsm_dispatch_", l_dispatchName[k], depth[d],
+                    &dispatch, &c, n);
+            c.sm = &l_msm[d].super;
+            measure("QMsm_dispatch_", l_dispatchName[k], depth[d],
+                    &dispatch, &c, n);
+
+            /* the same sequence of the entry and exit actions */
+            Q_ALLEGE(l_hsm[d].trace == l_msm[d].trace);
+        }
+    }
+    BENCH_USE(l_hsm[0].trace);
+}
+
+/* event queues and memory pools ==========================================*/
+static QEvt const l_evt = { (QSignal)EVT_SIG, 0U, 0U };
+
+static QEQueue l_eq;
+static QEvt const *l_eqSto[QLEN];
+
+static QMPool l_pool;
+static QF_MPOOL_EL(QEvt) l_poolSto[NBLOCKS];
+static QF_MPOOL_EL(QEvt) l_evtPoolSto[NBLOCKS];
+static void *l_block[NBLOCKS];
+
+/*..........................................................................*/
+static void eq_post(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint32_t i;
+    uint32_t k;
+
+    (void)ctx;
+    for (i = 0U; i < n; i += QLEN) {
+        BENCH_meterStart(m);
+        for (k = 0U; k < QLEN; ++k) {
+            (void)QEQueue_post(&l_eq, &l_evt, 0U);
+        }
+        BENCH_meterStop(m);
+        for (k = 0U; k < QLEN; ++k) {
+            (void)QEQueue_get(&l_eq);
+        }
+    }
+}
+/*..........................................................................*/
+static void eq_get(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint32_t i;
+    uint32_t k;
+
+    (void)ctx;
+    for (i = 0U; i < n; i += QLEN) {
+        for (k = 0U; k < QLEN; ++k) {
+            (void)QEQueue_post(&l_eq, &l_evt, 0U);
+        }
+        BENCH_meterStart(m);
+        for (k = 0U; k < QLEN; ++k) {
+            BENCH_USE(QEQueue_get(&l_eq));
+        }
+        BENCH_meterStop(m);
+    }
+}
+/*..........................................................................*/
+static void pool_get(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint32_t i;
+    uint32_t k;
+
+    (void)ctx;
+    for (i = 0U; i < n; i += NBLOCKS) {
+        BENCH_meterStart(m);
+        for (k = 0U; k < NBLOCKS; ++k) {
+            l_block[k] = QMPool_get(&l_pool, 0U);
+        }
+        BENCH_meterStop(m);
+        for (k = 0U; k < NBLOCKS; ++k) {
+            QMPool_put(&l_pool, l_block[k]);
+        }
+    }
+}
+/*..........................................................................*/
+static void pool_put(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint32_t i;
+    uint32_t k;
+
+    (void)ctx;
+    for (i = 0U; i < n; i += NBLOCKS) {
+        for (k = 0U; k < NBLOCKS; ++k) {
+            l_block[k] = QMPool_get(&l_pool, 0U);
+        }
+        BENCH_meterStart(m);
+        for (k = 0U; k < NBLOCKS; ++k) {
+            QMPool_put(&l_pool, l_block[k]);
+        }
+        BENCH_meterStop(m);
+    }
+}
+/*..........................................................................*/
+static void evt_new(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint32_t i;
+    uint32_t k;
+
+    (void)ctx;
+    for (i = 0U; i < n; i += NBLOCKS) {
+        BENCH_meterStart(m);
+        for (k = 0U; k < NBLOCKS; ++k) {
+            l_block[k] = Q_NEW(QEvt, EVT_SIG);
+        }
+        BENCH_meterStop(m);
+        for (k = 0U; k < NBLOCKS; ++k) {
+            QF_gc((QEvt const *)l_block[k]);
+        }
+    }
+}
+/*..........................................................................*/
+static void evt_gc(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint32_t i;
+    uint32_t k;
+
+    (void)ctx;
+    for (i = 0U; i < n; i += NBLOCKS) {
+        for (k = 0U; k < NBLOCKS; ++k) {
+            l_block[k] = Q_NEW(QEvt, EVT_SIG);
+        }
+        BENCH_meterStart(m);
+        for (k = 0U; k < NBLOCKS; ++k) {
+            QF_gc((QEvt const *)l_block[k]);
+        }
+        BENCH_meterStop(m);
+    }
+}
+/*..........................................................................*/
+static void bench_queues(uint32_t n) {
+    QEQueue_init(&l_eq, l_eqSto, Q_DIM(l_eqSto));
+    measure("QEQueue_post", "fifo", QLEN, &eq_post, (void *)0, n);
+    measure("QEQueue_get",  "fifo", QLEN, &eq_get,  (void *)0, n);
+
+    QMPool_init(&l_pool, l_poolSto, sizeof(l_poolSto), sizeof(l_poolSto[0]));
+    measure("QMPool_get", "block", sizeof(l_poolSto[0]),
+            &pool_get, (void *)0, n);
+    measure("QMPool_put", "block", sizeof(l_poolSto[0]),
+            &pool_put, (void *)0, n);
+
+    QF_poolInit(l_evtPoolSto, sizeof(l_evtPoolSto), sizeof(l_evtPoolSto[0]));
+    measure("QF_newX_", "QEvt", sizeof(QEvt), &evt_new, (void *)0, n);
+    measure("QF_gc",    "QEvt", sizeof(QEvt), &evt_gc,  (void *)0, n);
+}
+
+/* active objects (QV kernel only) ========================================*/
+#ifdef QV_CPU_SLEEP
+
+static QActive l_ao[QF_MAX_ACTIVE];
+static QEvt const *l_aoQSto[QF_MAX_ACTIVE][QLEN];
+static QSubscrList l_subscrSto[MAX_SIG];
+
+/*..........................................................................*/
+static QState Ao_idle(QActive * const me, QEvt const * const e) {
+    (void)me;
+    (void)e;
+    return Q_SUPER(&QHsm_top);
+}
+/*..........................................................................*/
+static QState Ao_initial(QActive * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(&Ao_idle);
+}
+/*..........................................................................*/
+static void ao_post(void *ctx, uint32_t n, BenchMeter * const m) {
+    QActive * const ao = (QActive *)ctx;
+    uint32_t i;
+    uint32_t k;
+
+    for (i = 0U; i < n; i += QLEN) {
+        BENCH_meterStart(m);
+        for (k = 0U; k < QLEN; ++k) {
+            QACTIVE_POST(ao, &l_evt, (void *)0);
+        }
+        BENCH_meterStop(m);
+        for (k = 0U; k < QLEN; ++k) {
+            (void)QActive_get_(ao);
+        }
+    }
+}
+/*..........................................................................*/
+static void ao_get(void *ctx, uint32_t n, BenchMeter * const m) {
+    QActive * const ao = (QActive *)ctx;
+    uint32_t i;
+    uint32_t k;
+
+    for (i = 0U; i < n; i += QLEN) {
+        for (k = 0U; k < QLEN; ++k) {
+            QACTIVE_POST(ao, &l_evt, (void *)0);
+        }
+        BENCH_meterStart(m);
+        for (k = 0U; k < QLEN; ++k) {
+            BENCH_USE(QActive_get_(ao));
+        }
+        BENCH_meterStop(m);
+    }
+}
+/*..........................................................................*/
+static void publish(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint_fast8_t const fanOut = *(uint_fast8_t const *)ctx;
+    uint_fast8_t p;
+    uint32_t i;
+    uint32_t k;
+
+    for (i = 0U; i < n; i += QLEN) {
+        BENCH_meterStart(m);
+        for (k = 0U; k < QLEN; ++k) {
+            QF_PUBLISH(&l_evt, (void *)0);
+        }
+        BENCH_meterStop(m);
+        for (p = 0U; p < fanOut; ++p) {
+            for (k = 0U; k < QLEN; ++k) {
+                (void)QActive_get_(&l_ao[p]);
+            }
+        }
+    }
+}
+/*..........................................................................*/
+static void bench_active(uint32_t n) {
+    static uint_fast8_t const fanOut[] = { 1U, 2U, 4U, 8U, 16U, 32U, 63U };
+    uint_fast8_t p;
+    uint_fast8_t k;
+
+    QF_psInit(l_subscrSto, Q_DIM(l_subscrSto));
+    for (p = 0U; p < Q_DIM(l_ao); ++p) {
+        QActive_ctor(&l_ao[p], Q_STATE_CAST(&Ao_initial));
+        QACTIVE_START(&l_ao[p], (uint_fast8_t)(p + 1U),
+                      l_aoQSto[p], Q_DIM(l_aoQSto[p]),
+                      (void *)0, 0U, (QEvt *)0);
+    }
+
+    measure("QActive_post_", "fifo", QLEN, &ao_post, &l_ao[0], n);
+    measure("QActive_get_",  "fifo", QLEN, &ao_get,  &l_ao[0], n);
+
+    p = 0U;
+    for (k = 0U; k < Q_DIM(fanOut); ++k) {
+        for (; p < fanOut[k]; ++p) { /* the subscribers of priority 1.. */
+            QActive_subscribe(&l_ao[p], EVT_SIG);
+        }
+        measure("QF_publish_", "static", fanOut[k],
+                &publish, (void *)&fanOut[k], n);
+    }
+}
+
+#endif /* QV_CPU_SLEEP */
+
+/* priority sets ==========================================================*/
+typedef struct {
+    QPSet64 const *set;
+    uint32_t mask;   /* the index mask of the sets */
+} SetCtx;
+
+/*..........................................................................*/
+static void find_max(void *ctx, uint32_t n, BenchMeter * const m) {
+    SetCtx const * const c = (SetCtx const *)ctx;
+    uint_fast8_t p;
+    uint32_t i;
+
+    BENCH_meterStart(m);
+    for (i = 0U; i < n; ++i) {
+        QPSet64_findMax(&c->set[i & c->mask], p);
+        BENCH_USE(p);
+    }
+    BENCH_meterStop(m);
+}
+/*..........................................................................*/
+static void bench_pset(uint32_t n) {
+    static QPSet64 l_low;
+    static QPSet64 l_high;
+    static QPSet64 l_random[N_SETS];
+    SetCtx c;
+    uint32_t i;
+    uint_fast8_t p;
+
+    QPSet64_insert(&l_low, 1U);
+    QPSet64_insert(&l_high, 63U);
+    for (i = 0U; i < N_SETS; ++i) {
+        p = (uint_fast8_t)(1U + ((uint32_t)rand() % 63U));
+        QPSet64_insert(&l_random[i], p); /* never empty */
+        for (p = 1U; p <= 63U; ++p) {
+            if ((rand() & 1) != 0) {
+                QPSet64_insert(&l_random[i], p);
+            }
+        }
+    }
+
+    c.mask = 0U;
+    c.set = &l_low;
+    measure("QPSet64_findMax", "low", 1U, &find_max, &c, n);
+    c.set = &l_high;
+    measure("QPSet64_findMax", "high", 1U, &find_max, &c, n);
+    c.mask = N_SETS - 1U;
+    c.set = &l_random[0];
+    measure("QPSet64_findMax", "random", N_SETS, &find_max, &c, n);
+}
+
+/* time events ============================================================*/
+static QActive  l_timerAo;  /* constructed, but never started */
+static QTimeEvt l_timer[N_TIMERS_MAX];
+
+/*..........................................................................*/
+static QState TimerAo_initial(QActive * const me, QEvt const * const e) {
+    (void)me;
+    (void)e;
+    return Q_HANDLED();
+}
+/*..........................................................................*/
+static void tick(void *ctx, uint32_t n, BenchMeter * const m) {
+    uint32_t const nTimers = *(uint32_t const *)ctx;
+    uint32_t i;
+
+    for (i = 0U; i < nTimers; ++i) {
+        QTimeEvt_armX(&l_timer[i], (QTimeEvtCtr)(TIMEOUT_MIN
+                      + ((uint32_t)rand() % TIMEOUT_RANGE)), 0U);
+    }
+    QF_TICK_X(0U, (void *)0); /* link the newly armed time events */
+
+    BENCH_meterStart(m);
+    for (i = 0U; i < n; ++i) {
+        QF_TICK_X(0U, (void *)0);
+    }
+    BENCH_meterStop(m);
+
+    for (i = 0U; i < nTimers; ++i) {
+        Q_ALLEGE(QTimeEvt_disarm(&l_timer[i]));
+    }
+    QF_TICK_X(0U, (void *)0); /* unlink the disarmed time events */
+}
+/*..........................................................................*/
+static void bench_tick(uint32_t n) {
+    static uint32_t const nTimers[] = { 0U, 1U, 10U, 100U, N_TIMERS_MAX };
+    uint32_t const nTicks = (n / 100U < TICKS_MAX) ? (n / 100U) + 1U
+                                                   : TICKS_MAX;
+    uint_fast8_t k;
+    uint32_t i;
+
+    QActive_ctor(&l_timerAo, Q_STATE_CAST(&TimerAo_initial));
+    for (i = 0U; i < N_TIMERS_MAX; ++i) {
+        QTimeEvt_ctorX(&l_timer[i], &l_timerAo, TIMEOUT_SIG, 0U);
+    }
+    for (k = 0U; k < Q_DIM(nTimers); ++k) {
+#ifdef QF_TIMEEVT_WHEEL_SIZE
+        measure("QF_tickX_", "wheel", nTimers[k],
+                &tick, (void *)&nTimers[k], nTicks);
+#else
+        measure("QF_tickX_", "list", nTimers[k],
+                &tick, (void *)&nTimers[k], nTicks);
+#endif
+    }
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    uint32_t n = BENCH_iterations(argc, argv, 262144U);
+
+    /** @pre at least one operation */
+    Q_REQUIRE(n > 0U);
+    n = ((n + NBLOCKS - 1U) / NBLOCKS) * NBLOCKS; /* whole sections */
+
+    QF_init();
+    (void)BENCH_countersOpen();
+
+    BENCH_jsonBegin("qf", n);
+    bench_dispatch(n);
+    bench_queues(n);
+#ifdef QV_CPU_SLEEP
+    bench_active(n);
+#endif
+    bench_pset(n);
+    bench_tick(n);
+    BENCH_jsonEnd();
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*****************************************************************************
+* Product: benchmark of the QMsm generated from the QM model (qmgen)
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: bench_qm [iterations]
+*
+* The TR state machine of "Documentation/State Diagrams/TR.qm", generated
+* by qmgen into myProgram/tr.c (make qm), is compared with the equivalent
+* QHsm written by hand. For every event the benchmark measures the cost of
+* one dispatch through the virtual table (QMSM_DISPATCH()), as the QF kernel
+* does it:
+*
+* RX       - the self-transition of the state On
+* KEY_TX   - the self-transition with the [KeyTx] guard of the choice
+* KEY_CHAR - the self-transition with the [KeyChar] guard
+* KEY_OFF  - the internal transition with the [KeyOff] guard
+* KEY_NONE - the key not matched by any guard (unhandled)
+*
+* The actions and guards, which TR.qm gives only by their brief names, are
+* implemented here for both state machines. The actions record their
+* sequence, which must be identical.
+*****************************************************************************/
+#include "qpc.h"
+#include "tr.h"
+#include "bench.h"
+
+#include <ctype.h>   /* for isalnum() */
+#include <stdio.h>   /* for printf() */
+
+Q_DEFINE_THIS_FILE
+
+typedef struct {
+    QEvt super;
+    char key;    /* the key pressed */
+} KeyEvt;
+
+static uint32_t l_trace; /* the sequence of the actions */
+
+/* the actions and guards of TR.qm ========================================*/
+static void note(uint32_t action, QEvt const * const e) {
+    l_trace = (l_trace * 31U) + (action * 256U) + (uint32_t)e->sig;
+}
+static bool keyTx(QEvt const * const e) {
+    return ((KeyEvt const *)e)->key == 'T';
+}
+static bool keyChar(QEvt const * const e) {
+    return isalnum((unsigned char)((KeyEvt const *)e)->key) != 0;
+}
+static bool keyOff(QEvt const * const e) {
+    return ((KeyEvt const *)e)->key == 'O';
+}
+/*..........................................................................*/
+void TR_Rx(TR * const me, QEvt const * const e) {
+    (void)me;
+    note(1U, e);
+}
+bool TR_KeyTx(TR * const me, QEvt const * const e) {
+    (void)me;
+    return keyTx(e);
+}
+void TR_Tx(TR * const me, QEvt const * const e) {
+    (void)me;
+    note(2U, e);
+}
+bool TR_KeyChar(TR * const me, QEvt const * const e) {
+    (void)me;
+    return keyChar(e);
+}
+void TR_ProcessChar(TR * const me, QEvt const * const e) {
+    (void)me;
+    note(3U, e);
+}
+bool TR_KeyOff(TR * const me, QEvt const * const e) {
+    (void)me;
+    return keyOff(e);
+}
+void TR_PowerOff(TR * const me, QEvt const * const e) {
+    (void)me;
+    note(4U, e);
+}
+
+/* the equivalent QHsm ====================================================*/
+typedef struct {
+    QActive super;
+} Ref;
+
+static QState Ref_initial(Ref * const me, QEvt const * const e);
+static QState Ref_On     (Ref * const me, QEvt const * const e);
+
+/*..........................................................................*/
+static QState Ref_initial(Ref * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(&Ref_On);
+}
+/*..........................................................................*/
+static QState Ref_On(Ref * const me, QEvt const * const e) {
+    QState status;
+    switch (e->sig) {
+        case RxIRQ_SIG: {
+            note(1U, e);
+            status = Q_TRAN(&Ref_On);
+            break;
+        }
+        case KeyIRQ_SIG: {
+            if (keyTx(e)) {
+                note(2U, e);
+                status = Q_TRAN(&Ref_On);
+            }
+            else if (keyChar(e)) {
+                note(3U, e);
+                status = Q_TRAN(&Ref_On);
+            }
+            else if (keyOff(e)) {
+                note(4U, e);
+                status = Q_HANDLED();
+            }
+            else {
+                status = Q_UNHANDLED();
+            }
+            break;
+        }
+        default: {
+            status = Q_SUPER(&QHsm_top);
+            break;
+        }
+    }
+    return status;
+}
+
+/*..........................................................................*/
+static KeyEvt const l_evt[] = {
+    { { (QSignal)RxIRQ_SIG,  0U, 0U }, '\0' },
+    { { (QSignal)KeyIRQ_SIG, 0U, 0U }, 'T'  },
+    { { (QSignal)KeyIRQ_SIG, 0U, 0U }, 'a'  },
+    { { (QSignal)KeyIRQ_SIG, 0U, 0U }, 'O'  },
+    { { (QSignal)KeyIRQ_SIG, 0U, 0U }, '#'  }
+};
+static char const * const l_name[] = {
+    "RX", "KEY_TX", "KEY_CHAR", "KEY_OFF", "KEY_NONE"
+};
+
+/*..........................................................................*/
+static double measure(QMsm * const sm, QEvt const * const e, uint32_t n,
+                      uint32_t * const trace)
+{
+    uint64_t t0;
+    uint32_t i;
+
+    l_trace = 0U;
+    t0 = BENCH_now();
+    for (i = 0U; i < n; ++i) {
+        QMSM_DISPATCH(sm, e);
+    }
+    *trace = l_trace;
+    return (double)(BENCH_now() - t0) / (double)n;
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    static TR l_tr;
+    static Ref l_ref;
+    uint32_t const n = BENCH_iterations(argc, argv, 1000000U);
+    unsigned k;
+
+    QF_init();
+
+    TR_ctor(&l_tr);
+    QActive_ctor(&l_ref.super, Q_STATE_CAST(&Ref_initial));
+    QMSM_INIT(&l_tr.super.super, (QEvt const *)0);
+    QMSM_INIT(&l_ref.super.super, (QEvt const *)0);
+
+    printf("%9s %12s %12s  [ns/dispatch]\n", "event", "QMsm (qmgen)", "QHsm");
+    for (k = 0U; k < Q_DIM(l_evt); ++k) {
+        QEvt const * const e = &l_evt[k].super;
+        uint32_t traceTr;
+        uint32_t traceRef;
+        double const tTr  = measure(&l_tr.super.super, e, n, &traceTr);
+        double const tRef = measure(&l_ref.super.super, e, n, &traceRef);
+        printf("%9s %12.2f %12.2f\n", l_name[k], tTr, tRef);
+
+        /* the same sequence of the actions in both state machines */
+        Q_ALLEGE(traceTr == traceRef);
+    }
+    BENCH_USE(l_trace);
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*****************************************************************************
+* Product: benchmark of the lock-free QSpscQueue against the QEQueue
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: bench_spscq [iterations]
+*
+* 1. single thread: bursts of post() followed by the same number of get(),
+*    which measures the raw cost of one post/get pair without contention.
+* 2. two threads: one producer and one consumer thread streaming events
+*    through the queue, which measures the throughput under contention
+*    (the QEQueue serializes both sides on the QF critical section).
+*****************************************************************************/
+#include "qpc.h"
+#include "qspscq.h"
+#include "bench.h"
+
+#include <stdio.h>   /* for printf() */
+#include <sched.h>   /* for sched_yield() */
+
+Q_DEFINE_THIS_FILE
+
+#define QLEN  64U
+
+static QEvt const l_evt[QLEN] = {
+    { (QSignal)Q_USER_SIG, 0U, 0U }
+};
+
+static QEvt const *l_qeqSto[QLEN];
+static QEvt const *l_spscSto[QLEN];
+static QEQueue    l_qeq;
+static QSpscQueue l_spsc;
+static uint32_t   l_nEvts;
+
+/*..........................................................................*/
+static void burst_qeq(uint32_t n, uint32_t burst) {
+    uint64_t t0;
+    uint32_t i;
+    uint32_t j;
+
+    QEQueue_init(&l_qeq, l_qeqSto, Q_DIM(l_qeqSto));
+    t0 = BENCH_now();
+    for (i = 0U; i < n; i += burst) {
+        for (j = 0U; j < burst; ++j) {
+            (void)QEQueue_post(&l_qeq, &l_evt[j], (uint_fast16_t)0);
+        }
+        for (j = 0U; j < burst; ++j) {
+            BENCH_USE(QEQueue_get(&l_qeq));
+        }
+    }
+    printf("QEQueue     burst %2u: %7.2f ns/post+get\n", (unsigned)burst,
+           (double)(BENCH_now() - t0) / (double)n);
+}
+/*..........................................................................*/
+static void burst_spsc(uint32_t n, uint32_t burst) {
+    uint64_t t0;
+    uint32_t i;
+    uint32_t j;
+
+    QSpscQueue_init(&l_spsc, l_spscSto, Q_DIM(l_spscSto),
+                    (QActive *)0, (QEvt const *)0);
+    t0 = BENCH_now();
+    for (i = 0U; i < n; i += burst) {
+        for (j = 0U; j < burst; ++j) {
+            (void)QSpscQueue_post(&l_spsc, &l_evt[j], (uint_fast16_t)0);
+        }
+        for (j = 0U; j < burst; ++j) {
+            BENCH_USE(QSpscQueue_get(&l_spsc));
+        }
+    }
+    printf("QSpscQueue  burst %2u: %7.2f ns/post+get\n", (unsigned)burst,
+           (double)(BENCH_now() - t0) / (double)n);
+}
+
+/*..........................................................................*/
+static void *producer_qeq(void *arg) {
+    uint32_t i;
+    (void)arg;
+    for (i = 0U; i < l_nEvts; ++i) {
+        while (!QEQueue_post(&l_qeq, &l_evt[0], 1U)) {
+            (void)sched_yield(); /* queue full */
+        }
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static void *producer_spsc(void *arg) {
+    uint32_t i;
+    (void)arg;
+    for (i = 0U; i < l_nEvts; ++i) {
+        while (!QSpscQueue_post(&l_spsc, &l_evt[0], 1U)) {
+            (void)sched_yield(); /* queue full */
+        }
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static void stream(char const *name, void *(*producer)(void *),
+                   QEvt const *(*get)(void))
+{
+    pthread_t thread;
+    uint64_t t0 = BENCH_now();
+    uint32_t i;
+
+    Q_ALLEGE(pthread_create(&thread, (pthread_attr_t *)0,
+                            producer, (void *)0) == 0);
+    for (i = 0U; i < l_nEvts; ) {
+        if (get() != (QEvt const *)0) {
+            ++i;
+        }
+        else {
+            (void)sched_yield(); /* queue empty */
+        }
+    }
+    (void)pthread_join(thread, (void **)0);
+    printf("%-11s stream  : %7.2f ns/event\n", name,
+           (double)(BENCH_now() - t0) / (double)l_nEvts);
+}
+/*..........................................................................*/
+static QEvt const *get_qeq(void)  { return QEQueue_get(&l_qeq); }
+static QEvt const *get_spsc(void) { return QSpscQueue_get(&l_spsc); }
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    uint32_t n = BENCH_iterations(argc, argv, 10000000U);
+
+    QF_init();
+
+    burst_qeq(n, 1U);
+    burst_spsc(n, 1U);
+    burst_qeq(n, 16U);
+    burst_spsc(n, 16U);
+
+    l_nEvts = n / 4U;
+    QEQueue_init(&l_qeq, l_qeqSto, Q_DIM(l_qeqSto));
+    stream("QEQueue", &producer_qeq, &get_qeq);
+    QSpscQueue_init(&l_spsc, l_spscSto, Q_DIM(l_spscSto),
+                    (QActive *)0, (QEvt const *)0);
+    stream("QSpscQueue", &producer_spsc, &get_spsc);
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*****************************************************************************
+* Product: benchmark of the QF time event management
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: bench_timeevt [ticks]
+*
+* For 10, 100, 1000 and 10000 armed time events, measures the cost of one
+* clock tick (QF_TICK_X()) and of one rearming of a time event. None of the
+* time events expires during the measurement, so the tick cost is only the
+* overhead of the time event management. Compare the default time event
+* lists (qf_time.c) with the hashed timing wheel (make TWHEEL=<size>).
+*****************************************************************************/
+#include "qpc.h"
+#include "bench.h"
+
+#include <stdio.h>   /* for printf() */
+#include <stdlib.h>  /* for rand() */
+
+Q_DEFINE_THIS_FILE
+
+#define N_MAX_TIMERS  10000U
+#define TIMEOUT_MIN   20000U  /* longer than the measured number of ticks */
+#define TIMEOUT_RANGE 40000U
+
+enum { TIMEOUT_SIG = Q_USER_SIG };
+
+static QActive  l_ao;  /* constructed, but never started */
+static QTimeEvt l_timer[N_MAX_TIMERS];
+
+/*..........................................................................*/
+static QState initial(QActive * const me, QEvt const * const e) {
+    (void)me;
+    (void)e;
+    return Q_HANDLED();
+}
+/*..........................................................................*/
+static QTimeEvtCtr timeout(void) {
+    return (QTimeEvtCtr)(TIMEOUT_MIN + ((uint32_t)rand() % TIMEOUT_RANGE));
+}
+/*..........................................................................*/
+static void measure(uint32_t nTimers, uint32_t nTicks) {
+    uint64_t t0;
+    double tick;
+    uint32_t i;
+
+    for (i = 0U; i < nTimers; ++i) {
+        QTimeEvt_armX(&l_timer[i], timeout(), (QTimeEvtCtr)0);
+    }
+    QF_TICK_X(0U, (void *)0); /* link the newly armed time events */
+
+    t0 = BENCH_now();
+    for (i = 0U; i < nTicks; ++i) {
+        QF_TICK_X(0U, (void *)0);
+    }
+    tick = (double)(BENCH_now() - t0) / (double)nTicks;
+
+    t0 = BENCH_now();
+    for (i = 0U; i < nTicks; ++i) {
+        Q_ALLEGE(QTimeEvt_rearm(&l_timer[i % nTimers], timeout()));
+    }
+    printf("%5u timers: %10.2f ns/tick %8.2f ns/rearm\n", (unsigned)nTimers,
+           tick, (double)(BENCH_now() - t0) / (double)nTicks);
+
+    for (i = 0U; i < nTimers; ++i) {
+        Q_ALLEGE(QTimeEvt_disarm(&l_timer[i]));
+    }
+    QF_TICK_X(0U, (void *)0); /* unlink the disarmed time events */
+}
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    uint32_t nTicks = BENCH_iterations(argc, argv, 10000U);
+    uint32_t n;
+
+    /** @pre the time events must not expire during the measurement */
+    Q_REQUIRE(nTicks < TIMEOUT_MIN);
+
+    QF_init();
+    QActive_ctor(&l_ao, Q_STATE_CAST(&initial));
+    for (n = 0U; n < N_MAX_TIMERS; ++n) {
+        QTimeEvt_ctorX(&l_timer[n], &l_ao, TIMEOUT_SIG, 0U);
+    }
+
+#ifdef QF_TIMEEVT_WHEEL_SIZE
+    printf("time events in the timing wheel of %u slots\n",
+           (unsigned)QF_TIMEEVT_WHEEL_SIZE);
+#else
+    printf("time events in the linked lists\n");
+#endif
+    for (n = 10U; n <= N_MAX_TIMERS; n *= 10U) {
+        measure(n, nTicks);
+    }
+    return 0;
+}
@@ -0,0 +1,891 @@
+/*****************************************************************************
+* Product: qhsmflat - compiles the QHsm of an active object into a flat QMsm
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: qhsmflat gen <src-dir> <trace-file> [events [seed]]
+*        qhsmflat check <trace-file>
+*
+* The tool is linked with the application (all objects except main.o) in
+* the Spy configuration and observes the state machines through their own
+* QS trace, which it drains from the QS buffer and decodes in-process with
+* the qs_decode library (make CONF=spy flatten, see the Makefile).
+*
+* gen   executes the top-most initial transition of every active object in
+*       l_machines[] and drives its QHsm through every reachable leaf state
+*       and every signal, recording the exit, entry and initial-transition
+*       actions in the QS records of each dispatch. From these it generates
+*       <src-dir>/<name>_flat.inc, which implements the same behavior as a
+*       QMsm with one flat state per leaf and one transition-action table
+*       per transition (see NOTE1). Before the exploration, the tool sends
+*       a pseudo-random sequence of events to the state machine and writes
+*       the resulting trace of actions and states to <trace-file>.
+*
+* check must be linked with the application compiled with QHSM_FLAT, which
+*       replaces the QHsm with the generated QMsm. It sends the same events
+*       as recorded in <trace-file> and compares the traces (see NOTE2).
+*****************************************************************************/
+#include "qpc.h"
+extern "C" {
+#include "blinky.h"
+}
+#include "qs_decode.hpp"
+
+#include <algorithm>
+#include <cctype>  /* for std::isalnum(), std::tolower() */
+#include <cstdio>  /* for std::fopen(), std::fprintf() */
+#include <cstdlib> /* for std::strtoul() */
+#include <deque>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+Q_DEFINE_THIS_FILE
+
+namespace {
+
+/*! an active object of the application, whose QHsm can be flattened */
+struct Machine {
+    char const *name;    //!< prefix of the state handlers, e.g. "Blinky"
+    void (*ctor)(void);  //!< constructor of the active object
+    QActive * const *ao; //!< the opaque pointer to the active object
+    QSignal maxSig;      //!< the signals Q_USER_SIG..maxSig-1 are explored
+};
+
+Machine const l_machines[] = {
+    { "Blinky", &Blinky_ctor, &AO_Blinky, static_cast<QSignal>(MAX_SIG) }
+};
+
+/*! a QEP record of the state machine being observed */
+struct Step {
+    uint8_t  rec;  //!< QEP_STATE_ENTRY, QEP_TRAN, ...
+    uint64_t fun;  //!< the state (the source state of a transition)
+    uint64_t fun2; //!< the target state or the new active state
+};
+
+/*! the QS trace of the application, decoded in-process */
+class Capture {
+public:
+    Capture() : m_dec(config()) {}
+
+    /*! drain the QS buffer and return the QEP records of @p sm */
+    std::vector<Step> drain(void const *sm) {
+        std::vector<Step> steps;
+        uint64_t const obj = reinterpret_cast<uintptr_t>(sm);
+        for (;;) {
+            uint16_t n = 1024U;
+            uint8_t const *block = QS_txBlock(&n);
+            if (block == nullptr) {
+                break;
+            }
+            m_dec.feed(block, n, [&](qs::Record const &r) {
+                if ((r.rec >= qs::QEP_STATE_ENTRY)
+                    && (r.rec <= qs::QEP_DISPATCH) && (r.obj == obj))
+                {
+                    steps.push_back(Step{ r.rec, r.fun, r.fun2 });
+                }
+            });
+            QS_txDone();
+        }
+        return steps;
+    }
+
+    /*! name of the state handler @p fun without the '&' */
+    std::string fun(uint64_t fun) const {
+        std::string s = m_dec.dict().fun(fun);
+        return (!s.empty() && (s[0] == '&')) ? s.substr(1U) : s;
+    }
+    std::string sig(QSignal sig, void const *sm) const {
+        return m_dec.dict().sig(sig, reinterpret_cast<uintptr_t>(sm));
+    }
+
+private:
+    static qs::Config config() {
+        qs::Config cfg;
+        cfg.objPtrSize = QS_OBJ_PTR_SIZE;
+        cfg.funPtrSize = QS_FUN_PTR_SIZE;
+        cfg.timeSize   = QS_TIME_SIZE;
+        cfg.sigSize    = Q_SIGNAL_SIZE;
+        return cfg;
+    }
+
+    qs::Decoder m_dec;
+};
+
+Capture *l_qs;
+
+/*! the event buffer, large enough for the parameters of the events */
+union {
+    QEvt evt;
+    uint8_t raw[256];
+} l_evt;
+
+std::vector<Step> dispatch(QActive *ao, QSignal sig) {
+    l_evt.evt.sig = sig;
+    QMSM_DISPATCH(&ao->super, &l_evt.evt);
+    return l_qs->drain(ao);
+}
+
+/*! the QS trace @p steps of one event as a line of text (see NOTE2) */
+std::string traceLine(std::string const &what,
+                      std::vector<Step> const &steps)
+{
+    static std::string const flat("_flat");
+    auto name = [](uint64_t f) {
+        std::string s = l_qs->fun(f);
+        if ((s.size() > flat.size())
+            && (s.compare(s.size() - flat.size(), flat.size(), flat) == 0))
+        {
+            s.resize(s.size() - flat.size());
+        }
+        return s;
+    };
+    std::string line = what + ":";
+    for (Step const &st : steps) {
+        switch (st.rec) {
+            case qs::QEP_STATE_ENTRY: line += " +" + name(st.fun); break;
+            case qs::QEP_STATE_EXIT:  line += " -" + name(st.fun); break;
+            case qs::QEP_INIT_TRAN:   line += " => " + name(st.fun); break;
+            case qs::QEP_TRAN:        line += " => " + name(st.fun2); break;
+            case qs::QEP_INTERN_TRAN: line += " handled"; break;
+            case qs::QEP_IGNORED:     line += " ignored"; break;
+            default:                  break; /* QEP_STATE_INIT, ... */
+        }
+    }
+    return line;
+}
+
+/*! the pseudo-random sequence of the signals (xorshift32) */
+QSignal randomSig(Machine const &m, uint32_t &seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return static_cast<QSignal>(Q_USER_SIG
+               + (seed % static_cast<uint32_t>(m.maxSig - Q_USER_SIG)));
+}
+
+#ifndef QHSM_FLAT /* the exploration needs the original QHsm */
+/*..........................................................................*/
+/*! the recorded behavior of a leaf state for one signal */
+struct Outcome {
+    uint8_t  kind;   //!< QEP_TRAN, QEP_INTERN_TRAN or QEP_IGNORED
+    uint64_t source; //!< the state which handled the signal
+    uint64_t target; //!< the target of the transition
+    uint64_t leaf;   //!< the new active (leaf) state
+    std::vector<Step> acts; //!< QEP_STATE_EXIT/ENTRY/INIT of the transition
+
+    bool operator==(Outcome const &o) const {
+        if ((kind != o.kind) || (source != o.source) || (leaf != o.leaf)
+            || (acts.size() != o.acts.size()))
+        {
+            return false;
+        }
+        for (std::size_t i = 0U; i < acts.size(); ++i) {
+            if ((acts[i].rec != o.acts[i].rec)
+                || (acts[i].fun != o.acts[i].fun))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/*! the actions and the end of a transition in the QS records @p steps */
+Outcome outcome(std::vector<Step> const &steps, uint64_t leaf) {
+    Outcome o = { qs::QEP_IGNORED, 0U, 0U, leaf, {} };
+    for (Step const &st : steps) {
+        switch (st.rec) {
+            case qs::QEP_STATE_ENTRY: /* intentionally fall through */
+            case qs::QEP_STATE_EXIT:  /* intentionally fall through */
+            case qs::QEP_STATE_INIT: {
+                o.acts.push_back(st);
+                break;
+            }
+            case qs::QEP_TRAN: {
+                o.kind = st.rec;
+                o.source = st.fun;
+                o.leaf = st.fun2;
+                break;
+            }
+            case qs::QEP_INTERN_TRAN: {
+                o.kind = st.rec;
+                o.source = st.fun;
+                break;
+            }
+            case qs::QEP_INIT_TRAN: {
+                o.kind = st.rec;
+                o.leaf = st.fun;
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+    /* the target is the source of the first nested initial transition */
+    o.target = o.leaf;
+    for (Step const &st : o.acts) {
+        if (st.rec == qs::QEP_STATE_INIT) {
+            o.target = st.fun;
+            break;
+        }
+    }
+    return o;
+}
+
+/*..........................................................................*/
+/*! the state machine discovered by driving the QHsm */
+struct Model {
+    Outcome init; //!< the top-most initial transition
+    std::vector<uint64_t> leaves; //!< in the order of the discovery
+    std::map<std::pair<uint64_t, QSignal>, Outcome> tran;
+    std::map<uint64_t, uint64_t> initTarget; //!< nested initial transitions
+    std::set<uint64_t> states; //!< all the states below the top state
+};
+
+uint64_t currentLeaf(QActive const *ao) {
+    return reinterpret_cast<uintptr_t>(ao->super.state.fun);
+}
+
+/*! drive the QHsm of @p ao through all the leaf states and signals */
+void explore(Machine const &m, QActive *ao, Model &model) {
+    std::set<uint64_t> known;
+    auto discover = [&](uint64_t leaf) {
+        if (known.insert(leaf).second) {
+            model.leaves.push_back(leaf);
+        }
+    };
+    auto pending = [&](uint64_t leaf) { /* the first unexplored signal */
+        for (QSignal sig = Q_USER_SIG; sig < m.maxSig; ++sig) {
+            if (model.tran.count({ leaf, sig }) == 0U) {
+                return sig;
+            }
+        }
+        return static_cast<QSignal>(0);
+    };
+    discover(model.init.leaf);
+
+    for (;;) {
+        uint64_t const cur = currentLeaf(ao);
+        QSignal sig = pending(cur);
+        if (sig == 0U) {
+            /* the shortest path of known transitions to a leaf state with
+            * unexplored signals, so that the extended state (such as the
+            * armed time events) stays consistent with the active state
+            */
+            std::map<uint64_t, std::pair<uint64_t, QSignal>> from;
+            std::deque<uint64_t> queue(1U, cur);
+            from[cur] = { 0U, static_cast<QSignal>(0) };
+            uint64_t goal = 0U;
+            while (!queue.empty() && (goal == 0U)) {
+                uint64_t const s = queue.front();
+                queue.pop_front();
+                for (auto const &t : model.tran) {
+                    uint64_t const n = t.second.leaf;
+                    if ((t.first.first == s) && (from.count(n) == 0U)) {
+                        from[n] = { s, t.first.second };
+                        if (pending(n) != 0U) {
+                            goal = n;
+                            break;
+                        }
+                        queue.push_back(n);
+                    }
+                }
+            }
+            if (goal == 0U) { /* any unexplored leaf state left? */
+                for (uint64_t const leaf : model.leaves) {
+                    if (pending(leaf) != 0U) {
+                        goal = leaf;
+                        break;
+                    }
+                }
+                if (goal == 0U) {
+                    break; /* all explored */
+                }
+                /* unreachable by the known transitions, enter directly */
+                ao->super.state.fun = reinterpret_cast<QStateHandler>(goal);
+                ao->super.temp.fun  = ao->super.state.fun;
+            }
+            else {
+                std::vector<QSignal> path;
+                for (uint64_t s = goal; s != cur; s = from[s].first) {
+                    path.push_back(from[s].second);
+                }
+                for (auto p = path.rbegin(); p != path.rend(); ++p) {
+                    uint64_t const leaf = currentLeaf(ao);
+                    Outcome const o = outcome(dispatch(ao, *p), leaf);
+                    if (!(o == model.tran[{ leaf, *p }])) {
+                        std::fprintf(stderr, "%s: the transition of %s on "
+                            "%s depends on the extended state\n", m.name,
+                            l_qs->fun(leaf).c_str(),
+                            l_qs->sig(*p, ao).c_str());
+                    }
+                }
+            }
+            continue;
+        }
+        Outcome o = outcome(dispatch(ao, sig), cur);
+        discover(o.leaf);
+        model.tran[{ cur, sig }] = std::move(o);
+    }
+
+    /* the states and the targets of their initial transitions */
+    auto addActs = [&model](Outcome const &o) {
+        for (Step const &st : o.acts) {
+            model.states.insert(st.fun);
+            if (st.rec == qs::QEP_STATE_INIT) {
+                model.initTarget.emplace(st.fun, st.fun2);
+            }
+        }
+    };
+    addActs(model.init);
+    for (auto const &t : model.tran) {
+        addActs(t.second);
+        if (t.second.kind != qs::QEP_IGNORED) {
+            model.states.insert(t.second.source);
+        }
+    }
+    /* the superstates of the leaf states (the empty signal is harmless) */
+    QEvt const empty = { static_cast<QSignal>(0), 0U, 0U };
+    QStateHandler const temp = ao->super.temp.fun;
+    for (uint64_t const leaf : model.leaves) {
+        QStateHandler s = reinterpret_cast<QStateHandler>(leaf);
+        while (s != Q_STATE_CAST(&QHsm_top)) {
+            model.states.insert(reinterpret_cast<uintptr_t>(s));
+            Q_ALLEGE((*s)(&ao->super, &empty) == (QState)Q_RET_SUPER);
+            s = ao->super.temp.fun;
+        }
+    }
+    ao->super.temp.fun = temp;
+}
+
+/*..........................................................................*/
+/*! generates the flat QMsm of @p m as C code (see NOTE1) */
+class Generator {
+public:
+    Generator(Machine const &m, QActive const *ao, Model const &model)
+      : m_m(m), m_ao(ao), m_model(model), m_out(nullptr)
+    {}
+
+    void write(std::string const &path) {
+        m_out = std::fopen(path.c_str(), "w");
+        if (m_out == nullptr) {
+            throw std::runtime_error("cannot create " + path);
+        }
+        collect();
+        header(path);
+        states();
+        actions();
+        tables();
+        handlers();
+        initial();
+        std::fclose(m_out);
+    }
+
+private:
+    /*! the C identifier of the state handler @p f */
+    std::string id(uint64_t f) const {
+        std::string const s = l_qs->fun(f);
+        bool ok = !s.empty() && !std::isdigit(static_cast<uint8_t>(s[0]));
+        for (char const c : s) {
+            ok = ok && (std::isalnum(static_cast<uint8_t>(c)) || (c == '_'));
+        }
+        if (!ok) {
+            throw std::runtime_error("the state " + s
+                                     + " has no QS_FUN_DICTIONARY()");
+        }
+        return s;
+    }
+    std::string sig(QSignal s) const { return l_qs->sig(s, m_ao); }
+    std::string table(uint64_t leaf, QSignal s) const {
+        return id(leaf) + "_flat_" + sig(s) + "_t";
+    }
+    std::string act(Step const &st) const {
+        return id(st.fun) + ((st.rec == qs::QEP_STATE_ENTRY) ? "_flat_e"
+                            : (st.rec == qs::QEP_STATE_EXIT) ? "_flat_x"
+                            : "_flat_i");
+    }
+
+    /*! the states @p c sorted by their names (independent of the layout
+    * of the code in memory)
+    */
+    template<typename C>
+    std::vector<uint64_t> byName(C const &c) const {
+        std::vector<uint64_t> v;
+        for (auto const &x : c) {
+            v.push_back(key(x));
+        }
+        std::sort(v.begin(), v.end(), [this](uint64_t a, uint64_t b) {
+            return id(a) < id(b);
+        });
+        return v;
+    }
+    static uint64_t key(uint64_t s) { return s; }
+    template<typename T>
+    static uint64_t key(std::pair<uint64_t const, T> const &x) {
+        return x.first;
+    }
+
+    void collect() {
+        auto add = [this](Outcome const &o) {
+            for (Step const &st : o.acts) {
+                m_acts[st.fun].insert(st.rec);
+            }
+        };
+        add(m_model.init);
+        for (auto const &t : m_model.tran) {
+            add(t.second);
+        }
+        m_leaves = byName(m_model.leaves);
+        for (uint64_t const leaf : m_leaves) {
+            for (QSignal sig = Q_USER_SIG; sig < m_m.maxSig; ++sig) {
+                auto const t = m_model.tran.find({ leaf, sig });
+                if ((t != m_model.tran.end())
+                    && (t->second.kind != qs::QEP_IGNORED))
+                {
+                    m_trans.push_back(&*t);
+                }
+            }
+        }
+    }
+
+    void header(std::string const &path) {
+        std::string const file = path.substr(path.find_last_of('/') + 1U);
+        std::fprintf(m_out,
+"/*****************************************************"
+"************************\n"
+"* %s as a flat QMsm, generated by qhsmflat from its QHsm\n"
+"* DO NOT EDIT, regenerate with \"make CONF=spy flatten\" in POSIX/\n"
+"*\n"
+"* Included at the end of the source file of %s when QHSM_FLAT is\n"
+"* defined. Every leaf state of the QHsm is a state without a superstate\n"
+"* here and every transition executes a single transition-action table\n"
+"* with all its exit, entry and initial-transition actions. The original\n"
+"* state handlers execute the actions and the guards; if a state handler\n"
+"* takes another transition than the recorded one, the flat state machine\n"
+"* asserts.\n"
+"*\n"
+"* %u leaf states, %u transitions, %u internal transitions\n"
+"*****************************************************"
+"************************/\n",
+            m_m.name, m_m.name, unsigned(m_model.leaves.size()),
+            count(qs::QEP_TRAN), count(qs::QEP_INTERN_TRAN));
+        m_file = file;
+    }
+
+    unsigned count(uint8_t kind) const {
+        unsigned n = 0U;
+        for (auto const &t : m_model.tran) {
+            n += (t.second.kind == kind) ? 1U : 0U;
+        }
+        return n;
+    }
+
+    void states() {
+        std::fprintf(m_out, "\n/* the flat states */\n");
+        for (uint64_t const leaf : m_leaves) {
+            std::fprintf(m_out, "static QState %s_flat(void * const me, "
+                         "QEvt const * const e);\n", id(leaf).c_str());
+        }
+        for (uint64_t const leaf : m_leaves) {
+            std::fprintf(m_out,
+                "static QMState const %s_flat_s = {\n"
+                "    (QMState const *)0,\n"
+                "    Q_STATE_CAST(&%s_flat),\n"
+                "    Q_ACTION_CAST(0),\n"
+                "    Q_ACTION_CAST(0),\n"
+                "    Q_ACTION_CAST(0)\n"
+                "};\n", id(leaf).c_str(), id(leaf).c_str());
+        }
+        bool any = false;
+        for (uint64_t const st : byName(m_acts)) {
+            std::set<uint8_t> const &a = m_acts.at(st);
+            if ((a.count(qs::QEP_STATE_ENTRY) != 0U)
+                || (a.count(qs::QEP_STATE_EXIT) != 0U))
+            {
+                if (!any) {
+                    std::fprintf(m_out, "\n#ifdef Q_SPY\n/* the original "
+                        "states, which name the entry and exit actions in "
+                        "QS */\n");
+                    any = true;
+                }
+                std::fprintf(m_out,
+                    "static QMState const %s_orig_s = {\n"
+                    "    (QMState const *)0,\n"
+                    "    Q_STATE_CAST(&%s),\n"
+                    "    Q_ACTION_CAST(0),\n"
+                    "    Q_ACTION_CAST(0),\n"
+                    "    Q_ACTION_CAST(0)\n"
+                    "};\n", id(st).c_str(), id(st).c_str());
+            }
+        }
+        if (any) {
+            std::fprintf(m_out, "#endif /* Q_SPY */\n");
+        }
+    }
+
+    void actions() {
+        if (m_acts.empty()) {
+            return;
+        }
+        std::fprintf(m_out,
+            "\n/* the actions, executed by the original state handlers */\n"
+            "static QEvt const %s_flat_evt_[] = {\n"
+            "    { (QSignal)Q_ENTRY_SIG, 0U, 0U },\n"
+            "    { (QSignal)Q_EXIT_SIG,  0U, 0U },\n"
+            "    { (QSignal)Q_INIT_SIG,  0U, 0U }\n"
+            "};\n", m_m.name);
+        for (uint64_t const st : byName(m_acts)) {
+            std::set<uint8_t> const &a = m_acts.at(st);
+            std::string const s = id(st);
+            if (a.count(qs::QEP_STATE_ENTRY) != 0U) {
+                std::fprintf(m_out,
+                    "static QState %s_flat_e(void * const me) {\n"
+                    "    (void)%s(me, &%s_flat_evt_[0]);\n"
+                    "    return QM_ENTRY(&%s_orig_s);\n"
+                    "}\n", s.c_str(), s.c_str(), m_m.name, s.c_str());
+            }
+            if (a.count(qs::QEP_STATE_EXIT) != 0U) {
+                std::fprintf(m_out,
+                    "static QState %s_flat_x(void * const me) {\n"
+                    "    (void)%s(me, &%s_flat_evt_[1]);\n"
+                    "    return QM_EXIT(&%s_orig_s);\n"
+                    "}\n", s.c_str(), s.c_str(), m_m.name, s.c_str());
+            }
+            if (a.count(qs::QEP_STATE_INIT) != 0U) {
+                std::fprintf(m_out,
+                    "static QState %s_flat_i(void * const me) {\n"
+                    "    if ((%s(me, &%s_flat_evt_[2])"
+                    " != (QState)Q_RET_TRAN)\n"
+                    "        || (Q_MSM_UPCAST(me)->temp.fun\n"
+                    "            != Q_STATE_CAST(&%s)))\n"
+                    "    {\n"
+                    "        Q_onAssert(\"%s\", (int_t)__LINE__);\n"
+                    "    }\n"
+                    "    return (QState)Q_RET_NULL;\n"
+                    "}\n", s.c_str(), s.c_str(), m_m.name,
+                    id(m_model.initTarget.at(st)).c_str(),
+                    m_file.c_str());
+            }
+        }
+    }
+
+    void tatbl(std::string const &name, Outcome const &o) {
+        std::fprintf(m_out,
+            "static struct {\n"
+            "    QMState const *target;\n"
+            "    QActionHandler const act[%u];\n"
+            "} const %s = {\n"
+            "    &%s_flat_s, /* target leaf state */\n"
+            "    {\n", unsigned(o.acts.size() + 1U), name.c_str(),
+            id(o.leaf).c_str());
+        for (Step const &st : o.acts) {
+            std::fprintf(m_out, "        Q_ACTION_CAST(&%s),\n",
+                         act(st).c_str());
+        }
+        std::fprintf(m_out,
+            "        Q_ACTION_CAST(0)  /* zero terminator */\n"
+            "    }\n"
+            "};\n");
+    }
+
+    void tables() {
+        std::fprintf(m_out, "\n/* the transition-action tables */\n");
+        tatbl(std::string(m_m.name) + "_initial_flat_t", m_model.init);
+        for (auto const *t : m_trans) {
+            if (t->second.kind == qs::QEP_TRAN) {
+                tatbl(table(t->first.first, t->first.second), t->second);
+            }
+        }
+    }
+
+    void handlers() {
+        for (uint64_t const leaf : m_leaves) {
+            std::fprintf(m_out,
+                "\n/*.................................................."
+                "........................*/\n"
+                "static QState %s_flat(void * const me, "
+                "QEvt const * const e) {\n"
+                "    switch (e->sig) {\n", id(leaf).c_str());
+            for (auto const *t : m_trans) {
+                Outcome const &o = t->second;
+                if (t->first.first != leaf) {
+                    continue;
+                }
+                std::string const s = sig(t->first.second);
+                if (o.kind == qs::QEP_INTERN_TRAN) {
+                    std::fprintf(m_out,
+                        "        case %s: { /* internal transition in %s */\n"
+                        "            if (%s(me, e)"
+                        " == (QState)Q_RET_HANDLED) {\n"
+                        "                return QM_HANDLED();\n"
+                        "            }\n"
+                        "            break;\n"
+                        "        }\n", s.c_str(), id(o.source).c_str(),
+                        id(o.source).c_str());
+                }
+                else {
+                    std::fprintf(m_out,
+                        "        case %s: { /* %s -> %s */\n"
+                        "            if ((%s(me, e) == (QState)Q_RET_TRAN)\n"
+                        "                && (Q_MSM_UPCAST(me)->temp.fun\n"
+                        "                    == Q_STATE_CAST(&%s)))\n"
+                        "            {\n"
+                        "                return QM_TRAN(&%s);\n"
+                        "            }\n"
+                        "            break;\n"
+                        "        }\n", s.c_str(), id(o.source).c_str(),
+                        id(o.target).c_str(), id(o.source).c_str(),
+                        id(o.target).c_str(),
+                        table(leaf, t->first.second).c_str());
+                }
+            }
+            std::fprintf(m_out,
+                "        default: {\n"
+                "            return QM_SUPER(); /* ignored, no superstate */\n"
+                "        }\n"
+                "    }\n"
+                "    Q_onAssert(\"%s\", (int_t)__LINE__); /* not recorded */\n"
+                "    return QM_HANDLED();\n"
+                "}\n", m_file.c_str());
+        }
+    }
+
+    void initial() {
+        std::fprintf(m_out,
+            "\n/*.................................................."
+            "........................*/\n"
+            "static QState %s_initial_flat(void * const me, "
+            "QEvt const * const e) {\n", m_m.name);
+        for (uint64_t const leaf : m_leaves) {
+            std::fprintf(m_out, "    QS_FUN_DICTIONARY(&%s_flat);\n",
+                         id(leaf).c_str());
+        }
+        /* the states without any role in the flat state machine */
+        for (uint64_t const s : byName(m_model.states)) {
+            if (!used(s)) {
+                std::fprintf(m_out, "    (void)&%s; /* no actions */\n",
+                             id(s).c_str());
+            }
+        }
+        std::fprintf(m_out,
+            "    if ((%s_initial(me, e) != (QState)Q_RET_TRAN)\n"
+            "        || (Q_MSM_UPCAST(me)->temp.fun != Q_STATE_CAST(&%s)))\n"
+            "    {\n"
+            "        Q_onAssert(\"%s\", (int_t)__LINE__);\n"
+            "    }\n"
+            "    return QM_TRAN_INIT(&%s_initial_flat_t);\n"
+            "}\n", m_m.name, id(m_model.init.target).c_str(), m_file.c_str(),
+            m_m.name);
+    }
+
+    /*! is the original state handler @p s called by the flat machine? */
+    bool used(uint64_t s) const {
+        if (m_acts.count(s) != 0U) {
+            return true;
+        }
+        for (auto const &t : m_model.tran) {
+            if ((t.second.kind != qs::QEP_IGNORED) && (t.second.source == s)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Machine const &m_m;
+    QActive const *m_ao;
+    Model const &m_model;
+    std::FILE *m_out;
+    std::string m_file;
+    std::map<uint64_t, std::set<uint8_t>> m_acts; //!< the actions by state
+    std::vector<uint64_t> m_leaves; //!< the leaf states by name
+    std::vector<std::pair<std::pair<uint64_t, QSignal> const, Outcome>
+                const *> m_trans; //!< the handled signals by leaf state
+};
+
+/*..........................................................................*/
+std::string lower(char const *s) {
+    std::string r(s);
+    for (char &c : r) {
+        c = static_cast<char>(std::tolower(static_cast<uint8_t>(c)));
+    }
+    return r;
+}
+#endif /* QHSM_FLAT */
+
+int gen(char const *dir, char const *traceFile, uint32_t nEvents,
+        uint32_t seed)
+{
+#ifdef QHSM_FLAT
+    (void)dir;
+    (void)traceFile;
+    (void)nEvents;
+    (void)seed;
+    std::fprintf(stderr, "qhsmflat gen: built with QHSM_FLAT, "
+                 "the original QHsm is not available\n");
+    return 1;
+#else
+    std::FILE *trace = std::fopen(traceFile, "w");
+    if (trace == nullptr) {
+        std::perror(traceFile);
+        return 1;
+    }
+    std::fprintf(trace, "# qhsmflat %u %u\n", unsigned(nEvents),
+                 unsigned(seed));
+    for (Machine const &m : l_machines) {
+        (*m.ctor)();
+        QActive * const ao = *m.ao;
+        QMSM_INIT(&ao->super, static_cast<QEvt const *>(0));
+
+        Model model;
+        std::vector<Step> const steps = l_qs->drain(ao);
+        model.init = outcome(steps, currentLeaf(ao));
+        /* the top-most initial transition and its target */
+        model.init.target = model.init.acts.front().fun2;
+        model.init.acts.erase(model.init.acts.begin());
+        std::fprintf(trace, "%s\n",
+                     traceLine(std::string(m.name) + " init", steps).c_str());
+
+        uint32_t rnd = seed;
+        for (uint32_t i = 0U; i < nEvents; ++i) {
+            QSignal const sig = randomSig(m, rnd);
+            std::fprintf(trace, "%s\n", traceLine(l_qs->sig(sig, ao),
+                                                  dispatch(ao, sig)).c_str());
+        }
+
+        explore(m, ao, model);
+        std::string const path = std::string(dir) + "/" + lower(m.name)
+                                 + "_flat.inc";
+        Generator(m, ao, model).write(path);
+        std::printf("%s: %u leaf states, %u states -> %s\n", m.name,
+                    unsigned(model.leaves.size()),
+                    unsigned(model.states.size()), path.c_str());
+    }
+    std::fclose(trace);
+    return 0;
+#endif
+}
+
+int check(char const *traceFile) {
+    std::FILE *trace = std::fopen(traceFile, "r");
+    if (trace == nullptr) {
+        std::perror(traceFile);
+        return 1;
+    }
+    unsigned nEvents = 0U;
+    unsigned seed = 0U;
+    if (std::fscanf(trace, "# qhsmflat %u %u\n", &nEvents, &seed) != 2) {
+        std::fprintf(stderr, "%s: not a qhsmflat trace\n", traceFile);
+        return 1;
+    }
+    char buf[1024];
+    unsigned lineNo = 1U;
+    auto expect = [&](std::string const &line) {
+        ++lineNo;
+        if ((std::fgets(buf, sizeof(buf), trace) == nullptr)
+            || (line + "\n" != buf))
+        {
+            std::fprintf(stderr, "%s:%u: expected\n  %s  got\n  %s\n",
+                         traceFile, lineNo, buf, line.c_str());
+            return false;
+        }
+        return true;
+    };
+    bool ok = true;
+    for (Machine const &m : l_machines) {
+        unsigned const first = lineNo;
+        (*m.ctor)();
+        QActive * const ao = *m.ao;
+        QMSM_INIT(&ao->super, static_cast<QEvt const *>(0));
+        ok = expect(traceLine(std::string(m.name) + " init",
+                              l_qs->drain(ao)));
+
+        uint32_t rnd = seed;
+        for (uint32_t i = 0U; ok && (i < nEvents); ++i) {
+            QSignal const sig = randomSig(m, rnd);
+            ok = expect(traceLine(l_qs->sig(sig, ao), dispatch(ao, sig)));
+        }
+        std::printf("%s: %s after %u events\n", m.name,
+                    ok ? "equivalent" : "NOT equivalent",
+                    unsigned(lineNo - first - 1U));
+        if (!ok) {
+            break;
+        }
+    }
+    std::fclose(trace);
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    std::string const cmd = (argc > 1) ? argv[1] : "";
+    if (!(((cmd == "gen") && (argc >= 4) && (argc <= 6))
+          || ((cmd == "check") && (argc == 3))))
+    {
+        std::fprintf(stderr,
+            "usage: qhsmflat gen <src-dir> <trace-file> [events [seed]]\n"
+            "       qhsmflat check <trace-file>\n");
+        return 2;
+    }
+
+    /* the QS buffer is drained by the tool, instead of QS_onStartup() of
+    * the BSP, whose QS_onFlush() would write the dictionaries to the file
+    */
+    static uint8_t qsBuf[64*1024];
+    QF_init();
+    QS_initBuf(qsBuf, sizeof(qsBuf));
+    QS_FILTER_ON(QS_ALL_RECORDS);
+
+    static Capture capture;
+    l_qs = &capture;
+
+    try {
+        if (cmd == "gen") {
+            uint32_t const n = (argc > 4)
+                ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 0))
+                : 10000U;
+            uint32_t const seed = (argc > 5)
+                ? static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 0))
+                : 1U;
+            return gen(argv[2], argv[3], n, (seed != 0U) ? seed : 1U);
+        }
+        return check(argv[2]);
+    }
+    catch (std::exception const &ex) {
+        std::fprintf(stderr, "qhsmflat: %s\n", ex.what());
+        return 1;
+    }
+}
+
+/*****************************************************************************
+* NOTE1:
+* The flat QMsm has one state per leaf state of the QHsm, which were
+* discovered by driving the QHsm. A flat state has no superstate and
+* handles every signal, which the QHsm handles in that leaf state, with the
+* original state handler that handled it (the leaf or one of its
+* superstates), so that the guards and the actions of the transition are
+* executed by the original code. The exit, entry and initial-transition
+* actions recorded for the transition (in the QS records QEP_STATE_EXIT,
+* QEP_STATE_ENTRY and QEP_STATE_INIT) are listed in one transition-action
+* table, which QMsm_execTatbl_() executes without any search of the state
+* hierarchy and without the calls of the state handlers that do not handle
+* the event. The entry and exit actions which the QHsm did not execute
+* (Q_SUPER() for Q_ENTRY_SIG or Q_EXIT_SIG) are not in the tables at all.
+*
+* The recorded behavior is valid only as long as the transitions do not
+* depend on the extended state. The generated state handlers verify that
+* the original handler took the recorded transition and assert otherwise;
+* the exploration reports the transitions that changed between the visits.
+*
+* NOTE2:
+* Every line of the trace holds the entry (+) and exit (-) actions of one
+* event in the order of their execution, followed by the new active state
+* (=>) or the internal transition (handled) or ignored event (ignored). The
+* names of the flat states are reduced to the names of the original leaf
+* states, so the traces of the QHsm and of the flat QMsm must be identical.
+*/
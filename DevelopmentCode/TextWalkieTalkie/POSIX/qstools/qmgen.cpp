@@ -0,0 +1,1073 @@
+/*****************************************************************************
+* Product: qmgen, generator of QMsm code from the QM models (*.qm)
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: qmgen [-o <dir>] <model.qm>
+*
+* -o  directory of the generated files (default: the current directory)
+*
+* For every class with a statechart in the model, qmgen writes <class>.h
+* with the class structure, the signals and the constructor, and <class>.c
+* with the state machine as a QMsm (the class TR becomes tr.h and tr.c).
+* The supported subset of the QM models comprises the hierarchical states
+* with the entry and exit actions and the initial transitions, the regular
+* and internal transitions with their actions and the (nested) choice
+* points with the guards. The actions and guards are either the code in
+* the model or, when the model gives only their brief names (as TR.qm in
+* Documentation/State Diagrams), the calls of the functions <class>_<brief>
+* declared in the header and implemented by the application.
+*
+* The generated code precomputes all the exit, entry and initial-transition
+* actions of every transition in a transition-action table, so that the
+* dispatch does not discover the state hierarchy at run time (see NOTE1).
+*****************************************************************************/
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>   /* for getopt() */
+#include <vector>
+
+namespace {
+
+/*..........................................................................*/
+/*! an element of the XML document */
+struct Node {
+    std::string tag;
+    std::map<std::string, std::string> attr;
+    std::string text;   //!< the character data (the code of the actions)
+    std::vector<std::unique_ptr<Node>> kids;
+    Node *parent = nullptr;
+
+    std::string get(char const *name) const {
+        auto const it = attr.find(name);
+        return (it != attr.end()) ? it->second : std::string();
+    }
+    Node const *child(char const *t) const {
+        for (auto const &k : kids) {
+            if (k->tag == t) {
+                return k.get();
+            }
+        }
+        return nullptr;
+    }
+};
+
+/*! the minimal XML parser for the QM models (no DTD, no namespaces) */
+class XmlParser {
+public:
+    explicit XmlParser(std::string src) : m_src(std::move(src)) {}
+
+    std::unique_ptr<Node> parse() {
+        auto root = std::make_unique<Node>();
+        root->tag = "#document";
+        Node *cur = root.get();
+        while (m_pos < m_src.size()) {
+            if (m_src[m_pos] != '<') {
+                std::size_t const end = m_src.find('<', m_pos);
+                cur->text += decode(m_src.substr(m_pos, end - m_pos));
+                m_pos = end;
+            }
+            else if (skip("<?", "?>") || skip("<!--", "-->")
+                     || skip("<!DOCTYPE", ">"))
+            {
+                /* processing instruction, comment or DTD */
+            }
+            else if (m_src.compare(m_pos, 9, "<![CDATA[") == 0) {
+                std::size_t const end = find("]]>", m_pos);
+                cur->text += m_src.substr(m_pos + 9U, end - m_pos - 9U);
+                m_pos = end + 3U;
+            }
+            else if (m_src.compare(m_pos, 2, "</") == 0) {
+                std::size_t const end = find(">", m_pos);
+                if ((cur->parent == nullptr)
+                    || (m_src.substr(m_pos + 2U, end - m_pos - 2U)
+                        != cur->tag))
+                {
+                    error("mismatched </" + cur->tag + ">");
+                }
+                cur = cur->parent;
+                m_pos = end + 1U;
+            }
+            else {
+                cur = element(cur);
+            }
+        }
+        if (cur != root.get()) {
+            error("unterminated <" + cur->tag + ">");
+        }
+        return root;
+    }
+
+private:
+    Node *element(Node *parent) {
+        auto node = std::make_unique<Node>();
+        node->parent = parent;
+        ++m_pos;
+        node->tag = name();
+        for (;;) {
+            spaces();
+            if (m_src.compare(m_pos, 2, "/>") == 0) {
+                m_pos += 2U;
+                parent->kids.push_back(std::move(node));
+                return parent;
+            }
+            if ((m_pos < m_src.size()) && (m_src[m_pos] == '>')) {
+                ++m_pos;
+                Node *const n = node.get();
+                parent->kids.push_back(std::move(node));
+                return n;
+            }
+            std::string const key = name();
+            spaces();
+            if ((m_pos >= m_src.size()) || (m_src[m_pos] != '=')) {
+                error("attribute " + key + " without a value");
+            }
+            ++m_pos;
+            spaces();
+            char const q = m_src[m_pos];
+            if ((q != '"') && (q != '\'')) {
+                error("unquoted attribute " + key);
+            }
+            std::size_t const end = find(std::string(1, q), m_pos + 1U);
+            node->attr[key] = decode(m_src.substr(m_pos + 1U,
+                                                  end - m_pos - 1U));
+            m_pos = end + 1U;
+        }
+    }
+
+    std::string name() {
+        std::size_t const start = m_pos;
+        while ((m_pos < m_src.size())
+               && (std::isalnum(static_cast<unsigned char>(m_src[m_pos]))
+                   || (std::strchr("_-.:", m_src[m_pos]) != nullptr)))
+        {
+            ++m_pos;
+        }
+        if (m_pos == start) {
+            error("name expected");
+        }
+        return m_src.substr(start, m_pos - start);
+    }
+    void spaces() {
+        while ((m_pos < m_src.size())
+               && std::isspace(static_cast<unsigned char>(m_src[m_pos])))
+        {
+            ++m_pos;
+        }
+    }
+    bool skip(char const *open, char const *close) {
+        if (m_src.compare(m_pos, std::strlen(open), open) != 0) {
+            return false;
+        }
+        m_pos = find(close, m_pos) + std::strlen(close);
+        return true;
+    }
+    std::size_t find(std::string const &s, std::size_t from) {
+        std::size_t const p = m_src.find(s, from);
+        if (p == std::string::npos) {
+            error("unexpected end of the file");
+        }
+        return p;
+    }
+    static std::string decode(std::string const &s) {
+        static char const *const ent[][2] = {
+            { "&lt;", "<" }, { "&gt;", ">" }, { "&quot;", "\"" },
+            { "&apos;", "'" }, { "&#10;", "\n" }, { "&#13;", "" },
+            { "&amp;", "&" } /* last */
+        };
+        std::string r;
+        for (std::size_t i = 0U; i < s.size(); ) {
+            bool found = false;
+            if (s[i] == '&') {
+                for (auto const &e : ent) {
+                    std::size_t const n = std::strlen(e[0]);
+                    if (s.compare(i, n, e[0]) == 0) {
+                        r += e[1];
+                        i += n;
+                        found = true;
+                        break;
+                    }
+                }
+            }
+            if (!found) {
+                r += s[i++];
+            }
+        }
+        return r;
+    }
+    [[noreturn]] void error(std::string const &msg) const {
+        unsigned line = 1U;
+        for (std::size_t i = 0U; (i < m_pos) && (i < m_src.size()); ++i) {
+            line += (m_src[i] == '\n') ? 1U : 0U;
+        }
+        throw std::runtime_error("line " + std::to_string(line) + ": "
+                                 + msg);
+    }
+
+    std::string m_src;
+    std::size_t m_pos = 0U;
+};
+
+/*..........................................................................*/
+/*! an action or a guard: the code in the model or the brief name */
+struct Code {
+    std::string code;
+    std::string brief;
+
+    bool empty() const { return code.empty() && brief.empty(); }
+};
+
+struct State;
+
+/*! a transition segment, possibly followed by the choice segments */
+struct Segment {
+    Code guard;
+    Code action;
+    State *target = nullptr;      //!< nullptr for an internal transition
+    std::vector<Segment> choices; //!< the branches of a choice point
+    std::string path;             //!< the target path in the model
+    Node const *node = nullptr;
+};
+
+struct Tran {
+    std::vector<std::string> trigs;
+    Segment seg;
+};
+
+struct State {
+    std::string name;
+    State *super = nullptr;       //!< nullptr for the top-level states
+    std::vector<State *> subs;
+    Code entry;
+    Code exit;
+    bool hasInit = false;
+    Segment init;                 //!< the initial transition, if hasInit
+    std::vector<Tran> trans;
+    Node const *node = nullptr;
+};
+
+/*! the statechart of a class in the model */
+struct Machine {
+    std::string cls;              //!< e.g. "TR"
+    std::string superclass;       //!< "qpc::QMActive" or "qpc::QMsm"
+    std::vector<std::pair<std::string, std::string>> attrs; //!< type, name
+    Segment init;                 //!< the top-most initial transition
+    std::vector<std::unique_ptr<State>> states; //!< in the model order
+    std::map<Node const *, State *> byNode;
+    std::vector<std::string> sigs;      //!< the triggers in the model order
+};
+
+bool isIdent(std::string const &s) {
+    if (s.empty() || std::isdigit(static_cast<unsigned char>(s[0]))) {
+        return false;
+    }
+    for (char const c : s) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && (c != '_')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string trim(std::string const &s) {
+    std::size_t b = 0U;
+    std::size_t e = s.size();
+    while ((b < e) && std::isspace(static_cast<unsigned char>(s[b]))) {
+        ++b;
+    }
+    while ((e > b) && std::isspace(static_cast<unsigned char>(s[e - 1U]))) {
+        --e;
+    }
+    return s.substr(b, e - b);
+}
+
+/*! the model elements counted by the numbers in the target paths */
+bool isItem(std::string const &tag) {
+    return (tag == "initial") || (tag == "state") || (tag == "tran")
+           || (tag == "choice") || (tag == "history")
+           || (tag == "submachine") || (tag == "smstate");
+}
+
+/*..........................................................................*/
+/*! builds the Machine from the <class> element of the model */
+class ModelReader {
+public:
+    explicit ModelReader(Machine &m) : m_m(m) {}
+
+    void read(Node const &cls) {
+        m_m.cls = cls.get("name");
+        m_m.superclass = cls.get("superclass");
+        if (!isIdent(m_m.cls)) {
+            throw std::runtime_error("invalid class name " + m_m.cls);
+        }
+        if ((m_m.superclass != "qpc::QMActive")
+            && (m_m.superclass != "qpc::QMsm"))
+        {
+            throw std::runtime_error(m_m.cls + ": the superclass "
+                + m_m.superclass + " is not qpc::QMActive or qpc::QMsm");
+        }
+        for (auto const &k : cls.kids) {
+            if (k->tag == "attribute") {
+                std::string const type = k->get("type");
+                std::string const name = k->get("name");
+                if (k->get("properties") != "0x01") { /* not static? */
+                    m_m.attrs.emplace_back(type, name);
+                }
+            }
+        }
+        Node const *sc = cls.child("statechart");
+        states(*sc, nullptr);
+        Node const *init = sc->child("initial");
+        if (init == nullptr) {
+            throw std::runtime_error(m_m.cls + ": no initial transition");
+        }
+        m_m.init = segment(*init);
+        resolve(m_m.init);
+        for (auto const &s : m_m.states) {
+            if (s->hasInit) {
+                resolve(s->init);
+            }
+            for (Tran &t : s->trans) {
+                resolve(t.seg);
+            }
+        }
+    }
+
+private:
+    void states(Node const &parent, State *super) {
+        for (auto const &k : parent.kids) {
+            if ((k->tag == "history") || (k->tag == "submachine")
+                || (k->tag == "smstate"))
+            {
+                throw std::runtime_error(m_m.cls + ": <" + k->tag
+                                         + "> is not supported");
+            }
+            if (k->tag != "state") {
+                continue;
+            }
+            auto s = std::make_unique<State>();
+            s->name = k->get("name");
+            s->super = super;
+            s->node = k.get();
+            if (!isIdent(s->name)) {
+                throw std::runtime_error(m_m.cls + ": invalid state name "
+                                         + s->name);
+            }
+            for (auto const &o : m_m.states) {
+                if (o->name == s->name) {
+                    throw std::runtime_error(m_m.cls + ": the state name "
+                        + s->name + " is not unique");
+                }
+            }
+            if (super != nullptr) {
+                super->subs.push_back(s.get());
+            }
+            State *const me = s.get();
+            m_m.byNode[k.get()] = me;
+            m_m.states.push_back(std::move(s));
+
+            for (auto const &c : k->kids) {
+                if (c->tag == "entry") {
+                    me->entry = code(*c);
+                }
+                else if (c->tag == "exit") {
+                    me->exit = code(*c);
+                }
+                else if (c->tag == "initial") {
+                    me->hasInit = true;
+                    me->init = segment(*c);
+                }
+                else if (c->tag == "tran") {
+                    Tran t;
+                    std::stringstream ss(c->get("trig"));
+                    std::string trig;
+                    while (std::getline(ss, trig, ',')) {
+                        trig = trim(trig);
+                        if (!isIdent(trig)) {
+                            throw std::runtime_error(me->name
+                                + ": invalid trigger '" + trig + "'");
+                        }
+                        t.trigs.push_back(trig);
+                        if (std::find(m_m.sigs.begin(), m_m.sigs.end(),
+                                      trig) == m_m.sigs.end())
+                        {
+                            m_m.sigs.push_back(trig);
+                        }
+                    }
+                    if (t.trigs.empty()) {
+                        throw std::runtime_error(me->name
+                            + ": a transition without a trigger");
+                    }
+                    t.seg = segment(*c);
+                    me->trans.push_back(std::move(t));
+                }
+            }
+            states(*k, me);
+        }
+    }
+
+    static Code code(Node const &n) {
+        Code c;
+        c.code = trim(n.text);
+        c.brief = trim(n.get("brief"));
+        return c;
+    }
+
+    Segment segment(Node const &n) {
+        Segment seg;
+        seg.node = &n;
+        seg.path = n.get("target");
+        for (auto const &c : n.kids) {
+            if (c->tag == "action") {
+                seg.action = code(*c);
+            }
+            else if (c->tag == "guard") {
+                seg.guard = code(*c);
+            }
+            else if (c->tag == "choice") {
+                seg.choices.push_back(segment(*c));
+            }
+        }
+        return seg;
+    }
+
+    void resolve(Segment &seg) {
+        if (!seg.path.empty()) {
+            if (!seg.choices.empty()) {
+                throw std::runtime_error(m_m.cls
+                    + ": a choice point with a target");
+            }
+            Node const *n = seg.node;
+            std::stringstream ss(seg.path);
+            std::string part;
+            while (std::getline(ss, part, '/')) {
+                if (part == "..") {
+                    n = n->parent;
+                }
+                else {
+                    unsigned long idx = std::stoul(part);
+                    Node const *next = nullptr;
+                    for (auto const &k : n->kids) {
+                        if (isItem(k->tag) && (idx-- == 0U)) {
+                            next = k.get();
+                            break;
+                        }
+                    }
+                    n = next;
+                }
+                if (n == nullptr) {
+                    break;
+                }
+            }
+            auto const it = m_m.byNode.find(n);
+            if (it == m_m.byNode.end()) {
+                throw std::runtime_error(m_m.cls + ": the target "
+                    + seg.path + " is not a state");
+            }
+            seg.target = it->second;
+        }
+        for (Segment &c : seg.choices) {
+            resolve(c);
+        }
+    }
+
+    Machine &m_m;
+};
+
+/*! does the code @p t use the identifier @p id? */
+bool uses(std::string const &t, std::string const &id) {
+    auto ident = [&t](std::size_t i) {
+        return std::isalnum(static_cast<unsigned char>(t[i])) || (t[i] == '_');
+    };
+    for (std::size_t p = t.find(id); p != std::string::npos;
+         p = t.find(id, p + 1U))
+    {
+        std::size_t const end = p + id.size();
+        if (((p == 0U) || !ident(p - 1U))
+            && ((end >= t.size()) || !ident(end)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*..........................................................................*/
+/*! writes the QMsm code of a Machine (see NOTE1) */
+class Generator {
+public:
+    Generator(Machine const &m, std::string model)
+      : m_m(m), m_model(std::move(model))
+    {
+        m_lower = m.cls;
+        for (char &c : m_lower) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+
+    void write(std::string const &dir) {
+        std::ostringstream c;
+        source(c);
+        std::ostringstream h;
+        header(h); /* after source(), which collects the hooks */
+        save(dir + "/" + m_lower + ".h", h.str());
+        save(dir + "/" + m_lower + ".c", c.str());
+    }
+
+private:
+    /*! the signature of a function given only by its brief name */
+    enum Hook { ACTION_ME, ACTION_ME_E, GUARD };
+
+    static void save(std::string const &path, std::string const &text) {
+        std::ofstream f(path, std::ios::binary);
+        f << text;
+        if (!f) {
+            throw std::runtime_error("cannot write " + path);
+        }
+    }
+
+    std::string fn(State const *s) const { return m_m.cls + "_" + s->name; }
+
+    /*! the hook function of the brief name @p brief */
+    std::string hook(std::string const &brief, Hook kind) {
+        if (!isIdent(brief)) {
+            throw std::runtime_error(m_m.cls + ": the brief '" + brief
+                + "' without any code is not a valid C identifier");
+        }
+        std::string const name = m_m.cls + "_" + brief;
+        auto const it = m_hooks.find(name);
+        if ((it != m_hooks.end()) && (it->second != kind)) {
+            throw std::runtime_error(m_m.cls + ": " + brief
+                + " is used with different signatures");
+        }
+        if (it == m_hooks.end()) {
+            m_hooks[name] = kind;
+            m_hookOrder.push_back(name);
+        }
+        return name;
+    }
+
+    /*! the statements of the action @p a, indented by @p ind */
+    std::string action(Code const &a, Hook kind, std::string const &ind) {
+        std::string out;
+        if (!a.code.empty()) {
+            std::stringstream ss(a.code);
+            std::string line;
+            if (!a.brief.empty()) {
+                out += ind + "/* " + a.brief + " */\n";
+            }
+            while (std::getline(ss, line)) {
+                out += ind + line + "\n";
+            }
+        }
+        else if (!a.brief.empty()) {
+            out += ind + hook(a.brief, kind)
+                   + ((kind == ACTION_ME) ? "(me);\n" : "(me, e);\n");
+        }
+        return out;
+    }
+
+    /*! the condition of the guard @p g */
+    std::string guard(Code const &g) {
+        if (!g.code.empty()) {
+            return g.code;
+        }
+        if (g.brief.empty()) {
+            throw std::runtime_error(m_m.cls + ": a choice without a guard");
+        }
+        return hook(g.brief, GUARD) + "(me, e)";
+    }
+
+    static bool isElse(Code const &g) { return g.code == "else"; }
+
+    static bool isAncestor(State const *a, State const *s) {
+        for (s = s->super; s != nullptr; s = s->super) {
+            if (s == a) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*! the actions entering the states below @p from down to @p to and
+    * the initial transitions nested in @p to; returns the leaf state
+    */
+    State const *enter(State const *from, State const *to,
+                       std::vector<std::string> &acts) const
+    {
+        for (;;) {
+            std::vector<State const *> path;
+            for (State const *s = to; s != from; s = s->super) {
+                path.push_back(s);
+            }
+            for (auto p = path.rbegin(); p != path.rend(); ++p) {
+                if (!(*p)->entry.empty()) {
+                    acts.push_back(fn(*p) + "_e");
+                }
+            }
+            if (!to->hasInit) {
+                return to;
+            }
+            State const *const t = to->init.target;
+            if ((t == nullptr) || !isAncestor(to, t)) {
+                throw std::runtime_error(fn(to) + ": the initial transition"
+                    " must target a substate");
+            }
+            if (!to->init.action.empty()) {
+                acts.push_back(fn(to) + "_i");
+            }
+            from = to;
+            to = t;
+        }
+    }
+
+    /*! the transition-action table of the transition from @p src to
+    * @p tgt, following the semantics of QHsm_tran_() (see NOTE1)
+    */
+    std::string tatbl(State const *src, State const *tgt,
+                      std::string const &ind) const
+    {
+        std::vector<std::string> acts;
+        State const *lca;
+        if (src == tgt) { /* transition to self */
+            if (!src->exit.empty()) {
+                acts.push_back(fn(src) + "_x");
+            }
+            lca = src->super;
+        }
+        else if (isAncestor(tgt, src)) { /* to a superstate */
+            for (State const *s = src; s != tgt; s = s->super) {
+                if (!s->exit.empty()) {
+                    acts.push_back(fn(s) + "_x");
+                }
+            }
+            lca = tgt;
+            tgt = nullptr; /* the target is not entered */
+        }
+        else if (isAncestor(src, tgt)) { /* to a substate */
+            lca = src;
+        }
+        else {
+            lca = src->super;
+            while ((lca != nullptr) && !isAncestor(lca, tgt)) {
+                lca = lca->super;
+            }
+            for (State const *s = src; s != lca; s = s->super) {
+                if (!s->exit.empty()) {
+                    acts.push_back(fn(s) + "_x");
+                }
+            }
+        }
+        State const *leaf = lca;
+        if (tgt != nullptr) {
+            leaf = enter(lca, tgt, acts);
+        }
+        else {
+            /* drill into the superstate with its initial transition */
+            if (lca->hasInit) {
+                if (!lca->init.action.empty()) {
+                    acts.push_back(fn(lca) + "_i");
+                }
+                leaf = enter(lca, lca->init.target, acts);
+            }
+        }
+        return table(leaf, acts, ind);
+    }
+
+    std::string table(State const *leaf, std::vector<std::string> const &acts,
+                      std::string const &ind) const
+    {
+        std::string out = ind + "static struct {\n"
+            + ind + "    QMState const *target;\n"
+            + ind + "    QActionHandler const act["
+                  + std::to_string(acts.size() + 1U) + "];\n"
+            + ind + "} const tatbl_ = { /* transition-action table */\n"
+            + ind + "    &" + fn(leaf) + "_s, /* target state */\n"
+            + ind + "    {\n";
+        for (std::string const &a : acts) {
+            out += ind + "        Q_ACTION_CAST(&" + a + "),\n";
+        }
+        out += ind + "        Q_ACTION_CAST(0) /* zero terminator */\n"
+            + ind + "    }\n"
+            + ind + "};\n";
+        return out;
+    }
+
+    /*! the code of the transition segment @p seg of the state @p src */
+    std::string segment(State const *src, Segment const &seg,
+                        std::string const &ind)
+    {
+        std::string out;
+        if (seg.choices.empty() && (seg.target != nullptr)) {
+            out += tatbl(src, seg.target, ind);
+        }
+        out += action(seg.action, ACTION_ME_E, ind);
+        if (!seg.choices.empty()) {
+            bool hasElse = false;
+            for (std::size_t i = 0U; i < seg.choices.size(); ++i) {
+                Segment const &c = seg.choices[i];
+                if (isElse(c.guard)) {
+                    if (i + 1U != seg.choices.size()) {
+                        throw std::runtime_error(fn(src)
+                            + ": the else guard must be the last one");
+                    }
+                    out += ind + ((i == 0U) ? "{" : "else {");
+                    hasElse = true;
+                }
+                else {
+                    out += ind + ((i == 0U) ? "if (" : "else if (")
+                           + guard(c.guard) + ") {";
+                }
+                if (!c.guard.brief.empty()) {
+                    out += " /* [" + c.guard.brief + "] */";
+                }
+                out += "\n" + segment(src, c, ind + "    ") + ind + "}\n";
+            }
+            if (!hasElse) {
+                out += ind + "else {\n"
+                    + ind + "    status_ = QM_UNHANDLED();\n"
+                    + ind + "}\n";
+            }
+        }
+        else if (seg.target != nullptr) {
+            out += ind + "status_ = QM_TRAN(&tatbl_);\n";
+        }
+        else {
+            out += ind + "status_ = QM_HANDLED();\n";
+        }
+        return out;
+    }
+
+    void source(std::ostream &o) {
+        o << "/*****************************************************"
+             "************************\n"
+          << "* Model: " << m_model << "\n"
+          << "* File:  " << m_lower << ".c\n"
+          << "*\n"
+          << "* The " << m_m.cls << " state machine as a QMsm, generated by "
+             "qmgen, DO NOT EDIT\n"
+          << "******************************************************"
+             "***********************/\n"
+          << "#include \"qpc.h\"\n"
+          << "#include \"" << m_lower << ".h\"\n\n";
+
+        /* the declarations, the names padded to a common column */
+        std::string const me = m_m.cls + " * const me";
+        std::vector<std::pair<std::string, bool>> decl; /* name, takes e? */
+        std::size_t width = 0U;
+        decl.emplace_back(m_m.cls + "_initial", true);
+        for (auto const &s : m_m.states) {
+            decl.emplace_back(fn(s.get()), true);
+            if (!s->entry.empty()) {
+                decl.emplace_back(fn(s.get()) + "_e", false);
+            }
+            if (!s->exit.empty()) {
+                decl.emplace_back(fn(s.get()) + "_x", false);
+            }
+            if (s->hasInit && !s->init.action.empty()) {
+                decl.emplace_back(fn(s.get()) + "_i", false);
+            }
+        }
+        for (auto const &d : decl) {
+            width = std::max(width, d.first.size());
+        }
+        for (auto const &d : decl) {
+            o << "static QState " << d.first
+              << std::string(width - d.first.size(), ' ') << "(" << me
+              << (d.second ? ", QEvt const * const e);\n" : ");\n");
+        }
+        o << "\n";
+        for (auto const &s : m_m.states) {
+            State const *const p = s.get();
+            auto act = [&](bool has, char const *suffix) {
+                return has ? "Q_ACTION_CAST(&" + fn(p) + suffix + ")"
+                           : std::string("Q_ACTION_CAST(0)");
+            };
+            o << "static QMState const " << fn(p) << "_s = {\n"
+              << "    " << ((p->super != nullptr)
+                            ? "&" + fn(p->super) + "_s"
+                            : std::string("(QMState const *)0"))
+              << ", /* superstate */\n"
+              << "    Q_STATE_CAST(&" << fn(p) << "),\n"
+              << "    " << act(!p->entry.empty(), "_e") << ",\n"
+              << "    " << act(!p->exit.empty(), "_x") << ",\n"
+              << "    Q_ACTION_CAST(0)  /* no history, see NOTE1 */\n"
+              << "};\n";
+        }
+
+        /* the constructor and the top-most initial transition */
+        o << "\n/*..................................................."
+             ".......................*/\n"
+          << "void " << m_m.cls << "_ctor(" << me << ") {\n"
+          << "    " << ((m_m.superclass == "qpc::QMActive")
+                        ? "QMActive_ctor" : "QMsm_ctor")
+          << "(&me->super, Q_STATE_CAST(&" << m_m.cls << "_initial));\n"
+          << "}\n";
+
+        if (m_m.init.target == nullptr) {
+            throw std::runtime_error(m_m.cls
+                + ": the initial transition has no target");
+        }
+        std::vector<std::string> acts;
+        State const *const leaf = enter(nullptr, m_m.init.target, acts);
+        o << "/*..................................................."
+             ".......................*/\n"
+          << "static QState " << m_m.cls << "_initial(" << me
+          << ", QEvt const * const e) {\n"
+          << table(leaf, acts, "    ");
+        std::string const a = action(m_m.init.action, ACTION_ME_E, "    ");
+        if (!uses(a, "me")) {
+            o << "    (void)me; /* unused parameter */\n";
+        }
+        if (!uses(a, "e")) {
+            o << "    (void)e;  /* unused parameter */\n";
+        }
+        o << a << "    return QM_TRAN_INIT(&tatbl_);\n"
+          << "}\n";
+
+        for (auto const &s : m_m.states) {
+            state(o, s.get());
+        }
+
+        o << "\n/*****************************************************"
+             "************************\n"
+          << "* NOTE1:\n"
+          << "* The transition-action tables list all the exit, entry and "
+             "initial-transition\n"
+          << "* actions of the transitions, computed by qmgen from the "
+             "state hierarchy. The\n"
+          << "* initial transitions are merged into the tables of the "
+             "transitions, so their\n"
+          << "* actions return Q_RET_NULL and the state handlers are "
+             "never called to\n"
+          << "* discover the hierarchy. The transitions to history are "
+             "not supported.\n"
+          << "*/\n";
+    }
+
+    void state(std::ostream &o, State const *s) {
+        std::string const me = m_m.cls + " * const me";
+        auto noMe = [](Code const &c) {
+            return c.code.empty() ? c.brief.empty() : !uses(c.code, "me");
+        };
+        auto entryExit = [&](Code const &c, char const *suffix,
+                             char const *macro)
+        {
+            o << "/*..................................................."
+                 ".......................*/\n"
+              << "static QState " << fn(s) << suffix << "(" << me << ") {\n"
+              << action(c, ACTION_ME, "    ");
+            if (noMe(c)) {
+                o << "    (void)me; /* unused parameter without Q_SPY */\n";
+            }
+            o << "    return " << macro << "(&" << fn(s) << "_s);\n"
+              << "}\n";
+        };
+
+        o << "\n";
+        if (!s->entry.empty()) {
+            entryExit(s->entry, "_e", "QM_ENTRY");
+        }
+        if (!s->exit.empty()) {
+            entryExit(s->exit, "_x", "QM_EXIT");
+        }
+        if (s->hasInit && !s->init.action.empty()) {
+            o << "/*..................................................."
+                 ".......................*/\n"
+              << "static QState " << fn(s) << "_i(" << me << ") {\n"
+              << action(s->init.action, ACTION_ME, "    ");
+            if (noMe(s->init.action)) {
+                o << "    (void)me; /* unused parameter */\n";
+            }
+            o << "    return (QState)Q_RET_NULL; /* merged, see NOTE1 */\n"
+              << "}\n";
+        }
+
+        /* the signals in the order of their values, see NOTE2 of .h */
+        std::map<std::size_t, std::pair<Tran const *, std::string>> cases;
+        for (Tran const &t : s->trans) {
+            for (std::string const &trig : t.trigs) {
+                std::size_t const k = static_cast<std::size_t>(
+                    std::find(m_m.sigs.begin(), m_m.sigs.end(), trig)
+                    - m_m.sigs.begin());
+                if (!cases.emplace(k, std::make_pair(&t, trig)).second) {
+                    throw std::runtime_error(fn(s) + ": more transitions "
+                                             "triggered by " + trig);
+                }
+            }
+        }
+        std::ostringstream body;
+        for (auto const &c : cases) {
+            Tran const *const t = c.second.first;
+            auto next = std::next(cases.find(c.first));
+            body << "        case " << c.second.second << "_SIG:";
+            if ((next != cases.end()) && (next->second.first == t)) {
+                body << "\n"; /* the same transition for more triggers */
+                continue;
+            }
+            body << " {\n" << segment(s, t->seg, "            ")
+                 << "            break;\n"
+                 << "        }\n";
+        }
+        o << "/*..................................................."
+             ".......................*/\n"
+          << "static QState " << fn(s) << "(" << me
+          << ", QEvt const * const e) {\n"
+          << "    QState status_;\n";
+        if (!uses(body.str(), "me")) {
+            o << "    (void)me; /* unused parameter */\n";
+        }
+        o << "    switch (e->sig) {\n"
+          << body.str()
+          << "        default: {\n"
+          << "            status_ = QM_SUPER();\n"
+          << "            break;\n"
+          << "        }\n"
+          << "    }\n"
+          << "    return status_;\n"
+          << "}\n";
+    }
+
+    void header(std::ostream &o) const {
+        std::string const me = m_m.cls + " * const me";
+        o << "/*****************************************************"
+             "************************\n"
+          << "* Model: " << m_model << "\n"
+          << "* File:  " << m_lower << ".h\n"
+          << "*\n"
+          << "* The " << m_m.cls << " state machine as a QMsm, generated by "
+             "qmgen, DO NOT EDIT\n"
+          << "******************************************************"
+             "***********************/\n"
+          << "#ifndef " << m_lower << "_h\n"
+          << "#define " << m_lower << "_h\n\n"
+          << "#ifndef " << m_m.cls << "_FIRST_SIG /* see NOTE1 */\n"
+          << "#define " << m_m.cls << "_FIRST_SIG Q_USER_SIG\n"
+          << "#endif\n\n"
+          << "enum " << m_m.cls << "Signals {\n";
+        for (std::size_t i = 0U; i < m_m.sigs.size(); ++i) {
+            o << "    " << m_m.sigs[i] << "_SIG"
+              << ((i == 0U) ? " = " + m_m.cls + "_FIRST_SIG" : "") << ",\n";
+        }
+        o << "    " << m_m.cls << "_MAX_SIG /* the last signal */\n"
+          << "};\n\n"
+          << "typedef struct {\n"
+          << "    " << ((m_m.superclass == "qpc::QMActive")
+                        ? "QMActive" : "QMsm") << " super;\n";
+        for (auto const &a : m_m.attrs) {
+            o << "    " << a.first << " " << a.second << ";\n";
+        }
+        o << "} " << m_m.cls << ";\n\n"
+          << "void " << m_m.cls << "_ctor(" << me << ");\n";
+        if (!m_hookOrder.empty()) {
+            o << "\n/* the actions and guards with only a brief name in the "
+                 "model, implemented\n* by the application\n*/\n";
+            for (std::string const &h : m_hookOrder) {
+                Hook const k = m_hooks.at(h);
+                o << ((k == GUARD) ? "bool " : "void ") << h << "(" << me
+                  << ((k == ACTION_ME) ? ");\n"
+                                       : ", QEvt const * const e);\n");
+            }
+        }
+        o << "\n#endif /* " << m_lower << "_h */\n"
+          << "\n/*****************************************************"
+             "************************\n"
+          << "* NOTE1:\n"
+          << "* The signals of the model are numbered in the order of "
+             "their first use from\n"
+          << "* " << m_m.cls << "_FIRST_SIG, so that the cases of the "
+             "switch statements in the state\n"
+          << "* handlers are dense and the compiler can dispatch them with "
+             "a jump table.\n"
+          << "*/\n";
+    }
+
+    Machine const &m_m;
+    std::string m_model;
+    std::string m_lower;
+    std::map<std::string, Hook> m_hooks;
+    std::vector<std::string> m_hookOrder;
+};
+
+void usage(char const *prog) {
+    std::fprintf(stderr, "usage: %s [-o <dir>] <model.qm>\n", prog);
+}
+
+} // namespace
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    std::string dir = ".";
+    int opt;
+    while ((opt = getopt(argc, argv, "o:h")) != -1) {
+        if (opt == 'o') {
+            dir = optarg;
+        }
+        else {
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string const path = argv[optind];
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), std::strerror(errno));
+        return 1;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::string const model = path.substr(path.find_last_of('/') + 1U);
+
+    try {
+        std::unique_ptr<Node> const doc = XmlParser(ss.str()).parse();
+        Node const *const root = doc->child("model");
+        if (root == nullptr) {
+            throw std::runtime_error("not a QM model");
+        }
+        unsigned n = 0U;
+        /* the classes in the packages (and nested packages) of the model */
+        std::vector<Node const *> todo(1U, root);
+        while (!todo.empty()) {
+            Node const *const p = todo.back();
+            todo.pop_back();
+            for (auto const &k : p->kids) {
+                if (k->tag == "package") {
+                    todo.push_back(k.get());
+                }
+                else if ((k->tag == "class")
+                         && (k->child("statechart") != nullptr))
+                {
+                    Machine m;
+                    ModelReader(m).read(*k);
+                    Generator(m, model).write(dir);
+                    std::printf("%s: %u states, %u signals\n",
+                                m.cls.c_str(), unsigned(m.states.size()),
+                                unsigned(m.sigs.size()));
+                    ++n;
+                }
+            }
+        }
+        if (n == 0U) {
+            throw std::runtime_error("no class with a statechart");
+        }
+    }
+    catch (std::exception const &ex) {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), ex.what());
+        return 1;
+    }
+    return 0;
+}
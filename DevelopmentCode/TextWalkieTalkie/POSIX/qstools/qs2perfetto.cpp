@@ -0,0 +1,376 @@
+/*****************************************************************************
+* Product: qs2perfetto, exporter of the QS trace to the Chrome trace JSON
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: qs2perfetto [-O<n>] [-F<n>] [-T<n>] [-S<n>] [-E<n>] [-Q<n>]
+*                    [-P<n>] [-B<n>] [-C<n>] [-f<Hz>] <file|->  > trace.json
+*
+* -O ... -C   sizes of the target data types, as in qsdecode
+* -f          frequency of the QS time stamps (QS_onGetTime()) in Hz,
+*             default 1000000000 (the nanoseconds of the host build)
+*
+* The JSON opens in ui.perfetto.dev or chrome://tracing and shows:
+* - one track per active object with a slice for every run-to-completion
+*   step, from QS_QEP_DISPATCH to the QS_QEP_TRAN, QS_QEP_INTERN_TRAN or
+*   QS_QEP_IGNORED that ends it (see NOTE1),
+* - a short "post" slice on the track of the sender of every event posted
+*   to an active object, with a flow arrow to the RTC step that processes
+*   the event (see NOTE2),
+* - counters of the event queues (nFree, nMin) and of the event pools,
+* - the clock ticks, ISRs, assertions and user records on the "QF" track.
+*****************************************************************************/
+#include "qs_decode.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <unistd.h>   /* for getopt() */
+
+namespace {
+
+enum { PID = 1, QF_TID = 1 };
+
+/* queued event of an active object, see NOTE2 */
+struct Pending {
+    uint32_t sig;
+    uint64_t flow;  //!< id of the flow from the post, 0 for none
+};
+
+/* state of the export for one active object or event sender */
+struct Track {
+    int      tid;
+    bool     inStep;   //!< inside an RTC step?
+    uint64_t t0;       //!< start of the RTC step
+    uint32_t sig;      //!< signal dispatched in the RTC step
+    uint64_t state;    //!< state handling the event
+    uint64_t flow;     //!< flow into the RTC step, 0 for none
+    uint64_t nextFlow; //!< flow of the event got from the queue
+    uint32_t nFree;    //!< last known nFree of the event queue
+    uint32_t nMin;     //!< last known nMin of the event queue
+    std::deque<Pending> queue;
+};
+
+/*..........................................................................*/
+class Exporter {
+public:
+    Exporter(qs::Decoder const &dec, double hz, std::FILE *out)
+      : m_dec(dec), m_usPerTick(1e6 / hz), m_out(out)
+    {}
+
+    void begin() {
+        std::fprintf(m_out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"args\":{\"name\":\"QP application\"}}", PID);
+    }
+    void record(qs::Record const &r);
+    void end();
+
+private:
+    Track &track(uint64_t obj);
+    void endStep(Track &a, qs::Record const &r, char const *how);
+    void counter(char const *kind, uint64_t obj, uint32_t nFree,
+                 uint32_t nMin);
+    void instant(qs::Record const &r, std::string const &name,
+                 std::string const &args);
+    std::string json(std::string_view s) const;
+    double ts(uint64_t time) const {
+        return static_cast<double>(time) * m_usPerTick;
+    }
+
+    qs::Decoder const &m_dec;
+    double const m_usPerTick;
+    std::FILE * const m_out;
+    std::unordered_map<uint64_t, Track> m_tracks;
+    uint64_t m_time = 0U;  //!< time of the current record
+    uint64_t m_flows = 0U; //!< last used flow id
+    int m_tids = QF_TID;   //!< last used track id
+};
+
+/*..........................................................................*/
+Track &Exporter::track(uint64_t obj) {
+    auto it = m_tracks.find(obj);
+    if (it == m_tracks.end()) {
+        Track t = Track();
+        t.tid = ++m_tids;
+        it = m_tracks.emplace(obj, t).first;
+    }
+    return it->second;
+}
+/*..........................................................................*/
+std::string Exporter::json(std::string_view s) const {
+    std::string out("\"");
+    for (char const c : s) {
+        if ((c == '"') || (c == '\\')) {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20U) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", unsigned(c));
+            out += buf;
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+    return out;
+}
+/*..........................................................................*/
+void Exporter::endStep(Track &a, qs::Record const &r, char const *how) {
+    qs::Dictionary const &d = m_dec.dict();
+    std::fprintf(m_out, ",\n{\"name\":%s,\"cat\":\"rtc\",\"ph\":\"X\","
+        "\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+        json(d.sig(a.sig, r.obj)).c_str(), PID, a.tid, ts(a.t0),
+        ts(r.time) - ts(a.t0));
+    if (a.flow != 0U) {
+        std::fprintf(m_out, ",\"bind_id\":\"0x%llx\",\"flow_in\":true",
+                     static_cast<unsigned long long>(a.flow));
+    }
+    std::fprintf(m_out, ",\"args\":{\"state\":%s,\"result\":\"%s\"",
+                 json(d.fun(a.state)).c_str(), how);
+    if (r.rec == qs::QEP_TRAN) {
+        std::fprintf(m_out, ",\"target\":%s", json(d.fun(r.fun2)).c_str());
+    }
+    std::fputs("}}", m_out);
+    a.inStep = false;
+    a.flow = 0U;
+}
+/*..........................................................................*/
+void Exporter::counter(char const *kind, uint64_t obj, uint32_t nFree,
+                       uint32_t nMin)
+{
+    std::fprintf(m_out, ",\n{\"name\":%s,\"ph\":\"C\",\"pid\":%d,"
+        "\"ts\":%.3f,\"args\":{\"nFree\":%u,\"nMin\":%u}}",
+        json(std::string(kind) + ' ' + m_dec.dict().obj(obj)).c_str(),
+        PID, ts(m_time), unsigned(nFree), unsigned(nMin));
+}
+/*..........................................................................*/
+void Exporter::instant(qs::Record const &r, std::string const &name,
+                       std::string const &args)
+{
+    std::fprintf(m_out, ",\n{\"name\":%s,\"ph\":\"i\",\"s\":\"t\","
+        "\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"args\":{%s}}",
+        json(name).c_str(), PID, QF_TID, ts(r.time), args.c_str());
+}
+/*..........................................................................*/
+void Exporter::record(qs::Record const &r) {
+    qs::Dictionary const &d = m_dec.dict();
+    m_time = r.time;
+    switch (r.rec) {
+        case qs::QEP_DISPATCH: {
+            Track &a = track(r.obj);
+            if (a.inStep) { /* the end of the last step was lost */
+                endStep(a, r, "?");
+            }
+            a.inStep = true;
+            a.t0     = r.time;
+            a.sig    = r.sig;
+            a.state  = r.fun;
+            a.flow   = a.nextFlow;
+            a.nextFlow = 0U;
+            break;
+        }
+        case qs::QEP_TRAN:        /* fall through */
+        case qs::QEP_INTERN_TRAN: /* fall through */
+        case qs::QEP_IGNORED: {
+            Track &a = track(r.obj);
+            if (a.inStep) {
+                endStep(a, r, (r.rec == qs::QEP_TRAN) ? "TRAN"
+                              : (r.rec == qs::QEP_IGNORED) ? "IGNORED"
+                              : "INTERN_TRAN");
+            }
+            break;
+        }
+        case qs::QF_ACTIVE_POST_FIFO:
+        case qs::QF_ACTIVE_POST_LIFO: {
+            Pending const e = { r.sig, ++m_flows };
+            int const tid = ((r.rec == qs::QF_ACTIVE_POST_FIFO)
+                             && (r.obj2 != 0U)) ? track(r.obj2).tid : QF_TID;
+            std::fprintf(m_out, ",\n{\"name\":%s,\"cat\":\"post\","
+                "\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":0,"
+                "\"bind_id\":\"0x%llx\",\"flow_out\":true,"
+                "\"args\":{\"to\":%s}}",
+                json("post " + d.sig(r.sig, r.obj)).c_str(), PID, tid,
+                ts(r.time), static_cast<unsigned long long>(e.flow),
+                json(d.obj(r.obj)).c_str());
+            Track &a = track(r.obj);
+            if (r.rec == qs::QF_ACTIVE_POST_FIFO) {
+                a.queue.push_back(e);
+            }
+            else {
+                a.queue.push_front(e);
+            }
+            a.nFree = r.ctr;
+            a.nMin  = r.ctr2;
+            counter("queue", r.obj, a.nFree, a.nMin);
+            break;
+        }
+        case qs::QF_ACTIVE_POST_ATTEMPT: {
+            Track &a = track(r.obj);
+            instant(r, "post failed " + d.sig(r.sig, r.obj),
+                    "\"to\":" + json(d.obj(r.obj)));
+            counter("queue", r.obj, r.ctr, a.nMin);
+            break;
+        }
+        case qs::QF_ACTIVE_GET:
+        case qs::QF_ACTIVE_GET_LAST: {
+            Track &a = track(r.obj);
+            a.nextFlow = 0U;
+            if (!a.queue.empty() && (a.queue.front().sig == r.sig)) {
+                a.nextFlow = a.queue.front().flow;
+                a.queue.pop_front();
+            }
+            else { /* posts lost or before the capture, resynchronize */
+                a.queue.clear();
+            }
+            a.nFree = (r.rec == qs::QF_ACTIVE_GET) ? r.ctr : (a.nFree + 1U);
+            counter("queue", r.obj, a.nFree, a.nMin);
+            break;
+        }
+        case qs::QF_MPOOL_GET:
+        case qs::QF_MPOOL_GET_ATTEMPT: {
+            Track &p = track(r.obj);
+            p.nFree = r.ctr;
+            if (r.rec == qs::QF_MPOOL_GET) {
+                p.nMin = r.ctr2;
+            }
+            counter("pool", r.obj, p.nFree, p.nMin);
+            break;
+        }
+        case qs::QF_MPOOL_PUT: {
+            Track &p = track(r.obj);
+            p.nFree = r.ctr;
+            counter("pool", r.obj, p.nFree, p.nMin);
+            break;
+        }
+        case qs::QF_TICK: {
+            instant(r, "tick", "\"rate\":" + std::to_string(r.u8a)
+                               + ",\"ctr\":" + std::to_string(r.ctr));
+            break;
+        }
+        case qs::QF_ISR_ENTRY:
+        case qs::QF_ISR_EXIT: {
+            std::fprintf(m_out, ",\n{\"name\":\"ISR prio %u\",\"ph\":\"%c\","
+                "\"pid\":%d,\"tid\":%d,\"ts\":%.3f}", unsigned(r.u8b),
+                (r.rec == qs::QF_ISR_ENTRY) ? 'B' : 'E', PID, QF_TID,
+                ts(r.time));
+            break;
+        }
+        case qs::ASSERT_FAIL: {
+            instant(r, "assert " + std::string(r.str) + ':'
+                       + std::to_string(r.line), "");
+            break;
+        }
+        default: {
+            if (r.rec >= qs::USER) {
+                instant(r, d.usr(r.rec),
+                        "\"data\":" + json(m_dec.userData(r)));
+            }
+            break;
+        }
+    }
+}
+/*..........................................................................*/
+void Exporter::end() {
+    std::fprintf(m_out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+        "\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"QF\"}}", PID, QF_TID);
+    for (auto const &t : m_tracks) {
+        std::fprintf(m_out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+            "\"pid\":%d,\"tid\":%d,\"args\":{\"name\":%s}}", PID,
+            t.second.tid, json(m_dec.dict().obj(t.first)).c_str());
+    }
+    std::fputs("\n]}\n", m_out);
+}
+
+/*..........................................................................*/
+void usage(char const *prog) {
+    std::fprintf(stderr,
+        "usage: %s [-O<n>] [-F<n>] [-T<n>] [-S<n>] [-E<n>] [-Q<n>] [-P<n>]"
+        " [-B<n>] [-C<n>] [-f<Hz>] <file|->\n", prog);
+}
+
+} // namespace
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    qs::Config cfg;
+    double hz = 1e9;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "O:F:T:S:E:Q:P:B:C:f:h")) != -1) {
+        if (opt == 'f') {
+            hz = std::atof(optarg);
+            if (!(hz > 0.0)) {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else if ((opt == 'h') || (opt == '?')
+                 || !cfg.set(static_cast<char>(opt),
+                             static_cast<unsigned>(std::atoi(optarg))))
+        {
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    qs::MappedFile file;
+    if (!file.open(argv[optind])) {
+        std::fprintf(stderr, "%s: %s\n", argv[optind], std::strerror(errno));
+        return 1;
+    }
+
+    static char outBuf[1U << 16];
+    std::setvbuf(stdout, outBuf, _IOFBF, sizeof(outBuf));
+
+    qs::Decoder dec(cfg);
+    Exporter exp(dec, hz, stdout);
+    exp.begin();
+    dec.feed(file.data(), file.size(), [&exp](qs::Record const &r) {
+        exp.record(r);
+    });
+    exp.end();
+    std::fflush(stdout);
+
+    qs::Stats const &st = dec.stats();
+    if ((st.badChecksum | st.malformed | st.seqGaps) != 0U) {
+        std::fprintf(stderr, "%llu bad checksums, %llu malformed,"
+            " %llu sequence gaps (%llu records lost)\n",
+            static_cast<unsigned long long>(st.badChecksum),
+            static_cast<unsigned long long>(st.malformed),
+            static_cast<unsigned long long>(st.seqGaps),
+            static_cast<unsigned long long>(st.lostFrames));
+    }
+    return 0;
+}
+
+/*****************************************************************************
+* NOTE1:
+* QS has no record for the end of an RTC step. Every dispatch, however,
+* ends with exactly one time-stamped record of the outcome: QS_QEP_TRAN,
+* QS_QEP_INTERN_TRAN or QS_QEP_IGNORED (QS_QEP_UNHANDLED only reports a
+* guard and the search continues in the superstate). The slice therefore
+* spans from the QS_QEP_DISPATCH to this record, which covers the actions
+* of the step, but not the bookkeeping after it (e.g., QF_gc()). The state
+* machine in these records is the active object itself (QActive derives
+* from QHsm), so the records go to the track of the active object.
+*
+* NOTE2:
+* The event queue of an active object is FIFO (LIFO posts go to the front),
+* so the exporter mirrors every queue with the posted signals and matches
+* each QS_QF_ACTIVE_GET/GET_LAST with the event at the front of the mirror.
+* The matched event carries the flow id of its post into the following
+* QS_QEP_DISPATCH. When the signals disagree (records lost, or events
+* posted before the capture started), the mirror is cleared and the steps
+* go without an arrow until the queue is in sync again. The flows use the
+* "bind_id"/"flow_out"/"flow_in" form, which binds the arrows to the slices
+* themselves, so both Perfetto and chrome://tracing draw them.
+*/
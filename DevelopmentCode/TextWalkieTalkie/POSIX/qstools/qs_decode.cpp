@@ -0,0 +1,505 @@
+/*****************************************************************************
+* Product: QS host decoder library
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* Implementation of the frame checksums, record layouts, dictionaries and
+* the memory mapping of the captures, see qs_decode.hpp.
+*****************************************************************************/
+#include "qs_decode.hpp"
+
+#include <cerrno>
+#include <cinttypes>  /* for PRIX64 */
+#include <cstdio>     /* for snprintf() */
+#include <fcntl.h>    /* for open() */
+#include <sys/mman.h> /* for mmap() */
+#include <sys/stat.h> /* for fstat() */
+#include <unistd.h>   /* for read(), close() */
+
+namespace qs {
+
+namespace {
+
+char const * const l_recNames[USER] = {
+    "QP_RESET",
+    "QEP_STATE_ENTRY", "QEP_STATE_EXIT", "QEP_STATE_INIT", "QEP_INIT_TRAN",
+    "QEP_INTERN_TRAN", "QEP_TRAN", "QEP_IGNORED", "QEP_DISPATCH",
+    "QEP_UNHANDLED",
+    "QF_ACTIVE_ADD", "QF_ACTIVE_REMOVE", "QF_ACTIVE_SUBSCRIBE",
+    "QF_ACTIVE_UNSUBSCRIBE", "QF_ACTIVE_POST_FIFO", "QF_ACTIVE_POST_LIFO",
+    "QF_ACTIVE_GET", "QF_ACTIVE_GET_LAST", "QF_EQUEUE_INIT",
+    "QF_EQUEUE_POST_FIFO", "QF_EQUEUE_POST_LIFO", "QF_EQUEUE_GET",
+    "QF_EQUEUE_GET_LAST", "QF_MPOOL_INIT", "QF_MPOOL_GET", "QF_MPOOL_PUT",
+    "QF_PUBLISH", "QF_RESERVED8", "QF_NEW", "QF_GC_ATTEMPT", "QF_GC",
+    "QF_TICK",
+    "QF_TIMEEVT_ARM", "QF_TIMEEVT_AUTO_DISARM", "QF_TIMEEVT_DISARM_ATTEMPT",
+    "QF_TIMEEVT_DISARM", "QF_TIMEEVT_REARM", "QF_TIMEEVT_POST",
+    "QF_TIMEEVT_CTR",
+    "QF_CRIT_ENTRY", "QF_CRIT_EXIT", "QF_ISR_ENTRY", "QF_ISR_EXIT",
+    "QF_INT_DISABLE", "QF_INT_ENABLE", "QF_ACTIVE_POST_ATTEMPT",
+    "QF_EQUEUE_POST_ATTEMPT", "QF_MPOOL_GET_ATTEMPT",
+    "QF_RESERVED1", "QF_RESERVED0",
+    "QK_MUTEX_LOCK", "QK_MUTEX_UNLOCK", "QK_SCHEDULE", "QK_RESERVED1",
+    "QK_RESERVED0",
+    "QEP_TRAN_HIST", "QEP_TRAN_EP", "QEP_TRAN_XP", "QEP_TRAN_CACHE",
+    "QEP_RESERVED0",
+    "SIG_DICT", "OBJ_DICT", "FUN_DICT", "USR_DICT", "EMPTY",
+    "RESERVED3", "RESERVED2", "TEST_RUN", "TEST_FAIL", "ASSERT_FAIL"
+};
+
+/* the record layouts of QP/C 5.4.0 (the QS_BEGIN_() blocks in qep_*.c,
+* qf_*.c and qs.h), see recLayout()
+*/
+char const * const l_recLayouts[USER] = {
+    "",          /* QP_RESET */
+    "OF",        /* QEP_STATE_ENTRY */
+    "OF",        /* QEP_STATE_EXIT */
+    "OFG",       /* QEP_STATE_INIT */
+    "TOF",       /* QEP_INIT_TRAN */
+    "TSOF",      /* QEP_INTERN_TRAN */
+    "TSOFG",     /* QEP_TRAN */
+    "TSOF",      /* QEP_IGNORED */
+    "TSOF",      /* QEP_DISPATCH */
+    "SOF",       /* QEP_UNHANDLED */
+    "TOu",       /* QF_ACTIVE_ADD */
+    "TOu",       /* QF_ACTIVE_REMOVE */
+    "TSO",       /* QF_ACTIVE_SUBSCRIBE */
+    "TSO",       /* QF_ACTIVE_UNSUBSCRIBE */
+    "TPSOuuqq",  /* QF_ACTIVE_POST_FIFO */
+    "TSOuuqq",   /* QF_ACTIVE_POST_LIFO */
+    "TSOuuq",    /* QF_ACTIVE_GET */
+    "TSOuu",     /* QF_ACTIVE_GET_LAST */
+    "Oq",        /* QF_EQUEUE_INIT */
+    "TSOuuqq",   /* QF_EQUEUE_POST_FIFO */
+    "TSOuuqq",   /* QF_EQUEUE_POST_LIFO */
+    "TSOuuq",    /* QF_EQUEUE_GET */
+    "TSOuu",     /* QF_EQUEUE_GET_LAST */
+    "Op",        /* QF_MPOOL_INIT */
+    "TOpp",      /* QF_MPOOL_GET */
+    "TOp",       /* QF_MPOOL_PUT */
+    "TPSuu",     /* QF_PUBLISH */
+    nullptr,     /* QF_RESERVED8 */
+    "TeS",       /* QF_NEW */
+    "TSuu",      /* QF_GC_ATTEMPT */
+    "TSuu",      /* QF_GC */
+    "tu",        /* QF_TICK */
+    "TOPttu",    /* QF_TIMEEVT_ARM */
+    "OPu",       /* QF_TIMEEVT_AUTO_DISARM */
+    "TOPu",      /* QF_TIMEEVT_DISARM_ATTEMPT */
+    "TOPttu",    /* QF_TIMEEVT_DISARM */
+    "TOPttuu",   /* QF_TIMEEVT_REARM */
+    "TOSPu",     /* QF_TIMEEVT_POST */
+    "TOPttu",    /* QF_TIMEEVT_CTR */
+    "Tu",        /* QF_CRIT_ENTRY */
+    "Tu",        /* QF_CRIT_EXIT */
+    "Tuu",       /* QF_ISR_ENTRY */
+    "Tuu",       /* QF_ISR_EXIT */
+    nullptr,     /* QF_INT_DISABLE */
+    nullptr,     /* QF_INT_ENABLE */
+    "TPSOuuqq",  /* QF_ACTIVE_POST_ATTEMPT */
+    "TSOuuqq",   /* QF_EQUEUE_POST_ATTEMPT */
+    "TOpp",      /* QF_MPOOL_GET_ATTEMPT */
+    nullptr, nullptr,                            /* QF_RESERVED1..0 */
+    nullptr, nullptr, nullptr, nullptr, nullptr, /* QK records */
+    "OFG",       /* QEP_TRAN_HIST */
+    "OFG",       /* QEP_TRAN_EP */
+    "OFG",       /* QEP_TRAN_XP */
+    "OFGcc",     /* QEP_TRAN_CACHE */
+    nullptr,     /* QEP_RESERVED0 */
+    "SOZ",       /* SIG_DICT */
+    "OZ",        /* OBJ_DICT */
+    "FZ",        /* FUN_DICT */
+    "uZ",        /* USR_DICT */
+    "",          /* EMPTY */
+    nullptr, nullptr, nullptr, nullptr,          /* RESERVED3..TEST_FAIL */
+    "TLZ"        /* ASSERT_FAIL */
+};
+
+/* little-endian unsigned integer of @p size bytes */
+inline uint64_t getLE(uint8_t const *p, unsigned size) {
+    uint64_t v = 0U;
+    for (unsigned i = size; i != 0U; --i) {
+        v = (v << 8) | p[i - 1U];
+    }
+    return v;
+}
+
+std::string hex(uint64_t v) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "0x%08" PRIX64, v);
+    return buf;
+}
+
+} // namespace
+
+/*..........................................................................*/
+std::string recName(uint8_t rec) {
+    if (rec < USER) {
+        return l_recNames[rec];
+    }
+    return "USER+" + std::to_string(rec - USER);
+}
+/*..........................................................................*/
+char const *recLayout(uint8_t rec) {
+    return (rec < USER) ? l_recLayouts[rec] : "T";
+}
+
+/*..........................................................................*/
+bool Config::set(char opt, unsigned size) {
+    uint8_t *field;
+    bool ptr = false; /* pointers and time stamps can be 8 bytes */
+    switch (opt) {
+        case 'O': field = &objPtrSize; ptr = true; break;
+        case 'F': field = &funPtrSize; ptr = true; break;
+        case 'T': field = &timeSize;   ptr = true; break;
+        case 'S': field = &sigSize;   break;
+        case 'E': field = &evtSize;   break;
+        case 'Q': field = &eqCtrSize; break;
+        case 'P': field = &mpCtrSize; break;
+        case 'B': field = &mpSizSize; break;
+        case 'C': field = &teCtrSize; break;
+        default:  return false;
+    }
+    if ((size != 1U) && (size != 2U) && (size != 4U)
+        && !(ptr && (size == 8U)))
+    {
+        return false;
+    }
+    *field = static_cast<uint8_t>(size);
+    return true;
+}
+
+/*..........................................................................*/
+void Dictionary::addSig(uint32_t sig, uint64_t obj, std::string_view name) {
+    m_sig[std::make_pair(sig, obj)] = name;
+}
+void Dictionary::addObj(uint64_t obj, std::string_view name) {
+    m_obj[obj] = name;
+}
+void Dictionary::addFun(uint64_t fun, std::string_view name) {
+    m_fun[fun] = name;
+}
+void Dictionary::addUsr(uint8_t rec, std::string_view name) {
+    m_usr[rec] = name;
+}
+/*..........................................................................*/
+std::string Dictionary::sig(uint32_t sig, uint64_t obj) const {
+    auto it = m_sig.find(std::make_pair(sig, obj));
+    if (it == m_sig.end()) {
+        it = m_sig.find(std::make_pair(sig, uint64_t(0))); /* global? */
+    }
+    return (it != m_sig.end()) ? it->second : std::to_string(sig);
+}
+std::string Dictionary::obj(uint64_t obj) const {
+    auto const it = m_obj.find(obj);
+    return (it != m_obj.end()) ? it->second : hex(obj);
+}
+std::string Dictionary::fun(uint64_t fun) const {
+    auto const it = m_fun.find(fun);
+    return (it != m_fun.end()) ? it->second : hex(fun);
+}
+std::string Dictionary::usr(uint8_t rec) const {
+    auto const it = m_usr.find(rec);
+    return (it != m_usr.end()) ? it->second : recName(rec);
+}
+std::string_view Dictionary::findObj(uint64_t obj) const {
+    auto const it = m_obj.find(obj);
+    return (it != m_obj.end()) ? std::string_view(it->second)
+                               : std::string_view();
+}
+void Dictionary::clear() {
+    m_sig.clear();
+    m_obj.clear();
+    m_fun.clear();
+    m_usr.clear();
+}
+
+/*..........................................................................*/
+Decoder::Decoder(Config const &cfg)
+  : m_cfg(cfg),
+    m_timeHi(0U),
+    m_timeLast(0U),
+    m_time(0U)
+{}
+/*..........................................................................*/
+bool Decoder::decode(Frame const &f, Record &r) {
+    r = Record();
+    r.offset = f.offset;
+    r.rec    = f.rec;
+    r.seq    = f.seq;
+    r.time   = m_time;
+
+    uint8_t const *p   = f.data;
+    uint8_t const *end = f.data + f.size;
+    char const *lay = recLayout(f.rec);
+    unsigned nCtr = 0U;
+    unsigned nU8  = 0U;
+    for (; (lay != nullptr) && (*lay != '\0'); ++lay) {
+        unsigned size;
+        switch (*lay) {
+            case 'T': size = m_cfg.timeSize;   break;
+            case 'S': size = m_cfg.sigSize;    break;
+            case 'O': /* fall through */
+            case 'P': size = m_cfg.objPtrSize; break;
+            case 'F': /* fall through */
+            case 'G': size = m_cfg.funPtrSize; break;
+            case 'q': size = m_cfg.eqCtrSize;  break;
+            case 'p': size = m_cfg.mpCtrSize;  break;
+            case 't': size = m_cfg.teCtrSize;  break;
+            case 'e': size = m_cfg.evtSize;    break;
+            case 'c': size = 4U;               break;
+            case 'L': size = 2U;               break;
+            case 'u': size = 1U;               break;
+            default: { /* 'Z' zero-terminated string */
+                uint8_t const *z = static_cast<uint8_t const *>(
+                    std::memchr(p, 0, static_cast<std::size_t>(end - p)));
+                if (z == nullptr) {
+                    ++m_scanner.stats().malformed;
+                    return false;
+                }
+                r.str = std::string_view(reinterpret_cast<char const *>(p),
+                                         static_cast<std::size_t>(z - p));
+                p = z + 1;
+                continue;
+            }
+        }
+        if (static_cast<std::size_t>(end - p) < size) {
+            ++m_scanner.stats().malformed;
+            return false;
+        }
+        uint64_t const v = getLE(p, size);
+        p += size;
+        switch (*lay) {
+            case 'T': {
+                if ((v < m_timeLast) && (size < 8U)) { /* wrap around? */
+                    m_timeHi += uint64_t(1) << (8U * size);
+                }
+                m_timeLast = v;
+                m_time = m_timeHi + v;
+                r.time = m_time;
+                r.hasTime = true;
+                break;
+            }
+            case 'S': r.sig  = static_cast<uint32_t>(v); break;
+            case 'O': r.obj  = v; break;
+            case 'P': r.obj2 = v; break;
+            case 'F': r.fun  = v; break;
+            case 'G': r.fun2 = v; break;
+            case 'L': r.line = static_cast<uint16_t>(v); break;
+            case 'u': {
+                if (nU8++ == 0U) {
+                    r.u8a = static_cast<uint8_t>(v);
+                }
+                else {
+                    r.u8b = static_cast<uint8_t>(v);
+                }
+                break;
+            }
+            default: { /* counters */
+                if (nCtr++ == 0U) {
+                    r.ctr = static_cast<uint32_t>(v);
+                }
+                else {
+                    r.ctr2 = static_cast<uint32_t>(v);
+                }
+                break;
+            }
+        }
+    }
+    r.known = (lay != nullptr);
+    r.data  = p;
+    r.size  = static_cast<uint32_t>(end - p);
+
+    switch (f.rec) {
+        case SIG_DICT: m_dict.addSig(r.sig, r.obj, r.str); break;
+        case OBJ_DICT: m_dict.addObj(r.obj, r.str);        break;
+        case FUN_DICT: m_dict.addFun(r.fun, r.str);        break;
+        case USR_DICT: m_dict.addUsr(r.u8a, r.str);        break;
+        default:                                           break;
+    }
+    return true;
+}
+
+/*..........................................................................*/
+std::string Decoder::userData(Record const &r) const {
+    std::string out;
+    char buf[64];
+    uint8_t const *p   = r.data;
+    uint8_t const *end = r.data + r.size;
+    while (p < end) {
+        uint8_t const fmt = *p++;
+        int const w = static_cast<int>(fmt >> 4);
+        unsigned size;
+        switch (fmt & 0x0FU) {
+            case 0x0U: case 0x1U: size = 1U; break;           /* I8, U8 */
+            case 0x2U: case 0x3U: size = 2U; break;           /* I16, U16 */
+            case 0x4U: case 0x5U: case 0x6U: case 0xFU:
+                size = 4U; break;                    /* I32, U32, F32, HEX */
+            case 0x7U: case 0xDU: case 0xEU:
+                size = 8U; break;                        /* F64, I64, U64 */
+            case 0xAU: size = m_cfg.sigSize + m_cfg.objPtrSize; break;
+            case 0xBU: size = m_cfg.objPtrSize; break;
+            case 0xCU: size = m_cfg.funPtrSize; break;
+            case 0x9U: /* MEM */
+                size = (p < end) ? (1U + *p) : 1U;
+                break;
+            default: { /* 0x8U, STR */
+                uint8_t const *z = static_cast<uint8_t const *>(
+                    std::memchr(p, 0, static_cast<std::size_t>(end - p)));
+                if (z == nullptr) {
+                    return out + " <?>";
+                }
+                size = static_cast<unsigned>(z - p) + 1U;
+                break;
+            }
+        }
+        if (static_cast<std::size_t>(end - p) < size) {
+            return out + " <?>";
+        }
+        if (!out.empty()) {
+            out += ' ';
+        }
+        uint64_t const v = getLE(p, (size <= 8U) ? size : 0U);
+        switch (fmt & 0x0FU) {
+            case 0x0U:
+                std::snprintf(buf, sizeof(buf), "%*d", w,
+                              static_cast<int>(static_cast<int8_t>(v)));
+                break;
+            case 0x2U:
+                std::snprintf(buf, sizeof(buf), "%*d", w,
+                              static_cast<int>(static_cast<int16_t>(v)));
+                break;
+            case 0x4U:
+                std::snprintf(buf, sizeof(buf), "%*d", w,
+                              static_cast<int>(static_cast<int32_t>(v)));
+                break;
+            case 0x1U: case 0x3U: case 0x5U:
+                std::snprintf(buf, sizeof(buf), "%*u", w,
+                              static_cast<unsigned>(v));
+                break;
+            case 0x6U: {
+                float x;
+                uint32_t const u = static_cast<uint32_t>(v);
+                std::memcpy(&x, &u, sizeof(x));
+                std::snprintf(buf, sizeof(buf), "%*g", w, double(x));
+                break;
+            }
+            case 0x7U: {
+                double x;
+                std::memcpy(&x, &v, sizeof(x));
+                std::snprintf(buf, sizeof(buf), "%*g", w, x);
+                break;
+            }
+            case 0xDU:
+                std::snprintf(buf, sizeof(buf), "%*" PRId64, w,
+                              static_cast<int64_t>(v));
+                break;
+            case 0xEU:
+                std::snprintf(buf, sizeof(buf), "%*" PRIu64, w, v);
+                break;
+            case 0xFU:
+                std::snprintf(buf, sizeof(buf), "0x%0*X", w,
+                              static_cast<unsigned>(v));
+                break;
+            default:
+                buf[0] = '\0';
+                break;
+        }
+        switch (fmt & 0x0FU) {
+            case 0x8U:
+                out.append(reinterpret_cast<char const *>(p), size - 1U);
+                break;
+            case 0x9U:
+                for (unsigned i = 1U; i < size; ++i) {
+                    std::snprintf(buf, sizeof(buf), (i > 1U) ? " %02X"
+                                  : "%02X", static_cast<unsigned>(p[i]));
+                    out += buf;
+                }
+                break;
+            case 0xAU:
+                out += m_dict.sig(
+                    static_cast<uint32_t>(getLE(p, m_cfg.sigSize)),
+                    getLE(p + m_cfg.sigSize, m_cfg.objPtrSize));
+                break;
+            case 0xBU: out += m_dict.obj(v); break;
+            case 0xCU: out += m_dict.fun(v); break;
+            default:   out += buf;           break;
+        }
+        p += size;
+    }
+    return out;
+}
+
+/*..........................................................................*/
+MappedFile::~MappedFile() {
+    if (m_mapped) {
+        (void)munmap(const_cast<uint8_t *>(m_data), m_size);
+    }
+}
+/*..........................................................................*/
+bool MappedFile::open(char const *path) {
+    int fd = 0; /* stdin */
+    if (std::strcmp(path, "-") != 0) {
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode)
+            && (st.st_size > 0))
+        {
+            m_size = static_cast<std::size_t>(st.st_size);
+            void *m = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                (void)madvise(m, m_size, MADV_SEQUENTIAL);
+                (void)close(fd);
+                m_data   = static_cast<uint8_t const *>(m);
+                m_mapped = true;
+                return true;
+            }
+        }
+    }
+
+    /* stdin, a pipe or a file that cannot be mapped, read it whole */
+    uint8_t buf[64 * 1024];
+    for (;;) {
+        ssize_t const n = read(fd, buf, sizeof(buf));
+        if (n > 0) {
+            m_copy.insert(m_copy.end(), buf, buf + n);
+        }
+        else if ((n == 0) || (errno != EINTR)) {
+            int const err = errno;
+            if (fd != 0) {
+                (void)close(fd);
+            }
+            m_data = m_copy.data();
+            m_size = m_copy.size();
+            errno = err;
+            return (n == 0);
+        }
+    }
+}
+
+} // namespace qs
+
+/*****************************************************************************
+* NOTE1:
+* The frames are delimited by the flag byte 0x7E. Inside a frame the bytes
+* 0x7E and 0x7D are transmitted as 0x7D followed by the byte XOR 0x20
+* (the record ID and the characters of the strings are never escaped,
+* because they cannot have these values). The checksum is the complement
+* of the sum of all the unescaped bytes from the sequence number up to the
+* last data byte, so the sum of all the bytes of an intact frame including
+* the checksum is 0xFF.
+*
+* A frame with a wrong checksum is discarded and the scanner simply
+* continues with the next flag, so a corrupted or truncated capture (e.g.,
+* a capture started in the middle of a frame) costs at most the frames
+* touching the damage. The discarded frames show up again as a gap in the
+* sequence numbers of the following frame. The sequence number is
+* incremented by the target for every record; a discontinuity means records
+* lost in the target (QS buffer overrun, see QS_getDropped()) or in the
+* transmission. The QS_EMPTY record starts a new session (QS_initBuf(), the
+* sequence numbers restart after a reset of the target), so it is not
+* counted as a discontinuity.
+*/
@@ -0,0 +1,382 @@
+/*****************************************************************************
+* Product: QS host decoder library
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* Decodes the binary QS trace (the qs.bin file written by the host BSP, or
+* a capture of the USART2 output of the target) into typed records.
+*
+* The decoding proceeds in two layers:
+* 1. qs::FrameScanner splits the byte stream into HDLC-like frames
+*    [seq][recId][data...][chksum][0x7E], removes the 0x7D escapes and
+*    verifies the checksums and the sequence numbers. The search for the
+*    0x7E/0x7D bytes is vectorized (SSE2/AVX2) and the frames without any
+*    escapes (the vast majority) are decoded in place, without copying.
+* 2. qs::Decoder parses the payload of every frame according to the record
+*    layouts of QP/C 5.4.0 into a qs::Record, maintains the dictionaries
+*    (QS_SIG_DICTIONARY(), QS_OBJ_DICTIONARY(), QS_FUN_DICTIONARY(),
+*    QS_USR_DICTIONARY()) and extends the time stamps to 64 bits.
+*
+* The QS trace contains no description of the target, so the sizes of the
+* pointers, signals and counters must match the target configuration
+* (qs::Config, defaults for the STM32L053 with the QP/C default sizes).
+*****************************************************************************/
+#ifndef qs_decode_hpp
+#define qs_decode_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace qs {
+
+/*! QS record IDs, the mirror of enum QSpyRecords in qs.h */
+enum RecId : uint8_t {
+    QP_RESET,
+    QEP_STATE_ENTRY, QEP_STATE_EXIT, QEP_STATE_INIT, QEP_INIT_TRAN,
+    QEP_INTERN_TRAN, QEP_TRAN, QEP_IGNORED, QEP_DISPATCH, QEP_UNHANDLED,
+    QF_ACTIVE_ADD, QF_ACTIVE_REMOVE, QF_ACTIVE_SUBSCRIBE,
+    QF_ACTIVE_UNSUBSCRIBE, QF_ACTIVE_POST_FIFO, QF_ACTIVE_POST_LIFO,
+    QF_ACTIVE_GET, QF_ACTIVE_GET_LAST, QF_EQUEUE_INIT,
+    QF_EQUEUE_POST_FIFO, QF_EQUEUE_POST_LIFO, QF_EQUEUE_GET,
+    QF_EQUEUE_GET_LAST, QF_MPOOL_INIT, QF_MPOOL_GET, QF_MPOOL_PUT,
+    QF_PUBLISH, QF_RESERVED8, QF_NEW, QF_GC_ATTEMPT, QF_GC, QF_TICK,
+    QF_TIMEEVT_ARM, QF_TIMEEVT_AUTO_DISARM, QF_TIMEEVT_DISARM_ATTEMPT,
+    QF_TIMEEVT_DISARM, QF_TIMEEVT_REARM, QF_TIMEEVT_POST, QF_TIMEEVT_CTR,
+    QF_CRIT_ENTRY, QF_CRIT_EXIT, QF_ISR_ENTRY, QF_ISR_EXIT,
+    QF_INT_DISABLE, QF_INT_ENABLE, QF_ACTIVE_POST_ATTEMPT,
+    QF_EQUEUE_POST_ATTEMPT, QF_MPOOL_GET_ATTEMPT,
+    QF_RESERVED1, QF_RESERVED0,
+    QK_MUTEX_LOCK, QK_MUTEX_UNLOCK, QK_SCHEDULE, QK_RESERVED1, QK_RESERVED0,
+    QEP_TRAN_HIST, QEP_TRAN_EP, QEP_TRAN_XP, QEP_TRAN_CACHE, QEP_RESERVED0,
+    SIG_DICT, OBJ_DICT, FUN_DICT, USR_DICT, EMPTY,
+    RESERVED3, RESERVED2, TEST_RUN, TEST_FAIL, ASSERT_FAIL,
+    USER
+};
+
+/*! name of the record @p rec, e.g. "QEP_DISPATCH" or "USER+3" */
+std::string recName(uint8_t rec);
+
+/*! sizes [bytes] of the target data types in the QS trace */
+struct Config {
+    uint8_t objPtrSize = 4U; //!< QS_OBJ_PTR_SIZE
+    uint8_t funPtrSize = 4U; //!< QS_FUN_PTR_SIZE
+    uint8_t timeSize   = 4U; //!< QS_TIME_SIZE
+    uint8_t sigSize    = 2U; //!< Q_SIGNAL_SIZE
+    uint8_t evtSize    = 2U; //!< QF_EVENT_SIZ_SIZE
+    uint8_t eqCtrSize  = 1U; //!< QF_EQUEUE_CTR_SIZE
+    uint8_t mpCtrSize  = 2U; //!< QF_MPOOL_CTR_SIZE
+    uint8_t mpSizSize  = 2U; //!< QF_MPOOL_SIZ_SIZE
+    uint8_t teCtrSize  = 2U; //!< QF_TIMEEVT_CTR_SIZE
+
+    /*! set the size selected by the QSPY option letter @p opt
+    * (O, F, T, S, E, Q, P, B, C); false for an unknown letter or size
+    */
+    bool set(char opt, unsigned size);
+};
+
+/*! one frame with the escapes removed and the checksum verified */
+struct Frame {
+    uint64_t offset;     //!< offset of the frame in the capture
+    uint8_t const *data; //!< payload between the record ID and the checksum
+    uint32_t size;       //!< number of bytes in the payload
+    uint8_t  seq;        //!< sequence number
+    uint8_t  rec;        //!< record ID
+};
+
+/*! statistics of the decoding */
+struct Stats {
+    uint64_t bytes;       //!< bytes scanned
+    uint64_t frames;      //!< frames with a valid checksum
+    uint64_t badChecksum; //!< frames discarded for a wrong checksum
+    uint64_t seqGaps;     //!< discontinuities of the sequence numbers
+    uint64_t lostFrames;  //!< frames missing in the discontinuities
+    uint64_t malformed;   //!< frames too short for the record layout
+};
+
+/*! index of the first 0x7E or 0x7D byte in @p p[0..n), or @p n */
+inline std::size_t findSpecial(uint8_t const *p, std::size_t n) {
+    std::size_t i = 0U;
+#if defined(__AVX2__)
+    __m256i const flag = _mm256_set1_epi8(0x7E);
+    __m256i const esc  = _mm256_set1_epi8(0x7D);
+    for (; i + 32U <= n; i += 32U) {
+        __m256i const v = _mm256_loadu_si256(
+                              reinterpret_cast<__m256i const *>(p + i));
+        uint32_t const m = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, flag),
+                            _mm256_cmpeq_epi8(v, esc))));
+        if (m != 0U) {
+            return i + static_cast<std::size_t>(__builtin_ctz(m));
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    __m128i const flag16 = _mm_set1_epi8(0x7E);
+    __m128i const esc16  = _mm_set1_epi8(0x7D);
+    for (; i + 16U <= n; i += 16U) {
+        __m128i const v = _mm_loadu_si128(
+                              reinterpret_cast<__m128i const *>(p + i));
+        uint32_t const m = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, flag16),
+                         _mm_cmpeq_epi8(v, esc16))));
+        if (m != 0U) {
+            return i + static_cast<std::size_t>(__builtin_ctz(m));
+        }
+    }
+#endif
+    for (; i < n; ++i) { /* the tail (or no SIMD) */
+        if ((p[i] == 0x7EU) || (p[i] == 0x7DU)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+/*! the sum of the bytes @p p[0..n) modulo 256 */
+inline uint8_t byteSum(uint8_t const *p, std::size_t n) {
+    uint32_t sum = 0U;
+    std::size_t i = 0U;
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16U <= n; i += 16U) { /* SAD against 0 sums 8 bytes */
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(
+                  _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + i)),
+                  _mm_setzero_si128()));
+    }
+    sum = static_cast<uint32_t>(_mm_cvtsi128_si32(acc))
+          + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#endif
+    for (; i < n; ++i) {
+        sum += p[i];
+    }
+    return static_cast<uint8_t>(sum);
+}
+
+/*! splits the QS byte stream into the frames (see NOTE1 in qs_decode.cpp)
+*
+* The stream can be fed in pieces of any size; a frame split between two
+* calls to scan() is completed in the next call.
+*/
+class FrameScanner {
+public:
+    /*! scan the @p n bytes at @p p and call @p onFrame(Frame const &)
+    * for every frame with a valid checksum
+    */
+    template<typename F>
+    void scan(uint8_t const *p, std::size_t n, F &&onFrame) {
+        std::size_t pos = 0U;
+        if (m_esc && (n != 0U)) { /* escape split between the calls? */
+            m_buf.push_back(static_cast<uint8_t>(p[pos++] ^ 0x20U));
+            m_esc = false;
+        }
+        while (pos < n) {
+            std::size_t const k = findSpecial(p + pos, n - pos);
+            if ((pos + k < n) && (p[pos + k] == 0x7EU) && m_buf.empty()) {
+                if (k != 0U) { /* no escapes, decode the frame in place */
+                    endFrame(p + pos, k, onFrame);
+                }
+                pos += k + 1U;
+                m_start = m_offset + pos;
+                continue;
+            }
+            m_buf.insert(m_buf.end(), p + pos, p + pos + k);
+            pos += k;
+            if (pos == n) {
+                break;
+            }
+            if (p[pos] == 0x7DU) { /* escape? */
+                if (++pos == n) {
+                    m_esc = true;
+                    break;
+                }
+                m_buf.push_back(static_cast<uint8_t>(p[pos++] ^ 0x20U));
+            }
+            else { /* flag 0x7E ending an escaped or a split frame */
+                ++pos;
+                endFrame(m_buf.data(), m_buf.size(), onFrame);
+                m_buf.clear();
+                m_start = m_offset + pos;
+            }
+        }
+        m_offset += n;
+        m_stats.bytes += n;
+    }
+
+    Stats const &stats() const { return m_stats; }
+    Stats &stats() { return m_stats; }
+
+private:
+    template<typename F>
+    void endFrame(uint8_t const *buf, std::size_t n, F &&onFrame) {
+        if ((n < 3U) || (byteSum(buf, n) != 0xFFU)) {
+            ++m_stats.badChecksum; /* counted also in the next seq gap */
+        }
+        else {
+            uint8_t const seq = buf[0];
+            uint8_t const rec = buf[1];
+            if (m_seqValid && (rec != EMPTY)
+                && (seq != static_cast<uint8_t>(m_seq + 1U)))
+            {
+                ++m_stats.seqGaps;
+                m_stats.lostFrames +=
+                    static_cast<uint8_t>(seq - m_seq - 1U);
+            }
+            m_seq = seq;
+            m_seqValid = true;
+            ++m_stats.frames;
+            Frame const f = { m_start, buf + 2,
+                              static_cast<uint32_t>(n - 3U), seq, rec };
+            onFrame(f);
+        }
+    }
+
+    std::vector<uint8_t> m_buf;  //!< frame with the escapes removed
+    uint64_t m_offset = 0U;      //!< offset of the next scanned byte
+    uint64_t m_start = 0U;       //!< offset of the current frame
+    Stats    m_stats = {};
+    uint8_t  m_seq = 0U;         //!< sequence number of the last frame
+    bool     m_seqValid = false; //!< is m_seq valid?
+    bool     m_esc = false;      //!< escape byte pending?
+};
+
+/*! names from the QS dictionary records */
+class Dictionary {
+public:
+    void addSig(uint32_t sig, uint64_t obj, std::string_view name);
+    void addObj(uint64_t obj, std::string_view name);
+    void addFun(uint64_t fun, std::string_view name);
+    void addUsr(uint8_t rec, std::string_view name);
+
+    /*! name of the signal @p sig of the state machine @p obj, the name of
+    * the global signal @p sig, or the number of the signal
+    */
+    std::string sig(uint32_t sig, uint64_t obj) const;
+    /*! name of the object @p obj, or its address in hex */
+    std::string obj(uint64_t obj) const;
+    /*! name of the function @p fun, or its address in hex */
+    std::string fun(uint64_t fun) const;
+    /*! name of the user record @p rec, or recName(rec) */
+    std::string usr(uint8_t rec) const;
+
+    /*! name of the object @p obj or an empty view (no formatting) */
+    std::string_view findObj(uint64_t obj) const;
+
+    void clear();
+
+private:
+    std::map<std::pair<uint32_t, uint64_t>, std::string> m_sig;
+    std::unordered_map<uint64_t, std::string> m_obj;
+    std::unordered_map<uint64_t, std::string> m_fun;
+    std::unordered_map<uint8_t, std::string> m_usr;
+};
+
+/*! one decoded QS record
+*
+* The fields are shared by the records according to their role, e.g.
+* obj is the state machine in the QEP records, the receiving active object
+* or queue in the POST/GET records, the memory pool in the MPOOL records
+* and the time event in the TIMEEVT records. The fields not present in the
+* record are zero; recLayout() lists the fields of every record.
+*/
+struct Record {
+    uint64_t offset;  //!< offset of the frame in the capture
+    uint64_t time;    //!< time stamp extended to 64 bits, see hasTime
+    uint64_t obj;     //!< SM, AO, queue, pool, time event
+    uint64_t obj2;    //!< sender (POST_FIFO, PUBLISH), AO of a time event
+    uint64_t fun;     //!< state (source state of a transition)
+    uint64_t fun2;    //!< target state of a transition
+    uint32_t sig;     //!< signal
+    uint32_t ctr;     //!< nFree, queue length, nTicks, event size, tick ctr
+    uint32_t ctr2;    //!< nMin, margin, interval
+    uint8_t  u8a;     //!< poolId, priority, tick rate, nesting, user rec
+    uint8_t  u8b;     //!< refCtr, ISR priority, isArmed
+    uint16_t line;    //!< location of ASSERT_FAIL
+    uint8_t  rec;     //!< record ID
+    uint8_t  seq;     //!< sequence number
+    bool     hasTime; //!< does the record carry a time stamp?
+    bool     known;   //!< has the payload been parsed into the fields?
+    std::string_view str; //!< dictionary name, module of ASSERT_FAIL
+    uint8_t const *data;  //!< payload (after the time stamp of USER records)
+    uint32_t size;        //!< number of bytes at data
+};
+
+/*! layout of the record @p rec, one character per field:
+* T time, S sig, O obj, P obj2, F fun, G fun2, u u8 (u8a, then u8b),
+* q/p/t/e queue/pool/time event counter or event size, c 32-bit counter
+* (ctr, then ctr2),
+* L line, Z string; nullptr for the records without a known layout
+*/
+char const *recLayout(uint8_t rec);
+
+/*! decodes the frames into the typed records */
+class Decoder {
+public:
+    explicit Decoder(Config const &cfg = Config());
+
+    /*! feed @p n bytes of the trace and call @p onRecord(Record const &)
+    * for every decoded record
+    */
+    template<typename F>
+    void feed(uint8_t const *p, std::size_t n, F &&onRecord) {
+        m_scanner.scan(p, n, [this, &onRecord](Frame const &f) {
+            Record r;
+            if (decode(f, r)) {
+                onRecord(static_cast<Record const &>(r));
+            }
+        });
+    }
+
+    /*! decode a single frame; false if the frame is malformed */
+    bool decode(Frame const &f, Record &r);
+
+    /*! format the data of a USER record (QS_U8(), QS_STR(), ...) */
+    std::string userData(Record const &r) const;
+
+    Config const &config() const { return m_cfg; }
+    Dictionary const &dict() const { return m_dict; }
+    Stats const &stats() const { return m_scanner.stats(); }
+
+private:
+    Config       m_cfg;
+    Dictionary   m_dict;
+    FrameScanner m_scanner;
+    uint64_t     m_timeHi;   //!< high part of the extended time stamp
+    uint64_t     m_timeLast; //!< last raw time stamp
+    uint64_t     m_time;     //!< last extended time stamp
+};
+
+/*! read-only memory mapping of a capture file ("-" reads stdin) */
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+    ~MappedFile();
+
+    /*! map the file @p path; false and errno set on failure */
+    bool open(char const *path);
+
+    uint8_t const *data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    uint8_t const *m_data = nullptr;
+    std::size_t    m_size = 0U;
+    bool           m_mapped = false;
+    std::vector<uint8_t> m_copy; //!< stdin or a file that cannot be mapped
+};
+
+} // namespace qs
+
+#endif /* qs_decode_hpp */
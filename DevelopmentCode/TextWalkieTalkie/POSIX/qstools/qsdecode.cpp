@@ -0,0 +1,249 @@
+/*****************************************************************************
+* Product: qsdecode, command-line decoder of the binary QS trace
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* usage: qsdecode [-O<n>] [-F<n>] [-T<n>] [-S<n>] [-E<n>] [-Q<n>] [-P<n>]
+*                 [-B<n>] [-C<n>] [-q] <file|->
+*
+* -O, -F, -T  size of object pointers, function pointers, time stamps
+* -S, -E      size of signals, event sizes
+* -Q, -P, -B  size of queue counters, pool counters, pool block sizes
+* -C          size of time event counters
+* -q          quiet, print only the statistics (e.g., to check a capture)
+*
+* The size options have the meaning of the QSPY options of the same names.
+* The defaults match the STM32L053 target; the host build writes 8-byte
+* pointers (qsdecode -O8 -F8 qs.bin). The records are printed one per
+* line as "time record fields", the statistics go to stderr.
+*****************************************************************************/
+#include "qs_decode.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>      /* for clock_gettime() */
+#include <unistd.h>   /* for getopt() */
+
+namespace {
+
+/*..........................................................................*/
+std::string hex(uint64_t v) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "0x%08llX",
+                  static_cast<unsigned long long>(v));
+    return buf;
+}
+/*..........................................................................*/
+char const *ctrLabel(uint8_t rec, unsigned n) {
+    switch (rec) {
+        case qs::QF_ACTIVE_POST_FIFO:
+        case qs::QF_ACTIVE_POST_LIFO:
+        case qs::QF_EQUEUE_POST_FIFO:
+        case qs::QF_EQUEUE_POST_LIFO:
+        case qs::QF_MPOOL_GET:
+            return (n == 0U) ? "nFree" : "nMin";
+        case qs::QF_ACTIVE_POST_ATTEMPT:
+        case qs::QF_EQUEUE_POST_ATTEMPT:
+        case qs::QF_MPOOL_GET_ATTEMPT:
+            return (n == 0U) ? "nFree" : "margin";
+        case qs::QF_ACTIVE_GET:
+        case qs::QF_EQUEUE_GET:
+        case qs::QF_MPOOL_PUT:
+            return "nFree";
+        case qs::QF_EQUEUE_INIT:  return "len";
+        case qs::QF_MPOOL_INIT:   return "nTot";
+        case qs::QF_NEW:          return "size";
+        case qs::QF_TIMEEVT_ARM:  return (n == 0U) ? "nTicks" : "interval";
+        case qs::QEP_TRAN_CACHE:  return (n == 0U) ? "hits" : "misses";
+        default:                  return (n == 0U) ? "ctr" : "interval";
+    }
+}
+/*..........................................................................*/
+char const *u8Label(uint8_t rec, unsigned n) {
+    switch (rec) {
+        case qs::QF_ACTIVE_ADD:
+        case qs::QF_ACTIVE_REMOVE:
+            return "prio";
+        case qs::QF_CRIT_ENTRY:
+        case qs::QF_CRIT_EXIT:
+            return "nest";
+        case qs::QF_ISR_ENTRY:
+        case qs::QF_ISR_EXIT:
+            return (n == 0U) ? "nest" : "prio";
+        case qs::QF_TICK:
+        case qs::QF_TIMEEVT_ARM:
+        case qs::QF_TIMEEVT_AUTO_DISARM:
+        case qs::QF_TIMEEVT_DISARM_ATTEMPT:
+        case qs::QF_TIMEEVT_DISARM:
+        case qs::QF_TIMEEVT_REARM:
+        case qs::QF_TIMEEVT_POST:
+        case qs::QF_TIMEEVT_CTR:
+            return (n == 0U) ? "rate" : "armed";
+        case qs::USR_DICT:
+            return "rec";
+        default:
+            return (n == 0U) ? "pool" : "ref";
+    }
+}
+/*..........................................................................*/
+void format(qs::Decoder const &dec, qs::Record const &r, std::string &s) {
+    qs::Dictionary const &d = dec.dict();
+    bool const dict = (r.rec >= qs::SIG_DICT) && (r.rec <= qs::FUN_DICT);
+    char buf[32];
+
+    s.clear();
+    if (r.hasTime) {
+        std::snprintf(buf, sizeof(buf), "%010llu ",
+                      static_cast<unsigned long long>(r.time));
+        s += buf;
+    }
+    else {
+        s.append(11U, ' ');
+    }
+    if (r.rec >= qs::USER) {
+        s += d.usr(r.rec);
+        s += ' ';
+        s += dec.userData(r);
+        return;
+    }
+    s += qs::recName(r.rec);
+
+    char const *lay = qs::recLayout(r.rec);
+    unsigned nCtr = 0U;
+    unsigned nU8  = 0U;
+    for (; (lay != nullptr) && (*lay != '\0'); ++lay) {
+        switch (*lay) {
+            case 'T':
+                continue;
+            case 'S':
+                s += " Sig=";
+                s += dict ? std::to_string(r.sig)
+                     : d.sig(r.sig, (r.rec == qs::QF_TIMEEVT_POST)
+                                    ? r.obj2 : r.obj);
+                break;
+            case 'O':
+                s += " Obj=";
+                s += dict ? hex(r.obj) : d.obj(r.obj);
+                break;
+            case 'P':
+                s += ((r.rec >= qs::QF_TIMEEVT_ARM)
+                      && (r.rec <= qs::QF_TIMEEVT_CTR)) ? " Act=" : " Src=";
+                s += d.obj(r.obj2);
+                break;
+            case 'F':
+                s += dict ? (" Fun=" + hex(r.fun))
+                          : (" State=" + d.fun(r.fun));
+                break;
+            case 'G':
+                s += " Target=";
+                s += d.fun(r.fun2);
+                break;
+            case 'u':
+                s += ' ';
+                s += u8Label(r.rec, nU8);
+                s += '=';
+                s += std::to_string((nU8++ == 0U) ? r.u8a : r.u8b);
+                break;
+            case 'L':
+                s += " Line=";
+                s += std::to_string(r.line);
+                break;
+            case 'Z':
+                s += (r.rec == qs::ASSERT_FAIL) ? " Module=" : " Name=";
+                s += r.str;
+                break;
+            default: /* counters */
+                s += ' ';
+                s += ctrLabel(r.rec, nCtr);
+                s += '=';
+                s += std::to_string((nCtr++ == 0U) ? r.ctr : r.ctr2);
+                break;
+        }
+    }
+    if (!r.known) { /* no layout, dump the payload */
+        s += " Data=";
+        for (uint32_t i = 0U; i < r.size; ++i) {
+            std::snprintf(buf, sizeof(buf), (i != 0U) ? " %02X" : "%02X",
+                          static_cast<unsigned>(r.data[i]));
+            s += buf;
+        }
+    }
+}
+/*..........................................................................*/
+void usage(char const *prog) {
+    std::fprintf(stderr,
+        "usage: %s [-O<n>] [-F<n>] [-T<n>] [-S<n>] [-E<n>] [-Q<n>] [-P<n>]"
+        " [-B<n>] [-C<n>] [-q] <file|->\n", prog);
+}
+
+} // namespace
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    qs::Config cfg;
+    bool quiet = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "O:F:T:S:E:Q:P:B:C:qh")) != -1) {
+        if (opt == 'q') {
+            quiet = true;
+        }
+        else if ((opt == 'h') || (opt == '?')
+                 || !cfg.set(static_cast<char>(opt),
+                             static_cast<unsigned>(std::atoi(optarg))))
+        {
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    qs::MappedFile file;
+    if (!file.open(argv[optind])) {
+        std::fprintf(stderr, "%s: %s\n", argv[optind], std::strerror(errno));
+        return 1;
+    }
+
+    static char outBuf[1U << 16];
+    std::setvbuf(stdout, outBuf, _IOFBF, sizeof(outBuf));
+
+    timespec t0;
+    timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    qs::Decoder dec(cfg);
+    uint64_t nRecs = 0U;
+    std::string line;
+    dec.feed(file.data(), file.size(), [&](qs::Record const &r) {
+        ++nRecs;
+        if (!quiet) {
+            format(dec, r, line);
+            line += '\n';
+            std::fwrite(line.data(), 1U, line.size(), stdout);
+        }
+    });
+    std::fflush(stdout);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double const sec = double(t1.tv_sec - t0.tv_sec)
+                       + 1e-9 * double(t1.tv_nsec - t0.tv_nsec);
+    qs::Stats const &st = dec.stats();
+    std::fprintf(stderr,
+        "%llu bytes, %llu records, %llu bad checksums, %llu malformed,"
+        " %llu sequence gaps (%llu records lost)\n"
+        "%.3f s, %.1f MB/s\n",
+        static_cast<unsigned long long>(st.bytes),
+        static_cast<unsigned long long>(nRecs),
+        static_cast<unsigned long long>(st.badChecksum),
+        static_cast<unsigned long long>(st.malformed),
+        static_cast<unsigned long long>(st.seqGaps),
+        static_cast<unsigned long long>(st.lostFrames),
+        sec, (sec > 0.0) ? (double(st.bytes) / sec * 1e-6) : 0.0);
+
+    return ((st.badChecksum | st.malformed | st.seqGaps) != 0U) ? 1 : 0;
+}
@@ -34,6 +34,10 @@
 #include "qpc.h"
 #include "blinky.h"
 #include "bsp.h"
+#include "bsp_pins.h"
+#include "keypad.h"
+#include "display.h"
+#include "stimlog.h"
 
 #include "stm32l0xx.h"  /* CMSIS-compliant header file for the MCU used */
 /* add other drivers if necessary... */
@@ -47,7 +51,9 @@ Q_DEFINE_THIS_FILE
 enum KernelAwareISRs {
     GPIOPORTA_PRIO = QF_AWARE_ISR_CMSIS_PRI, /* see NOTE00 */
     GPIOPORTC_PRIO = QF_AWARE_ISR_CMSIS_PRI, /* see NOTE00 */
+    TIM6_PRIO      = QF_AWARE_ISR_CMSIS_PRI, /* LED refresh, see NOTE07 */
     SYSTICK_PRIO,
+    DMA1_CH4_PRIO,
     /* ... */
     MAX_KERNEL_AWARE_CMSIS_PRI /* keep always last */
 };
@@ -55,6 +61,10 @@ enum KernelAwareISRs {
 Q_ASSERT_COMPILE(MAX_KERNEL_AWARE_CMSIS_PRI <= (0xFF >>(8-__NVIC_PRIO_BITS)));
 
 void SysTick_Handler(void);
+void LPTIM1_IRQHandler(void);
+void EXTI4_15_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
+void DMA1_Channel4_5_6_7_IRQHandler(void);
 
 /* Local-scope defines -----------------------------------------------------*/
 /* LED pins available on the board (just one user LED LD2--Green on PA.5) */
@@ -81,6 +91,48 @@ void SysTick_Handler(void);
 
 static uint32_t l_rnd;  /* random seed */
 
+/* configure all the pins of the port from the pin table, see NOTE08 */
+#define GPIO_CONFIG(gpio_, port_) do { \
+    (gpio_)->BSRR    = BSP_PORT_OFF(port_); \
+    (gpio_)->OTYPER  = ((gpio_)->OTYPER  & ~BSP_PORT_MASK1(port_)) \
+                       | BSP_PORT_OTYPER(port_); \
+    (gpio_)->OSPEEDR = ((gpio_)->OSPEEDR & ~BSP_PORT_MASK2(port_)) \
+                       | BSP_PORT_OSPEEDR(port_); \
+    (gpio_)->PUPDR   = ((gpio_)->PUPDR   & ~BSP_PORT_MASK2(port_)) \
+                       | BSP_PORT_PUPDR(port_); \
+    (gpio_)->MODER   = ((gpio_)->MODER   & ~BSP_PORT_MASK2(port_)) \
+                       | BSP_PORT_MODER(port_); \
+} while (0)
+
+/* the keypad rows (PB0..PB3, outputs) and columns (PB4..PB7, inputs) */
+#define KEYPAD_ROW_PINS  BSP_KEY_ROW_PINS
+#define KEYPAD_COL_PINS  BSP_KEY_COL_PINS
+#define KEYPAD_COL_SHIFT 4U
+Q_ASSERT_COMPILE(BSP_PIN_KEY_COL0 == (1U << KEYPAD_COL_SHIFT));
+#define KEYPAD_SETTLE    4U  /* row settling time [NOPs], see NOTE05 */
+
+static uint8_t volatile l_keypadScan; /* scanning burst in progress? */
+static uint16_t l_bcmArr[DISPLAY_PLANES]; /* TIM6 periods, see NOTE07 */
+static uint16_t keypad_scan(void);
+static void keypad_idle(void);
+
+#ifdef STIMLOG
+    /* the stimuli recorded by the ISRs, see NOTE09 */
+    static uint8_t l_stimLogSto[1024];
+#endif
+
+/* tickless idle in the Release configuration, see NOTE03 */
+#if defined NDEBUG && !defined Q_SPY
+    #define BSP_TICKLESS
+
+    #define LPTIM_HZ        (32768U / 32U) /* LSE divided by the prescaler */
+    #define LPTIM_MAX_SLEEP 0xF000U  /* longest Stop mode [LPTIM counts] */
+    #define TICKLESS_MIN    2U       /* shortest Stop mode [clock ticks] */
+
+    static void tickless_init(void);
+    static void tickless_idle(void);
+#endif
+
 #ifdef Q_SPY
     QSTimeCtr QS_tickTime_;
     QSTimeCtr QS_tickPeriod_;
@@ -88,6 +140,11 @@ static uint32_t l_rnd;  /* random seed */
     /* event-source identifiers used for tracing */
     static uint8_t const l_SysTick_Handler = 0U;
 
+    /* the QS output through the USART2 TX DMA, see NOTE04 */
+    #define QS_DMA_BLOCK  256U  /* largest DMA transfer [bytes] */
+    static uint8_t volatile l_qsDmaBusy; /* DMA transfer in progress? */
+    static void qs_dmaStart(void);
+
     enum AppRecords { /* application-specific trace records */
         PHILO_STAT = QS_USER
     };
@@ -96,34 +153,59 @@ static uint32_t l_rnd;  /* random seed */
 
 /* ISRs used in the application ==========================================*/
 void SysTick_Handler(void) {   /* system clock tick ISR */
-    /* state of the button debouncing, see below */
-    static struct ButtonsDebouncing {
-        uint32_t depressed;
-        uint32_t previous;
-    } buttons = { ~0U, ~0U };
-    uint32_t current;
-    uint32_t tmp;
-
 #ifdef Q_SPY
     {
-        tmp = SysTick->CTRL; /* clear CTRL_COUNTFLAG */
+        uint32_t tmp = SysTick->CTRL; /* clear CTRL_COUNTFLAG */
         QS_tickTime_ += QS_tickPeriod_; /* account for the clock rollover */
+        (void)tmp;
     }
 #endif
 
     QF_TICK_X(0U, &l_SysTick_Handler); /* process time events for rate 0 */
 
-    /* get state of the user button */
-    /* Perform the debouncing of buttons. The algorithm for debouncing
-    * adapted from the book "Embedded Systems Dictionary" by Jack Ganssle
-    * and Michael Barr, page 71.
-    */
-    current = ~GPIOC->IDR; /* read Port C with the state of Button B1 */
-    tmp = buttons.depressed; /* save the debounced depressed buttons */
-    buttons.depressed |= (buttons.previous & current); /* set depressed */
-    buttons.depressed &= (buttons.previous | current); /* clear released */
-    buttons.previous   = current; /* update the history */
-    tmp ^= buttons.depressed;     /* changed debounced depressed */
+    if (l_keypadScan != 0U) { /* scanning burst in progress? see NOTE06 */
+        uint16_t const keys = keypad_scan();
+        STIMLOG_SCAN(keys); /* see NOTE09 */
+        if (!Keypad_tick(keys)) { /* all keys released? */
+            keypad_idle();
+        }
+    }
+    else {
+        STIMLOG_TICKS(1U);
+    }
+}
+/*..........................................................................*/
+void TIM6_DAC_IRQHandler(void) { /* LED matrix refresh, see NOTE07 */
+    uint_fast8_t plane;
+    TIM6->SR = 0U; /* clear the update interrupt flag */
+    GPIOC->BSRR = Display_scan(&plane); /* the next column in a single store */
+    TIM6->ARR = l_bcmArr[plane]; /* the period of its bit-plane */
+}
+/*..........................................................................*/
+void EXTI4_15_IRQHandler(void) { /* a key pressed in the keypad idle mode */
+    uint16_t keys;
+    EXTI->IMR &= ~KEYPAD_COL_PINS; /* disarm the columns */
+    EXTI->PR   = KEYPAD_COL_PINS;  /* clear the pending flags */
+    l_keypadScan = 1U;             /* start the scanning burst */
+    keys = keypad_scan();          /* the first sample right away */
+    STIMLOG_WAKE(keys);
+    (void)Keypad_tick(keys);
+}
+#ifdef Q_SPY
+/*..........................................................................*/
+void DMA1_Channel4_5_6_7_IRQHandler(void) { /* QS DMA transfer complete */
+    DMA1->IFCR = DMA_IFCR_CGIF4; /* clear all flags of the channel 4 */
+    DMA1_Channel4->CCR &= ~DMA_CCR_EN;
+
+    QF_INT_DISABLE();
+    QS_txDone();   /* release the transmitted block */
+    qs_dmaStart(); /* chain the next block, if any */
+    QF_INT_ENABLE();
+}
+#endif /* Q_SPY */
+/*..........................................................................*/
+void LPTIM1_IRQHandler(void) { /* wake-up from the tickless idle */
+    LPTIM1->ICR = LPTIM_ICR_CMPMCF; /* clear the compare match flag */
 }
 
 /* BSP functions ===========================================================*/
@@ -135,170 +217,26 @@ void BSP_init(void) {
 
 	
 	
-    /* enable GPIOC clock port */
-    RCC->IOPENR |= (1U << 2);
-
-    /* configure LED (PC.0) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*0));
-    GPIOC->MODER   |=  ((1U << 2*0));
-    GPIOC->OTYPER  &= ~((1U <<   0));
-    GPIOC->OSPEEDR &= ~((3U << 2*0));
-    GPIOC->OSPEEDR |=  ((1U << 2*0));
-    GPIOC->PUPDR   &= ~((3U << 2*0));
-
-    /* configure LED (PC.1) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*1)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*1)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   1)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*1)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*1)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*1)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.2) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*2)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*2)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   2)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*2)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*2)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*2)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.3) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*3)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*3)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   3)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*3)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*3)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*3)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.4) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*4)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*4)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   4)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*4)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*4)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*4)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.5) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*5)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*5)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   5)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*5)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*5)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*5)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.6) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*6)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*6)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   6)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*6)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*6)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*6)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.7) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*7)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*7)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   7)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*7)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*7)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*7)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.8) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*8)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*8)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   8)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*8)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*8)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*8)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.9) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*9)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*9)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   9)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*9)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*9)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*9)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.10) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*10)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*10)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   10)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*10)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*10)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*10)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.11) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*11)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*11)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   11)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*11)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*11)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*11)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* configure LED (PC.12) pin as push-pull output, no pull-up, pull-down */
-    GPIOC->MODER   &= ~((3U << 2*12)); // 00s out the bits that were there.  keeps all others
-    GPIOC->MODER   |=  ((1U << 2*12)); // 01: General purpose output mode
-    GPIOC->OTYPER  &= ~((1U <<   12)); // set type = 0: Output push-pull (reset state)
-    GPIOC->OSPEEDR &= ~((3U << 2*12)); // 0 out the bits that were there.  (00: Very low speed)
-    GPIOC->OSPEEDR |=  ((1U << 2*12)); // 01: Low speeed
-    GPIOC->PUPDR   &= ~((3U << 2*12)); // 0 out the bits.  00: No pull-up, pull-down
-
-    /* enable GPIOB clock port */
-    RCC->IOPENR |= (1U << 1);
-
-    /* configure Button Row 0 output (PB.0) pin as push-pull output, no pull-up, pull-down */
-    GPIOB->MODER   &= ~((3U << 2*0)); // clear. 00 out the bits that were there.  (00s out the bits that were there.  keeps all others (not reset state)
-    GPIOB->MODER   |=  ((1U << 2*0)); // 01: General purpose output mode
-    GPIOB->OTYPER  &= ~((1U <<   0)); // clear. 0  out the bits that were there.  (0: Output push-pull, reset state)
-    GPIOB->OTYPER  |=  ((0U <<   0)); // set type = 0: Output push-pull, reset state
-    GPIOB->OSPEEDR &= ~((3U << 2*0)); // clear. 00 out the bits that were there.  (00: Very low speed) unknown reset state
-    GPIOB->OSPEEDR |=  ((1U << 2*0)); // 01: Low speeed
-    GPIOB->PUPDR   &= ~((3U << 2*0)); // clear. 00 out the bits that were there.  (00: No pull-up, pull-down) unknown reset state
-    GPIOB->PUPDR   |=  ((0U << 2*0)); // set 00: No pull-up, pull-down
-
-    /* configure Button Row 0 output (PB.1) pin as push-pull output, no pull-up, pull-down */
-    GPIOB->MODER   &= ~((3U << 2*1)); // clear. 00 out the bits that were there.  (00s out the bits that were there.  keeps all others (not reset state)
-    GPIOB->MODER   |=  ((1U << 2*1)); // 01: General purpose output mode
-    GPIOB->OTYPER  &= ~((1U <<   1)); // clear. 0  out the bits that were there.  (0: Output push-pull, reset state)
-    GPIOB->OTYPER  |=  ((0U <<   1)); // set type = 0: Output push-pull, reset state
-    GPIOB->OSPEEDR &= ~((3U << 2*1)); // clear. 00 out the bits that were there.  (00: Very low speed) unknown reset state
-    GPIOB->OSPEEDR |=  ((1U << 2*1)); // 01: Low speeed
-    GPIOB->PUPDR   &= ~((3U << 2*1)); // clear. 00 out the bits that were there.  (00: No pull-up, pull-down) unknown reset state
-    GPIOB->PUPDR   |=  ((0U << 2*1)); // set 00: No pull-up, pull-down
-
-    /* configure Button Row 0 output (PB.2) pin as push-pull output, no pull-up, pull-down */
-    GPIOB->MODER   &= ~((3U << 2*2)); // clear. 00 out the bits that were there.  (00s out the bits that were there.  keeps all others (not reset state)
-    GPIOB->MODER   |=  ((1U << 2*2)); // 01: General purpose output mode
-    GPIOB->OTYPER  &= ~((1U <<   2)); // clear. 0  out the bits that were there.  (0: Output push-pull, reset state)
-    GPIOB->OTYPER  |=  ((0U <<   2)); // set type = 0: Output push-pull, reset state
-    GPIOB->OSPEEDR &= ~((3U << 2*2)); // clear. 00 out the bits that were there.  (00: Very low speed) unknown reset state
-    GPIOB->OSPEEDR |=  ((1U << 2*2)); // 01: Low speeed
-    GPIOB->PUPDR   &= ~((3U << 2*2)); // clear. 00 out the bits that were there.  (00: No pull-up, pull-down) unknown reset state
-    GPIOB->PUPDR   |=  ((0U << 2*2)); // set 00: No pull-up, pull-down
-
-    /* configure Button Row 0 output (PB.3) pin as push-pull output, no pull-up, pull-down */
-    GPIOB->MODER   &= ~((3U << 2*3)); // clear. 00 out the bits that were there.  (00s out the bits that were there.  keeps all others (not reset state)
-    GPIOB->MODER   |=  ((1U << 2*3)); // 01: General purpose output mode
-    GPIOB->OTYPER  &= ~((1U <<   3)); // clear. 0  out the bits that were there.  (0: Output push-pull, reset state)
-    GPIOB->OTYPER  |=  ((0U <<   3)); // set type = 0: Output push-pull, reset state
-    GPIOB->OSPEEDR &= ~((3U << 2*3)); // clear. 00 out the bits that were there.  (00: Very low speed) unknown reset state
-    GPIOB->OSPEEDR |=  ((1U << 2*3)); // 01: Low speeed
-    GPIOB->PUPDR   &= ~((3U << 2*3)); // clear. 00 out the bits that were there.  (00: No pull-up, pull-down) unknown reset state
-    GPIOB->PUPDR   |=  ((0U << 2*3)); // set 00: No pull-up, pull-down
-
-
-    /* Configure Button column S1-S13 as input, (PB.4), no pull-up, pull-down */
-    GPIOB->MODER   &= ~(3UL << 2*4);  //clear+- the mode  00: Input mode
-    GPIOB->OSPEEDR &= ~(3UL << 2*4);  // clear the speed
-    GPIOB->OSPEEDR |=  (1UL << 2*4);  // speed = 01
-    GPIOB->PUPDR   &= ~(3UL << 2*4);  // clear the pupd.  00: No pull-up, pull-down
-    GPIOB->PUPDR   |=  (0UL << 2*4);  // set 00: No pull-up, pull-down
-
-/* Configure Button column S2-S14 as input, (PB.5), no pull-up, pull-down */
-    GPIOB->MODER   &= ~(3UL << 2*5);  //clear+- the mode  00: Input mode
-    GPIOB->OSPEEDR &= ~(3UL << 2*5);  // clear the speed
-    GPIOB->OSPEEDR |=  (1UL << 2*5);  // speed = 01
-    GPIOB->PUPDR   &= ~(3UL << 2*5);  // clear the pupd.  00: No pull-up, pull-down
-    GPIOB->PUPDR   |=  (0UL << 2*5);  // set 00: No pull-up, pull-down
+    /* enable the GPIOB and GPIOC clock ports */
+    RCC->IOPENR |= (1U << 1) | (1U << 2);
+
+    /* configure all the pins of the pin table (bsp_pins.h), see NOTE08 */
+    GPIO_CONFIG(GPIOB, BSP_PORT_B);
+    GPIO_CONFIG(GPIOC, BSP_PORT_C);
+
+    /* the keypad wake-up: the EXTI lines 4..7 from the columns PB.4..PB.7
+    * on the rising edge, armed only in the keypad idle mode, see NOTE06
+    */
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+    SYSCFG->EXTICR[1] = (SYSCFG->EXTICR[1] & ~0xFFFFU)
+                        | SYSCFG_EXTICR2_EXTI4_PB | SYSCFG_EXTICR2_EXTI5_PB
+                        | SYSCFG_EXTICR2_EXTI6_PB | SYSCFG_EXTICR2_EXTI7_PB;
+    EXTI->RTSR |= KEYPAD_COL_PINS;
+    keypad_idle();
+
+#ifdef STIMLOG
+    StimLog_init(l_stimLogSto, (uint16_t)sizeof(l_stimLogSto));
+#endif
 
 
 
@@ -314,94 +252,26 @@ void BSP_init(void) {
     QS_OBJ_DICTIONARY(&l_SysTick_Handler);
 }
 /*..........................................................................*/
-void BSP_ledAOff() {GPIOC->BSRR |= (PORT_PIN_8      );}  /* turn LED off */
-void BSP_ledAOn () {GPIOC->BSRR |= (PORT_PIN_8 << 16);}  /* turn LED on  */
-void BSP_ledBOff() {GPIOC->BSRR |= (PORT_PIN_9      );}  /* turn LED off */
-void BSP_ledBOn () {GPIOC->BSRR |= (PORT_PIN_9 << 16);}  /* turn LED on  */
-void BSP_ledCOff() {GPIOC->BSRR |= (PORT_PIN_10      );}  /* turn LED off */
-void BSP_ledCOn () {GPIOC->BSRR |= (PORT_PIN_10 << 16);}  /* turn LED on  */
-void BSP_ledDOff() {GPIOC->BSRR |= (PORT_PIN_11      );}  /* turn LED off */
-void BSP_ledDOn () {GPIOC->BSRR |= (PORT_PIN_11 << 16);}  /* turn LED on  */
-void BSP_ledEOff() {GPIOC->BSRR |= (PORT_PIN_12      );}  /* turn LED off */
-void BSP_ledEOn () {GPIOC->BSRR |= (PORT_PIN_12 << 16);}  /* turn LED on  */
-
-void BSP_led0Off() {GPIOC->BSRR |= (PORT_PIN_0 << 16);}  /* turn LED off */
-void BSP_led0On () {GPIOC->BSRR |=  PORT_PIN_0       ;}  /* turn LED on  */
-void BSP_led1Off() {GPIOC->BSRR |= (PORT_PIN_1 << 16);}  /* turn LED off */
-void BSP_led1On () {GPIOC->BSRR |=  PORT_PIN_1       ;}  /* turn LED on  */
-void BSP_led2Off() {GPIOC->BSRR |= (PORT_PIN_2 << 16);}  /* turn LED off */
-void BSP_led2On () {GPIOC->BSRR |=  PORT_PIN_2       ;}  /* turn LED on  */
-void BSP_led3Off() {GPIOC->BSRR |= (PORT_PIN_3 << 16);}  /* turn LED off */
-void BSP_led3On () {GPIOC->BSRR |=  PORT_PIN_3       ;}  /* turn LED on  */
-void BSP_led4Off() {GPIOC->BSRR |= (PORT_PIN_4 << 16);}  /* turn LED off */
-void BSP_led4On () {GPIOC->BSRR |=  PORT_PIN_4       ;}  /* turn LED on  */
-void BSP_led5Off() {GPIOC->BSRR |= (PORT_PIN_5 << 16);}  /* turn LED off */
-void BSP_led5On () {GPIOC->BSRR |=  PORT_PIN_5       ;}  /* turn LED on  */
-void BSP_led6Off() {GPIOC->BSRR |= (PORT_PIN_6 << 16);}  /* turn LED off */
-void BSP_led6On () {GPIOC->BSRR |=  PORT_PIN_6       ;}  /* turn LED on  */
-void BSP_led7Off() {GPIOC->BSRR |= (PORT_PIN_7 << 16);}  /* turn LED off */
-void BSP_led7On () {GPIOC->BSRR |=  PORT_PIN_7       ;}  /* turn LED on  */
-
-// button outputs
-//Push-pull mode: A 0 in the Output register activates the N-MOS whereas a 1 in
-//the Output register activates the P-MOS
-void BSP_buttonR0Off(){GPIOB->BSRR |= (PORT_PIN_0 << 16);} // blow it off the variable to the left.  leave all 0s?
-void BSP_buttonR0On (){GPIOB->BSRR |= (PORT_PIN_0      );}
-void BSP_buttonR1Off(){GPIOB->BSRR |= (PORT_PIN_1 << 16);} // blow it off the variable to the left.  leave all 0s?
-void BSP_buttonR1On (){GPIOB->BSRR |= (PORT_PIN_1      );}
-void BSP_buttonR2Off(){GPIOB->BSRR |= (PORT_PIN_2 << 16);} // blow it off the variable to the left.  leave all 0s?
-void BSP_buttonR2On (){GPIOB->BSRR |= (PORT_PIN_2      );}
-void BSP_buttonR3Off(){GPIOB->BSRR |= (PORT_PIN_3 << 16);} // blow it off the variable to the left.  leave all 0s?
-void BSP_buttonR3On (){GPIOB->BSRR |= (PORT_PIN_3      );}
-
-int BSP_buttonCS0()
-{
-	int a = 0;
-	int r = 0;
-	r = GPIOB->IDR;
-	a = r & PORT_PIN_4;
-	
-	if (a == PORT_PIN_4)
-	  return 1; // button pressed
-  else
-	  return 0; // button not pressed
-};
-int BSP_buttonCS1()
-{
-	int a = 0;
-	int r = 0;
-	r = GPIOB->IDR;
-	a = r & PORT_PIN_5;
-	
-	if (a == PORT_PIN_5)
-	  return 1; // button pressed
-  else
-	  return 0; // button not pressed
-};
-int BSP_buttonCS2()
-{
-	int a = 0;
-	int r = 0;
-	r = GPIOB->IDR;
-	a = r & PORT_PIN_6;
-	
-	if (a == PORT_PIN_6)
-	  return 1; // button pressed
-  else
-	  return 0; // button not pressed
-};
-int BSP_buttonCS3()
-{
-	int a = 0;
-	int r = 0;
-	r = GPIOB->IDR;
-	a = r & PORT_PIN_7;
-	
-	if (a == PORT_PIN_7)
-	  return 1; // button pressed
-  else
-	  return 0; // button not pressed
-};
+void BSP_pinsWrite(BSPPinSet const *set) { /* see bsp_pins.h */
+    if (set->bsrr[BSP_PORT_B] != 0U) {
+        GPIOB->BSRR = set->bsrr[BSP_PORT_B];
+    }
+    if (set->bsrr[BSP_PORT_C] != 0U) {
+        GPIOC->BSRR = set->bsrr[BSP_PORT_C];
+    }
+}
+/*..........................................................................*/
+/* BSP_ledAOn(), BSP_buttonCS0()... generated from the pin table */
+#define BSP_PIN_WRITE(port_, bsrr_) (GPIO##port_->BSRR = (bsrr_))
+#define BSP_PIN_READ(port_)         (GPIO##port_->IDR)
+BSP_PINS(BSP_PIN_ACCESSOR_, ~)
+/*..........................................................................*/
+void BSP_ledSetLevel(uint8_t x, uint8_t y, uint8_t level) {
+    Q_REQUIRE((x < DISPLAY_COLS) && (y < DISPLAY_ROWS)
+              && (level <= DISPLAY_LEVEL_MAX));
+    (*Display_frame())[x][y] = level;
+    Display_swap();
+}
 
 //#define BTN_B1   (1U << 13)
 
@@ -492,8 +362,47 @@ void BSP_terminate(int16_t result) {
     (void)result;
 }
 
+/*..........................................................................*/
+static uint16_t keypad_scan(void) { /* the whole key matrix in one pass */
+    uint16_t keys = 0U;
+    uint32_t row;
+    uint32_t i;
+
+    for (row = 0U; row < KEYPAD_ROWS; ++row) {
+        /* drive the row high and all the others low in one write */
+        GPIOB->BSRR = (KEYPAD_ROW_PINS << 16) | (BSP_PIN_KEY_ROW0 << row);
+        for (i = KEYPAD_SETTLE; i != 0U; --i) {
+            __NOP();
+        }
+        keys |= (uint16_t)(((GPIOB->IDR >> KEYPAD_COL_SHIFT) & 0xFU)
+                           << (row * KEYPAD_COLS));
+    }
+    GPIOB->BSRR = (KEYPAD_ROW_PINS << 16); /* all rows low */
+    return keys;
+}
+/*..........................................................................*/
+static void keypad_idle(void) { /* stop scanning until a key press */
+    uint32_t i;
+
+    GPIOB->BSRR = KEYPAD_ROW_PINS; /* drive all the rows high */
+    for (i = KEYPAD_SETTLE; i != 0U; --i) {
+        __NOP();
+    }
+    l_keypadScan = 0U;
+    EXTI->PR   = KEYPAD_COL_PINS;  /* clear the stale pending flags */
+    EXTI->IMR |= KEYPAD_COL_PINS;  /* arm the columns */
+
+    /* a key pressed before the columns were armed raises no edge */
+    if ((GPIOB->IDR & KEYPAD_COL_PINS) != 0U) {
+        EXTI->IMR &= ~KEYPAD_COL_PINS;
+        l_keypadScan = 1U;
+    }
+}
+
 /* QF callbacks ============================================================*/
 void QF_onStartup(void) {
+    uint_fast8_t plane;
+
     /* set up the SysTick timer to fire at BSP_TICKS_PER_SEC rate */
     SysTick_Config(SystemCoreClock / BSP_TICKS_PER_SEC);
 
@@ -504,9 +413,32 @@ void QF_onStartup(void) {
     * DO NOT LEAVE THE ISR PRIORITIES AT THE DEFAULT VALUE!
     */
     NVIC_SetPriority(SysTick_IRQn,   SYSTICK_PRIO);
+    NVIC_SetPriority(LPTIM1_IRQn,    SYSTICK_PRIO); /* only wakes up */
+    NVIC_SetPriority(EXTI4_15_IRQn,  SYSTICK_PRIO); /* scans as SysTick */
+    NVIC_SetPriority(DMA1_Channel4_5_6_7_IRQn, DMA1_CH4_PRIO);
+    NVIC_SetPriority(TIM6_DAC_IRQn,  TIM6_PRIO);
     /* ... */
 
+    /* the LED matrix refresh with the binary code modulation, the period
+    * of the bit-plane n is (1 << n) slots of DISPLAY_BCM_HZ, see NOTE07
+    */
+    for (plane = 0U; plane < DISPLAY_PLANES; ++plane) {
+        l_bcmArr[plane] = (uint16_t)(((SystemCoreClock / DISPLAY_BCM_HZ)
+                                      << plane) - 1U);
+    }
+    RCC->APB1ENR |= RCC_APB1ENR_TIM6EN;
+    TIM6->PSC  = 0U;
+    TIM6->ARR  = l_bcmArr[0];
+    TIM6->DIER = TIM_DIER_UIE;
+    TIM6->CR1  = TIM_CR1_CEN; /* no ARR preload (ARPE == 0), see NOTE07 */
+
     /* enable IRQs... */
+    NVIC_EnableIRQ(EXTI4_15_IRQn);
+    NVIC_EnableIRQ(TIM6_DAC_IRQn);
+#ifdef BSP_TICKLESS
+    tickless_init();
+    NVIC_EnableIRQ(LPTIM1_IRQn);
+#endif
 }
 /*..........................................................................*/
 void QF_onCleanup(void) {
@@ -519,18 +451,10 @@ void QV_onIdle(void) {  /* called with interrupts disabled, see NOTE01 */
     //GPIOA->BSRR |= (LED_LD2 << 16);  /* turn LED[n] off */
 
 #ifdef Q_SPY
-    QF_INT_ENABLE();
-    if ((USART2->ISR & 0x0080U) != 0) {  /* is TXE empty? */
-        uint16_t b;
-
-        QF_INT_DISABLE();
-        b = QS_getByte();
-        QF_INT_ENABLE();
-
-        if (b != QS_EOD) {  /* not End-Of-Data? */
-            USART2->TDR  = (b & 0xFFU);  /* put into the DR register */
-        }
+    if (l_qsDmaBusy == 0U) { /* QS output not running? */
+        qs_dmaStart(); /* start the DMA chain, see NOTE04 */
     }
+    QF_INT_ENABLE();
 #elif defined NDEBUG
     /* Put the CPU and peripherals to the low-power mode.
     * you might need to customize the clock management for your application,
@@ -547,8 +471,7 @@ void QV_onIdle(void) {  /* called with interrupts disabled, see NOTE01 */
     * The trick with BOOT(0) is it gets the part to run the System Loader
     * instead of your broken code. When done disconnect BOOT0, and start over.
     */
-    //QV_CPU_SLEEP();  /* atomically go to sleep and enable interrupts */
-    QF_INT_ENABLE(); /* for now, just enable interrupts */
+    tickless_idle(); /* sleep until the next time event, see NOTE03 */
 #else
     QF_INT_ENABLE(); /* just enable interrupts */
 #endif
@@ -557,6 +480,144 @@ void QV_onIdle(void) {  /* called with interrupts disabled, see NOTE01 */
 /*..........................................................................*/
 /* NOTE Q_onAssert() defined in assembly in startup_<device>.s */
 
+#ifdef BSP_TICKLESS
+/*..........................................................................*/
+static uint32_t lptim_count(void) { /* read the asynchronous LPTIM counter */
+    uint32_t cnt;
+    do {
+        cnt = LPTIM1->CNT;
+    } while (cnt != LPTIM1->CNT); /* two equal reads in a row */
+    return cnt;
+}
+/*..........................................................................*/
+static void tickless_init(void) {
+    RCC->APB1ENR |= (RCC_APB1ENR_PWREN | RCC_APB1ENR_LPTIM1EN);
+
+    /* start the LSE 32.768kHz oscillator (the backup domain access) */
+    PWR->CR  |= PWR_CR_DBP;
+    RCC->CSR |= RCC_CSR_LSEON;
+    while ((RCC->CSR & RCC_CSR_LSERDY) == 0U) { /* wait for the LSE */
+    }
+
+    /* LPTIM1 clocked from the LSE / 32, free running over 16 bits */
+    RCC->CCIPR   |= RCC_CCIPR_LPTIM1SEL; /* 11: LSE */
+    LPTIM1->CFGR  = (LPTIM_CFGR_PRESC_2 | LPTIM_CFGR_PRESC_0); /* 101: /32 */
+    LPTIM1->IER   = LPTIM_IER_CMPMIE; /* interrupt on the compare match */
+    LPTIM1->CR    = LPTIM_CR_ENABLE;
+    LPTIM1->ARR   = 0xFFFFU;
+    while ((LPTIM1->ISR & LPTIM_ISR_ARROK) == 0U) { /* wait for the write */
+    }
+    LPTIM1->ICR   = LPTIM_ICR_ARROKCF;
+    LPTIM1->CR   |= LPTIM_CR_CNTSTRT; /* start in the continuous mode */
+
+    EXTI->IMR |= EXTI_IMR_IM29; /* LPTIM1 wake-up line (EXTI line 29) */
+
+    /* WFI with SLEEPDEEP enters the Stop mode with the low-power regulator,
+    * VREFINT off and the fast wake-up, and wakes up with the MSI clock
+    */
+    PWR->CR = (PWR->CR & ~PWR_CR_PDDS)
+              | (PWR_CR_LPSDSR | PWR_CR_ULP | PWR_CR_FWU);
+    RCC->CFGR &= ~RCC_CFGR_STOPWUCK;
+}
+/*..........................................................................*/
+static void tickless_idle(void) { /* called with interrupts disabled */
+    uint32_t period = SysTick->LOAD + 1U; /* tick period [CPU clocks] */
+    QTimeEvtCtr nTicks = QF_ticksToNextX(0U);
+    uint32_t frac;    /* time since the last tick [1/LPTIM_HZ ticks] */
+    uint32_t sleep;   /* time to sleep [LPTIM counts] */
+    uint32_t elapsed; /* elapsed clock ticks */
+    uint32_t cnt;
+    uint32_t now;
+
+    /* the next time event too close, the clock tick already pending, the
+    * keypad scanning burst in progress (needs the tick) or any LED lit
+    * (needs the refresh timer)?
+    */
+    if (((nTicks != (QTimeEvtCtr)0) && (nTicks < TICKLESS_MIN))
+        || ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+        || (l_keypadScan != 0U)
+        || Display_isLit())
+    {
+        QV_CPU_SLEEP(); /* sleep until the next interrupt, the tick runs */
+        return;
+    }
+
+    /* stop the clock tick and find out the time since the last tick */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    frac = ((period - SysTick->VAL) * LPTIM_HZ) / period;
+
+    /* time until the nearest time event (rounded up), see NOTE03 */
+    if (nTicks == (QTimeEvtCtr)0) { /* no time events armed? */
+        sleep = LPTIM_MAX_SLEEP;     /* sleep until any other interrupt */
+    }
+    else {
+        sleep = (((uint32_t)nTicks * LPTIM_HZ) - frac
+                 + BSP_TICKS_PER_SEC - 1U) / BSP_TICKS_PER_SEC;
+        if (sleep > LPTIM_MAX_SLEEP) {
+            sleep = LPTIM_MAX_SLEEP;
+        }
+    }
+
+    /* program the single wake-up at the nearest time event */
+    cnt = lptim_count();
+    LPTIM1->CMP = (cnt + sleep) & 0xFFFFU;
+    while ((LPTIM1->ISR & LPTIM_ISR_CMPOK) == 0U) { /* wait for the write */
+    }
+    LPTIM1->ICR = (LPTIM_ICR_CMPOKCF | LPTIM_ICR_CMPMCF);
+    NVIC_ClearPendingIRQ(LPTIM1_IRQn);
+
+    /* enter the Stop mode, any interrupt (even disabled) wakes up the CPU */
+    PWR->CR |= PWR_CR_CWUF;
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+    __WFI();
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+    /* the elapsed time in the Stop mode [1/LPTIM_HZ ticks] */
+    now = lptim_count();
+    frac += ((now - cnt) & 0xFFFFU) * BSP_TICKS_PER_SEC;
+    elapsed = frac / LPTIM_HZ;
+    frac   %= LPTIM_HZ;
+    STIMLOG_TICKS(elapsed); /* all idle ticks, see NOTE09 */
+
+    /* catch up with the elapsed ticks, in which no time event expires */
+    if ((nTicks == (QTimeEvtCtr)0) || (elapsed < (uint32_t)nTicks)) {
+        QF_tickSkipX(0U, (QTimeEvtCtr)elapsed);
+        elapsed = 0U;
+    }
+    else {
+        QF_tickSkipX(0U, nTicks - (QTimeEvtCtr)1);
+        elapsed -= ((uint32_t)nTicks - 1U); /* ticks to process below */
+    }
+
+    /* process the ticks, in which the time events expire, with the SysTick
+    * still stopped, so that SysTick_Handler() cannot preempt them, and
+    * also the ticks elapsed in the meantime, see NOTE03
+    */
+    while (elapsed != 0U) {
+        for (; elapsed != 0U; --elapsed) {
+            QF_TICK_X(0U, (void *)0); /* enables the interrupts on exit */
+        }
+        QF_INT_DISABLE();
+        cnt = now;
+        now = lptim_count();
+        frac += ((now - cnt) & 0xFFFFU) * BSP_TICKS_PER_SEC;
+        elapsed = frac / LPTIM_HZ;
+        frac   %= LPTIM_HZ;
+        STIMLOG_TICKS(elapsed);
+    }
+
+    /* restart the clock tick in phase with the elapsed time */
+    SysTick->LOAD = (((LPTIM_HZ - frac) * period) / LPTIM_HZ) - 1U;
+    SysTick->VAL  = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    while (SysTick->VAL == 0U) { /* wait for the SysTick reload */
+    }
+    SysTick->LOAD = period - 1U; /* the next periods are full ticks */
+
+    QF_INT_ENABLE();
+}
+#endif /* BSP_TICKLESS */
+
 /* QS callbacks ============================================================*/
 #ifdef Q_SPY
 /*..........................................................................*/
@@ -586,7 +647,7 @@ uint8_t QS_onStartup(void const *arg) {
     GPIOA->MODER  |=  (( 2ul << 2* 3) | ( 2ul << 2* 2) );
 
     USART2->BRR  = __USART_BRR(SystemCoreClock, 115200ul);  /* baud rate */
-    USART2->CR3  = 0x0000;         /* no flow control */
+    USART2->CR3  = USART_CR3_DMAT; /* no flow control, DMA transmitter */
     USART2->CR2  = 0x0000;         /* 1 stop bit      */
     USART2->CR1  = ((1ul <<  2) |  /* enable RX       */
                     (1ul <<  3) |  /* enable TX       */
@@ -594,6 +655,13 @@ uint8_t QS_onStartup(void const *arg) {
                     (0ul << 28) |  /* 8 data bits     */
                     (1ul <<  0) ); /* enable USART    */
 
+    /* DMA1 channel 4 mapped to USART2_TX, memory to the TDR register */
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+    DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~DMA_CSELR_C4S)
+                        | (4UL << 12); /* C4S = 0100: USART2_TX */
+    DMA1_Channel4->CPAR = (uint32_t)&USART2->TDR;
+    NVIC_EnableIRQ(DMA1_Channel4_5_6_7_IRQn);
+
     QS_tickPeriod_ = SystemCoreClock / BSP_TICKS_PER_SEC;
     QS_tickTime_ = QS_tickPeriod_; /* to start the timestamp at zero */
 
@@ -688,16 +756,29 @@ QSTimeCtr QS_onGetTime(void) { /* NOTE: invoked with interrupts DISABLED */
 }
 /*..........................................................................*/
 void QS_onFlush(void) {
-    uint16_t b;
-
     QF_INT_DISABLE();
-    while ((b = QS_getByte()) != QS_EOD) {    /* while not End-Of-Data... */
-        QF_INT_ENABLE();
-        while ((USART2->ISR & 0x0080U) == 0U) { /* while TXE not empty */
-        }
-        USART2->TDR  = (b & 0xFFU);  /* put into the DR register */
+    if (l_qsDmaBusy == 0U) { /* QS output not running? */
+        qs_dmaStart();
     }
     QF_INT_ENABLE();
+    while (l_qsDmaBusy != 0U) { /* until the DMA chain drains the buffer */
+    }
+}
+/*..........................................................................*/
+static void qs_dmaStart(void) { /* called with interrupts disabled */
+    uint16_t nBytes = (uint16_t)QS_DMA_BLOCK;
+    uint8_t const *block = QS_txBlock(&nBytes);
+
+    if (block != (uint8_t *)0) { /* any QS data to output? */
+        DMA1_Channel4->CMAR  = (uint32_t)block;
+        DMA1_Channel4->CNDTR = nBytes;
+        DMA1_Channel4->CCR   = (DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE
+                                | DMA_CCR_EN);
+        l_qsDmaBusy = 1U;
+    }
+    else {
+        l_qsDmaBusy = 0U;
+    }
 }
 #endif /* Q_SPY */
 /*--------------------------------------------------------------------------*/
@@ -732,4 +813,97 @@ void QS_onFlush(void) {
 * of the LED is proportional to the frequency of invcations of the idle loop.
 * Please note that the LED is toggled with interrupts locked, so no interrupt
 * execution time contributes to the brightness of the User LED.
+*
+* NOTE03:
+* In the Release configuration the idle callback stops the SysTick and puts
+* the MCU to the Stop mode until the nearest time event expiration, which
+* QF_ticksToNextX() reports, or until any other interrupt. The single
+* wake-up is the compare match of the LPTIM1 running from the LSE in the
+* Stop mode. After the wake-up, the elapsed ticks are caught up with
+* QF_tickSkipX() and QF_TICK_X(), and the SysTick is restarted in phase
+* with the elapsed time, so that the clock ticks do not drift. The
+* QF_TICK_X() calls run before the restart: QF_tickX_() must not be
+* preempted by itself for the same tick rate, and its critical sections
+* re-enable the interrupts, so only the stopped SysTick keeps the
+* SysTick_Handler() out. The ticks elapsed while processing them are
+* processed as well, before the SysTick restarts in phase. Shorter
+* sleeps than TICKLESS_MIN ticks just wait for the next interrupt with the
+* SysTick running. The code assumes the default MSI system clock, which
+* the MCU uses after the wake-up from the Stop mode; a BSP switching to
+* another clock must restore it after the WFI. As with the WFI, the Stop
+* mode disconnects the debugger, unless DBGMCU_CR_DBG_STOP is set.
+*
+* NOTE04:
+* The QS data is sent out by the DMA1 channel 4 directly from the QS buffer
+* (zero copy). The idle callback starts the transfer of the first block
+* from QS_txBlock() and the transfer-complete interrupt releases it with
+* QS_txDone() and chains the next block, until the QS buffer is empty. The
+* CPU is thus involved only once per block, and the trace throughput is
+* limited by the baud rate. The block in transfer is protected from the new
+* QS data until the whole QS buffer overruns, and the number of the bytes
+* lost by the overruns is available from QS_getDropped().
+*
+* NOTE05:
+* The keypad is scanned in the clock tick with one read of GPIOB->IDR per
+* row, which returns all four columns of the row at once. The row is driven
+* with a single write to GPIOB->BSRR, in which the set bit takes precedence
+* over the reset bits of all the rows. KEYPAD_SETTLE NOPs let the column
+* inputs follow the driven row through the key contacts and the input
+* synchronizer (two clocks), so the whole scan takes a few microseconds of
+* CPU time. The debouncing is left to Keypad_tick(), so that no scan needs
+* to wait for the contacts to settle.
+*
+* NOTE06:
+* The keypad is scanned only in the bursts started by a key press. Between
+* the bursts, in the keypad idle mode, all the rows are driven high and the
+* EXTI lines of the columns are armed, so that the first pressed key raises
+* the EXTI4_15 interrupt, which also wakes the MCU up from the Stop mode of
+* the tickless idle (NOTE03). The interrupt disarms the columns, takes the
+* first sample right away and leaves the following ones to SysTick_Handler(),
+* so a key press is sampled within one clock tick. The burst, which keeps
+* the clock tick running, ends when Keypad_tick() reports all the keys
+* released and debounced. The EXTI interrupt has the priority of the
+* SysTick, so that the two never preempt each other in the keypad code.
+*
+* NOTE07:
+* The TIM6 update interrupt multiplexes the LED matrix one column and one
+* bit-plane at a time, with the single GPIOC->BSRR store of the word
+* precomputed by Display_swap(), so the refresh costs the CPU only a few
+* instructions per bit-plane regardless of the shown pattern. The binary
+* code modulation (NOTE2 of display.c) doubles the timer period with every
+* bit-plane: the ISR writes the period of the bit-plane it has just shown
+* to TIM6->ARR, which without the ARR preload applies to the period already
+* running (the counter has only just restarted from 0). At the default
+* 2.097 MHz MSI clock the shortest slot of DISPLAY_BCM_HZ is about 139
+* cycles, and the 16 levels take 4000 interrupts per second at the
+* DISPLAY_FRAME_HZ of 200, where PWM would take 15000. The interrupt has
+* the highest kernel-aware priority, so that the refresh does not jitter
+* with the other ISRs, yet it is masked during the short critical sections
+* of Display_swap(). TIM6 stops in the Stop mode, so the tickless idle does
+* not enter it while any LED is lit. The LEDs are no longer driven with the
+* BSP_led...() functions, which would interfere with the refresh.
+*
+* NOTE08:
+* All the GPIO pins used by the BSP are declared once in the pin table
+* BSP_PINS() of bsp_pins.h (port, pin, mode, output type, speed, pull and
+* the level of the "on" state), which the preprocessor folds into one
+* constant value and mask per configuration register and port. BSP_init()
+* thus configures each port with one write per register (instead of the
+* four read-modify-write sequences per pin before), and the outputs are
+* driven to their "off" levels with one BSRR store before MODER turns them
+* into outputs, so they never glitch on. The pin accessors BSP_ledAOn()...
+* and BSP_buttonCS0()... are generated from the same table, so a pin is
+* moved or reconfigured by changing its single table row. The host BSP
+* shares the table for its mocked ports.
+*
+* NOTE09:
+* With STIMLOG defined, every stimulus entering the application is recorded
+* at the ISR boundary into l_stimLogSto[] (stimlog.c): each SysTick with the
+* keypad sample it passed to Keypad_tick(), if any, the keypad wake-up of
+* EXTI4_15 with its sample, and the ticks elapsed in the tickless idle.
+* The runs of ticks are run-length encoded, so the 1KB hold about a hundred
+* key presses of an otherwise idle session. The buffer is read out with the
+* debugger (or written out by the simulator at exit) and replayed into the
+* same active objects by the host BSP (BSP_REPLAY). The recording costs a
+* few dozen instructions per tick, so it is off by default.
 */
@@ -36,7 +36,14 @@
 
 #define BSP_TICKS_PER_SEC    100U
 
+/* the 5x8 LED matrix: the rows 0..7 are the pins PC0..PC7 (active high)
+* and the columns A..E the pins PC8..PC12 (active low)
+*/
+#define BSP_LED_ROW_PIN0     0U
+#define BSP_LED_COL_PIN0     8U
+
 void BSP_init(void);
+void BSP_terminate(int16_t result);
 void BSP_ledAOff(void);
 void BSP_ledAOn (void);
 void BSP_ledBOff(void);
@@ -65,6 +72,10 @@ void BSP_led6On (void);
 void BSP_led7Off(void);
 void BSP_led7On (void);
 
+/* set the brightness 0..DISPLAY_LEVEL_MAX of the LED in the column x (A..E)
+* and the row y (0..7) of the matrix and show it from the next refresh frame
+*/
+void BSP_ledSetLevel(uint8_t x, uint8_t y, uint8_t level);
 
 void BSP_buttonR0Off(void);
 void BSP_buttonR0On(void);
@@ -0,0 +1,205 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, the GPIO pins of the board
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The declarative table of all the GPIO pins used by the BSP, shared by the
+* target and the host BSP, and the pin sets that batch any number of pin
+* changes into one GPIOx->BSRR store per port. A pin set accumulates the
+* changes as the set and reset halves of the BSRR word of every port (with
+* constant pin names the words fold at compile time), and BSP_pinsWrite()
+* applies all the changes of a port atomically with a single plain store.
+*****************************************************************************/
+#ifndef bsp_pins_h
+#define bsp_pins_h
+
+/* the pins of the board, the single source of their configuration and of
+* their accessors:
+* X_(a_, name, accessor, port, pin, mode, type, speed, pull, on), where a_
+* is passed through from BSP_PINS() to every X_
+*/
+#define BSP_PINS(X_, a_) \
+    X_(a_, LED_ROW0, led0,      C,  0, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_ROW1, led1,      C,  1, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_ROW2, led2,      C,  2, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_ROW3, led3,      C,  3, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_ROW4, led4,      C,  4, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_ROW5, led5,      C,  5, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_ROW6, led6,      C,  6, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_ROW7, led7,      C,  7, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, LED_COLA, ledA,      C,  8, OUT, PP, LOW, NONE, LOW) \
+    X_(a_, LED_COLB, ledB,      C,  9, OUT, PP, LOW, NONE, LOW) \
+    X_(a_, LED_COLC, ledC,      C, 10, OUT, PP, LOW, NONE, LOW) \
+    X_(a_, LED_COLD, ledD,      C, 11, OUT, PP, LOW, NONE, LOW) \
+    X_(a_, LED_COLE, ledE,      C, 12, OUT, PP, LOW, NONE, LOW) \
+    X_(a_, KEY_ROW0, buttonR0,  B,  0, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, KEY_ROW1, buttonR1,  B,  1, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, KEY_ROW2, buttonR2,  B,  2, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, KEY_ROW3, buttonR3,  B,  3, OUT, PP, LOW, NONE, HIGH) \
+    X_(a_, KEY_COL0, buttonCS0, B,  4, IN,  PP, LOW, NONE, HIGH) \
+    X_(a_, KEY_COL1, buttonCS1, B,  5, IN,  PP, LOW, NONE, HIGH) \
+    X_(a_, KEY_COL2, buttonCS2, B,  6, IN,  PP, LOW, NONE, HIGH) \
+    X_(a_, KEY_COL3, buttonCS3, B,  7, IN,  PP, LOW, NONE, HIGH)
+
+/* the GPIO ports of the pins, the indexes of BSPPinSet.bsrr[] */
+enum BSPPorts {
+    BSP_PORT_B,
+    BSP_PORT_C,
+    BSP_PORT_MAX
+};
+
+/* the fields of the pin configuration (the GPIOx register bits) */
+#define BSP_MODE_IN     0U  /* MODER */
+#define BSP_MODE_OUT    1U
+#define BSP_MODE_AF     2U
+#define BSP_MODE_AN     3U
+#define BSP_TYPE_PP     0U  /* OTYPER */
+#define BSP_TYPE_OD     1U
+#define BSP_SPEED_VLOW  0U  /* OSPEEDR */
+#define BSP_SPEED_LOW   1U
+#define BSP_SPEED_MED   2U
+#define BSP_SPEED_HIGH  3U
+#define BSP_PULL_NONE   0U  /* PUPDR */
+#define BSP_PULL_UP     1U
+#define BSP_PULL_DOWN   2U
+
+/* the BSRR words turning the pins of the mask on and off, by the level of
+* the "on" state of the pins
+*/
+#define BSP_ON_HIGH(mask_)  ((uint32_t)(mask_))
+#define BSP_ON_LOW(mask_)   ((uint32_t)(mask_) << 16)
+#define BSP_OFF_HIGH(mask_) ((uint32_t)(mask_) << 16)
+#define BSP_OFF_LOW(mask_)  ((uint32_t)(mask_))
+
+/* the input levels XOR-ed with GPIOx->IDR to read the "on" pins as 1 */
+#define BSP_READ_HIGH       0U
+#define BSP_READ_LOW        0xFFFFU
+
+/* BSP_PIN_<name>: the mask of the pin in its port */
+#define BSP_PIN_MASK_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                      pull_, on_) \
+    BSP_PIN_##name_ = (1U << (pin_)),
+enum BSPPinMasks {
+    BSP_PINS(BSP_PIN_MASK_, ~)
+    BSP_PIN_MASK_END_
+};
+
+/* BSP_PORT_OF_<name>: the port of the pin */
+#define BSP_PIN_PORT_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                      pull_, on_) \
+    BSP_PORT_OF_##name_ = BSP_PORT_##port_,
+enum BSPPinPorts {
+    BSP_PINS(BSP_PIN_PORT_, ~)
+    BSP_PIN_PORT_END_
+};
+
+/* the configuration of all the pins of the port (BSP_PORT_B...) folded at
+* compile time into the value and the mask of each GPIOx register
+*/
+#define BSP_PORT_MODER(port_)      (0U BSP_PINS(BSP_CFG_MODER_,   (port_)))
+#define BSP_PORT_OTYPER(port_)     (0U BSP_PINS(BSP_CFG_OTYPER_,  (port_)))
+#define BSP_PORT_OSPEEDR(port_)    (0U BSP_PINS(BSP_CFG_OSPEEDR_, (port_)))
+#define BSP_PORT_PUPDR(port_)      (0U BSP_PINS(BSP_CFG_PUPDR_,   (port_)))
+#define BSP_PORT_MASK2(port_)      (0U BSP_PINS(BSP_CFG_MASK2_,   (port_)))
+#define BSP_PORT_MASK1(port_)      (0U BSP_PINS(BSP_CFG_MASK1_,   (port_)))
+
+/* the BSRR word turning all the outputs of the port off */
+#define BSP_PORT_OFF(port_)        (0U BSP_PINS(BSP_CFG_OFF_,     (port_)))
+
+#define BSP_CFG_FIELD_(a_, port_, pin_, bits_, val_) \
+    | ((BSP_PORT_##port_ == (a_)) \
+       ? ((uint32_t)(val_) << ((bits_) * (uint32_t)(pin_))) : 0U)
+#define BSP_CFG_MODER_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                       pull_, on_) \
+    BSP_CFG_FIELD_(a_, port_, pin_, 2U, BSP_MODE_##mode_)
+#define BSP_CFG_OTYPER_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                        pull_, on_) \
+    BSP_CFG_FIELD_(a_, port_, pin_, 1U, BSP_TYPE_##type_)
+#define BSP_CFG_OSPEEDR_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                         pull_, on_) \
+    BSP_CFG_FIELD_(a_, port_, pin_, 2U, BSP_SPEED_##speed_)
+#define BSP_CFG_PUPDR_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                       pull_, on_) \
+    BSP_CFG_FIELD_(a_, port_, pin_, 2U, BSP_PULL_##pull_)
+#define BSP_CFG_MASK2_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                       pull_, on_) \
+    BSP_CFG_FIELD_(a_, port_, pin_, 2U, 3U)
+#define BSP_CFG_MASK1_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                       pull_, on_) \
+    BSP_CFG_FIELD_(a_, port_, pin_, 1U, 1U)
+#define BSP_CFG_OFF_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                     pull_, on_) \
+    | (((BSP_PORT_##port_ == (a_)) && (BSP_MODE_##mode_ == BSP_MODE_OUT)) \
+       ? BSP_OFF_##on_(1U << (pin_)) : 0U)
+
+/* the accessors of the pins: BSP_<accessor>On() and BSP_<accessor>Off() of
+* the outputs, int BSP_<accessor>() of the inputs (1 when on). The BSP
+* defines BSP_PIN_WRITE(port_, bsrr_) and BSP_PIN_READ(port_) for its GPIO
+* (or mocked GPIO) and expands BSP_PINS(BSP_PIN_ACCESSOR_, ~) once.
+*/
+#define BSP_PIN_ACCESSOR_(a_, name_, acc_, port_, pin_, mode_, type_, speed_, \
+                          pull_, on_) \
+    BSP_PIN_ACCESSOR_##mode_(name_, acc_, port_, on_)
+#define BSP_PIN_ACCESSOR_OUT(name_, acc_, port_, on_) \
+    void BSP_##acc_##On(void) { \
+        BSP_PIN_WRITE(port_, BSP_ON_##on_(BSP_PIN_##name_)); \
+    } \
+    void BSP_##acc_##Off(void) { \
+        BSP_PIN_WRITE(port_, BSP_OFF_##on_(BSP_PIN_##name_)); \
+    }
+#define BSP_PIN_ACCESSOR_IN(name_, acc_, port_, on_) \
+    int BSP_##acc_(void) { \
+        return (((BSP_PIN_READ(port_) ^ BSP_READ_##on_) \
+                 & (uint32_t)BSP_PIN_##name_) != 0U) ? 1 : 0; \
+    }
+#define BSP_PIN_ACCESSOR_AF(name_, acc_, port_, on_)
+#define BSP_PIN_ACCESSOR_AN(name_, acc_, port_, on_)
+
+/* the groups of the pins */
+#define BSP_LED_ROW_PINS ((uint32_t)(BSP_PIN_LED_ROW0 | BSP_PIN_LED_ROW1 \
+    | BSP_PIN_LED_ROW2 | BSP_PIN_LED_ROW3 | BSP_PIN_LED_ROW4 \
+    | BSP_PIN_LED_ROW5 | BSP_PIN_LED_ROW6 | BSP_PIN_LED_ROW7))
+#define BSP_LED_COL_PINS ((uint32_t)(BSP_PIN_LED_COLA | BSP_PIN_LED_COLB \
+    | BSP_PIN_LED_COLC | BSP_PIN_LED_COLD | BSP_PIN_LED_COLE))
+#define BSP_KEY_ROW_PINS ((uint32_t)(BSP_PIN_KEY_ROW0 | BSP_PIN_KEY_ROW1 \
+    | BSP_PIN_KEY_ROW2 | BSP_PIN_KEY_ROW3))
+#define BSP_KEY_COL_PINS ((uint32_t)(BSP_PIN_KEY_COL0 | BSP_PIN_KEY_COL1 \
+    | BSP_PIN_KEY_COL2 | BSP_PIN_KEY_COL3))
+
+/* the LED matrix layout assumed by display.c, see bsp.h */
+Q_ASSERT_COMPILE(BSP_LED_ROW_PINS == (0xFFU << BSP_LED_ROW_PIN0));
+Q_ASSERT_COMPILE(BSP_LED_COL_PINS == (0x1FU << BSP_LED_COL_PIN0));
+
+/* the batch of the pin changes, the BSRR word of every port */
+typedef struct {
+    uint32_t bsrr[BSP_PORT_MAX];
+} BSPPinSet;
+
+#define BSP_PIN_SET_EMPTY { { 0U } }
+
+/* drive the pins of the mask (in the port of the pin name_) high, which
+* overrides any earlier BSPPinSet_low() of the same pins in the set
+*/
+#define BSPPinSet_high(me_, name_, mask_) \
+    ((me_)->bsrr[BSP_PORT_OF_##name_] = \
+        ((me_)->bsrr[BSP_PORT_OF_##name_] & ~((uint32_t)(mask_) << 16)) \
+        | (uint32_t)(mask_))
+
+/* drive the pins of the mask (in the port of the pin name_) low, which
+* overrides any earlier BSPPinSet_high() of the same pins in the set
+*/
+#define BSPPinSet_low(me_, name_, mask_) \
+    ((me_)->bsrr[BSP_PORT_OF_##name_] = \
+        ((me_)->bsrr[BSP_PORT_OF_##name_] & ~(uint32_t)(mask_)) \
+        | ((uint32_t)(mask_) << 16))
+
+#define BSPPinSet_set(me_, name_) \
+    BSPPinSet_high((me_), name_, BSP_PIN_##name_)
+#define BSPPinSet_reset(me_, name_) \
+    BSPPinSet_low((me_), name_, BSP_PIN_##name_)
+
+/* apply the pin set with one BSRR store per port that has any change */
+void BSP_pinsWrite(BSPPinSet const *set);
+
+#endif /* bsp_pins_h */
+
@@ -0,0 +1,744 @@
+/*****************************************************************************
+* Product: "Blinky" example, POSIX host (mocked NUCLEO-L053R8 board)
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web  : http://www.state-machine.com
+* Email: info@state-machine.com
+*****************************************************************************/
+#include "qpc.h"
+#include "blinky.h"
+#include "bsp.h"
+#include "bsp_pins.h"
+#include "keypad.h"
+#include "display.h"
+#include "stimlog.h"
+
+#include <stdio.h>   /* for fprintf() and QS output file */
+#include <stdlib.h>  /* for getenv(), strtoul(), exit(), qsort() */
+#include <time.h>    /* for clock_gettime() */
+
+Q_DEFINE_THIS_FILE
+
+/* Local-scope defines -----------------------------------------------------*/
+/* mocked GPIO output data registers with the pins of the target BSP
+* (bsp_pins.h), see NOTE00
+*/
+static uint32_t l_portB_ODR;
+static uint32_t l_portC_ODR;
+static void portB_BSRR(uint32_t word);
+static void portC_BSRR(uint32_t word);
+static uint32_t portB_IDR(void);
+
+/* mocked key matrix: bit (4*row + column) set when the key is pressed */
+static uint32_t l_keys;
+static uint8_t l_keypadScan; /* scanning burst in progress? see NOTE03 */
+static void keypad_idle(void);
+
+/* the key matrix stimuli of BSP_KEYS at the given clock ticks, see NOTE01 */
+#define MAX_STIMULI 64U
+static struct {
+    uint32_t tick;
+    uint32_t keys;
+} l_stim[MAX_STIMULI];
+static uint_fast8_t l_stimN;    /* number of the stimuli */
+static uint_fast8_t l_stimNext; /* the next stimulus to apply */
+static void stimuli_parse(char const *env);
+static void stimuli_apply(uint32_t tick);
+
+/* the replay of a recorded stimulus log (BSP_REPLAY), see NOTE06 */
+static StimPlayer l_player;
+static uint8_t *l_replayLog; /* the whole log, 0 when not replaying */
+static void replay_start(char const *fname);
+static void replay_records(void);
+static void replay_tick(uint32_t skipped);
+
+static uint32_t l_rnd;      /* random seed */
+static uint32_t l_runTicks; /* number of ticks to run (0 == forever) */
+static uint32_t l_lastTick; /* the tick of the last QF_onClockTick() */
+
+#ifdef STIMLOG
+    /* the recording of the stimuli (make REC=1), see NOTE06 */
+    static uint8_t l_recSto[1024];
+    static FILE *l_recFile;
+    static void rec_write(void);
+#endif
+
+#ifdef QV_RTC_STEP_TIMING
+    /* the timed RTC steps and clock ticks (make REPLAY=1), see NOTE07 */
+    typedef struct {
+        uint64_t key;  /* (prio << 48) | (signal << 32) | ns */
+        uint32_t tick; /* the clock tick of the step, for BSP_STEP_FILE */
+    } StepRec;
+    static StepRec *l_step;
+    static uint32_t l_stepN;
+    static uint32_t l_stepMax;
+    static struct timespec l_wall0; /* the start of QF_run() */
+    static void step_add(uint8_t prio, QSignal sig, uint32_t ns);
+    static void step_report(void);
+#endif
+
+#ifdef Q_SPY
+    static FILE *l_qsFile;          /* QS output file */
+    static struct timespec l_t0;    /* time base for QS time stamps */
+
+    /* event-source identifiers used for tracing */
+    static uint8_t const l_clock_tick = 0U;
+#endif
+
+/* BSP functions ===========================================================*/
+void BSP_init(void) {
+    char const *env;
+
+    /* optional run length in clock ticks, see NOTE01 */
+    env = getenv("BSP_RUN_TICKS");
+    if (env != (char const *)0) {
+        l_runTicks = (uint32_t)strtoul(env, (char **)0, 0);
+    }
+    /* optional replay of a recorded stimulus log, see NOTE06 */
+    env = getenv("BSP_REPLAY");
+    if (env != (char const *)0) {
+        replay_start(env);
+    }
+    /* or the mocked key matrix, bit (4*row + column), see NOTE01 */
+    else {
+        env = getenv("BSP_KEYS");
+        if (env != (char const *)0) {
+            stimuli_parse(env);
+            stimuli_apply(0U); /* the keys pressed from the start */
+        }
+    }
+#ifdef STIMLOG
+    env = getenv("BSP_REC_FILE");
+    if (env == (char const *)0) {
+        env = "stim.log";
+    }
+    l_recFile = fopen(env, "wb");
+    if (l_recFile == (FILE *)0) {
+        fprintf(stderr, "BSP_REC_FILE: cannot create %s\n", env);
+        exit(-1);
+    }
+    StimLog_init(l_recSto, (uint16_t)sizeof(l_recSto));
+#endif
+
+    if (QS_INIT((void *)0) == 0) { /* initialize the QS software tracing */
+        Q_ERROR();
+    }
+    QS_OBJ_DICTIONARY(&l_clock_tick);
+
+    /* the outputs of the pin table off, as BSP_init() of the target */
+    portB_BSRR(BSP_PORT_OFF(BSP_PORT_B));
+    portC_BSRR(BSP_PORT_OFF(BSP_PORT_C));
+    keypad_idle();
+}
+/*..........................................................................*/
+static void stimuli_parse(char const *env) { /* "keys" or "tick:keys,..." */
+    while ((*env != '\0') && (l_stimN < MAX_STIMULI)) {
+        char *end;
+        uint32_t val = (uint32_t)strtoul(env, &end, 0);
+
+        l_stim[l_stimN].tick = 0U;
+        if (*end == ':') {
+            l_stim[l_stimN].tick = val;
+            val = (uint32_t)strtoul(end + 1, &end, 0);
+        }
+        l_stim[l_stimN].keys = val;
+        ++l_stimN;
+        if (*end != ',') {
+            break;
+        }
+        env = end + 1;
+    }
+}
+/*..........................................................................*/
+static void stimuli_apply(uint32_t tick) { /* the stimuli due in the tick */
+    while ((l_stimNext < l_stimN) && (l_stim[l_stimNext].tick <= tick)) {
+        l_keys = l_stim[l_stimNext].keys;
+        ++l_stimNext;
+    }
+}
+/*..........................................................................*/
+static void replay_start(char const *fname) { /* load the whole log */
+    FILE *f = fopen(fname, "rb");
+    long size = -1L;
+
+    if ((f != (FILE *)0) && (fseek(f, 0L, SEEK_END) == 0)) {
+        size = ftell(f);
+        rewind(f);
+    }
+    if (size > 0L) {
+        l_replayLog = (uint8_t *)malloc((size_t)size);
+    }
+    if ((l_replayLog == (uint8_t *)0)
+        || (fread(l_replayLog, 1, (size_t)size, f) != (size_t)size)
+        || (StimPlayer_init(&l_player, l_replayLog, (uint32_t)size)
+            != BSP_TICKS_PER_SEC))
+    {
+        fprintf(stderr, "BSP_REPLAY: %s is not a stimulus log of %u Hz\n",
+                fname, (unsigned)BSP_TICKS_PER_SEC);
+        exit(-1);
+    }
+    (void)fclose(f);
+}
+/*..........................................................................*/
+static void replay_records(void) { /* up to the next run of clock ticks */
+    enum StimPlayerStep step;
+
+    while ((step = StimPlayer_step(&l_player)) == STIM_WAKE) { /* "EXTI" */
+        STIMLOG_WAKE(l_player.keys);
+        (void)Keypad_tick(l_player.keys);
+    }
+    if (step != STIM_TICK) { /* the end of the log? */
+        if (step != STIM_END) {
+            fprintf(stderr, "BSP_REPLAY: the log %s at the tick %u\n",
+                    (step == STIM_LOST) ? "is truncated" : "is corrupted",
+                    (unsigned)QF_getTickCtr());
+        }
+        BSP_terminate(0);
+    }
+}
+/*..........................................................................*/
+static void replay_tick(uint32_t skipped) { /* the stimuli of the tick */
+    if (l_player.ticks == 0U) { /* the replay over? */
+        return;
+    }
+    /* only the idle ticks of the current run skipped in virtual time */
+    Q_ASSERT((skipped == 0U)
+             || ((l_player.scan == 0U) && (skipped < l_player.ticks)));
+    l_player.ticks -= skipped + 1U;
+
+    if (l_player.scan != 0U) { /* the tick scans the keypad? */
+        STIMLOG_SCAN(l_player.keys);
+        (void)Keypad_tick(l_player.keys);
+    }
+    else {
+        STIMLOG_TICKS(1U);
+    }
+    if (l_player.ticks == 0U) { /* the end of the run? */
+        replay_records();
+    }
+}
+#ifdef STIMLOG
+/*..........................................................................*/
+static void rec_write(void) { /* write out the recorded stimuli */
+    uint8_t buf[256];
+    uint16_t n;
+
+    while ((n = StimLog_read(buf, (uint16_t)sizeof(buf))) != 0U) {
+        (void)fwrite(buf, 1, n, l_recFile);
+    }
+}
+#endif
+/*..........................................................................*/
+static void portB_BSRR(uint32_t word) { /* the mocked GPIOB->BSRR store */
+    l_portB_ODR = (l_portB_ODR & ~(word >> 16)) | (word & 0xFFFFU);
+}
+static void portC_BSRR(uint32_t word) { /* the mocked GPIOC->BSRR store */
+    l_portC_ODR = (l_portC_ODR & ~(word >> 16)) | (word & 0xFFFFU);
+}
+/*..........................................................................*/
+void BSP_pinsWrite(BSPPinSet const *set) { /* see bsp_pins.h */
+    portB_BSRR(set->bsrr[BSP_PORT_B]);
+    portC_BSRR(set->bsrr[BSP_PORT_C]);
+}
+/*..........................................................................*/
+/* BSP_ledAOn(), BSP_buttonCS0()... generated from the pin table */
+#define BSP_PIN_WRITE(port_, bsrr_) (port##port_##_BSRR(bsrr_))
+#define BSP_PIN_READ(port_)         (port##port_##_IDR())
+BSP_PINS(BSP_PIN_ACCESSOR_, ~)
+/*..........................................................................*/
+void BSP_ledSetLevel(uint8_t x, uint8_t y, uint8_t level) {
+    Q_REQUIRE((x < DISPLAY_COLS) && (y < DISPLAY_ROWS)
+              && (level <= DISPLAY_LEVEL_MAX));
+    (*Display_frame())[x][y] = level;
+    Display_swap();
+}
+
+/* button column inputs (PB4..PB7), the mocked GPIOB->IDR: a column reads
+* high when a pressed key connects it to a row that is currently driven high
+*/
+static uint32_t portB_IDR(void) {
+    uint32_t idr = l_portB_ODR;
+    uint32_t row;
+    for (row = 0U; row < KEYPAD_ROWS; ++row) {
+        if ((l_portB_ODR & (BSP_PIN_KEY_ROW0 << row)) != 0U) {
+            idr |= ((l_keys >> (row * KEYPAD_COLS)) & 0xFU) << 4;
+        }
+    }
+    return idr;
+}
+
+/*..........................................................................*/
+static uint16_t keypad_scan(void) { /* as keypad_scan() of the target BSP */
+    uint16_t keys = 0U;
+    uint32_t row;
+
+    for (row = 0U; row < KEYPAD_ROWS; ++row) {
+        portB_BSRR((BSP_KEY_ROW_PINS << 16) | (BSP_PIN_KEY_ROW0 << row));
+        keys |= (uint16_t)(((portB_IDR() >> 4) & 0xFU)
+                           << (row * KEYPAD_COLS));
+    }
+    portB_BSRR(BSP_KEY_ROW_PINS << 16); /* all rows low */
+    return keys;
+}
+/*..........................................................................*/
+static void keypad_idle(void) { /* as keypad_idle() of the target BSP */
+    portB_BSRR(BSP_KEY_ROW_PINS); /* drive all the rows high */
+    l_keypadScan = 0U;
+}
+
+/*..........................................................................*/
+uint32_t BSP_random(void) { /* a very cheap pseudo-random-number generator */
+    /* "Super-Duper" Linear Congruential Generator (LCG)
+    * LCG(2^32, 3*7*11*13*23, 0, seed)
+    */
+    l_rnd = l_rnd * (3U*7U*11U*13U*23U);
+    return l_rnd >> 8;
+}
+/*..........................................................................*/
+void BSP_randomSeed(uint32_t seed) {
+    l_rnd = seed;
+}
+/*..........................................................................*/
+void BSP_terminate(int16_t result) {
+    (void)result;
+    QF_stop(); /* stop QF and return from QF_run() to main() */
+}
+
+/* QF callbacks ============================================================*/
+void QF_onStartup(void) {
+    /* the tick thread emulates SysTick at BSP_TICKS_PER_SEC rate */
+    QF_setTickRate(BSP_TICKS_PER_SEC);
+
+#ifdef QV_RTC_STEP_TIMING
+    l_stepMax = 4096U; /* grown in step_add() when needed, see NOTE07 */
+    l_step = (StepRec *)malloc(l_stepMax * sizeof(l_step[0]));
+    Q_ASSERT(l_step != (StepRec *)0);
+    (void)clock_gettime(CLOCK_MONOTONIC, &l_wall0);
+#endif
+    if (l_replayLog != (uint8_t *)0) {
+        replay_records(); /* the wake-ups before the first tick, if any */
+    }
+}
+/*..........................................................................*/
+void QF_onCleanup(void) {
+#ifdef STIMLOG
+    StimLog_flush(); /* the last run of clock ticks */
+    rec_write();
+    (void)fclose(l_recFile);
+#endif
+#ifdef QV_RTC_STEP_TIMING
+    step_report();
+#endif
+    QS_EXIT(); /* flush and close the QS output */
+}
+/*..........................................................................*/
+void QF_onClockTick(void) { /* the "SysTick" ISR, called from tick thread */
+    uint32_t const tick = QF_getTickCtr();
+    uint32_t const skipped = tick - l_lastTick - 1U; /* see NOTE05 */
+    uint_fast8_t plane;
+#ifdef QV_RTC_STEP_TIMING
+    struct timespec t0;
+    struct timespec t1;
+    (void)clock_gettime(CLOCK_MONOTONIC, &t0);
+#endif
+
+    l_lastTick = tick;
+    QF_TICK_X(0U, &l_clock_tick); /* process time events for rate 0 */
+
+    QF_INT_DISABLE(); /* the "TIM6 ISR" refreshes one bit-plane, see NOTE04 */
+    portC_BSRR(Display_scan(&plane));
+    QF_INT_ENABLE();
+    (void)plane; /* the bit-plane periods are not mocked */
+
+    STIMLOG_TICKS(skipped); /* the idle ticks skipped in virtual time */
+    if (l_replayLog != (uint8_t *)0) { /* replaying the stimuli? */
+        replay_tick(skipped);
+    }
+    else {
+        stimuli_apply(tick);
+        if (l_keypadScan != 0U) { /* scanning burst in progress? */
+            uint16_t const keys = keypad_scan();
+            STIMLOG_SCAN(keys);
+            if (!Keypad_tick(keys)) { /* all keys released? */
+                keypad_idle();
+            }
+        }
+        else {
+            STIMLOG_TICKS(1U);
+            if ((portB_IDR() & BSP_KEY_COL_PINS) != 0U) { /* the "EXTI" */
+                uint16_t const keys = keypad_scan();
+                l_keypadScan = 1U;
+                STIMLOG_WAKE(keys);
+                (void)Keypad_tick(keys); /* the first sample right away */
+            }
+        }
+    }
+#ifdef STIMLOG
+    rec_write();
+#endif
+
+    if ((l_runTicks != 0U) && (tick == l_runTicks)) {
+        BSP_terminate(0);
+    }
+
+#if defined(Q_SPY) && !defined(QV_CPU_SLEEP)
+    QS_onFlush(); /* no QV idle loop in this port, output QS from the tick */
+#endif
+
+#ifdef QV_RTC_STEP_TIMING
+    (void)clock_gettime(CLOCK_MONOTONIC, &t1);
+    step_add(0U, 0U, (uint32_t)(((t1.tv_sec - t0.tv_sec) * 1000000000L)
+                                + (t1.tv_nsec - t0.tv_nsec)));
+#endif
+}
+#ifdef QV_CPU_SLEEP /* cooperative QV kernel? (ports/posix/qv) */
+/*..........................................................................*/
+void QV_onIdle(void) {  /* called with the QF mutex locked */
+#ifdef Q_SPY
+    uint16_t nBytes = (uint16_t)1024;
+    uint8_t const *block = QS_txBlock(&nBytes);
+
+    if (block != (uint8_t *)0) { /* any QS data to output? */
+        QF_INT_ENABLE();
+        (void)fwrite(block, 1, nBytes, l_qsFile); /* the "DMA" transfer */
+        QF_INT_DISABLE();
+        QS_txDone(); /* the "DMA transfer-complete interrupt" */
+        QF_INT_ENABLE();
+        return; /* go back to the QV loop, which re-checks the ready set */
+    }
+#endif
+    QV_CPU_SLEEP(); /* block on the QV condition variable, see NOTE02 */
+}
+#ifdef QF_VIRTUAL_TIME
+/*..........................................................................*/
+static uint32_t ticks_until(uint32_t nTicks, uint32_t now, uint32_t tick) {
+    uint32_t const limit = (tick > now) ? (tick - now) : 1U;
+    return ((nTicks == 0U) || (limit < nTicks)) ? limit : nTicks;
+}
+/*..........................................................................*/
+uint32_t QF_onVirtualIdle(uint32_t nTicks) { /* see NOTE05 */
+    uint32_t const now = QF_getTickCtr();
+
+    if (l_replayLog != (uint8_t *)0) { /* stop at the end of the run */
+        if (l_player.scan != 0U) {
+            return 1U;
+        }
+        nTicks = ticks_until(nTicks, 0U, l_player.ticks);
+    }
+    /* polling the keypad in every tick? */
+    else if ((l_keypadScan != 0U)
+             || ((portB_IDR() & BSP_KEY_COL_PINS) != 0U))
+    {
+        return 1U;
+    }
+    else if (l_stimNext < l_stimN) { /* stop at the next stimulus */
+        nTicks = ticks_until(nTicks, now, l_stim[l_stimNext].tick);
+    }
+    if (l_runTicks != 0U) { /* stop at the end of the run */
+        nTicks = ticks_until(nTicks, now, l_runTicks);
+    }
+    return nTicks;
+}
+#endif /* QF_VIRTUAL_TIME */
+#ifdef QV_RTC_STEP_TIMING
+/*..........................................................................*/
+void QV_onRtcStep(QActive const *act, QSignal sig, uint32_t ns) {
+    step_add(act->prio, sig, ns); /* see NOTE07 */
+}
+/*..........................................................................*/
+static void step_add(uint8_t prio, QSignal sig, uint32_t ns) {
+    StepRec rec;
+
+    rec.key  = ((uint64_t)prio << 48) | ((uint64_t)sig << 32) | ns;
+    rec.tick = QF_getTickCtr();
+    if (l_stepN == l_stepMax) { /* grown outside the lock, see NOTE07 */
+        l_stepMax *= 2U;
+        l_step = (StepRec *)realloc(l_step, l_stepMax * sizeof(l_step[0]));
+        Q_ASSERT(l_step != (StepRec *)0);
+    }
+    QF_INT_DISABLE(); /* the RTC steps and the clock tick, see NOTE07 */
+    l_step[l_stepN] = rec;
+    ++l_stepN;
+    QF_INT_ENABLE();
+}
+/*..........................................................................*/
+static int step_cmp(void const *a, void const *b) {
+    uint64_t const x = ((StepRec const *)a)->key;
+    uint64_t const y = ((StepRec const *)b)->key;
+    return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+/*..........................................................................*/
+static void step_row(char const *name, StepRec const *s, uint32_t n) {
+    uint64_t total = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < n; ++i) {
+        total += (uint32_t)s[i].key;
+    }
+    printf("steps: %-9s %9u %11.1f %8u %8u %8u %8u\n", name,
+           (unsigned)n, (double)total / 1000.0,
+           (unsigned)(uint32_t)s[0].key,
+           (unsigned)(uint32_t)s[(n - 1U) / 2U].key,
+           (unsigned)(uint32_t)s[(uint32_t)(((uint64_t)(n - 1U) * 99U)
+                                            / 100U)].key,
+           (unsigned)(uint32_t)s[n - 1U].key);
+}
+/*..........................................................................*/
+static void step_report(void) { /* the RTC steps by priority and signal */
+    struct timespec t;
+    char const *env = getenv("BSP_STEP_FILE");
+    uint32_t i;
+    uint32_t j;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &t);
+    if (env != (char const *)0) { /* every step as CSV, in the run order */
+        FILE *f = fopen(env, "w");
+        if (f != (FILE *)0) {
+            for (i = 0U; i < l_stepN; ++i) {
+                uint64_t const key = l_step[i].key;
+                fprintf(f, "%u,%u,%u,%u\n", (unsigned)l_step[i].tick,
+                        (unsigned)(key >> 48),
+                        (unsigned)((key >> 32) & 0xFFFFU),
+                        (unsigned)(uint32_t)key);
+            }
+            (void)fclose(f);
+        }
+    }
+    printf("steps: %u ticks (%.2f s) in %.3f s of wall-clock time\n",
+           (unsigned)QF_getTickCtr(),
+           (double)QF_getTickCtr() / (double)BSP_TICKS_PER_SEC,
+           (double)(t.tv_sec - l_wall0.tv_sec)
+           + ((double)(t.tv_nsec - l_wall0.tv_nsec) / 1e9));
+    printf("steps: %-9s %9s %11s %8s %8s %8s %8s\n", "prio:sig",
+           "count", "total[us]", "min[ns]", "p50[ns]", "p99[ns]", "max[ns]");
+    if (l_stepN == 0U) {
+        return;
+    }
+
+    /* sorted by the priority, the signal and the duration */
+    qsort(l_step, l_stepN, sizeof(l_step[0]), &step_cmp);
+    for (i = 0U; i < l_stepN; i = j) {
+        char name[16];
+        uint64_t const key = l_step[i].key >> 32;
+
+        for (j = i + 1U; (j < l_stepN) && ((l_step[j].key >> 32) == key);
+             ++j)
+        {
+        }
+        if (key == 0U) { /* the clock tick "ISR" */
+            (void)snprintf(name, sizeof(name), "tick");
+        }
+        else {
+            (void)snprintf(name, sizeof(name), "%u:%u",
+                           (unsigned)(key >> 16), (unsigned)(key & 0xFFFFU));
+        }
+        step_row(name, &l_step[i], j - i);
+    }
+
+    /* all the RTC steps together, without the clock ticks */
+    for (i = 0U, j = 0U; i < l_stepN; ++i) {
+        if ((l_step[i].key >> 48) != 0U) {
+            l_step[j].key = (uint32_t)l_step[i].key;
+            ++j;
+        }
+    }
+    if (j != 0U) {
+        qsort(l_step, j, sizeof(l_step[0]), &step_cmp);
+        step_row("all", l_step, j);
+    }
+    free(l_step);
+}
+#endif /* QV_RTC_STEP_TIMING */
+#endif /* QV_CPU_SLEEP */
+
+/*..........................................................................*/
+void Q_onAssert(char_t const Q_ROM * const module, int_t location) {
+    /* NOTE: might be called with the QF mutex locked, so no QS output */
+    fprintf(stderr, "Assertion failed in %s:%d\n", module, (int)location);
+    exit(-1);
+}
+
+/* QS callbacks ============================================================*/
+#ifdef Q_SPY
+/*..........................................................................*/
+uint8_t QS_onStartup(void const *arg) {
+    static uint8_t qsBuf[64*1024]; /* buffer for Quantum Spy */
+    char const *fname = getenv("BSP_QS_FILE");
+
+    (void)arg; /* avoid the "unused parameter" compiler warning */
+    QS_initBuf(qsBuf, sizeof(qsBuf));
+
+    if (fname == (char const *)0) {
+        fname = "qs.bin";
+    }
+    l_qsFile = fopen(fname, "wb");
+    if (l_qsFile == (FILE *)0) {
+        return (uint8_t)0; /* return failure */
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &l_t0);
+
+    /* the host has enough bandwidth to trace everything */
+    QS_FILTER_ON(QS_ALL_RECORDS);
+
+    return (uint8_t)1; /* return success */
+}
+/*..........................................................................*/
+void QS_onCleanup(void) {
+    if (l_qsFile != (FILE *)0) {
+        QS_onFlush();
+        (void)fclose(l_qsFile);
+        l_qsFile = (FILE *)0;
+        if (QS_getDropped() != 0U) {
+            fprintf(stderr, "QS: %lu bytes lost by the buffer overruns\n",
+                    (unsigned long)QS_getDropped());
+        }
+    }
+}
+/*..........................................................................*/
+QSTimeCtr QS_onGetTime(void) { /* NOTE: invoked with the QF mutex locked */
+#ifdef QF_VIRTUAL_TIME
+    /* nanoseconds of the virtual time, reproducible, see NOTE05 */
+    return (QSTimeCtr)((uint64_t)QF_getTickCtr()
+                       * (1000000000U / BSP_TICKS_PER_SEC));
+#else
+    struct timespec t;
+    (void)clock_gettime(CLOCK_MONOTONIC, &t);
+    /* nanoseconds since QS_onStartup(), wrapping around every ~4.3s */
+    return (QSTimeCtr)(((uint64_t)(t.tv_sec - l_t0.tv_sec) * 1000000000U)
+                       + (uint64_t)t.tv_nsec - (uint64_t)l_t0.tv_nsec);
+#endif
+}
+/*..........................................................................*/
+void QS_onFlush(void) {
+    uint16_t nBytes;
+    uint8_t const *block;
+
+    if (l_qsFile == (FILE *)0) {
+        return;
+    }
+    QF_INT_DISABLE();
+    for (;;) {
+        nBytes = (uint16_t)1024;
+        block = QS_txBlock(&nBytes);
+        if (block == (uint8_t *)0) { /* End-Of-Data? */
+            break;
+        }
+        QF_INT_ENABLE();
+        (void)fwrite(block, 1, nBytes, l_qsFile);
+        QF_INT_DISABLE();
+        QS_txDone();
+    }
+    QF_INT_ENABLE();
+    (void)fflush(l_qsFile);
+}
+#endif /* Q_SPY */
+/*--------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* NOTE00:
+* The host BSP keeps the exact polarity of the NUCLEO-L053R8 wiring: the LED
+* rows 0..7 (PC0..PC7) are active high, the LED columns A..E (PC8..PC12) are
+* active low, and the button rows (PB0..PB3) are driven high one at a time
+* while the columns (PB4..PB7) are read back. Only the output data registers
+* are mocked, and the input data register of the columns is computed from
+* the driven rows and the pressed keys, which is enough for the application
+* code in ButtonFunctions.c, the keypad scan and the LED refresh to run
+* unmodified.
+*
+* NOTE01:
+* The main() of the application takes no arguments, so the host build is
+* configured through the environment: BSP_RUN_TICKS=<n> stops QF_run() after
+* n clock ticks (useful for perf, sanitizer and benchmark runs), BSP_KEYS is
+* a bitmask of the pressed keys, or a list of <tick>:<keys> stimuli that
+* change the pressed keys in the given clock ticks (e.g. "100:0x21,140:0"),
+* and BSP_QS_FILE names the binary QS output file in the Q_SPY build
+* configuration (default qs.bin). BSP_REPLAY, BSP_REC_FILE and
+* BSP_STEP_FILE are described in NOTE06 and NOTE07.
+*
+* NOTE02:
+* QV_onIdle() is called with the QF_pThreadMutex_ locked ("interrupts
+* disabled"). QV_CPU_SLEEP() atomically unlocks the mutex and blocks until
+* the next event is posted, which is the equivalent of the WFI instruction.
+* In the Q_SPY configuration the QS data is written out first and the idle
+* callback returns without blocking until the QS buffer is drained. The
+* blocks are written directly from the QS buffer with QS_txBlock() and
+* QS_txDone(), in the same way as the DMA output of the target BSP. The
+* thread-per-AO port (ports/posix/mt) has no idle loop, so there the QS data
+* is written out from the clock tick instead.
+*
+* NOTE03:
+* The keypad idle mode of the target BSP is mocked as well: between the
+* scanning bursts all the rows are driven high, and the EXTI interrupt on
+* the rising edge of a column is replaced by checking the columns in the
+* clock tick, which then starts the burst exactly as the EXTI4_15 interrupt
+* of the target does.
+*
+* NOTE04:
+* The LED matrix refresh of the target (the TIM6 interrupt with the
+* binary code modulation) is mocked by refreshing one bit-plane of a column
+* in every clock tick, with the same GPIOC->BSRR words applied to the
+* mocked output data register, but without the doubling periods of the
+* bit-planes. The mutex stands for the masked interrupt of the target.
+*
+* NOTE05:
+* With the virtual time of the QV port (make VTIME=1, QF_VIRTUAL_TIME) the
+* clock jumps over the idle ticks to the next time event, so
+* QF_onVirtualIdle() stops it earlier at the next BSP_KEYS stimulus, at the
+* end of every replayed run of ticks and at the end of BSP_RUN_TICKS, and
+* keeps it ticking one by one as long as the keypad is polled (a pressed
+* key, a scanning burst or a replayed run of keypad scans). The LED refresh is
+* not run in the skipped ticks. The QS time stamps are the virtual time,
+* so the runs, including their QS traces, are exactly reproducible.
+*
+* NOTE06:
+* The stimuli enter the application only in the clock tick: QF_TICK_X()
+* and, during a scanning burst or at the "EXTI", the keypad sample passed
+* to Keypad_tick(). With STIMLOG (make REC=1) they are recorded with
+* stimlog.c into BSP_REC_FILE (default stim.log), just as the ISRs of the
+* target BSP record them. With BSP_REPLAY=<log> the key matrix mock and
+* BSP_KEYS are bypassed, and the recorded samples are passed to
+* Keypad_tick() in the same ticks instead, so the active objects get the
+* same events in the same order as in the recorded session, whether it
+* was recorded on the target or on the host. The replay ends with the log.
+* A replay in a REC=1 build records the same log again.
+*
+* NOTE07:
+* With QV_RTC_STEP_TIMING (make REPLAY=1, which also implies VTIME=1) the
+* QV port times every RTC step (see NOTE6 in qf_port.h) and the clock tick
+* times itself, from which QF_onCleanup() prints the count, the total and
+* the min/median/99th percentile/max of the durations per priority and
+* signal ("prio:sig", "tick" for the clock tick). BSP_STEP_FILE=<file>
+* also writes every step as a CSV line "tick,prio,sig,ns". The steps are
+* collected in memory and only sorted and written out in QF_onCleanup(),
+* so during the run every step costs one 16-byte store to l_step[] under
+* the QF mutex. The buffer is preallocated in QF_onStartup() and doubled
+* when full, before the mutex is locked. This is safe, because the steps
+* are only ever added from the QV thread: the virtual time of REPLAY=1 has
+* no tick thread.
+*/
@@ -0,0 +1,1110 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, register-level STM32L053 simulator, POSIX host
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* Runs the unmodified target BSP (myBoardSupport/bsp.c) on the host. The
+* peripheral registers are memory mapped at their target addresses, and the
+* accesses to GPIO, SYSCFG/EXTI, TIM6, USART2, DMA1, SysTick, NVIC and SCB
+* are trapped and simulated: a virtual 4x4 key matrix driven by the rows
+* PB0..PB3, a virtual 5x8 LED matrix decoded from PC0..PC12 and a USART2
+* sink. The interrupts are delivered to the main thread ("the CPU") as
+* signals, see NOTE1..NOTE4. Built with "make SIM=1" (x86-64 Linux only).
+*****************************************************************************/
+#define _GNU_SOURCE  /* for memfd_create(), REG_EFL and REG_ERR */
+
+#include "qpc.h"
+#include "bsp.h"
+#include "bsp_pins.h"
+#include "stimlog.h"
+
+#include "stm32l0xx.h"  /* CMSIS-compliant header file for the MCU used */
+
+#include <errno.h>      /* for errno */
+#include <pthread.h>    /* for pthread_create(), pthread_kill() */
+#include <semaphore.h>  /* for sem_post(), async-signal-safe */
+#include <signal.h>     /* for sigaction() */
+#include <stddef.h>     /* for offsetof() */
+#include <stdio.h>      /* for fprintf() and the USART2 sink file */
+#include <stdlib.h>     /* for getenv(), strtoul(), exit() */
+#include <string.h>     /* for memset() */
+#include <sys/mman.h>   /* for mmap(), mprotect(), memfd_create() */
+#include <time.h>       /* for clock_gettime() */
+#include <ucontext.h>   /* for the trap flag, see NOTE2 */
+#include <unistd.h>     /* for ftruncate() */
+
+#if !defined(__x86_64__) || !defined(__linux__)
+    #error "the simulator traps the register accesses on x86-64 Linux only"
+#endif
+
+/* the target ISRs in bsp.c, the DMA1 one only in the Q_SPY configuration */
+void SysTick_Handler(void);
+void EXTI4_15_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
+void DMA1_Channel4_5_6_7_IRQHandler(void) __attribute__((weak));
+
+/* Local-scope defines -----------------------------------------------------*/
+#define SIM_IRQ_SIG     SIGUSR1  /* the "interrupt line" of the CPU */
+#define SIM_PAGE        0x1000U  /* the trapping granularity [bytes] */
+#define SIM_KICK_NS     20000L   /* retry of a masked interrupt [ns] */
+#define SIM_MAX_STIM    64U      /* the most BSP_KEYS stimuli */
+#define EFL_TF          0x100    /* the trap flag of the x86 EFLAGS */
+#define ERR_WRITE       0x2      /* the write bit of the page-fault code */
+
+/* the view of the simulator on the registers, which never traps */
+#define SIM(p_) ((__typeof__(p_))sim_view((uint32_t)(uintptr_t)(p_)))
+
+/* the address regions of the target mapped on the host, see NOTE1 */
+typedef struct {
+    uint32_t base;   /* target address */
+    uint32_t size;   /* [bytes], a multiple of SIM_PAGE */
+} SimRegion;
+
+static SimRegion const l_region[] = {
+    { PERIPH_BASE,    0x00030000U },  /* APB1, APB2, AHB */
+    { IOPPERIPH_BASE, 0x00002000U },  /* GPIOA..GPIOH */
+    { SCS_BASE,       0x00001000U }   /* SysTick, NVIC, SCB */
+};
+#define SIM_REGIONS (sizeof(l_region) / sizeof(l_region[0]))
+
+/* the trapped peripherals, see NOTE2 */
+typedef struct {
+    char const *name;
+    uint32_t base;   /* target address of the registers */
+    uint32_t size;   /* [bytes] */
+    void (*read)(uint32_t off);  /* refresh before any access */
+    void (*access)(uint32_t off, uint32_t old, uint32_t val, bool write);
+    uint32_t reads;  /* statistics */
+    uint32_t writes;
+} SimPeriph;
+
+static void gpio_read(uint32_t off, uint_fast8_t port);
+static void gpio_access(uint32_t off, uint32_t val, uint_fast8_t port);
+static void gpioA_read(uint32_t off) { gpio_read(off, 0U); }
+static void gpioB_read(uint32_t off) { gpio_read(off, 1U); }
+static void gpioC_read(uint32_t off) { gpio_read(off, 2U); }
+static void gpioA_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write);
+static void gpioB_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write);
+static void gpioC_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write);
+static void syscfg_access(uint32_t off, uint32_t old, uint32_t val,
+                          bool write);
+static void exti_access(uint32_t off, uint32_t old, uint32_t val,
+                        bool write);
+static void usart_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write);
+static void dma_access(uint32_t off, uint32_t old, uint32_t val,
+                       bool write);
+static void systick_read(uint32_t off);
+static void systick_access(uint32_t off, uint32_t old, uint32_t val,
+                           bool write);
+static void nvic_read(uint32_t off);
+static void nvic_access(uint32_t off, uint32_t old, uint32_t val,
+                        bool write);
+
+static SimPeriph l_periph[] = {
+    { "GPIOA",   GPIOA_BASE,   0x400U, &gpioA_read, &gpioA_access, 0U, 0U },
+    { "GPIOB",   GPIOB_BASE,   0x400U, &gpioB_read, &gpioB_access, 0U, 0U },
+    { "GPIOC",   GPIOC_BASE,   0x400U, &gpioC_read, &gpioC_access, 0U, 0U },
+    { "SYSCFG",  SYSCFG_BASE,  0x400U, 0, &syscfg_access, 0U, 0U },
+    { "EXTI",    EXTI_BASE,    0x400U, 0, &exti_access, 0U, 0U },
+    { "TIM6",    TIM6_BASE,    0x400U, 0, 0, 0U, 0U },
+    { "USART2",  USART2_BASE,  0x400U, 0, &usart_access, 0U, 0U },
+    { "DMA1",    DMA1_BASE,    0x400U, 0, &dma_access, 0U, 0U },
+    { "SysTick", SysTick_BASE, (uint32_t)sizeof(SysTick_Type),
+      &systick_read, &systick_access, 0U, 0U },
+    { "NVIC",    NVIC_BASE,    (uint32_t)sizeof(NVIC_Type),
+      &nvic_read, &nvic_access, 0U, 0U },
+    { "SCB",     SCB_BASE,     (uint32_t)sizeof(SCB_Type), 0, 0, 0U, 0U }
+};
+#define SIM_PERIPHS (sizeof(l_periph) / sizeof(l_periph[0]))
+
+/* the simulated interrupts in the order of the exception numbers */
+enum SimIsrs {
+    ISR_SYSTICK,
+    ISR_EXTI4_15,
+    ISR_DMA1_CH4_7,
+    ISR_TIM6_DAC,
+    ISR_MAX,
+    CTX_THREAD = ISR_MAX  /* the statistics context of the thread code */
+};
+
+typedef struct {
+    char const *name;
+    void (*handler)(void);
+    int_fast8_t irq;   /* IRQn_Type */
+} SimIsr;
+
+static SimIsr const l_isr[ISR_MAX] = {
+    { "SysTick",  &SysTick_Handler,                SysTick_IRQn },
+    { "EXTI4_15", &EXTI4_15_IRQHandler,            EXTI4_15_IRQn },
+    { "DMA1_CH4", &DMA1_Channel4_5_6_7_IRQHandler, DMA1_Channel4_5_6_7_IRQn },
+    { "TIM6_DAC", &TIM6_DAC_IRQHandler,            TIM6_DAC_IRQn }
+};
+
+/* the statistics of the interrupts and of the thread code */
+typedef struct {
+    uint32_t calls;
+    uint32_t accesses;    /* trapped register accesses */
+    uint32_t maxAccesses; /* the most accesses in one call */
+    uint64_t ns;          /* host time, including the traps */
+} SimStat;
+
+static SimStat l_stat[ISR_MAX + 1U];
+static uint_fast8_t l_ctx = CTX_THREAD; /* the running context */
+
+/* the memory behind the registers and the access in progress */
+static uint8_t *l_view;    /* the whole backing memory, never protected */
+static struct {
+    uintptr_t page;        /* the unprotected page, 0 if none */
+    uint32_t addr;         /* target address of the accessed word */
+    uint32_t old;          /* its value before the access */
+    SimPeriph *periph;     /* 0 for the other registers of the page */
+    bool write;
+    bool irqBlocked;       /* SIM_IRQ_SIG blocked before the access? */
+} l_step;
+
+/* the interrupt delivery, see NOTE3 */
+static pthread_t l_cpu;           /* the main thread */
+static sem_t l_kick;              /* posted when an interrupt is pended */
+static uint32_t volatile l_pend;  /* pending interrupts, by SimIsrs */
+static uint32_t l_nvicEnabled;    /* NVIC->ISER, by IRQn */
+static bool volatile l_halted;    /* the CPU stopped at exit? */
+
+/* the virtual time [CPU clocks] and the clock tick, see NOTE4 */
+static uint64_t l_now;
+static uint64_t l_tim6Next;       /* the next TIM6 update event */
+static bool l_tim6Run;
+static uint32_t l_ticks;          /* SysTick interrupts so far */
+static uint32_t l_hostTicks;      /* reloads from the tick thread */
+static uint32_t l_runTicks;       /* number of ticks to run (0 == forever) */
+static uint64_t volatile l_reloadNs; /* host time of the last reload */
+
+/* the virtual board */
+static uint32_t l_keys;           /* bit (4*row + column) when pressed */
+static struct {
+    uint32_t tick;
+    uint32_t keys;
+} l_stim[SIM_MAX_STIM];           /* the BSP_KEYS stimuli */
+static uint_fast8_t l_stimN;
+static uint_fast8_t l_stimNext;
+static uint32_t l_extiLevel;      /* the EXTI line inputs */
+static uint8_t  l_ledRows[5];     /* the lit rows of the columns A..E */
+static uint64_t l_ledLit[5][8];   /* the lit time of the LEDs [clocks] */
+static uint64_t l_ledSince;       /* the last change of the LED matrix */
+static FILE    *l_usartFile;      /* SIM_USART sink, if any */
+static uint32_t l_usartBytes;
+
+static void irq_pend(uint_fast8_t isr);
+static void exti_update(void);
+static uint64_t host_ns(void);
+
+/*..........................................................................*/
+static void *sim_view(uint32_t addr) { /* the simulator view of a register */
+    size_t offset = 0U;
+    uint_fast8_t i;
+
+    for (i = 0U; i < SIM_REGIONS; ++i) {
+        if ((addr - l_region[i].base) < l_region[i].size) {
+            return &l_view[offset + (addr - l_region[i].base)];
+        }
+        offset += l_region[i].size;
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static SimPeriph *periph_at(uint32_t addr) {
+    uint_fast8_t i;
+    for (i = 0U; i < SIM_PERIPHS; ++i) {
+        if ((addr - l_periph[i].base) < l_periph[i].size) {
+            return &l_periph[i];
+        }
+    }
+    return (SimPeriph *)0;
+}
+/*..........................................................................*/
+static bool page_trapped(uintptr_t page) {
+    uint_fast8_t i;
+    for (i = 0U; i < SIM_PERIPHS; ++i) {
+        if ((l_periph[i].base & ~(SIM_PAGE - 1U)) == page) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* the register access traps, see NOTE2 ====================================*/
+static void bus_fault(int sig, siginfo_t *info, void *context) {
+    ucontext_t *uc = (ucontext_t *)context;
+    uintptr_t const addr = (uintptr_t)info->si_addr;
+    uintptr_t const page = addr & ~(uintptr_t)(SIM_PAGE - 1U);
+    int const err = errno;
+
+    if ((addr > 0xFFFFFFFFU) || !page_trapped(page) || (l_step.page != 0U)) {
+        (void)signal(sig, SIG_DFL); /* a genuine crash, fault again */
+        return;
+    }
+    l_step.page   = page;
+    l_step.addr   = (uint32_t)addr & ~3U;
+    l_step.periph = periph_at(l_step.addr);
+    if ((l_step.periph != (SimPeriph *)0)
+        && (l_step.periph->read != 0))
+    {
+        (*l_step.periph->read)(l_step.addr - l_step.periph->base);
+    }
+    l_step.old   = *(uint32_t *)sim_view(l_step.addr);
+    l_step.write = ((uc->uc_mcontext.gregs[REG_ERR] & ERR_WRITE) != 0);
+
+    /* let the access through and trap right after it */
+    (void)mprotect((void *)page, SIM_PAGE, PROT_READ | PROT_WRITE);
+    uc->uc_mcontext.gregs[REG_EFL] |= EFL_TF;
+    l_step.irqBlocked = (sigismember(&uc->uc_sigmask, SIM_IRQ_SIG) == 1);
+    (void)sigaddset(&uc->uc_sigmask, SIM_IRQ_SIG);
+    errno = err;
+}
+/*..........................................................................*/
+static void bus_step(int sig, siginfo_t *info, void *context) {
+    ucontext_t *uc = (ucontext_t *)context;
+    SimPeriph *p = l_step.periph;
+    uint32_t val;
+    bool write;
+    int const err = errno;
+
+    (void)info;
+    if (l_step.page == 0U) { /* not a step of a register access? */
+        (void)signal(sig, SIG_DFL);
+        (void)raise(sig);
+        return;
+    }
+    (void)mprotect((void *)l_step.page, SIM_PAGE, PROT_NONE);
+    uc->uc_mcontext.gregs[REG_EFL] &= ~EFL_TF;
+    if (!l_step.irqBlocked) {
+        (void)sigdelset(&uc->uc_sigmask, SIM_IRQ_SIG);
+    }
+    l_step.page = 0U;
+
+    val   = *(uint32_t *)sim_view(l_step.addr);
+    write = l_step.write || (val != l_step.old);
+    ++l_stat[l_ctx].accesses;
+    if (p != (SimPeriph *)0) {
+        if (write) {
+            ++p->writes;
+        }
+        else {
+            ++p->reads;
+        }
+        if (p->access != 0) {
+            (*p->access)(l_step.addr - p->base, l_step.old, val, write);
+        }
+    }
+    errno = err;
+}
+
+/* the virtual board =======================================================*/
+static GPIO_TypeDef *gpio_port(uint_fast8_t port) {
+    static GPIO_TypeDef * const gpio[] = { GPIOA, GPIOB, GPIOC };
+    return SIM(gpio[port]);
+}
+/*..........................................................................*/
+static uint32_t gpio_mode(GPIO_TypeDef const *gpio, uint32_t mode) {
+    uint32_t pins = 0U;
+    uint_fast8_t pin;
+    for (pin = 0U; pin < 16U; ++pin) {
+        if (((gpio->MODER >> (2U * pin)) & 3U) == mode) {
+            pins |= (1U << pin);
+        }
+    }
+    return pins;
+}
+/*..........................................................................*/
+static uint32_t key_columns(void) { /* the columns driven by the keys */
+    GPIO_TypeDef const *gpio = gpio_port(1U);
+    uint32_t const rows = gpio->ODR & gpio_mode(gpio, BSP_MODE_OUT)
+                          & BSP_KEY_ROW_PINS;
+    uint32_t cols = 0U;
+    uint_fast8_t row;
+
+    for (row = 0U; row < 4U; ++row) {
+        if ((rows & ((uint32_t)BSP_PIN_KEY_ROW0 << row)) != 0U) {
+            cols |= (l_keys >> (4U * row)) & 0xFU;
+        }
+    }
+    return cols * (uint32_t)BSP_PIN_KEY_COL0;
+}
+/*..........................................................................*/
+static uint32_t gpio_idr(uint_fast8_t port) {
+    GPIO_TypeDef const *gpio = gpio_port(port);
+    uint32_t const out = gpio_mode(gpio, BSP_MODE_OUT);
+    uint32_t const in  = gpio_mode(gpio, BSP_MODE_IN);
+    uint32_t pullUp = 0U;
+    uint_fast8_t pin;
+    uint32_t idr;
+
+    for (pin = 0U; pin < 16U; ++pin) {
+        if (((gpio->PUPDR >> (2U * pin)) & 3U) == BSP_PULL_UP) {
+            pullUp |= (1U << pin);
+        }
+    }
+    idr = (gpio->ODR & out) | (pullUp & in);
+    if (port == 1U) { /* the key matrix */
+        idr |= key_columns() & in;
+    }
+    return idr;
+}
+/*..........................................................................*/
+static void led_update(void) { /* the LED matrix after a GPIOC change */
+    GPIO_TypeDef const *gpio = gpio_port(2U);
+    uint32_t const out  = gpio_mode(gpio, BSP_MODE_OUT);
+    uint32_t const rows = (gpio->ODR & out & BSP_LED_ROW_PINS)
+                          / (uint32_t)BSP_PIN_LED_ROW0;
+    uint32_t const cols = (~gpio->ODR & out & BSP_LED_COL_PINS)
+                          / (uint32_t)BSP_PIN_LED_COLA;
+    uint_fast8_t col;
+    uint_fast8_t row;
+
+    for (col = 0U; col < 5U; ++col) {
+        for (row = 0U; row < 8U; ++row) {
+            if ((l_ledRows[col] & (1U << row)) != 0U) {
+                l_ledLit[col][row] += l_now - l_ledSince;
+            }
+        }
+        l_ledRows[col] = (uint8_t)(((cols & (1U << col)) != 0U) ? rows : 0U);
+    }
+    l_ledSince = l_now;
+}
+/*..........................................................................*/
+static void gpio_read(uint32_t off, uint_fast8_t port) {
+    if (off == offsetof(GPIO_TypeDef, IDR)) {
+        gpio_port(port)->IDR = gpio_idr(port);
+    }
+}
+/*..........................................................................*/
+static void gpio_access(uint32_t off, uint32_t val, uint_fast8_t port) {
+    GPIO_TypeDef *gpio = gpio_port(port);
+
+    switch (off) {
+        case offsetof(GPIO_TypeDef, BSRR): { /* the set takes precedence */
+            gpio->ODR  = (gpio->ODR & ~(val >> 16)) | (val & 0xFFFFU);
+            gpio->BSRR = 0U;
+            break;
+        }
+        case offsetof(GPIO_TypeDef, BRR): {
+            gpio->ODR &= ~(val & 0xFFFFU);
+            gpio->BRR  = 0U;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    gpio->ODR &= 0xFFFFU;
+    if (port == 2U) {
+        led_update();
+    }
+    exti_update();
+}
+/*..........................................................................*/
+static void gpioA_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write)
+{
+    (void)old;
+    if (write) {
+        gpio_access(off, val, 0U);
+    }
+}
+/*..........................................................................*/
+static void gpioB_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write)
+{
+    (void)old;
+    if (write) {
+        gpio_access(off, val, 1U);
+    }
+}
+/*..........................................................................*/
+static void gpioC_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write)
+{
+    (void)old;
+    if (write) {
+        gpio_access(off, val, 2U);
+    }
+}
+/*..........................................................................*/
+static void exti_eval(void) { /* the EXTI4_15 interrupt request */
+    EXTI_TypeDef const *exti = SIM(EXTI);
+    if ((exti->PR & exti->IMR & 0xFFF0U) != 0U) {
+        irq_pend(ISR_EXTI4_15);
+    }
+}
+/*..........................................................................*/
+static void exti_update(void) { /* the edges on the EXTI lines 0..15 */
+    SYSCFG_TypeDef const *syscfg = SIM(SYSCFG);
+    EXTI_TypeDef *exti = SIM(EXTI);
+    uint32_t idr[3];
+    uint32_t level = 0U;
+    uint32_t edges;
+    uint_fast8_t line;
+
+    idr[0] = gpio_idr(0U);
+    idr[1] = gpio_idr(1U);
+    idr[2] = gpio_idr(2U);
+    for (line = 0U; line < 16U; ++line) {
+        uint32_t const port = (syscfg->EXTICR[line >> 2]
+                               >> (4U * (line & 3U))) & 0xFU;
+        if (port < 3U) {
+            level |= idr[port] & (1U << line);
+        }
+    }
+    edges = ((level & ~l_extiLevel) & exti->RTSR)
+            | ((~level & l_extiLevel) & exti->FTSR);
+    l_extiLevel = level;
+    exti->PR |= edges;
+    exti_eval();
+}
+/*..........................................................................*/
+static void syscfg_access(uint32_t off, uint32_t old, uint32_t val,
+                          bool write)
+{
+    (void)off;
+    (void)old;
+    (void)val;
+    if (write) { /* SYSCFG->EXTICR might select other ports */
+        exti_update();
+    }
+}
+/*..........................................................................*/
+static void exti_access(uint32_t off, uint32_t old, uint32_t val,
+                        bool write)
+{
+    EXTI_TypeDef *exti = SIM(EXTI);
+
+    if (!write) {
+        return;
+    }
+    if (off == offsetof(EXTI_TypeDef, PR)) {
+        exti->PR = old & ~val; /* write 1 to clear */
+    }
+    else if (off == offsetof(EXTI_TypeDef, SWIER)) {
+        exti->PR |= val;
+        exti->SWIER = 0U;
+    }
+    exti_eval();
+}
+/*..........................................................................*/
+static void usart_tx(uint8_t const *data, uint32_t n) {
+    USART_TypeDef const *usart = SIM(USART2);
+    if ((usart->CR1 & (USART_CR1_UE | USART_CR1_TE))
+        == (USART_CR1_UE | USART_CR1_TE))
+    {
+        if (l_usartFile != (FILE *)0) {
+            (void)fwrite(data, 1, n, l_usartFile);
+        }
+        l_usartBytes += n;
+    }
+}
+/*..........................................................................*/
+static void usart_access(uint32_t off, uint32_t old, uint32_t val,
+                         bool write)
+{
+    USART_TypeDef *usart = SIM(USART2);
+
+    if (!write) {
+        return;
+    }
+    if (off == offsetof(USART_TypeDef, TDR)) {
+        uint8_t const byte = (uint8_t)val;
+        usart_tx(&byte, 1U);
+    }
+    else if (off == offsetof(USART_TypeDef, ISR)) { /* read-only */
+        usart->ISR = old;
+    }
+}
+/*..........................................................................*/
+static void dma_eval(void) { /* the DMA1_Channel4_5_6_7 interrupt request */
+    if (((SIM(DMA1)->ISR & DMA_ISR_TCIF4) != 0U)
+        && ((SIM(DMA1_Channel4)->CCR & DMA_CCR_TCIE) != 0U))
+    {
+        irq_pend(ISR_DMA1_CH4_7);
+    }
+}
+/*..........................................................................*/
+static void dma_ch4(void) { /* the whole transfer of the channel 4 at once */
+    DMA_Channel_TypeDef *ch = SIM(DMA1_Channel4);
+
+    if (((ch->CCR & DMA_CCR_DIR) != 0U)
+        && (ch->CPAR == (uint32_t)(uintptr_t)&USART2->TDR)
+        && ((SIM(USART2)->CR3 & USART_CR3_DMAT) != 0U))
+    {
+        usart_tx((uint8_t const *)(uintptr_t)ch->CMAR, ch->CNDTR & 0xFFFFU);
+    }
+    ch->CNDTR = 0U;
+    SIM(DMA1)->ISR |= (DMA_ISR_GIF4 | DMA_ISR_TCIF4);
+    dma_eval();
+}
+/*..........................................................................*/
+static void dma_access(uint32_t off, uint32_t old, uint32_t val,
+                       bool write)
+{
+    DMA_TypeDef *dma = SIM(DMA1);
+
+    if (!write) {
+        return;
+    }
+    if (off == offsetof(DMA_TypeDef, IFCR)) {
+        uint32_t clear = val;
+        uint_fast8_t ch;
+        for (ch = 0U; ch < 7U; ++ch) { /* CGIFx clears all the flags */
+            if ((val & (1U << (4U * ch))) != 0U) {
+                clear |= (0xFU << (4U * ch));
+            }
+        }
+        dma->ISR &= ~clear;
+        dma->IFCR = 0U;
+    }
+    else if (off == offsetof(DMA_TypeDef, ISR)) { /* read-only */
+        dma->ISR = old;
+    }
+    else if (off == (DMA1_Channel4_BASE - DMA1_BASE)) { /* CCR4 */
+        if (((val & ~old) & DMA_CCR_EN) != 0U) {
+            dma_ch4();
+        }
+    }
+}
+/*..........................................................................*/
+static void systick_read(uint32_t off) {
+    SysTick_Type *st = SIM(SysTick);
+
+    if (off == offsetof(SysTick_Type, VAL)) { /* down-counting since reload */
+        uint64_t const period = 1000000000U / BSP_TICKS_PER_SEC;
+        uint64_t elapsed = host_ns() - l_reloadNs;
+        uint32_t const load = st->LOAD & 0xFFFFFFU;
+
+        if (elapsed > period) {
+            elapsed = period;
+        }
+        st->VAL = load - (uint32_t)((elapsed * load) / period);
+    }
+}
+/*..........................................................................*/
+static void systick_access(uint32_t off, uint32_t old, uint32_t val,
+                           bool write)
+{
+    SysTick_Type *st = SIM(SysTick);
+
+    if (off == offsetof(SysTick_Type, CTRL)) {
+        if (!write) { /* the COUNTFLAG clears on read */
+            (void)__atomic_and_fetch(&st->CTRL,
+                                     ~SysTick_CTRL_COUNTFLAG_Msk,
+                                     __ATOMIC_SEQ_CST);
+        }
+        else if (((val & ~old) & SysTick_CTRL_ENABLE_Msk) != 0U) {
+            l_reloadNs = host_ns();
+        }
+    }
+    else if ((off == offsetof(SysTick_Type, VAL)) && write) {
+        (void)__atomic_and_fetch(&st->CTRL, ~SysTick_CTRL_COUNTFLAG_Msk,
+                                 __ATOMIC_SEQ_CST);
+        l_reloadNs = host_ns();
+    }
+}
+/*..........................................................................*/
+static void nvic_read(uint32_t off) {
+    NVIC_Type *nvic = SIM(NVIC);
+
+    if ((off == offsetof(NVIC_Type, ISPR))
+        || (off == offsetof(NVIC_Type, ICPR)))
+    {
+        uint32_t pend = 0U;
+        uint_fast8_t i;
+        for (i = ISR_EXTI4_15; i < ISR_MAX; ++i) {
+            if ((l_pend & (1U << i)) != 0U) {
+                pend |= (1U << l_isr[i].irq);
+            }
+        }
+        nvic->ISPR[0] = pend;
+        nvic->ICPR[0] = pend;
+    }
+}
+/*..........................................................................*/
+static void nvic_access(uint32_t off, uint32_t old, uint32_t val,
+                        bool write)
+{
+    NVIC_Type *nvic = SIM(NVIC);
+    uint_fast8_t i;
+
+    (void)old;
+    if (!write) {
+        return;
+    }
+    if (off == offsetof(NVIC_Type, ISER)) {
+        l_nvicEnabled |= val;
+    }
+    else if (off == offsetof(NVIC_Type, ICER)) {
+        l_nvicEnabled &= ~val;
+    }
+    else if ((off == offsetof(NVIC_Type, ISPR))
+             || (off == offsetof(NVIC_Type, ICPR)))
+    {
+        for (i = ISR_EXTI4_15; i < ISR_MAX; ++i) {
+            if ((val & (1U << l_isr[i].irq)) != 0U) {
+                if (off == offsetof(NVIC_Type, ISPR)) {
+                    irq_pend(i);
+                }
+                else {
+                    (void)__atomic_and_fetch(&l_pend, ~(1U << i),
+                                             __ATOMIC_SEQ_CST);
+                }
+            }
+        }
+        nvic_read(off);
+    }
+    nvic->ISER[0] = l_nvicEnabled;
+    nvic->ICER[0] = l_nvicEnabled;
+    (void)sem_post(&l_kick); /* an enabled interrupt might be pending */
+}
+
+/* the interrupt delivery, see NOTE3 =======================================*/
+static void irq_pend(uint_fast8_t isr) {
+    (void)__atomic_or_fetch(&l_pend, (1U << isr), __ATOMIC_SEQ_CST);
+    (void)sem_post(&l_kick);
+}
+/*..........................................................................*/
+static bool irq_enabled(uint_fast8_t isr) {
+    uint32_t const tick = SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk;
+    if (isr == ISR_SYSTICK) {
+        return (SIM(SysTick)->CTRL & tick) == tick;
+    }
+    return (l_nvicEnabled & (1U << l_isr[isr].irq)) != 0U;
+}
+/*..........................................................................*/
+static uint32_t irq_prio(uint_fast8_t isr) { /* the CMSIS priority field */
+    if (isr == ISR_SYSTICK) {
+        return SIM(SCB)->SHP[1] >> 24;
+    }
+    return (SIM(NVIC)->IP[l_isr[isr].irq >> 2]
+            >> (8U * ((uint32_t)l_isr[isr].irq & 3U))) & 0xFFU;
+}
+/*..........................................................................*/
+static int_fast8_t irq_next(void) { /* the highest-priority pending one */
+    int_fast8_t next = -1;
+    uint_fast8_t i;
+
+    for (i = 0U; i < ISR_MAX; ++i) {
+        if (((l_pend & (1U << i)) != 0U) && irq_enabled(i)) {
+            if (l_isr[i].handler == 0) { /* not in this configuration */
+                (void)__atomic_and_fetch(&l_pend, ~(1U << i),
+                                         __ATOMIC_SEQ_CST);
+            }
+            else if ((next < 0)
+                     || (irq_prio(i) < irq_prio((uint_fast8_t)next)))
+            {
+                next = (int_fast8_t)i;
+            }
+        }
+    }
+    return next;
+}
+/*..........................................................................*/
+static void isr_run(uint_fast8_t isr) {
+    uint_fast8_t const ctx = l_ctx;
+    uint32_t const accesses = l_stat[isr].accesses;
+    uint64_t const t0 = host_ns();
+
+    l_ctx = isr;
+    (*l_isr[isr].handler)();
+    l_ctx = ctx;
+
+    l_stat[isr].ns += host_ns() - t0;
+    ++l_stat[isr].calls;
+    if ((l_stat[isr].accesses - accesses) > l_stat[isr].maxAccesses) {
+        l_stat[isr].maxAccesses = l_stat[isr].accesses - accesses;
+    }
+}
+/*..........................................................................*/
+static uint64_t tim6_period(void) {
+    TIM_TypeDef const *tim = SIM(TIM6);
+    return (uint64_t)((tim->PSC & 0xFFFFU) + 1U)
+           * (uint64_t)((tim->ARR & 0xFFFFU) + 1U);
+}
+/*..........................................................................*/
+static void tim6_run(uint64_t end) { /* the TIM6 update events until end */
+    TIM_TypeDef *tim = SIM(TIM6);
+
+    while ((tim->CR1 & TIM_CR1_CEN) != 0U) {
+        uint64_t period;
+
+        if (!l_tim6Run) { /* just started? */
+            l_tim6Run  = true;
+            l_tim6Next = l_now + tim6_period();
+        }
+        if (l_tim6Next >= end) {
+            break;
+        }
+        l_now  = l_tim6Next;
+        period = tim6_period(); /* latched with the ARR preload */
+        tim->SR |= TIM_SR_UIF;
+        if (((tim->DIER & TIM_DIER_UIE) != 0U) && irq_enabled(ISR_TIM6_DAC)) {
+            isr_run(ISR_TIM6_DAC);
+        }
+        if ((tim->CR1 & TIM_CR1_ARPE) == 0U) { /* the ARR written by the ISR */
+            period = tim6_period();
+        }
+        l_tim6Next += period;
+    }
+    if ((tim->CR1 & TIM_CR1_CEN) == 0U) {
+        l_tim6Run = false;
+    }
+    l_now = end;
+}
+/*..........................................................................*/
+static void systick_run(void) { /* the SysTick exception, see NOTE4 */
+    uint32_t const keys = l_keys;
+
+    tim6_run(l_now + (SIM(SysTick)->LOAD & 0xFFFFFFU) + 1U);
+    ++l_ticks;
+    while ((l_stimNext < l_stimN) && (l_stim[l_stimNext].tick <= l_ticks)) {
+        l_keys = l_stim[l_stimNext].keys;
+        ++l_stimNext;
+    }
+    if (l_keys != keys) {
+        exti_update();
+    }
+    isr_run(ISR_SYSTICK);
+}
+/*..........................................................................*/
+static void cpu_irq(int sig) { /* the "interrupt entry" of the main thread */
+    int const err = errno;
+
+    (void)sig;
+    /* the QF mutex free, i.e., the interrupts not disabled? see NOTE3 */
+    if ((!l_halted) && (pthread_mutex_trylock(&QF_pThreadMutex_) == 0)) {
+        int_fast8_t isr;
+
+        (void)pthread_mutex_unlock(&QF_pThreadMutex_);
+        for (isr = irq_next(); isr >= 0; isr = irq_next()) {
+            (void)__atomic_and_fetch(&l_pend, ~(1U << isr), __ATOMIC_SEQ_CST);
+            if (isr == ISR_SYSTICK) {
+                systick_run();
+            }
+            else {
+                isr_run((uint_fast8_t)isr);
+            }
+            exti_eval(); /* the level-sensitive requests pend again */
+            dma_eval();
+        }
+    }
+    errno = err;
+}
+/*..........................................................................*/
+static void *nvic_thread(void *arg) { /* interrupts the CPU until served */
+    struct timespec const retry = { 0, SIM_KICK_NS };
+
+    (void)arg;
+    for (;;) {
+        uint_fast8_t i;
+        bool ready = false;
+
+        while (sem_wait(&l_kick) != 0) {
+        }
+        do {
+            ready = false;
+            for (i = 0U; i < ISR_MAX; ++i) {
+                ready = ready
+                        || (((l_pend & (1U << i)) != 0U) && irq_enabled(i));
+            }
+            if (ready && !l_halted) {
+                (void)pthread_kill(l_cpu, SIM_IRQ_SIG);
+                (void)nanosleep(&retry, (struct timespec *)0);
+            }
+        } while (ready && !l_halted);
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* the simulator startup and the report ====================================*/
+static void sim_fail(char const *what) {
+    fprintf(stderr, "sim: %s failed (%d)\n", what, errno);
+    exit(-1);
+}
+#ifdef STIMLOG
+/*..........................................................................*/
+static void sim_stimLog(void) { /* the stimuli recorded by the target BSP */
+    char const *fname = getenv("BSP_REC_FILE");
+    FILE *f;
+    uint8_t buf[256];
+    uint16_t n;
+
+    if (fname == (char const *)0) {
+        fname = "stim.log";
+    }
+    f = fopen(fname, "wb");
+    if (f == (FILE *)0) {
+        fprintf(stderr, "sim: cannot create %s\n", fname);
+        return;
+    }
+    StimLog_flush(); /* the interrupts are halted already */
+    while ((n = StimLog_read(buf, (uint16_t)sizeof(buf))) != 0U) {
+        (void)fwrite(buf, 1, n, f);
+    }
+    printf("sim: stimulus log %s, %ld bytes\n", fname, ftell(f));
+    (void)fclose(f);
+}
+#endif
+/*..........................................................................*/
+static void sim_report(void) {
+    sigset_t irq;
+    uint_fast8_t i;
+    uint_fast8_t col;
+    uint_fast8_t row;
+
+    l_halted = true; /* no more interrupts */
+    (void)sigemptyset(&irq);
+    (void)sigaddset(&irq, SIM_IRQ_SIG);
+    (void)pthread_sigmask(SIG_BLOCK, &irq, (sigset_t *)0);
+    led_update();
+
+    printf("sim: %u ticks, %.3f s of virtual time at %u Hz\n",
+           (unsigned)l_ticks, (double)l_now / (double)SystemCoreClock,
+           (unsigned)SystemCoreClock);
+    printf("sim: %-10s %9s %9s %9s %12s\n",
+           "context", "calls", "accesses", "max", "host ns/call");
+    for (i = 0U; i < ISR_MAX; ++i) {
+        SimStat const *s = &l_stat[i];
+        if (s->calls != 0U) {
+            printf("sim: %-10s %9u %9.2f %9u %12.0f\n", l_isr[i].name,
+                   (unsigned)s->calls,
+                   (double)s->accesses / (double)s->calls,
+                   (unsigned)s->maxAccesses,
+                   (double)s->ns / (double)s->calls);
+        }
+    }
+    printf("sim: %-10s %9s %9u\n", "thread", "-",
+           (unsigned)l_stat[CTX_THREAD].accesses);
+    printf("sim: %-10s %9s %9s\n", "peripheral", "reads", "writes");
+    for (i = 0U; i < SIM_PERIPHS; ++i) {
+        if ((l_periph[i].reads + l_periph[i].writes) != 0U) {
+            printf("sim: %-10s %9u %9u\n", l_periph[i].name,
+                   (unsigned)l_periph[i].reads, (unsigned)l_periph[i].writes);
+        }
+    }
+    printf("sim: USART2 %u bytes\n", (unsigned)l_usartBytes);
+    printf("sim: LED matrix [%% of the time lit]\n"
+           "sim:        A     B     C     D     E\n");
+    for (row = 0U; row < 8U; ++row) {
+        printf("sim: %u ", (unsigned)row);
+        for (col = 0U; col < 5U; ++col) {
+            printf(" %5.1f", (l_now != 0U)
+                   ? ((100.0 * (double)l_ledLit[col][row]) / (double)l_now)
+                   : 0.0);
+        }
+        printf("\n");
+    }
+    if (l_usartFile != (FILE *)0) {
+        (void)fclose(l_usartFile);
+    }
+#ifdef STIMLOG
+    sim_stimLog();
+#endif
+}
+/*..........................................................................*/
+static void sim_keys(char const *env) { /* "keys" or "tick:keys,..." */
+    while ((*env != '\0') && (l_stimN < SIM_MAX_STIM)) {
+        char *end;
+        uint32_t val = (uint32_t)strtoul(env, &end, 0);
+
+        l_stim[l_stimN].tick = 0U;
+        if (*end == ':') {
+            l_stim[l_stimN].tick = val;
+            val = (uint32_t)strtoul(end + 1, &end, 0);
+        }
+        l_stim[l_stimN].keys = val;
+        ++l_stimN;
+        if (*end != ',') {
+            break;
+        }
+        env = end + 1;
+    }
+}
+/*..........................................................................*/
+__attribute__((constructor))
+static void sim_init(void) { /* before main(), i.e., before the "reset" */
+    struct sigaction sa;
+    pthread_t nvic;
+    size_t total = 0U;
+    char const *env;
+    uint_fast8_t i;
+    int fd;
+
+    if ((uintptr_t)&l_view > 0xFFFFFFFFU) { /* see NOTE1 */
+        sim_fail("linking with -no-pie");
+    }
+
+    /* the registers in the shared memory, mapped twice, see NOTE1 */
+    for (i = 0U; i < SIM_REGIONS; ++i) {
+        total += l_region[i].size;
+    }
+    fd = memfd_create("stm32l053", 0U);
+    if ((fd < 0) || (ftruncate(fd, (off_t)total) != 0)) {
+        sim_fail("memfd_create()");
+    }
+    l_view = (uint8_t *)mmap((void *)0, total, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+    if (l_view == (uint8_t *)MAP_FAILED) {
+        sim_fail("mmap()");
+    }
+    total = 0U;
+    for (i = 0U; i < SIM_REGIONS; ++i) {
+        void *base = (void *)(uintptr_t)l_region[i].base;
+        if (mmap(base, l_region[i].size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, (off_t)total) != base)
+        {
+            sim_fail("mmap() at the target address");
+        }
+        total += l_region[i].size;
+    }
+
+    /* the reset values used by SystemCoreClockUpdate() and the BSP */
+    SIM(RCC)->CR     = RCC_CR_MSION | RCC_CR_MSIRDY;
+    SIM(RCC)->ICSCR  = RCC_ICSCR_MSIRANGE_5; /* MSI 2.097 MHz */
+    SIM(GPIOA)->MODER = 0xEBFFFCFFU;
+    SIM(GPIOB)->MODER = 0xFFFFFFFFU;
+    SIM(GPIOC)->MODER = 0xFFFFFFFFU;
+    SIM(USART2)->ISR = USART_ISR_TXE | USART_ISR_TC;
+
+    /* the configuration through the environment, see NOTE4 */
+    env = getenv("BSP_RUN_TICKS");
+    if (env != (char const *)0) {
+        l_runTicks = (uint32_t)strtoul(env, (char **)0, 0);
+    }
+    env = getenv("BSP_KEYS");
+    if (env != (char const *)0) {
+        sim_keys(env);
+    }
+    env = getenv("SIM_USART");
+    if (env != (char const *)0) {
+        l_usartFile = fopen(env, "wb");
+        if (l_usartFile == (FILE *)0) {
+            sim_fail("fopen(SIM_USART)");
+        }
+    }
+
+    /* the traps of the register accesses, see NOTE2 */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO;
+    (void)sigemptyset(&sa.sa_mask);
+    (void)sigaddset(&sa.sa_mask, SIM_IRQ_SIG);
+    sa.sa_sigaction = &bus_fault;
+    (void)sigaction(SIGSEGV, &sa, (struct sigaction *)0);
+    sa.sa_sigaction = &bus_step;
+    (void)sigaction(SIGTRAP, &sa, (struct sigaction *)0);
+    for (i = 0U; i < SIM_PERIPHS; ++i) {
+        void *page = (void *)(uintptr_t)(l_periph[i].base & ~(SIM_PAGE - 1U));
+        if (mprotect(page, SIM_PAGE, PROT_NONE) != 0) {
+            sim_fail("mprotect()");
+        }
+    }
+
+    /* the interrupts of the main thread, see NOTE3 */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_RESTART;
+    (void)sigemptyset(&sa.sa_mask);
+    sa.sa_handler = &cpu_irq;
+    (void)sigaction(SIM_IRQ_SIG, &sa, (struct sigaction *)0);
+    l_cpu = pthread_self();
+    if ((sem_init(&l_kick, 0, 0U) != 0)
+        || (pthread_create(&nvic, (pthread_attr_t *)0, &nvic_thread,
+                           (void *)0) != 0))
+    {
+        sim_fail("pthread_create()");
+    }
+    (void)pthread_detach(nvic);
+    (void)atexit(&sim_report);
+}
+
+/* QF and QP callbacks not provided by the target BSP ======================*/
+void QF_onClockTick(void) { /* the SysTick reload, from the tick thread */
+    SysTick_Type *st = SIM(SysTick);
+
+    if ((st->CTRL & SysTick_CTRL_ENABLE_Msk) != 0U) {
+        l_reloadNs = host_ns();
+        (void)__atomic_or_fetch(&st->CTRL, SysTick_CTRL_COUNTFLAG_Msk,
+                                __ATOMIC_SEQ_CST);
+        if ((st->CTRL & SysTick_CTRL_TICKINT_Msk) != 0U) {
+            irq_pend(ISR_SYSTICK);
+        }
+    }
+    if (l_runTicks != 0U) {
+        ++l_hostTicks;
+        if (l_hostTicks == l_runTicks) {
+            QF_stop();
+        }
+    }
+}
+/*..........................................................................*/
+void Q_onAssert(char_t const Q_ROM * const module, int_t location) {
+    /* NOTE: the startup code of the target defines it in assembly */
+    fprintf(stderr, "Assertion failed in %s:%d\n", module, (int)location);
+    exit(-1);
+}
+
+/*****************************************************************************
+* NOTE1:
+* The three address regions of the target (the APB/AHB peripherals, the
+* GPIO ports on the IOPORT bus and the System Control Space) are mapped at
+* their target addresses from one shared memory object, which is mapped a
+* second time for the simulator itself (SIM()), so the simulator reads and
+* updates the registers without ever trapping. The CMSIS device header is
+* used unmodified, so the BSP accesses the registers through the usual
+* absolute addresses. The QS DMA of the target stores 32-bit memory
+* addresses in DMA1_Channel4->CMAR, so the executable is linked with
+* -no-pie to keep the static data below 4 GB.
+*
+* NOTE2:
+* The pages of the trapped peripherals are protected, so every register
+* access of the BSP raises SIGSEGV. The fault handler refreshes the
+* register read by the access (e.g., GPIOx->IDR from the key matrix or
+* SysTick->VAL from the host clock), unprotects the page and single-steps
+* the faulting instruction with the trap flag. The SIGTRAP right after it
+* protects the page again and applies the side effects of the write (the
+* GPIOx->BSRR set/reset, the write-1-to-clear EXTI->PR and DMA1->IFCR, the
+* USART2->TDR output, the start of the DMA transfer, ...). A write is told
+* from a read by the page-fault error code, so also the writes of an
+* unchanged value are seen. Only the word of the access is simulated, which
+* covers the volatile register accesses generated from the CMSIS header.
+*
+* NOTE3:
+* All the code of the application and of the BSP runs in the main thread,
+* which stands for the CPU. An interrupt is delivered as SIM_IRQ_SIG to the
+* main thread, whose handler runs the pending ISRs by their NVIC priority
+* only if the QF_pThreadMutex_ is free, i.e., if the "interrupts" are not
+* disabled by QF_INT_DISABLE(). A masked interrupt stays pending, and the
+* NVIC thread signals the main thread again every SIM_KICK_NS until it is
+* served, which stands for the interrupt taken right after
+* QF_INT_ENABLE(). The ISRs do not preempt each other.
+*
+* NOTE4:
+* The tick thread of the QF port reloads SysTick at BSP_TICKS_PER_SEC in
+* host time and pends its interrupt. The virtual time advances by
+* (SysTick->LOAD + 1) CPU clocks per SysTick interrupt, and the TIM6 update
+* events within that period are simulated first (with and without the ARR
+* preload), so the LED refresh runs at its exact virtual rate and the lit
+* time of every LED is accounted in virtual CPU clocks. The simulator is
+* configured through the environment, as the mocked host BSP:
+* BSP_RUN_TICKS=<n> stops QF_run() after n clock ticks, BSP_KEYS=<keys> or
+* BSP_KEYS=<tick>:<keys>,... sets the pressed keys (bit 4*row + column)
+* from the given SysTick interrupt on, and SIM_USART=<file> receives the
+* USART2 output (the QS trace of the Q_SPY configuration). At exit the
+* simulator reports the calls, the trapped register accesses and the host
+* time of every ISR (e.g., the keypad scan in SysTick and the LED refresh in
+* TIM6_DAC), the accesses of every peripheral and the brightness of the LED
+* matrix.
+*/
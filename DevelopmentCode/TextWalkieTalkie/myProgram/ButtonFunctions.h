@@ -1,5 +1,3 @@
-int ButtonCheckPress(int x, int y);
-
 void ButtonAllRowOff(void);
 void ButtonAllRowOn(void);
 
@@ -1,94 +1,40 @@
+#include "qpc.h"
 #include "LEDFunctions.h"
-#include "bsp.h"
+#include "display.h"
+
+// the LEDs are shown through the framebuffer (display.c), so that
+// the refresh ISR multiplexes them without any pin toggling here
+
+static void LEDAllSet(uint8_t level)
+{
+	DisplayFrame *frame = Display_frame();
+	uint_fast8_t x;
+	uint_fast8_t y;
+
+	for (x = 0U; x < DISPLAY_COLS; ++x)
+		for (y = 0U; y < DISPLAY_ROWS; ++y)
+			(*frame)[x][y] = level;
+	Display_swap();
+}
 
 void LEDAllOff()
 {
-	BSP_ledAOff();
-  BSP_ledBOff();
-  BSP_ledCOff();
-  BSP_ledDOff();
-  BSP_ledEOff();
-	
-	BSP_led0Off();
-  BSP_led1Off();
-  BSP_led2Off();
-  BSP_led3Off();
-  BSP_led4Off();
-  BSP_led5Off();
-  BSP_led6Off();
-  BSP_led7Off();
+	LEDAllSet(0U);
 };
 void LEDAllOn()
 {
-	BSP_ledAOn();
-  BSP_ledBOn();
-  BSP_ledCOn();
-  BSP_ledDOn();
-  BSP_ledEOn();
-	
-	BSP_led0On();
-  BSP_led1On();
-  BSP_led2On();
-  BSP_led3On();
-  BSP_led4On();
-  BSP_led5On();
-  BSP_led6On();
-  BSP_led7On();
+	LEDAllSet(DISPLAY_LEVEL_MAX);
 };
 
 void LEDXYOnSingle(int x, int y)
 {
-	// x axis is A - E
-	switch (x){
-		case 0:{
-			BSP_ledAOn();
-			break;}
-		case 1:{
-			BSP_ledBOn();
-			break;}
-		case 2:{
-			BSP_ledCOn();
-			break;}
-		case 3:{
-			BSP_ledDOn();
-			break;}
-		case 4:{
-			BSP_ledEOn();
-			break;}
-		default:
-			break;
-	}		
-	
-	// y axis is 0 - 7
-	switch (y){
-		case 0:{
-			BSP_led0On();
-			break;}
-		case 1:{
-			BSP_led1On();
-			break;}
-		case 2:{
-			BSP_led2On();
-			break;}
-		case 3:{
-			BSP_led3On();
-			break;}
-		case 4:{
-			BSP_led4On();
-			break;}
-		case 5:{
-			BSP_led5On();
-			break;}
-		case 6:{
-			BSP_led6On();
-			break;}
-		case 7:{
-			BSP_led7On();
-			break;}
-		default:
-			break;
-	}		
+	// x axis is A - E, y axis is 0 - 7
+	if ((x >= 0) && (x < (int)DISPLAY_COLS)
+	    && (y >= 0) && (y < (int)DISPLAY_ROWS))
+	{
+		(*Display_frame())[x][y] = DISPLAY_LEVEL_MAX;
+		Display_swap();
+	}
 };
 
 //end of file
-
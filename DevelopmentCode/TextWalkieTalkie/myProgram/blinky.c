@@ -46,7 +46,7 @@ Contact information:
 
 #include "bsp.h"
 #include "LEDFunctions.h"
-#include "ButtonFunctions.h"
+#include "keypad.h"
 
 
 //Q_DEFINE_THIS_FILE
@@ -90,6 +90,11 @@ static QState Blinky_1     (Blinky * const me, QEvt const * const e);
 static QState Blinky_2     (Blinky * const me, QEvt const * const e);
 static QState Blinky_3     (Blinky * const me, QEvt const * const e);
 
+#ifdef QHSM_FLAT
+/* the same state machine as a flat QMsm, generated by qhsmflat */
+static QState Blinky_initial_flat(void * const me, QEvt const * const e);
+#endif
+
 
 /*..........................................................................*/
 
@@ -98,7 +103,11 @@ void Blinky_ctor(void) {
 
     Blinky * const me = &l_blinky;
 
+#ifdef QHSM_FLAT
+    QMActive_ctor(&me->super, Q_STATE_CAST(&Blinky_initial_flat));
+#else
     QActive_ctor(&me->super, Q_STATE_CAST(&Blinky_initial));
+#endif
 
     QTimeEvt_ctorX(&me->timeEvt, &me->super, TIMEOUT_SIG, 0U);
 
@@ -125,9 +134,13 @@ QState Blinky_initial(Blinky * const me, QEvt const * const e)
 
     QS_FUN_DICTIONARY(&Blinky_initial);
 
-    QS_FUN_DICTIONARY(&Blinky_off);
+    QS_FUN_DICTIONARY(&Blinky_0);
+
+    QS_FUN_DICTIONARY(&Blinky_1);
+
+    QS_FUN_DICTIONARY(&Blinky_2);
 
-    QS_FUN_DICTIONARY(&Blinky_on);
+    QS_FUN_DICTIONARY(&Blinky_3);
     QS_SIG_DICTIONARY(DUMMY_SIG,     (void *)0);
 
     /* global signal */
@@ -162,7 +175,7 @@ QState Blinky_0(Blinky * const me, QEvt const * const e)
 					LEDAllOff();
 					
 					LEDXYOnSingle(0,0);
-					if(ButtonCheckPress(0,0) == 1)
+					if(Keypad_isDown(KEYPAD_KEY(0,0)))
 						LEDXYOnSingle(3,0);
 
           status = Q_HANDLED();
@@ -204,7 +217,7 @@ QState Blinky_1(Blinky * const me, QEvt const * const e)
 					
 					LEDAllOff();
 					LEDXYOnSingle(1,0);
-					if(ButtonCheckPress(1,0) == 1)
+					if(Keypad_isDown(KEYPAD_KEY(0,1)))
 						LEDXYOnSingle(4,0);
 
             status = Q_HANDLED();
@@ -251,7 +264,7 @@ QState Blinky_2(Blinky * const me, QEvt const * const e)
 					
 					LEDAllOff();
 					LEDXYOnSingle(1,1);
-					if(ButtonCheckPress(1,1) == 1)
+					if(Keypad_isDown(KEYPAD_KEY(1,1)))
 						LEDXYOnSingle(4,1);
 					
             status = Q_HANDLED();
@@ -298,7 +311,7 @@ QState Blinky_3(Blinky * const me, QEvt const * const e)
 
 					LEDAllOff();
 					LEDXYOnSingle(0,1);
-					if(ButtonCheckPress(0,1) == 1)
+					if(Keypad_isDown(KEYPAD_KEY(1,0)))
 						LEDXYOnSingle(3,1);
 
 					status = Q_HANDLED();
@@ -332,3 +345,6 @@ QState Blinky_3(Blinky * const me, QEvt const * const e)
 
 }
 
+#ifdef QHSM_FLAT
+#include "blinky_flat.inc"
+#endif
@@ -36,6 +36,8 @@
 
 enum BlinkySignals {
     DUMMY_SIG = Q_USER_SIG,
+    KEY_DOWN_SIG,         /* a key of the keypad pressed (KeyEvt) */
+    KEY_UP_SIG,           /* a key of the keypad released (KeyEvt) */
     MAX_PUB_SIG,          /* the last published signal */
 
     TIMEOUT_SIG,
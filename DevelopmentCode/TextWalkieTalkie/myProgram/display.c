@@ -0,0 +1,148 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, 5x8 LED matrix framebuffer
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The frames are double-buffered as the precomputed GPIOC->BSRR words of
+* their columns and bit-planes, see NOTE1 and NOTE2.
+*****************************************************************************/
+#include "qpc.h"
+#include "bsp.h"
+#include "display.h"
+
+#include <string.h>  /* for memset() */
+
+/* the two frames of the refresh, see NOTE1 */
+static struct {
+    /* the BSRR words of the columns, for each bit-plane */
+    uint32_t word[2][DISPLAY_COLS][DISPLAY_PLANES];
+    uint8_t lit[2];  /* any LED lit in the frame? */
+    uint8_t shown;   /* the frame multiplexed by the refresh ISR */
+    uint8_t ready;   /* the other frame waiting for the next refresh frame? */
+    uint8_t col;     /* the next column to refresh */
+    uint8_t plane;   /* the next bit-plane of the column to refresh */
+} l_display;
+
+static DisplayFrame l_frame; /* drawn by the application */
+
+/*..........................................................................*/
+/* the BSRR word turning the column on with the given rows, see NOTE1 */
+static uint32_t encode(uint_fast8_t col, uint8_t rows) {
+    uint32_t const colPin  = 1U << (BSP_LED_COL_PIN0 + col);
+    uint32_t const colPins = ((1U << DISPLAY_COLS) - 1U) << BSP_LED_COL_PIN0;
+    uint32_t const on  = (uint32_t)rows << BSP_LED_ROW_PIN0;
+    uint32_t const off = (uint32_t)(uint8_t)~rows << BSP_LED_ROW_PIN0;
+
+    /* set: the lit rows and the other columns (active low, so off);
+    * reset: the unlit rows and this column
+    */
+    return (on | (colPins & ~colPin)) | ((off | colPin) << 16);
+}
+/*..........................................................................*/
+void Display_init(void) {
+    uint_fast8_t col;
+    uint_fast8_t plane;
+
+    memset(l_frame, 0, sizeof(l_frame));
+    for (col = 0U; col < DISPLAY_COLS; ++col) {
+        for (plane = 0U; plane < DISPLAY_PLANES; ++plane) {
+            l_display.word[0][col][plane] = encode(col, 0U);
+            l_display.word[1][col][plane] = encode(col, 0U);
+        }
+    }
+    l_display.lit[0] = 0U;
+    l_display.lit[1] = 0U;
+    l_display.shown  = 0U;
+    l_display.ready  = 0U;
+    l_display.col    = 0U;
+    l_display.plane  = 0U;
+}
+/*..........................................................................*/
+DisplayFrame *Display_frame(void) {
+    return &l_frame;
+}
+/*..........................................................................*/
+void Display_swap(void) {
+    uint_fast8_t next;
+    uint_fast8_t col;
+    uint_fast8_t plane;
+    uint8_t lit = 0U;
+
+    QF_INT_DISABLE();
+    l_display.ready = 0U; /* cancel the frame still waiting, if any */
+    next = (uint_fast8_t)(l_display.shown ^ 1U); /* stays hidden now */
+    QF_INT_ENABLE();
+
+    for (col = 0U; col < DISPLAY_COLS; ++col) {
+        for (plane = 0U; plane < DISPLAY_PLANES; ++plane) {
+            uint_fast8_t row;
+            uint8_t rows = 0U; /* the rows lit in this bit-plane */
+
+            for (row = 0U; row < DISPLAY_ROWS; ++row) {
+                rows |= (uint8_t)(((l_frame[col][row] >> plane) & 1U)
+                                  << row);
+            }
+            l_display.word[next][col][plane] = encode(col, rows);
+            lit |= rows;
+        }
+    }
+    l_display.lit[next] = (uint8_t)(lit != 0U);
+
+    QF_INT_DISABLE();
+    l_display.ready = 1U; /* show it from the next refresh frame */
+    QF_INT_ENABLE();
+}
+/*..........................................................................*/
+uint32_t Display_scan(uint_fast8_t *plane) {
+    uint32_t word;
+
+    /* start of a refresh frame? */
+    if ((l_display.col == 0U) && (l_display.plane == 0U)) {
+        if (l_display.ready != 0U) {
+            l_display.shown ^= 1U;
+            l_display.ready  = 0U;
+        }
+    }
+    word = l_display.word[l_display.shown][l_display.col][l_display.plane];
+    *plane = l_display.plane;
+    ++l_display.plane;
+    if (l_display.plane == DISPLAY_PLANES) {
+        l_display.plane = 0U;
+        ++l_display.col;
+        if (l_display.col == DISPLAY_COLS) {
+            l_display.col = 0U;
+        }
+    }
+    return word;
+}
+/*..........................................................................*/
+bool Display_isLit(void) {
+    return (l_display.lit[l_display.shown] != 0U) || (l_display.ready != 0U);
+}
+
+/*****************************************************************************
+* NOTE1:
+* The rows 0..7 of the LED matrix are the active-high pins PC0..PC7 and the
+* columns A..E the active-low pins PC8..PC12 (see BSP_LED_ROW_PIN0 and
+* BSP_LED_COL_PIN0 in bsp.h), so a single 32-bit store to GPIOC->BSRR turns
+* the previous column off, drives the rows of the next column and turns it
+* on. Display_swap() encodes these words for all the columns of the drawn
+* frame in the hidden half of l_display, outside of any critical section,
+* and only then marks it ready. The refresh ISR switches the halves at the
+* start of a refresh frame, so every refresh frame shows either the old or
+* the new frame, but never a mix of both (no tearing), and the ISR itself
+* does a single table lookup per column and bit-plane. Display_swap() must
+* be called from one active object at a time.
+*
+* NOTE2:
+* The brightness uses the binary code modulation instead of PWM. Every
+* column is shown as DISPLAY_PLANES bit-planes, where the bit-plane n lights
+* the LEDs with the bit n of their level set and lasts (1 << n) time slots
+* of DISPLAY_BCM_HZ, so an LED is lit for exactly "level" out of the
+* DISPLAY_LEVEL_MAX slots of its column. Display_swap() precomputes the
+* BSRR word of every bit-plane, and the refresh ISR reprograms its timer
+* period from the returned bit-plane, so the 16 levels cost only
+* DISPLAY_PLANES (4) interrupts per column instead of the DISPLAY_LEVEL_MAX
+* (15) of PWM with the same resolution. Only the low DISPLAY_PLANES bits of
+* the levels in the framebuffer are used.
+*/
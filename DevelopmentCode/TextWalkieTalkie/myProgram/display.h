@@ -0,0 +1,46 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, 5x8 LED matrix framebuffer
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The application draws into the framebuffer (the brightness level
+* 0..DISPLAY_LEVEL_MAX of every LED, indexed [column A..E][row 0..7]) and
+* shows it with Display_swap(). The BSP refresh ISR multiplexes the shown
+* frame one column and one bit-plane at a time (binary code modulation),
+* with one store of the precomputed word from Display_scan() to
+* GPIOC->BSRR, see NOTE1 and NOTE2 of display.c.
+*****************************************************************************/
+#ifndef display_h
+#define display_h
+
+#define DISPLAY_COLS      5U    /* columns A..E */
+#define DISPLAY_ROWS      8U    /* rows 0..7 */
+#define DISPLAY_PLANES    4U    /* bit-planes of the brightness levels */
+#define DISPLAY_LEVEL_MAX ((1U << DISPLAY_PLANES) - 1U) /* fully lit */
+#define DISPLAY_FRAME_HZ  200U  /* refresh frames per second */
+
+/* the shortest time slot of the binary code modulation (bit-plane 0) in
+* slots per second; the slot of the bit-plane n is (1 << n) times longer
+*/
+#define DISPLAY_BCM_HZ \
+    (DISPLAY_FRAME_HZ * DISPLAY_COLS * DISPLAY_LEVEL_MAX)
+
+typedef uint8_t DisplayFrame[DISPLAY_COLS][DISPLAY_ROWS];
+
+void Display_init(void);
+
+/* the framebuffer to draw into, never shown before Display_swap() */
+DisplayFrame *Display_frame(void);
+
+/* show the framebuffer from the start of the next refresh frame */
+void Display_swap(void);
+
+/* the GPIOC->BSRR word of the next column and bit-plane, which the refresh
+* ISR shows for (1 << *plane) time slots; called from the refresh ISR
+*/
+uint32_t Display_scan(uint_fast8_t *plane);
+
+/* any LED lit in the shown frame? (e.g., to keep the refresh running) */
+bool Display_isLit(void);
+
+#endif /* display_h */
@@ -0,0 +1,77 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, 4x4 keypad
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The keys are debounced with the vertical counters, see NOTE1.
+*****************************************************************************/
+#include "qpc.h"
+#include "blinky.h"
+#include "keypad.h"
+
+/* the debouncing state of all the keys, one bit per key in each member */
+static struct {
+    uint16_t state;          /* the debounced state of the keys */
+    uint16_t cnt0;           /* the vertical counters, bit 0 */
+    uint16_t cnt1;           /* the vertical counters, bit 1 */
+} l_keypad;
+
+/*..........................................................................*/
+void Keypad_init(void) {
+    l_keypad.state = 0U;     /* all keys up */
+    l_keypad.cnt0  = 0xFFFFU; /* all counters idle */
+    l_keypad.cnt1  = 0xFFFFU;
+
+    QS_OBJ_DICTIONARY(&l_keypad);
+    QS_SIG_DICTIONARY(KEY_DOWN_SIG, (void *)0);
+    QS_SIG_DICTIONARY(KEY_UP_SIG,   (void *)0);
+}
+/*..........................................................................*/
+bool Keypad_tick(uint16_t sample) {
+    uint16_t changed = (uint16_t)(l_keypad.state ^ sample);
+
+    /* count down the keys that differ, reset the others, see NOTE1 */
+    l_keypad.cnt0 = (uint16_t)~(l_keypad.cnt0 & changed);
+    l_keypad.cnt1 = (uint16_t)(l_keypad.cnt0 ^ (l_keypad.cnt1 & changed));
+    changed &= (uint16_t)(l_keypad.cnt0 & l_keypad.cnt1); /* rolled over */
+    if (changed != 0U) {
+        uint16_t const state = (uint16_t)(l_keypad.state ^ changed);
+        uint8_t key;
+
+        QF_INT_DISABLE(); /* Keypad_state() can be called from any AO */
+        l_keypad.state = state;
+        QF_INT_ENABLE();
+        for (key = 0U; changed != 0U; ++key, changed >>= 1) {
+            if ((changed & 1U) != 0U) {
+                KeyEvt *ke = Q_NEW(KeyEvt, ((state & (1U << key)) != 0U)
+                                           ? KEY_DOWN_SIG : KEY_UP_SIG);
+                ke->key = key;
+                QF_PUBLISH(&ke->super, &l_keypad);
+            }
+        }
+    }
+
+    /* any key down or any counter not idle? */
+    return (l_keypad.state != 0U)
+           || ((uint16_t)(l_keypad.cnt0 & l_keypad.cnt1) != 0xFFFFU);
+}
+/*..........................................................................*/
+uint16_t Keypad_state(void) {
+    uint16_t state;
+    QF_INT_DISABLE();
+    state = l_keypad.state;
+    QF_INT_ENABLE();
+    return state;
+}
+
+/*****************************************************************************
+* NOTE1:
+* Every key has a 2-bit counter, whose bits are kept "vertically" in cnt0
+* and cnt1, so that one sample updates all the 16 counters with a few
+* bitwise operations. The counter of a key is idle at 3 and counts down on
+* every sample that differs from the debounced state of the key. When it
+* rolls over from 0 back to 3, that is after four consecutive differing
+* samples (40 ms at BSP_TICKS_PER_SEC of 100), the debounced state of the
+* key toggles. A sample equal to the debounced state resets the counter to
+* 3, so the bouncing contacts never reach the rollover.
+*/
@@ -0,0 +1,40 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, 4x4 keypad
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The BSP scans the whole key matrix from the clock tick ISR and passes the
+* raw sample to Keypad_tick(), which debounces all 16 keys in parallel and
+* publishes KEY_DOWN_SIG and KEY_UP_SIG (KeyEvt) for every debounced change.
+*****************************************************************************/
+#ifndef keypad_h
+#define keypad_h
+
+#define KEYPAD_ROWS   4U
+#define KEYPAD_COLS   4U
+
+/* the key code of the key in the given row and column, which is also the
+* bit of the key in the raw samples and in Keypad_state()
+*/
+#define KEYPAD_KEY(row_, col_) ((uint8_t)(((row_) * KEYPAD_COLS) + (col_)))
+
+typedef struct {
+    QEvt super;   /* inherit QEvt */
+    uint8_t key;  /* the key code KEYPAD_KEY(row, column) */
+} KeyEvt;
+
+void Keypad_init(void);
+
+/* debounce the raw sample (bit KEYPAD_KEY() set for a closed key) and
+* publish the changes; called from the clock tick ISR. Returns false when
+* all the keys are up and debounced, so that the BSP can stop scanning
+* until the next key press wakes it up.
+*/
+bool Keypad_tick(uint16_t sample);
+
+/* the debounced state of all the keys, bit KEYPAD_KEY() set when down */
+uint16_t Keypad_state(void);
+
+#define Keypad_isDown(key_) ((Keypad_state() & (1U << (key_))) != 0U)
+
+#endif /* keypad_h */
@@ -34,20 +34,39 @@
 #include "qpc.h"
 #include "blinky.h"
 #include "bsp.h"
+#include "keypad.h"
+#include "display.h"
 
 
 /*..........................................................................*/
 int main() {
     static QEvt const *l_blinkyQSto[10]; /* storage for Blinky event queue */
+    static QSubscrList l_subscrSto[MAX_PUB_SIG];
+    static QF_MPOOL_EL(KeyEvt) l_smlPoolSto[8]; /* storage for small pool */
+#ifdef QHSM_TRAN_CACHE
+    static QHsmTranCache l_tranCache; /* shared by the AOs of the QV kernel */
+#endif
+#ifdef QHSM_SIG_MAP
+    static QHsmSigMap l_sigMap;       /* shared by the AOs of the QV kernel */
+#endif
 
     QF_init();  /* initialize the framework and the underlying RT kernel */
     BSP_init(); /* initialize the Board Support Package */
 
-    /* publish-subscribe not used, no call to QF_psInit() */
-    /* dynamic event allocation not used, no call to QF_poolInit() */
+    /* initialize publish-subscribe and the event pool for the keypad */
+    QF_psInit(l_subscrSto, Q_DIM(l_subscrSto));
+    QF_poolInit(l_smlPoolSto, sizeof(l_smlPoolSto), sizeof(l_smlPoolSto[0]));
+    Keypad_init();
+    Display_init();
 
     /* instantiate and start the active objects... */
     Blinky_ctor();
+#ifdef QHSM_TRAN_CACHE
+    QHsm_setTranCache(&AO_Blinky->super, &l_tranCache);
+#endif
+#ifdef QHSM_SIG_MAP
+    QHsm_setSigMap(&AO_Blinky->super, &l_sigMap);
+#endif
     QACTIVE_START(AO_Blinky,      /* AO pointer to start */
                   1U,             /* unique QP priority of the AO */
                   l_blinkyQSto,   /* storage for the AO's queue */
@@ -0,0 +1,274 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, stimulus log (record and replay)
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The runs of clock ticks are run-length encoded, so an idle device records
+* next to nothing, see NOTE1.
+*****************************************************************************/
+#include "qpc.h"
+#include "bsp.h"
+#include "stimlog.h"
+
+Q_DEFINE_THIS_MODULE("stimlog")
+
+/* the records of the log, see NOTE1 */
+enum {
+    REC_TICKS = 0x00U, /* n clock ticks without the keypad scan */
+    REC_SCANS = 0x40U, /* n clock ticks with the keypad scan */
+    REC_KEYS  = 0x80U, /* the next keypad sample (uint16_t) */
+    REC_WAKE  = 0x81U, /* the keypad wake-up (EXTI) with its sample */
+    REC_LOST  = 0xFFU, /* the rest of the log lost in an overrun */
+    REC_END   = 0x00U  /* the end of the log (e.g., the unused buffer) */
+};
+#define REC_KIND    0xC0U /* the kind of the record in the tag */
+#define REC_RUN     0x3FU /* the run length in the tag, or the escape */
+#define REC_MAX     6U    /* the longest record (tag + 5 bytes of varint) */
+
+#define HDR_SIZE    8U    /* the header of the log */
+#define HDR_VERSION 1U
+
+/* the recording, see NOTE2 */
+static struct {
+    uint8_t *buf;   /* the ring buffer */
+    uint16_t size;  /* the size of the ring buffer */
+    uint16_t head;  /* the next byte to write */
+    uint16_t tail;  /* the next byte to read */
+    uint16_t keys;  /* the last recorded keypad sample */
+    uint32_t run;   /* the clock ticks of the pending run */
+    uint8_t  scan;  /* the pending run scans the keypad? */
+    uint8_t  lost;  /* the recording stopped by an overrun? */
+} l_rec;
+
+/*..........................................................................*/
+static uint16_t rec_free(void) {
+    uint16_t const used = (l_rec.head >= l_rec.tail)
+                          ? (uint16_t)(l_rec.head - l_rec.tail)
+                          : (uint16_t)(l_rec.size - l_rec.tail + l_rec.head);
+    return (uint16_t)(l_rec.size - used - 1U); /* one byte kept empty */
+}
+/*..........................................................................*/
+static void rec_put(uint8_t b) {
+    l_rec.buf[l_rec.head] = b;
+    ++l_rec.head;
+    if (l_rec.head == l_rec.size) {
+        l_rec.head = 0U;
+    }
+}
+/*..........................................................................*/
+/* room for a record of n bytes? stops the recording when not, see NOTE2 */
+static bool rec_room(uint_fast8_t n) {
+    if (l_rec.lost != 0U) {
+        return false;
+    }
+    if (rec_free() < (uint16_t)(n + 1U)) { /* + the REC_LOST marker */
+        rec_put((uint8_t)REC_LOST);
+        l_rec.lost = 1U;
+        return false;
+    }
+    return true;
+}
+/*..........................................................................*/
+static void rec_keys(uint8_t tag, uint16_t keys) {
+    if (rec_room(3U)) {
+        rec_put(tag);
+        rec_put((uint8_t)keys);
+        rec_put((uint8_t)(keys >> 8));
+    }
+    l_rec.keys = keys;
+}
+/*..........................................................................*/
+void StimLog_init(uint8_t sto[], uint16_t stoSize) {
+    Q_REQUIRE(stoSize > (HDR_SIZE + REC_MAX));
+
+    l_rec.buf  = sto;
+    l_rec.size = stoSize;
+    l_rec.head = 0U;
+    l_rec.tail = 0U;
+    l_rec.keys = 0U;
+    l_rec.run  = 0U;
+    l_rec.scan = 0U;
+    l_rec.lost = 0U;
+
+    rec_put((uint8_t)'T'); /* the magic "TWSL" */
+    rec_put((uint8_t)'W');
+    rec_put((uint8_t)'S');
+    rec_put((uint8_t)'L');
+    rec_put((uint8_t)HDR_VERSION);
+    rec_put(0U);
+    rec_put((uint8_t)BSP_TICKS_PER_SEC);
+    rec_put((uint8_t)(BSP_TICKS_PER_SEC >> 8));
+}
+/*..........................................................................*/
+void StimLog_flush(void) {
+    uint32_t n = l_rec.run;
+
+    if ((n == 0U) || !rec_room(REC_MAX)) {
+        return;
+    }
+    l_rec.run = 0U;
+    if (n < REC_RUN) {
+        rec_put((uint8_t)((l_rec.scan != 0U ? REC_SCANS : REC_TICKS) | n));
+    }
+    else { /* the escape followed by the varint of n - REC_RUN */
+        rec_put((uint8_t)((l_rec.scan != 0U ? REC_SCANS : REC_TICKS)
+                          | REC_RUN));
+        n -= REC_RUN;
+        while (n >= 0x80U) {
+            rec_put((uint8_t)(n | 0x80U));
+            n >>= 7;
+        }
+        rec_put((uint8_t)n);
+    }
+}
+/*..........................................................................*/
+void StimLog_ticks(uint32_t n) {
+    if (n == 0U) {
+        return;
+    }
+    if ((l_rec.scan != 0U) || (l_rec.run > (0xFFFFFFFFU - n))) {
+        StimLog_flush(); /* a different run */
+        l_rec.scan = 0U;
+    }
+    l_rec.run += n;
+}
+/*..........................................................................*/
+void StimLog_scan(uint16_t keys) {
+    if (keys != l_rec.keys) { /* the sample applies to this tick */
+        StimLog_flush();
+        rec_keys((uint8_t)REC_KEYS, keys);
+    }
+    if ((l_rec.scan == 0U) || (l_rec.run == 0xFFFFFFFFU)) {
+        StimLog_flush(); /* a different run */
+        l_rec.scan = 1U;
+    }
+    ++l_rec.run;
+}
+/*..........................................................................*/
+void StimLog_wake(uint16_t keys) {
+    StimLog_flush(); /* the wake-up comes after the ticks so far */
+    rec_keys((uint8_t)REC_WAKE, keys);
+}
+/*..........................................................................*/
+uint16_t StimLog_read(uint8_t dst[], uint16_t max) {
+    uint16_t n = 0U;
+
+    while ((n < max) && (l_rec.tail != l_rec.head)) {
+        dst[n] = l_rec.buf[l_rec.tail];
+        ++n;
+        ++l_rec.tail;
+        if (l_rec.tail == l_rec.size) {
+            l_rec.tail = 0U;
+        }
+    }
+    return n;
+}
+
+/*..........................................................................*/
+uint16_t StimPlayer_init(StimPlayer * const me,
+                         uint8_t const *log, uint32_t size)
+{
+    me->next  = log + size; /* nothing to replay in an invalid log */
+    me->end   = log + size;
+    me->ticks = 0U;
+    me->keys  = 0U;
+    me->scan  = 0U;
+
+    if ((size < HDR_SIZE)
+        || (log[0] != (uint8_t)'T') || (log[1] != (uint8_t)'W')
+        || (log[2] != (uint8_t)'S') || (log[3] != (uint8_t)'L')
+        || (log[4] != (uint8_t)HDR_VERSION))
+    {
+        return 0U;
+    }
+    me->next = log + HDR_SIZE;
+    return (uint16_t)(log[6] | ((uint16_t)log[7] << 8));
+}
+/*..........................................................................*/
+enum StimPlayerStep StimPlayer_step(StimPlayer * const me) {
+    while (me->ticks == 0U) {
+        uint8_t tag;
+
+        if ((me->next == me->end) || (*me->next == (uint8_t)REC_END)) {
+            me->next = me->end;
+            return STIM_END;
+        }
+        tag = *me->next;
+        ++me->next;
+
+        if ((tag == (uint8_t)REC_KEYS) || (tag == (uint8_t)REC_WAKE)) {
+            if ((me->end - me->next) < 2) {
+                return STIM_BAD;
+            }
+            me->keys = (uint16_t)(me->next[0] | ((uint16_t)me->next[1] << 8));
+            me->next += 2;
+            if (tag == (uint8_t)REC_WAKE) {
+                return STIM_WAKE;
+            }
+        }
+        else if (tag == (uint8_t)REC_LOST) {
+            me->next = me->end;
+            return STIM_LOST;
+        }
+        else if (((tag & REC_KIND) == REC_SCANS)
+                 || ((tag & REC_KIND) == REC_TICKS))
+        {
+            uint32_t n = (uint32_t)(tag & REC_RUN);
+            if (n == REC_RUN) { /* the varint follows */
+                uint32_t ext = 0U;
+                uint_fast8_t shift = 0U;
+                uint8_t b;
+                do {
+                    if ((me->next == me->end) || (shift > 28U)) {
+                        return STIM_BAD;
+                    }
+                    b = *me->next;
+                    ++me->next;
+                    ext |= (uint32_t)(b & 0x7FU) << shift;
+                    shift += 7U;
+                } while ((b & 0x80U) != 0U);
+                n += ext;
+            }
+            if (n == 0U) { /* an empty run of keypad scans */
+                return STIM_BAD;
+            }
+            me->ticks = n;
+            me->scan  = (uint8_t)((tag & REC_KIND) == REC_SCANS);
+        }
+        else { /* reserved for the other interrupts, see NOTE1 */
+            return STIM_BAD;
+        }
+    }
+    return STIM_TICK;
+}
+
+/*****************************************************************************
+* NOTE1:
+* The log starts with the 8-byte header: the magic "TWSL", the version (1),
+* a reserved byte and the clock tick rate in Hz (little-endian uint16_t).
+* Each record starts with a tag byte, whose two top bits select the kind:
+* 00 - a run of n clock ticks without the keypad scan (QF_TICK_X() only),
+* 01 - a run of n clock ticks, each also passing the current keypad sample
+*      to Keypad_tick().
+* The low 6 bits of a run are n for the runs of 1 to 62 ticks, or 63
+* followed by n - 63 as a little-endian base-128 varint for the longer ones.
+* 0x00 - the end of the log, so a zero-filled buffer ends the replay.
+* 0x80 - the next keypad sample (little-endian uint16_t), recorded only when
+*      the sample changes, before the tick that scans it.
+* 0x81 - the keypad wake-up (EXTI4_15) with its sample, passed to
+*      Keypad_tick() right away, between two clock ticks.
+* 0xFF - the rest of the log was lost in an overrun of the recording.
+* The other tags of the kind 10 and 11 are reserved for the other interrupt
+* sources, such as the radio receive interrupt (RxIRQ_SIG of the TR model),
+* once it has a driver. An hour of idle ticks costs 4 bytes, and a key
+* press with its release about a dozen.
+*
+* NOTE2:
+* The recording functions are called from the ISRs of one priority (SysTick,
+* EXTI4_15 and the tickless idle with the interrupts disabled), and
+* StimLog_read() from the thread of the BSP that writes the log out, never
+* concurrently with them. A run of clock ticks is kept pending until a
+* different record ends it, so StimLog_flush() must be called before the
+* last read. When the ring buffer is full, the recording stops for good
+* with the REC_LOST marker, because a gap would desynchronize the replay.
+*/
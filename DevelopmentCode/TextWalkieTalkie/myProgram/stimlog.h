@@ -0,0 +1,73 @@
+/*****************************************************************************
+* Product: TextWalkieTalkie, stimulus log (record and replay)
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+* The ISRs of the BSP record every stimulus entering the application (the
+* clock ticks and the keypad samples passed to Keypad_tick()) into a compact
+* binary log, which the host BSP replays into the same active objects, see
+* NOTE1 of stimlog.c for the format. The recording is compiled in only with
+* STIMLOG defined, the replay is always available.
+*****************************************************************************/
+#ifndef stimlog_h
+#define stimlog_h
+
+/* recording -------------------------------------------------------------*/
+/* start the recording into the ring buffer sto[] and write the header */
+void StimLog_init(uint8_t sto[], uint16_t stoSize);
+
+/* n clock ticks without the keypad scan (e.g., skipped in the idle) */
+void StimLog_ticks(uint32_t n);
+
+/* a clock tick, which scanned the keypad sample passed to Keypad_tick() */
+void StimLog_scan(uint16_t keys);
+
+/* the keypad wake-up (EXTI), which passed the sample to Keypad_tick() */
+void StimLog_wake(uint16_t keys);
+
+/* write out the pending run of clock ticks, e.g., before the last read */
+void StimLog_flush(void);
+
+/* copy at most max bytes of the log into dst[], returns the bytes copied;
+* must not preempt or be preempted by the recording
+*/
+uint16_t StimLog_read(uint8_t dst[], uint16_t max);
+
+#ifdef STIMLOG
+    #define STIMLOG_TICKS(n_)    StimLog_ticks(n_)
+    #define STIMLOG_SCAN(keys_)  StimLog_scan(keys_)
+    #define STIMLOG_WAKE(keys_)  StimLog_wake(keys_)
+#else
+    #define STIMLOG_TICKS(n_)    ((void)0)
+    #define STIMLOG_SCAN(keys_)  ((void)0)
+    #define STIMLOG_WAKE(keys_)  ((void)0)
+#endif
+
+/* replay ----------------------------------------------------------------*/
+typedef struct {
+    uint8_t const *next; /* the next record of the log */
+    uint8_t const *end;  /* the end of the log */
+    uint32_t ticks;      /* the clock ticks left in the current run */
+    uint16_t keys;       /* the current keypad sample */
+    uint8_t  scan;       /* the current run scans the keypad? */
+} StimPlayer;
+
+/* what StimPlayer_step() found next in the log */
+enum StimPlayerStep {
+    STIM_TICK,  /* the next clock tick of the current run (me->ticks != 0) */
+    STIM_WAKE,  /* a keypad wake-up with the sample me->keys */
+    STIM_END,   /* the end of the log */
+    STIM_LOST,  /* the rest of the log was lost in an overrun */
+    STIM_BAD    /* a corrupted or unknown record */
+};
+
+/* start the replay of the log, returns its clock tick rate [Hz] or 0 when
+* it is not a stimulus log
+*/
+uint16_t StimPlayer_init(StimPlayer * const me,
+                         uint8_t const *log, uint32_t size);
+
+/* decode the log up to the next clock tick or keypad wake-up */
+enum StimPlayerStep StimPlayer_step(StimPlayer * const me);
+
+#endif /* stimlog_h */
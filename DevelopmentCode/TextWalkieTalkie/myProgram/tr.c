@@ -0,0 +1,110 @@
+/*****************************************************************************
+* Model: TR.qm
+* File:  tr.c
+*
+* The TR state machine as a QMsm, generated by qmgen, DO NOT EDIT
+*****************************************************************************/
+#include "qpc.h"
+#include "tr.h"
+
+static QState TR_initial(TR * const me, QEvt const * const e);
+static QState TR_On     (TR * const me, QEvt const * const e);
+
+static QMState const TR_On_s = {
+    (QMState const *)0, /* superstate */
+    Q_STATE_CAST(&TR_On),
+    Q_ACTION_CAST(0),
+    Q_ACTION_CAST(0),
+    Q_ACTION_CAST(0)  /* no history, see NOTE1 */
+};
+
+/*..........................................................................*/
+void TR_ctor(TR * const me) {
+    QMActive_ctor(&me->super, Q_STATE_CAST(&TR_initial));
+}
+/*..........................................................................*/
+static QState TR_initial(TR * const me, QEvt const * const e) {
+    static struct {
+        QMState const *target;
+        QActionHandler const act[1];
+    } const tatbl_ = { /* transition-action table */
+        &TR_On_s, /* target state */
+        {
+            Q_ACTION_CAST(0) /* zero terminator */
+        }
+    };
+    (void)me; /* unused parameter */
+    (void)e;  /* unused parameter */
+    return QM_TRAN_INIT(&tatbl_);
+}
+
+/*..........................................................................*/
+static QState TR_On(TR * const me, QEvt const * const e) {
+    QState status_;
+    switch (e->sig) {
+        case RxIRQ_SIG: {
+            static struct {
+                QMState const *target;
+                QActionHandler const act[1];
+            } const tatbl_ = { /* transition-action table */
+                &TR_On_s, /* target state */
+                {
+                    Q_ACTION_CAST(0) /* zero terminator */
+                }
+            };
+            TR_Rx(me, e);
+            status_ = QM_TRAN(&tatbl_);
+            break;
+        }
+        case KeyIRQ_SIG: {
+            if (TR_KeyTx(me, e)) { /* [KeyTx] */
+                static struct {
+                    QMState const *target;
+                    QActionHandler const act[1];
+                } const tatbl_ = { /* transition-action table */
+                    &TR_On_s, /* target state */
+                    {
+                        Q_ACTION_CAST(0) /* zero terminator */
+                    }
+                };
+                TR_Tx(me, e);
+                status_ = QM_TRAN(&tatbl_);
+            }
+            else if (TR_KeyChar(me, e)) { /* [KeyChar] */
+                static struct {
+                    QMState const *target;
+                    QActionHandler const act[1];
+                } const tatbl_ = { /* transition-action table */
+                    &TR_On_s, /* target state */
+                    {
+                        Q_ACTION_CAST(0) /* zero terminator */
+                    }
+                };
+                TR_ProcessChar(me, e);
+                status_ = QM_TRAN(&tatbl_);
+            }
+            else if (TR_KeyOff(me, e)) { /* [KeyOff] */
+                TR_PowerOff(me, e);
+                status_ = QM_HANDLED();
+            }
+            else {
+                status_ = QM_UNHANDLED();
+            }
+            break;
+        }
+        default: {
+            status_ = QM_SUPER();
+            break;
+        }
+    }
+    return status_;
+}
+
+/*****************************************************************************
+* NOTE1:
+* The transition-action tables list all the exit, entry and initial-transition
+* actions of the transitions, computed by qmgen from the state hierarchy. The
+* initial transitions are merged into the tables of the transitions, so their
+* actions return Q_RET_NULL and the state handlers are never called to
+* discover the hierarchy. The transitions to history are not supported.
+*/
@@ -0,0 +1,44 @@
+/*****************************************************************************
+* Model: TR.qm
+* File:  tr.h
+*
+* The TR state machine as a QMsm, generated by qmgen, DO NOT EDIT
+*****************************************************************************/
+#ifndef tr_h
+#define tr_h
+
+#ifndef TR_FIRST_SIG /* see NOTE1 */
+#define TR_FIRST_SIG Q_USER_SIG
+#endif
+
+enum TRSignals {
+    RxIRQ_SIG = TR_FIRST_SIG,
+    KeyIRQ_SIG,
+    TR_MAX_SIG /* the last signal */
+};
+
+typedef struct {
+    QMActive super;
+} TR;
+
+void TR_ctor(TR * const me);
+
+/* the actions and guards with only a brief name in the model, implemented
+* by the application
+*/
+void TR_Rx(TR * const me, QEvt const * const e);
+bool TR_KeyTx(TR * const me, QEvt const * const e);
+void TR_Tx(TR * const me, QEvt const * const e);
+bool TR_KeyChar(TR * const me, QEvt const * const e);
+void TR_ProcessChar(TR * const me, QEvt const * const e);
+bool TR_KeyOff(TR * const me, QEvt const * const e);
+void TR_PowerOff(TR * const me, QEvt const * const e);
+
+#endif /* tr_h */
+
+/*****************************************************************************
+* NOTE1:
+* The signals of the model are numbered in the order of their first use from
+* TR_FIRST_SIG, so that the cases of the switch statements in the state
+* handlers are dense and the compiler can dispatch them with a jump table.
+*/
@@ -308,6 +308,16 @@ union QMAttr {
 /*! virtual table for the ::QMsm class. */
 typedef struct QMsmVtbl QMsmVtbl;
 
+#ifdef QHSM_TRAN_CACHE
+/*! transition path cache of the ::QHsm class, see QHsm_setTranCache() */
+struct QHsmTranCache;
+#endif
+
+#ifdef QHSM_SIG_MAP
+/*! handled-signal map of the ::QHsm class, see QHsm_setSigMap() */
+struct QHsmSigMap;
+#endif
+
 /*! Meta State Machine. */
 /**
 * @description
@@ -336,6 +346,12 @@ typedef struct {
     QMsmVtbl const *vptr; /*!< virtual pointer */
     union QMAttr state;   /*!< current active state (state-variable) */
     union QMAttr temp;    /*!< temporary: tran. chain, target state, etc. */
+#ifdef QHSM_TRAN_CACHE
+    struct QHsmTranCache *tranCache; /*!< transition path cache of QHsm */
+#endif
+#ifdef QHSM_SIG_MAP
+    struct QHsmSigMap *sigMap; /*!< handled-signal map of QHsm */
+#endif
 } QMsm;
 
 /*! Virtual table for the ::QMsm class. */
@@ -444,6 +460,109 @@ bool QHsm_isIn(QHsm * const me, QStateHandler const state);
 /*! the top-state. */
 QState QHsm_top(void const * const me, QEvt const * const e);
 
+/*! maximum depth of state nesting in a HSM (including the top level),
+* must be >= 3
+*/
+#ifndef QHSM_MAX_NEST_DEPTH
+#define QHSM_MAX_NEST_DEPTH 6
+#endif
+
+#ifdef QHSM_TRAN_CACHE /* transition path cache of QHsm configured? */
+
+#if (QHSM_TRAN_CACHE < 1) || (QHSM_TRAN_CACHE > 255)
+    #error "QHSM_TRAN_CACHE defined incorrectly, expected 1..255"
+#endif
+
+/*! Transition cached in the ::QHsmTranCache. */
+typedef struct {
+    QStateHandler source; /*!< source of the transition (0 when unused) */
+    QStateHandler target; /*!< target of the transition */
+    uint8_t nExit;        /*!< number of states exited from the source */
+    int8_t  ip;           /*!< index of the outermost state in path, or -1 */
+    QStateHandler path[QHSM_MAX_NEST_DEPTH]; /*!< entry path, target first */
+} QHsmTranEntry;
+
+/*! Transition path cache of ::QHsm. */
+/**
+* @description
+* The cache remembers, for the most recent QHSM_TRAN_CACHE transitions
+* (source, target), the number of the states exited from the source and
+* the entry path to the target, which QHsm_dispatch_() otherwise discovers
+* by calling the state-handlers with the empty signal and searching for the
+* LCA in QHsm_tran_(). The same cache also serves the nested initial
+* transitions. The entries depend only on the state-handlers, so the state
+* machines dispatched in the same thread (e.g., all the active objects of
+* the QV kernel) can share one cache, but a cache must not be shared by
+* state machines dispatched concurrently.
+*
+* @note The cache must be zero-initialized before use (e.g., static).
+*/
+typedef struct QHsmTranCache {
+    QHsmTranEntry entry[QHSM_TRAN_CACHE]; /*!< the cached transitions */
+    uint32_t hits;   /*!< transitions replayed from the cache */
+    uint32_t misses; /*!< transitions resolved by QHsm_tran_() */
+    uint8_t  next;   /*!< the entry to replace next (round robin) */
+} QHsmTranCache;
+
+/*! Attach the transition path cache @p cache (or 0 to detach) to a HSM. */
+void QHsm_setTranCache(QHsm * const me, QHsmTranCache * const cache);
+
+#endif /* QHSM_TRAN_CACHE */
+
+#ifdef QHSM_SIG_MAP /* handled-signal map of QHsm configured? */
+
+#if (QHSM_SIG_MAP < 2) || (QHSM_SIG_MAP > 128) \
+    || ((QHSM_SIG_MAP & (QHSM_SIG_MAP - 1)) != 0)
+    #error "QHSM_SIG_MAP defined incorrectly, expected power of 2 in 2..128"
+#endif
+
+/*! signals below this limit are tracked in the ::QHsmSigMap */
+#ifndef QHSM_SIG_MAP_SIGS
+#define QHSM_SIG_MAP_SIGS 64
+#endif
+
+/*! State known to the ::QHsmSigMap. */
+typedef struct {
+    QStateHandler state; /*!< the state-handler (0 when unused) */
+    uint8_t super;       /*!< index of the superstate (#QHSM_SIG_MAP if
+                         * not known yet) */
+    uint32_t skip[(QHSM_SIG_MAP_SIGS + 31) / 32]; /*!< bitmap of the signals
+                         * that the state passes to the superstate */
+} QHsmSigState;
+
+/*! Handled-signal map of ::QHsm. */
+/**
+* @description
+* The map is an open-addressing hash table of #QHSM_SIG_MAP states, in
+* which every state has a link to its superstate and the bitmap of the
+* signals that it does not handle. QHsm_dispatch_() follows the links over
+* the states, which are known to pass the signal to the superstate, to the
+* first state that might handle it, and QHsm_isIn() follows the links
+* without calling the state-handlers at all. The map is learned: a state
+* is marked as passing a signal through when its handler returns
+* Q_SUPER() for it. A state-handler must therefore return Q_SUPER() for a
+* signal only if it never handles that signal (a guard that evaluates to
+* false must return Q_UNHANDLED()). Alternatively the handled signals can
+* be declared with QHsmSigMap_declare() up front. The map depends only on
+* the state-handlers, so it can be shared like the ::QHsmTranCache.
+*
+* @note The map must be zero-initialized before use (e.g., static) and
+* must have room for all the states of the state machines using it.
+*/
+typedef struct QHsmSigMap {
+    QHsmSigState state[QHSM_SIG_MAP]; /*!< the known states */
+    uint32_t skipped; /*!< number of state-handler calls skipped so far */
+} QHsmSigMap;
+
+/*! Attach the handled-signal map @p map (or 0 to detach) to a HSM. */
+void QHsm_setSigMap(QHsm * const me, QHsmSigMap * const map);
+
+/*! Declare the signals handled by the state @p state in the map @p map. */
+void QHsmSigMap_declare(QHsmSigMap * const map, QStateHandler const state,
+                        QSignal const sigs[], uint_fast8_t const n);
+
+#endif /* QHSM_SIG_MAP */
+
 
 /****************************************************************************/
 /*! obtain the current QEP version number string */
@@ -82,6 +82,14 @@
     #define QF_TIMEEVT_CTR_SIZE  2
 #endif
 
+#ifdef QF_TIMEEVT_WHEEL_SIZE
+    #if ((QF_TIMEEVT_WHEEL_SIZE & (QF_TIMEEVT_WHEEL_SIZE - 1)) != 0)
+        #error "QF_TIMEEVT_WHEEL_SIZE must be a power of 2"
+    #elif ((QF_TIMEEVT_CTR_SIZE == 1) && (QF_TIMEEVT_WHEEL_SIZE > 128))
+        #error "QF_TIMEEVT_WHEEL_SIZE too large for QF_TIMEEVT_CTR_SIZE"
+    #endif
+#endif
+
 /****************************************************************************/
 struct QEQueue; /* forward declaration */
 
@@ -428,6 +436,11 @@ QEvt const *QActive_get_(QActive *const me);
 * invocation of the QF_tickX_() function. Only armed (timing out) time events
 * are in the list, so only armed time events consume CPU cycles.
 *
+* Optionally, when the macro #QF_TIMEEVT_WHEEL_SIZE is defined, the armed
+* time events are organized into a hashed timing wheel instead (see
+* qf_twheel.c), so that QF_tickX_() processes only the time events in one
+* slot of the wheel rather than all armed time events.
+*
 * @sa ::QTimeEvt for the description of the data members @n @ref oop
 *
 * @note QF manages the time events in the function QF_tickX_(), which
@@ -464,6 +477,25 @@ typedef struct QTimeEvt {
     * periodically.
     */
     QTimeEvtCtr interval;
+
+#ifdef QF_TIMEEVT_WHEEL_SIZE
+    /*! link to the @a next member of the previous time event in the list */
+    /**
+    * @description
+    * With the timing wheel (see qf_twheel.c) the armed time events are in
+    * doubly-linked lists, so that disarming takes constant time.
+    */
+    struct QTimeEvt * volatile *pprev;
+
+    /*! the tick (of the tick rate) at which the time event expires */
+    /**
+    * @description
+    * With the timing wheel the counter @a ctr is not decremented in every
+    * tick. Instead, the time event expires when the tick counter of its
+    * tick rate reaches @a due.
+    */
+    QTimeEvtCtr due;
+#endif /* QF_TIMEEVT_WHEEL_SIZE */
 } QTimeEvt;
 
 /* public functions */
@@ -637,6 +669,16 @@ void QF_onCleanup(void);
 /*! Returns 'true' if there are no armed time events at a given tick rate */
 bool QF_noTimeEvtsActiveX(uint_fast8_t const tickRate);
 
+/*! Returns the number of clock ticks until the nearest time event
+* expiration at a given tick rate (0 if no time events are armed)
+*/
+QTimeEvtCtr QF_ticksToNextX(uint_fast8_t const tickRate);
+
+/*! Advance the time events at a given tick rate by a number of clock ticks
+* without any time event expiring ("tickless" catch-up)
+*/
+void QF_tickSkipX(uint_fast8_t const tickRate, QTimeEvtCtr const nTicks);
+
 /*! Register an active object to be managed by the framework */
 void QF_add_(QActive * const a);
 
@@ -0,0 +1,399 @@
+/**
+* @file
+* @brief Header-only C++17 hierarchical state machine engine with the state
+* hierarchy resolved at compile time, interoperable with ::QActive
+* @ingroup qep
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#ifndef qhsm_ct_hpp
+#define qhsm_ct_hpp
+
+/**
+* @description
+* ::QHsm discovers the state hierarchy at run time: QHsm_dispatch_() and
+* QHsm_tran_() call the state-handlers with the reserved QEP_EMPTY_SIG_ to
+* find the superstates and then search for the least common ancestor (LCA)
+* of the source and target. In the qct engine the states are types, which
+* name their superstate, so the exit and entry chains of every transition
+* are resolved by the templates and inlined into straight-line code of the
+* exit and entry actions (see NOTE1 at the end of this file).
+*
+* A state is a class derived from qct::State<Self, Superstate> with static
+* members, which are all optional:
+* @code
+* struct Blinky_on : qct::State<Blinky_on, qct::Top> {
+*     using Initial = Blinky_off;               // initial transition
+*     static void entry(Blinky &me);            // entry action
+*     static void exit(Blinky &me);             // exit action
+*     static void init(Blinky &me);             // initial transition action
+*     template<typename X>                      // X: the current leaf state
+*     static qct::Ret handle(Blinky &me, QEvt const *e) {
+*         switch (e->sig) {
+*             case TIMEOUT_SIG: return tran<X, Blinky_off>(me);
+*             case DUMMY_SIG:   return handled();
+*         }
+*         return super();                       // try the superstate
+*     }
+* };
+* @endcode
+*
+* The state machine derives from qct::Hsm<Derived> (a plain state machine,
+* like ::QHsm) or from qct::Active<Derived> (an active object, which is a
+* ::QActive to the QF framework), defines the top-most initial transition
+* with `using Initial = ...;` and optionally the action of the top-most
+* initial transition `static void initial(Derived &me, QEvt const *e)`.
+* A qct::Active is started, posted to, armed in time events and garbage
+* collected exactly as any other ::QActive, through its ao() pointer.
+*
+* The semantics of the transitions is that of QHsm_tran_() (the action of a
+* transition executes before the exits, a transition to a superstate or a
+* substate of the source is local). The engine does not produce the QS_QEP_
+* trace records and does not maintain the QMsm::state attribute, so the
+* QS state machine records and QMsm_isInState() do not apply to it; the
+* QF records (post, get, time events) are produced as for any ::QActive.
+*/
+
+#include "qpc.h"
+
+#include <type_traits>
+
+namespace qct {
+
+/*! result of a state-handler, see QState */
+enum class Ret : uint8_t {
+    SUPER,   //!< not handled in this state, try the superstate
+    HANDLED, //!< handled (internal transition)
+    TRAN,    //!< transition taken
+    IGNORED  //!< not handled in any state of the hierarchy
+};
+
+/*! the top state, the common superstate of all states */
+struct Top {
+    using Parent  = void;
+    using Initial = void;
+};
+
+template<typename Me> struct Leaf;
+
+/*! base of all states, see the description of this file */
+template<typename Self, typename Superstate>
+struct State {
+    using Parent  = Superstate;
+    using Initial = void;
+
+    template<typename Me> static void entry(Me &) {}
+    template<typename Me> static void exit(Me &) {}
+    template<typename Me> static void init(Me &) {}
+    template<typename X, typename Me>
+    static Ret handle(Me &, QEvt const *) { return Ret::SUPER; }
+
+protected:
+    /*! take the transition from the state Self to @p Target, where @p X
+    * is the current leaf state (the template parameter of handle())
+    */
+    template<typename X, typename Target, typename Me>
+    static Ret tran(Me &me) {
+        return Me::template tran_<X, Self, Target>(me);
+    }
+    static Ret handled() { return Ret::HANDLED; }
+    static Ret super()   { return Ret::SUPER; }
+};
+
+/*! unique identity of the state @p S, see Hsm::state() */
+template<typename S>
+inline constexpr char stateId = 0;
+
+/*! is @p A the state @p D or a superstate of @p D? */
+template<typename A, typename D>
+constexpr bool isAncestorOrSelf() {
+    if constexpr (std::is_same_v<A, D>) {
+        return true;
+    }
+    else if constexpr (std::is_same_v<D, Top>) {
+        return false;
+    }
+    else {
+        return isAncestorOrSelf<A, typename D::Parent>();
+    }
+}
+
+/*! @cond INTERNAL */
+template<typename T> struct Tag { using type = T; };
+
+template<typename S, typename T>
+constexpr auto lcaTag() {
+    if constexpr (isAncestorOrSelf<S, T>()) {
+        return Tag<S>();
+    }
+    else {
+        return lcaTag<typename S::Parent, T>();
+    }
+}
+/*! @endcond */
+
+/*! the LCA of the transition from @p S to @p T, which is neither exited
+* nor entered (the superstate of S for the transition to self, otherwise
+* the nearest common superstate-or-self of S and T, as in QHsm_tran_())
+*/
+template<typename S, typename T>
+using Lca = typename std::conditional_t<std::is_same_v<S, T>,
+                                        Tag<typename S::Parent>,
+                                        decltype(lcaTag<S, T>())>::type;
+
+/*! execute the exit actions from @p X up to, but excluding, @p L */
+template<typename X, typename L, typename Me>
+inline void exitUpTo(Me &me) {
+    if constexpr (!std::is_same_v<X, L>) {
+        X::exit(me);
+        exitUpTo<typename X::Parent, L>(me);
+    }
+}
+
+/*! execute the entry actions from below @p L down to @p T */
+template<typename L, typename T, typename Me>
+inline void enterDownTo(Me &me) {
+    if constexpr (!std::is_same_v<L, T>) {
+        enterDownTo<L, typename T::Parent>(me);
+        T::entry(me);
+    }
+}
+
+/*! dispatch the event @p e in the current leaf state @p X, starting with
+* the state @p S and continuing with its superstates
+*/
+template<typename X, typename S, typename Me>
+inline Ret dispatchFrom(Me &me, QEvt const *e) {
+    if constexpr (std::is_same_v<S, Top>) {
+        return Ret::IGNORED;
+    }
+    else {
+        Ret const r = S::template handle<X>(me, e);
+        if (r == Ret::SUPER) {
+            return dispatchFrom<X, typename S::Parent>(me, e);
+        }
+        return r;
+    }
+}
+
+/*! is the leaf state @p X in the state with the identity @p id? */
+template<typename X>
+inline bool isInLeaf(char const *id) {
+    if constexpr (std::is_same_v<X, Top>) {
+        return (id == &stateId<Top>);
+    }
+    else {
+        return (id == &stateId<X>) || isInLeaf<typename X::Parent>(id);
+    }
+}
+
+/*! run-time representation of the current leaf state */
+template<typename Me>
+struct Leaf {
+    Ret (*dispatch)(Me &me, QEvt const *e);
+    bool (*isIn)(char const *id);
+    char const *id;
+};
+
+template<typename Me, typename X>
+inline Ret dispatchLeaf(Me &me, QEvt const *e) {
+    return dispatchFrom<X, X>(me, e);
+}
+
+template<typename Me, typename X>
+inline constexpr Leaf<Me> leaf = {
+    &dispatchLeaf<Me, X>, &isInLeaf<X>, &stateId<X>
+};
+
+/*! take the initial transitions nested in the state @p T and return the
+* final leaf state
+*/
+template<typename T, typename Me>
+inline Leaf<Me> const *drill(Me &me) {
+    if constexpr (std::is_void_v<typename T::Initial>) {
+        return &leaf<Me, T>;
+    }
+    else {
+        using I = typename T::Initial;
+        static_assert(isAncestorOrSelf<T, typename I::Parent>(),
+                      "initial transition must target a substate");
+        T::init(me);
+        enterDownTo<T, I>(me);
+        return drill<I>(me);
+    }
+}
+
+/****************************************************************************/
+/*! hierarchical state machine with the hierarchy resolved at compile time
+*
+* @tparam Derived the state machine class (CRTP), which defines
+*                 `using Initial = <state>;`
+*/
+template<typename Derived>
+class Hsm {
+public:
+    /*! take the top-most initial transition, see QMSM_INIT() */
+    void init(QEvt const *e) {
+        Derived &me = static_cast<Derived &>(*this);
+        using I = typename Derived::Initial;
+        Derived::initial(me, e);
+        enterDownTo<Top, I>(me);
+        m_leaf = drill<I>(me);
+    }
+
+    /*! dispatch the event @p e, see QMSM_DISPATCH() */
+    Ret dispatch(QEvt const *e) {
+#ifndef Q_NASSERT
+        /** @pre init() must have been called (Q_REQUIRE_ID() would need
+        * Q_DEFINE_THIS_MODULE in this header)
+        */
+        if (m_leaf == nullptr) {
+            Q_onAssert("qhsm_ct", 100);
+        }
+#endif
+        return (*m_leaf->dispatch)(static_cast<Derived &>(*this), e);
+    }
+
+    /*! is the state machine in the state @p S (or its substate)? */
+    template<typename S>
+    bool isIn() const {
+        return (*m_leaf->isIn)(&stateId<S>);
+    }
+
+    /*! identity of the current leaf state (the address of stateId<S>) */
+    char const *state() const {
+        return m_leaf->id;
+    }
+
+    /*! the action of the top-most initial transition (hidden by Derived) */
+    static void initial(Derived &, QEvt const *) {}
+
+    /*! @cond INTERNAL: the transition, see State::tran() */
+    template<typename X, typename S, typename T>
+    static Ret tran_(Derived &me) {
+        static_assert(isAncestorOrSelf<S, X>(),
+                      "the source must contain the current state");
+        using L = Lca<S, T>;
+        exitUpTo<X, L>(me);
+        enterDownTo<L, T>(me);
+        me.Hsm::m_leaf = drill<T>(me);
+        return Ret::TRAN;
+    }
+    /*! @endcond */
+
+protected:
+    Hsm() : m_leaf(nullptr) {}
+
+private:
+    Leaf<Derived> const *m_leaf; //!< the current leaf state
+};
+
+/*! @cond INTERNAL: the ::QActive part of qct::Active, see NOTE2 */
+struct ActiveBase {
+    QActive super;
+};
+/*! @endcond */
+
+/****************************************************************************/
+/*! active object with the compile-time state machine
+*
+* To the QF framework, qct::Active is a ::QActive whose virtual init() and
+* dispatch() operations run the compile-time state machine, so it is
+* started with QACTIVE_START(), posted to with QACTIVE_POST(), serves as
+* the target of ::QTimeEvt and its events are recycled by QF_gc(), all
+* through the ao() pointer.
+*/
+template<typename Derived>
+class Active : public ActiveBase, public Hsm<Derived> {
+public:
+    QActive *ao() { return &this->super; }
+
+protected:
+    Active() {
+        QActive_ctor(&this->super, Q_STATE_CAST(&QHsm_top));
+        this->super.super.vptr = &vtbl(this->super.super.vptr)->super;
+    }
+
+private:
+    static Derived &self(QMsm * const me) {
+        return static_cast<Derived &>(*reinterpret_cast<ActiveBase *>(me));
+    }
+    static void init_(QMsm * const me, QEvt const * const e) {
+        self(me).init(e);
+    }
+    static void dispatch_(QMsm * const me, QEvt const * const e) {
+        (void)self(me).dispatch(e);
+    }
+    /* the QActive virtual table of the port with init() and dispatch()
+    * replaced (the port can provide its own start/post operations)
+    */
+    static QActiveVtbl const *vtbl(QMsmVtbl const *base) {
+        static QActiveVtbl const v = [base]() {
+            QActiveVtbl t = *reinterpret_cast<QActiveVtbl const *>(base);
+            t.super.init     = &init_;
+            t.super.dispatch = &dispatch_;
+            return t;
+        }();
+        return &v;
+    }
+};
+
+} // namespace qct
+
+/*****************************************************************************
+* NOTE1:
+* The current state is represented at run time by a pointer to the constant
+* qct::Leaf of the current leaf state X, which holds the instantiation of
+* dispatchFrom<X, X>(). The handlers are instantiated for every leaf state
+* below them with X as the template parameter, so when a superstate S takes
+* a transition to T, the complete path X -> LCA(S, T) -> T and the nested
+* initial transitions of T are known at compile time. The transition thus
+* compiles into the sequence of the exit and entry actions (which inline
+* to nothing if the states have none) and the store of the new leaf, with
+* no search for the superstates and the LCA and no path array on the stack.
+* The price is code size: a superstate handler is instantiated once for
+* each of its leaf states.
+*
+* NOTE2:
+* ActiveBase is a standard-layout class with the QActive as its first (and
+* only) member, and it is the first base of qct::Active, so the QMsm
+* pointer passed by the framework to the virtual init() and dispatch() is
+* pointer-interconvertible with the ActiveBase, and the downcast to the
+* Derived class is a regular static_cast. The QActive is initialized by
+* QActive_ctor() with QHsm_top as a placeholder initial pseudostate, which
+* is never called, because the virtual init() is replaced.
+*/
+
+#endif /* qhsm_ct_hpp */
@@ -0,0 +1,187 @@
+/**
+* @file
+* @brief QP native, platform-independent, lock-free multiple-producer
+* single-consumer (MPSC) event queue interface
+* @ingroup qf
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#ifndef qmpscq_h
+#define qmpscq_h
+
+/**
+* @description
+* This header file is needed when the application uses the lock-free
+* ::QMpscQueue for the communication between any number of producer threads
+* and exactly one consumer, or when the QF port uses ::QMpscQueue as the
+* event queue of active objects (#QF_EQUEUE_TYPE). The QF port must provide
+* the atomic operations QF_CAS() and QF_FETCH_ADD(), as well as the memory
+* barrier QF_MEM_FENCE() and the acquire/release QF_LOAD_ACQ() and
+* QF_STORE_REL(). These are readily available on multicore hosts, but not
+* on the ARMv6-M (Cortex-M0+) MCUs, which lack the exclusive-access
+* instructions.
+*/
+
+#include "qequeue.h" /* QMpscQueue uses the ::QEQueueCtr counter type */
+
+#if !defined(QF_CAS) || !defined(QF_FETCH_ADD) || !defined(QF_MEM_FENCE) \
+    || !defined(QF_LOAD_ACQ) || !defined(QF_STORE_REL)
+    #error "QF port must define QF_CAS(), QF_FETCH_ADD(), QF_MEM_FENCE(), \
+QF_LOAD_ACQ() and QF_STORE_REL() to use QMpscQueue"
+#endif
+
+#if (QF_EQUEUE_CTR_SIZE > 2)
+    #error "QMpscQueue supports only QF_EQUEUE_CTR_SIZE of 1 or 2"
+#endif
+
+#ifdef QF_CACHE_LINE_SIZE
+    /* keep the producer and consumer data in separate cache lines */
+    #define QMPSC_PAD_(n_) uint8_t pad##n_[QF_CACHE_LINE_SIZE];
+#else
+    #define QMPSC_PAD_(n_)
+#endif
+
+/****************************************************************************/
+/*! Lock-free multiple-producer single-consumer event queue */
+/**
+* @description
+* ::QMpscQueue is a bounded ring buffer of event pointers, which can be
+* posted to concurrently from any number of threads, without any critical
+* section (except for the reference counter of a dynamic event). A producer
+* reserves a slot and claims the position of the slot in the ring buffer
+* with a single compare-and-swap of the @a ctrl word, which packs the head
+* index together with the number of free slots. Because the number of free
+* slots is checked in the same atomic operation, the @p margin semantics of
+* QEQueue_post() are preserved exactly, even under contention. The producer
+* then stores the event into its slot, which publishes the event to the
+* consumer. An empty (NULL) slot at the tail means that the queue is empty
+* or that the producer of the oldest event has not finished yet.
+*
+* The queue has a private front slot of the consumer, which is used only
+* for posting in the LIFO order by the consumer itself (self-posting and
+* QActive_recall()).
+*
+* @note Unlike ::QEQueue, the whole ring buffer is usable, so the capacity
+* of the queue is qLen.
+*
+* @sa NOTE1 in qf_mpscq.c
+*/
+typedef struct QMpscQueue {
+    /*! pointer to the start of the ring buffer, NULL marks a free slot */
+    QEvt const * volatile *ring;
+
+    /*! number of slots in the ring buffer. */
+    QEQueueCtr end;
+
+    /*! the consumer is about to block and must be signalled, see NOTE2 */
+    uint8_t volatile waiting;
+
+    QMPSC_PAD_(0)
+
+    /*! head (upper 16 bits) and number of free slots (lower 16 bits) */
+    uint32_t volatile ctrl;
+
+    /*! minimum number of free slots ever in the ring buffer. */
+    /**
+    * @description
+    * this attribute remembers the low-watermark of the queue, exactly as
+    * QEQueue::nMin, and is updated lock-free by the producers.
+    */
+    QEQueueCtr volatile nMin;
+
+    QMPSC_PAD_(1)
+
+    /*! the LIFO front slot of the consumer (consumer-owned). */
+    QEvt const *frontEvt;
+
+    /*! offset from where the next event will be extracted (consumer-owned) */
+    QEQueueCtr tail;
+
+    QMPSC_PAD_(2)
+} QMpscQueue;
+
+/* public class operations */
+
+/*! Initialize the lock-free MPSC event queue */
+void QMpscQueue_init(QMpscQueue * const me,
+                     QEvt const *qSto[], uint_fast16_t const qLen);
+
+/*! Post an event to the MPSC event queue (FIFO), from any thread. */
+bool QMpscQueue_post(QMpscQueue * const me, QEvt const * const e,
+                     uint_fast16_t const margin);
+
+/*! Post an event to the MPSC event queue (LIFO), consumer side only. */
+void QMpscQueue_postLIFO(QMpscQueue * const me, QEvt const * const e);
+
+/*! Obtain an event from the MPSC event queue, consumer side only. */
+QEvt const *QMpscQueue_get(QMpscQueue * const me);
+
+/*! Number of free entries in the MPSC queue as seen by the caller. */
+#define QMpscQueue_getNFree(me_) \
+    ((uint_fast16_t)((me_)->ctrl & (uint32_t)0xFFFFU))
+
+/*! Minimum number of free entries ever in the MPSC queue. */
+#define QMpscQueue_getNMin(me_) ((uint_fast16_t)(me_)->nMin)
+
+/****************************************************************************/
+/* interface used only inside QP implementation, but not in applications */
+#ifdef QP_IMPL
+
+/*! reserve a slot with the given margin and claim its position @p pos
+* (or only reserve the front slot when @p pos is NULL), returns the number
+* of free slots seen before the reservation (failed when <= margin)
+*/
+QEQueueCtr QMpscQueue_reserve_(QMpscQueue * const me,
+                               uint_fast16_t const margin,
+                               QEQueueCtr * const pos);
+
+/*! publish the event in the slot reserved by QMpscQueue_reserve_(),
+* returns true when the consumer is blocking and must be signalled
+*/
+bool QMpscQueue_publish_(QMpscQueue * const me, QEQueueCtr const pos,
+                         QEvt const * const e);
+
+/*! take the event from the front of the queue, consumer side only */
+QEvt const *QMpscQueue_take_(QMpscQueue * const me,
+                             QEQueueCtr * const nFree);
+
+/*! consumer about to block: returns true when the queue is still empty,
+* after which the producers will signal the consumer, see NOTE2
+*/
+bool QMpscQueue_prepareWait_(QMpscQueue * const me);
+
+#endif /* QP_IMPL */
+
+#endif /* qmpscq_h */
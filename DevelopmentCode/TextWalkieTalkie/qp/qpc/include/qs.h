@@ -120,7 +120,7 @@ enum QSpyRecords {
     QS_QEP_TRAN_HIST,     /*!< a transition to history was taken */
     QS_QEP_TRAN_EP,   /*!< a transition to entry point into a submachine */
     QS_QEP_TRAN_XP,   /*!< a transition to exit  point out of a submachine */
-    QS_QEP_RESERVED1,
+    QS_QEP_TRAN_CACHE,    /*!< a transition was added to the QHsm cache */
     QS_QEP_RESERVED0,
 
     /* [60] Miscellaneous QS records */
@@ -280,6 +280,15 @@ uint16_t QS_getByte(void);
 /*! Block-oriented interface to the QS data buffer. */
 uint8_t const *QS_getBlock(uint16_t *pNbytes);
 
+/*! Start the transmission of a block of the QS data buffer (zero-copy). */
+uint8_t const *QS_txBlock(uint16_t *pNbytes);
+
+/*! Complete the transmission of the block obtained from QS_txBlock(). */
+void QS_txDone(void);
+
+/*! Number of bytes lost so far by the overruns of the QS data buffer. */
+#define QS_getDropped() (QS_priv_.dropped)
+
 
 /* platform-specific callback functions, need to be implemented by clients */
 
@@ -399,7 +408,7 @@ QSTimeCtr QS_onGetTime(void);
 * The state machine filter affects the following QS records:
 * ::QS_QEP_STATE_ENTRY, ::QS_QEP_STATE_EXIT, ::QS_QEP_STATE_INIT,
 * ::QS_QEP_INTERN_TRAN, ::QS_QEP_TRAN, ::QS_QEP_IGNORED,
-* ::QS_QEP_TRAN_HIST, ::Q_RET_TRAN_EP, ::Q_RET_TRAN_XP
+* ::QS_QEP_TRAN_HIST, ::Q_RET_TRAN_EP, ::Q_RET_TRAN_XP, ::QS_QEP_TRAN_CACHE
 *
 * @note
 * Because active objects are state machines at the same time, the state
@@ -1065,6 +1074,8 @@ typedef struct {
     QSCtr    head;        /*!< offset to where next byte will be inserted */
     QSCtr    tail;        /*!< offset of where next event will be extracted */
     QSCtr    used;        /*!< number of bytes currently in the ring buffer */
+    QSCtr    tx;          /*!< number of bytes in transmission at the tail */
+    uint32_t dropped;     /*!< number of bytes lost by the buffer overruns */
     uint8_t  seq;         /*!< the record sequence number */
     uint8_t  chksum;      /*!< the checksum of the current record */
 
@@ -0,0 +1,169 @@
+/**
+* @file
+* @brief QP native, platform-independent, lock-free single-producer
+* single-consumer (SPSC) event queue interface
+* @ingroup qf
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#ifndef qspscq_h
+#define qspscq_h
+
+/**
+* @description
+* This header file is needed only when the application uses the lock-free
+* ::QSpscQueue for the communication between exactly one producer (a single
+* ISR or, on the host, a single thread) and exactly one consumer (typically
+* an active object). The QF port must provide the memory barrier macro
+* QF_MEM_FENCE() and can optionally provide the QF_LOAD_ACQ() and
+* QF_STORE_REL() operations, see below.
+*/
+
+#include "qequeue.h" /* QSpscQueue uses the ::QEQueueCtr counter type */
+
+/* NOTE: this header must be included after "qf_port.h" (::QActive) */
+
+#ifndef QF_MEM_FENCE
+    #error "QF_MEM_FENCE() must be defined in the QF port to use QSpscQueue"
+#endif
+
+#ifndef QF_LOAD_ACQ
+    /*! load-acquire of an index: load @p p_ into @p var_ and prevent
+    * any later memory accesses from moving before the load.
+    */
+    #define QF_LOAD_ACQ(var_, p_) do { \
+        (var_) = *(p_); \
+        QF_MEM_FENCE(); \
+    } while (0)
+#endif
+
+#ifndef QF_STORE_REL
+    /*! store-release of an index: store @p v_ into @p p_ after all
+    * earlier memory accesses have completed.
+    */
+    #define QF_STORE_REL(p_, v_) do { \
+        QF_MEM_FENCE(); \
+        *(p_) = (v_); \
+    } while (0)
+#endif
+
+#ifdef QF_CACHE_LINE_SIZE
+    /* keep the producer and consumer indices in separate cache lines */
+    #define QSPSC_PAD_(n_) uint8_t pad##n_[QF_CACHE_LINE_SIZE];
+#else
+    #define QSPSC_PAD_(n_)
+#endif
+
+/****************************************************************************/
+/*! Lock-free single-producer single-consumer event queue */
+/**
+* @description
+* ::QSpscQueue is a bounded ring buffer of event pointers, in which the
+* producer owns the head index and the consumer owns the tail index. Each
+* side only reads the index of the other side, so neither QSpscQueue_post()
+* nor QSpscQueue_get() needs a critical section for static events. (Posting
+* a dynamic event still needs a very short critical section to increment
+* the event's reference counter, exactly as in QEQueue_post().)
+*
+* The queue can optionally "ring a doorbell" in an active object. When the
+* doorbell is configured in QSpscQueue_init(), QSpscQueue_post() posts the
+* doorbell event to the active object only when the posted event found the
+* queue empty. The active object then drains the queue with QSpscQueue_get()
+* until it returns NULL. This way the AO queue and the QF critical section
+* are engaged only once per burst of events rather than once per event.
+*
+* @note The ring buffer always keeps one slot empty, so the capacity of
+* the queue is qLen - 1.
+*
+* @attention The queue is correct only if there is exactly one producer and
+* exactly one consumer at any given time. Posting to the same QSpscQueue from
+* two ISRs (or two threads) leads to lost events.
+*/
+typedef struct QSpscQueue {
+    /*! pointer to the start of the ring buffer. */
+    QEvt const **ring;
+
+    /*! active object to notify when the queue becomes not empty (or NULL) */
+    QActive *act;
+
+    /*! the doorbell event posted to @a act */
+    QEvt const *doorbell;
+
+    /*! number of slots in the ring buffer. */
+    QEQueueCtr end;
+
+    /*! minimum number of free events ever in the ring buffer. */
+    /**
+    * @description
+    * this attribute is updated only by the producer and remembers the
+    * low-watermark of the ring buffer, exactly as QEQueue::nMin.
+    */
+    QEQueueCtr nMin;
+
+    QSPSC_PAD_(0)
+
+    /*! offset to where the next event will be inserted (producer-owned). */
+    QEQueueCtr volatile head;
+
+    QSPSC_PAD_(1)
+
+    /*! offset from where the next event will be extracted (consumer-owned) */
+    QEQueueCtr volatile tail;
+
+    QSPSC_PAD_(2)
+} QSpscQueue;
+
+/* public class operations */
+
+/*! Initialize the lock-free SPSC event queue */
+void QSpscQueue_init(QSpscQueue * const me,
+                     QEvt const *qSto[], uint_fast16_t const qLen,
+                     QActive * const act,
+                     QEvt const * const doorbell);
+
+/*! Post an event to the SPSC event queue (FIFO), producer side only. */
+bool QSpscQueue_post(QSpscQueue * const me, QEvt const * const e,
+                     uint_fast16_t const margin);
+
+/*! Obtain an event from the SPSC event queue, consumer side only. */
+QEvt const *QSpscQueue_get(QSpscQueue * const me);
+
+/*! Number of free entries in the SPSC queue as seen by the caller. */
+uint_fast16_t QSpscQueue_getNFree(QSpscQueue const * const me);
+
+/*! Minimum number of free entries ever in the SPSC queue. */
+#define QSpscQueue_getNMin(me_) ((uint_fast16_t)(me_)->nMin)
+
+#endif /* qspscq_h */
@@ -82,6 +82,9 @@
 #define QF_CRIT_EXIT(dummy)     QF_INT_ENABLE()
 #define QF_CRIT_EXIT_NOP()      __nop()
 
+/* memory barrier for the lock-free QSpscQueue (qspscq.h), see NOTE6 */
+#define QF_MEM_FENCE()          __dmb(0xF)
+
 #include "qep_port.h" /* QEP port */
 #include "qv_port.h"  /* QV port cooperative kernel port */
 #include "qf.h"       /* QF platform-independent public interface */
@@ -126,6 +129,12 @@
 * the macro QF_AWARE_ISR_CMSIS_PRI is intended only for applications and
 * is not used inside the QF port, which remains generic and not dependent
 * on the number of implemented priority bits in the NVIC.
+*
+* NOTE6:
+* On the single-core Cortex-M the data memory barrier is needed only to keep
+* the compiler and the write buffer from reordering the accesses to the ring
+* buffer of the lock-free QSpscQueue with the accesses to its head and tail
+* indices. The default QF_LOAD_ACQ()/QF_STORE_REL() in qspscq.h build on it.
 */
 
 #endif /* qf_port_h */
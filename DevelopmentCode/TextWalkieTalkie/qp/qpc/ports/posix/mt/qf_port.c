@@ -0,0 +1,275 @@
+/**
+* @file
+* @brief QF/C port to POSIX, thread-per-active-object, implementation of
+* kernel-specific functions.
+* @ingroup ports
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+#include <time.h>         /* for clock_gettime() */
+#include <errno.h>        /* for ETIMEDOUT */
+
+Q_DEFINE_THIS_MODULE("qf_port")
+
+/**
+* @note This module replaces qv.c in the host build. Every active object
+* gets its own POSIX thread, so the RTC steps of different active objects
+* can run concurrently on different cores, while the RTC semantics of each
+* individual active object are preserved by its single thread.
+*/
+
+/* Global objects ==========================================================*/
+pthread_mutex_t QF_pThreadMutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+/* Local objects ===========================================================*/
+static bool     l_isRunning;  /* flag indicating when QF is running */
+static uint32_t l_tickHz = 100U; /* tick rate of QF_run() [Hz] */
+static uint32_t l_tickCtr;    /* clock ticks since QF_run() */
+static pthread_cond_t l_runCond; /* wakes up QF_run() when QF is stopped */
+
+/* active objects with a thread to join at the end of QF_run() */
+static QActive *l_threadAO[QF_MAX_ACTIVE + 1];
+
+static void *aoThread(void *arg);
+
+/****************************************************************************/
+void QF_init(void) {
+    extern uint_fast8_t QF_maxPool_;
+    extern QTimeEvt QF_timeEvtHead_[QF_MAX_TICK_RATE];
+    pthread_condattr_t attr;
+
+    QF_maxPool_ = (uint_fast8_t)0;
+    QF_bzero(&QF_timeEvtHead_[0], (uint_fast16_t)sizeof(QF_timeEvtHead_));
+    QF_bzero(&QF_active_[0],      (uint_fast16_t)sizeof(QF_active_));
+    QF_bzero(&l_threadAO[0],      (uint_fast16_t)sizeof(l_threadAO));
+
+    /* the tick deadlines in QF_run() are on the monotonic clock */
+    (void)pthread_condattr_init(&attr);
+    (void)pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    (void)pthread_cond_init(&l_runCond, &attr);
+    (void)pthread_condattr_destroy(&attr);
+
+    /* the AO threads start running already in QActive_start_() */
+    l_isRunning = true;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Causes QF_run() to return after all active object threads have finished
+* their current RTC steps. Can be called from any thread, including from
+* the RTC step of an active object and from the QF_onClockTick() callback.
+*/
+void QF_stop(void) {
+    uint_fast8_t p;
+
+    QF_INT_DISABLE();
+    l_isRunning = false;
+    (void)pthread_cond_signal(&l_runCond);
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        if (l_threadAO[p] != (QActive *)0) {
+            (void)pthread_cond_signal(&l_threadAO[p]->osObject);
+        }
+    }
+    QF_INT_ENABLE();
+}
+
+/****************************************************************************/
+void QF_setTickRate(uint32_t ticksPerSec) {
+    l_tickHz = ticksPerSec;
+}
+
+/****************************************************************************/
+/**
+* @description
+* The clock ticks counted since QF_run(), incremented right before every
+* call to QF_onClockTick(). It can be called from any thread.
+*/
+uint32_t QF_getTickCtr(void) {
+    return __atomic_load_n(&l_tickCtr, __ATOMIC_ACQUIRE);
+}
+
+/****************************************************************************/
+/**
+* @description
+* In this port the thread calling QF_run() becomes the "SysTick" thread,
+* which calls QF_onClockTick() on absolute CLOCK_MONOTONIC deadlines until
+* QF_stop() is called. Then it joins all active object threads.
+*
+* @returns 0 for success, which is passed on as return from main().
+*/
+int_t QF_run(void) {
+    struct timespec next;
+    long period = 0L;
+    uint_fast8_t p;
+
+    QF_onStartup(); /* application-specific startup callback */
+
+    if (l_tickHz != (uint32_t)0) {
+        period = (long)(1000000000L / (long)l_tickHz);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &next);
+    __atomic_store_n(&l_tickCtr, (uint32_t)0, __ATOMIC_RELEASE);
+
+    QF_INT_DISABLE();
+    while (l_isRunning) {
+        if (period == 0L) { /* no clock tick? */
+            (void)pthread_cond_wait(&l_runCond, &QF_pThreadMutex_);
+        }
+        else {
+            next.tv_nsec += period;
+            if (next.tv_nsec >= 1000000000L) {
+                next.tv_nsec -= 1000000000L;
+                ++next.tv_sec;
+            }
+            /* a spurious wake-up only delays the tick to the next deadline,
+            * so the tick count might fall behind but never runs ahead
+            */
+            if ((pthread_cond_timedwait(&l_runCond, &QF_pThreadMutex_,
+                                        &next) == ETIMEDOUT)
+                && l_isRunning)
+            {
+                QF_INT_ENABLE();
+                (void)__atomic_add_fetch(&l_tickCtr, (uint32_t)1,
+                                         __ATOMIC_ACQ_REL);
+                QF_onClockTick(); /* the "ISR" provided by the application */
+                QF_INT_DISABLE();
+            }
+        }
+    }
+    QF_INT_ENABLE();
+
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        if (l_threadAO[p] != (QActive *)0) {
+            (void)pthread_join(l_threadAO[p]->thread, (void **)0);
+            (void)pthread_cond_destroy(&l_threadAO[p]->osObject);
+            l_threadAO[p] = (QActive *)0;
+        }
+    }
+    (void)pthread_cond_destroy(&l_runCond);
+
+    QF_onCleanup(); /* application-specific cleanup callback */
+
+    return (int_t)0;
+}
+
+/****************************************************************************/
+void QActive_start_(QActive * const me, uint_fast8_t prio,
+                    QEvt const *qSto[], uint_fast16_t qLen,
+                    void *stkSto, uint_fast16_t stkSize,
+                    QEvt const *ie)
+{
+    /** @pre the priority must be in range and the stack storage must not
+    * be provided, because the POSIX threads allocate their own stacks.
+    */
+    Q_REQUIRE_ID(400, ((uint_fast8_t)0 < prio)
+                 && (prio <= (uint_fast8_t)QF_MAX_ACTIVE)
+                 && (stkSto == (void *)0));
+
+    (void)stkSize; /* avoid the "unused parameter" compiler warning */
+
+#ifdef QF_MPSC_EQUEUE
+    QMpscQueue_init(&me->eQueue, qSto, qLen);
+#else
+    QEQueue_init(&me->eQueue, qSto, qLen);
+#endif
+    (void)pthread_cond_init(&me->osObject, (pthread_condattr_t *)0);
+    me->prio = prio; /* set QF priority of this AO before adding it to QF */
+    QF_add_(me);     /* make QF aware of this active object */
+    QMSM_INIT(&me->super, ie); /* take the top-most initial tran. */
+
+    QS_FLUSH(); /* flush the QS trace buffer to the host */
+
+    QF_INT_DISABLE();
+    Q_ALLEGE_ID(410, pthread_create(&me->thread, (pthread_attr_t *)0,
+                                    &aoThread, me) == 0);
+    l_threadAO[prio] = me;
+    QF_INT_ENABLE();
+}
+
+/****************************************************************************/
+/**
+* @description
+* Removes the AO from the framework. The AO thread finishes its current
+* RTC step (if any) and exits. The thread is joined in QF_run().
+*/
+void QActive_stop(QActive * const me) {
+    QF_remove_(me);  /* remove the AO from the framework */
+
+    QF_INT_DISABLE();
+    (void)pthread_cond_signal(&me->osObject); /* let the AO thread exit */
+    QF_INT_ENABLE();
+}
+
+/****************************************************************************/
+/* the thread of every active object, see NOTE3 in qf_port.h */
+static void *aoThread(void *arg) {
+    QActive *act = (QActive *)arg;
+
+    QF_INT_DISABLE();
+    for (;;) {
+        QEvt const *e;
+
+        while (QACTIVE_EQUEUE_ISEMPTY_(act)
+               && l_isRunning
+               && (QF_active_[act->prio] == act))
+        {
+            (void)pthread_cond_wait(&act->osObject, &QF_pThreadMutex_);
+        }
+        if ((!l_isRunning) || (QF_active_[act->prio] != act)) {
+            break; /* QF stopped or this AO stopped */
+        }
+        QF_INT_ENABLE();
+
+        /* perform the run-to-completion (RTC) step... */
+        e = QActive_get_(act); /* the queue is not empty, does not block */
+        QMSM_DISPATCH(&act->super, e);
+        QF_gc(e);
+
+        QF_INT_DISABLE();
+    }
+    QF_INT_ENABLE();
+
+    return (void *)0;
+}
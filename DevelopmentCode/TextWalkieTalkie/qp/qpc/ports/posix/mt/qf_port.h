@@ -0,0 +1,180 @@
+/**
+* @file
+* @brief QF/C port to POSIX, thread-per-active-object, GNU-C99 compiler
+* @ingroup ports
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#ifndef qf_port_h
+#define qf_port_h
+
+/* POSIX event queue and thread types */
+#ifdef QF_MPSC_EQUEUE /* lock-free multiple-producer AO queues, see NOTE5 */
+    #define QF_EQUEUE_TYPE      QMpscQueue
+#else
+    #define QF_EQUEUE_TYPE      QEQueue
+#endif
+#define QF_OS_OBJECT_TYPE       pthread_cond_t
+#define QF_THREAD_TYPE          pthread_t
+
+/* The maximum number of active objects in the application */
+#define QF_MAX_ACTIVE           63
+
+/* The maximum number of system clock tick rates */
+#define QF_MAX_TICK_RATE        2
+
+/* QF "interrupt" disable/enable, see NOTE1 */
+#define QF_INT_DISABLE()        pthread_mutex_lock(&QF_pThreadMutex_)
+#define QF_INT_ENABLE()         pthread_mutex_unlock(&QF_pThreadMutex_)
+
+/* QF critical section entry/exit */
+/* QF_CRIT_STAT_TYPE not defined: unconditional interrupt disabling" policy */
+#define QF_CRIT_ENTRY(dummy)    QF_INT_DISABLE()
+#define QF_CRIT_EXIT(dummy)     QF_INT_ENABLE()
+#define QF_CRIT_EXIT_NOP()      ((void)0)
+
+/* GNU-C provides the count-leading-zeros builtin for fast LOG2 */
+#define QF_LOG2(n_) ((uint8_t)(32U - __builtin_clz((unsigned)(n_))))
+
+/* memory ordering for the lock-free QSpscQueue (qspscq.h), see NOTE4 */
+#define QF_MEM_FENCE()          __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define QF_LOAD_ACQ(var_, p_) \
+    ((var_) = __atomic_load_n((p_), __ATOMIC_ACQUIRE))
+#define QF_STORE_REL(p_, v_)    __atomic_store_n((p_), (v_), __ATOMIC_RELEASE)
+#define QF_CACHE_LINE_SIZE      64
+
+/* atomic read-modify-write for the lock-free QMpscQueue (qmpscq.h) */
+#define QF_CAS(p_, pExp_, new_) \
+    __atomic_compare_exchange_n((p_), (pExp_), (new_), false, \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define QF_FETCH_ADD(p_, v_)    __atomic_fetch_add((p_), (v_), __ATOMIC_ACQ_REL)
+
+#include <pthread.h>  /* POSIX-thread API */
+
+#include "qep_port.h" /* QEP port */
+#include "qequeue.h"  /* POSIX port needs event-queue */
+#ifdef QF_MPSC_EQUEUE
+#include "qmpscq.h"   /* lock-free MPSC event queue for active objects */
+#endif
+#include "qmpool.h"   /* POSIX port needs memory-pool */
+#include "qpset.h"    /* POSIX port needs priority-set */
+#include "qf.h"       /* QF platform-independent public interface */
+
+/* set the clock tick rate, see NOTE2 */
+void QF_setTickRate(uint32_t ticksPerSec);
+
+/* clock tick callback (provided in the app), called from QF_run() */
+void QF_onClockTick(void);
+
+/* clock ticks since QF_run() */
+uint32_t QF_getTickCtr(void);
+
+/* mutex for QF "interrupt" disabling and critical sections */
+extern pthread_mutex_t QF_pThreadMutex_;
+
+/****************************************************************************/
+/* interface used only inside QP implementation, but not in applications */
+#ifdef QP_IMPL
+
+    /* event queue operations, see NOTE3 */
+    #ifdef QF_MPSC_EQUEUE
+        /* also announces that the AO thread is blocking, see NOTE5 */
+        #define QACTIVE_EQUEUE_ISEMPTY_(me_) \
+            QMpscQueue_prepareWait_(&(me_)->eQueue)
+    #else
+        #define QACTIVE_EQUEUE_ISEMPTY_(me_) \
+            ((me_)->eQueue.frontEvt == (QEvt *)0)
+    #endif
+    #define QACTIVE_EQUEUE_WAIT_(me_) \
+        while (QACTIVE_EQUEUE_ISEMPTY_(me_)) { \
+            (void)pthread_cond_wait(&(me_)->osObject, &QF_pThreadMutex_); \
+        }
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) \
+        ((void)pthread_cond_signal(&(me_)->osObject))
+    #define QACTIVE_EQUEUE_ONEMPTY_(me_) ((void)0)
+
+    /* native QF event pool operations */
+    #define QF_EPOOL_TYPE_            QMPool
+    #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
+        (QMPool_init(&(p_), (poolSto_), (poolSize_), (evtSize_)))
+    #define QF_EPOOL_EVENT_SIZE_(p_)  ((uint_fast16_t)(p_).blockSize)
+    #define QF_EPOOL_GET_(p_, e_, m_) ((e_) = (QEvt *)QMPool_get(&(p_), (m_)))
+    #define QF_EPOOL_PUT_(p_, e_)     (QMPool_put(&(p_), (e_)))
+
+#endif /* QP_IMPL */
+
+/*****************************************************************************
+* NOTE1:
+* As in the ports/posix/qv port, the "interrupt disabling" policy locks the
+* single mutex QF_pThreadMutex_. The mutex protects only the short QF
+* critical sections (posting, event allocation, time events). The RTC steps
+* of different active objects run outside the mutex, truly in parallel, on
+* as many cores as the host provides.
+*
+* NOTE2:
+* In this port there is no separate tick thread. Instead, the main thread
+* that calls QF_run() calls QF_onClockTick() at the rate set with
+* QF_setTickRate(), until QF_stop() is called. When the tick rate is set to
+* zero, the main thread just waits for QF_stop().
+*
+* NOTE3:
+* Each active object runs in its own POSIX thread, which blocks on the
+* condition variable osObject while its event queue is empty. The condition
+* variable is signalled only when an event is posted to an empty queue,
+* because only then the AO thread can be blocked. The QF priorities of the
+* active objects are not mapped to thread priorities (which would require
+* a real-time scheduling policy and privileges), so they only serve as
+* unique identifiers of the active objects in this port.
+*
+* NOTE4:
+* The lock-free QSpscQueue relies on the acquire/release ordering of its head
+* and tail indices, which on a multicore host requires the GCC __atomic
+* builtins rather than just the volatile accesses sufficient on a single-core
+* MCU. The producer and consumer indices are padded to separate cache lines
+* (QF_CACHE_LINE_SIZE) to avoid false sharing between the two cores.
+*
+* NOTE5:
+* With the native QEQueue every post to an active object locks the single
+* QF_pThreadMutex_, so the producers posting from many cores serialize on
+* the mutex. When QF_MPSC_EQUEUE is defined (make MPSC=1), the active
+* objects use the lock-free QMpscQueue instead and qf_actq_mpsc.c replaces
+* qf_actq.c. The producers then lock the mutex only to signal an AO thread
+* that has announced (in QACTIVE_EQUEUE_ISEMPTY_()) that it is about to
+* block on its empty queue. The margin and the nMin low-watermark keep the
+* same semantics as with QEQueue, but the LIFO posting is limited to a single
+* pending self-posted (or recalled) event.
+*/
+
+#endif /* qf_port_h */
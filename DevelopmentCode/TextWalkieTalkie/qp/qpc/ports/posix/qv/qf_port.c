@@ -0,0 +1,308 @@
+/**
+* @file
+* @brief QF/C port to POSIX, cooperative QV kernel, definition of
+* ::QV_readySet_ and implementation of kernel-specific functions.
+* @ingroup ports
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+#include <time.h>         /* for clock_nanosleep(), clock_gettime() */
+#include <errno.h>        /* for EINTR */
+
+Q_DEFINE_THIS_MODULE("qf_port")
+
+/**
+* @note This module replaces qv.c in the host build. It implements the same
+* cooperative QV event loop, but on top of a single POSIX thread, while the
+* "interrupts" (the clock tick and any BSP stimuli) run in separate threads
+* serialized by the QF_pThreadMutex_.
+*/
+
+/* Global objects ==========================================================*/
+pthread_mutex_t QF_pThreadMutex_ = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t  QV_condVar_      = PTHREAD_COND_INITIALIZER;
+
+/* Package-scope objects ****************************************************/
+QPSet64 QV_readySet_; /* QV-ready set of active objects */
+
+/* Local objects ===========================================================*/
+static bool      l_isRunning;  /* flag indicating when QF is running */
+static uint32_t  l_tickHz = 100U; /* tick rate of the tick thread [Hz] */
+static uint32_t  l_tickCtr;    /* clock ticks since QF_run() */
+
+#ifndef QF_VIRTUAL_TIME
+static pthread_t l_tickThread; /* the "SysTick" thread */
+
+static void *tickThread(void *arg);
+#endif
+
+/****************************************************************************/
+void QF_init(void) {
+    extern uint_fast8_t QF_maxPool_;
+    extern QTimeEvt QF_timeEvtHead_[QF_MAX_TICK_RATE];
+
+    /* clear the internal QF variables, so that the framework can start
+    * correctly even if QF_init() is called again, such as in benchmarks
+    * that run several QF sessions in the same process.
+    */
+    QF_maxPool_ = (uint_fast8_t)0;
+    QF_bzero(&QV_readySet_,       (uint_fast16_t)sizeof(QV_readySet_));
+    QF_bzero(&QF_timeEvtHead_[0], (uint_fast16_t)sizeof(QF_timeEvtHead_));
+    QF_bzero(&QF_active_[0],      (uint_fast16_t)sizeof(QF_active_));
+}
+
+/****************************************************************************/
+/**
+* @description
+* On the host QF_stop() causes QF_run() to return. It can be called from
+* any thread, including from the RTC step of an active object and from
+* the QF_onClockTick() callback.
+*/
+void QF_stop(void) {
+    QF_INT_DISABLE();
+    l_isRunning = false;
+    (void)pthread_cond_signal(&QV_condVar_); /* wake up the QV loop */
+    QF_INT_ENABLE();
+}
+
+/****************************************************************************/
+void QF_setTickRate(uint32_t ticksPerSec) {
+    l_tickHz = ticksPerSec;
+}
+
+/****************************************************************************/
+/**
+* @description
+* The clock ticks counted since QF_run(), incremented right before every
+* call to QF_onClockTick(). With QF_VIRTUAL_TIME it is the virtual time,
+* which includes the ticks skipped in QV_virtualSleep_(). It can be called
+* with or without the QF_pThreadMutex_ locked.
+*/
+uint32_t QF_getTickCtr(void) {
+    return __atomic_load_n(&l_tickCtr, __ATOMIC_ACQUIRE);
+}
+
+/****************************************************************************/
+/**
+* @description
+* The QV event loop is identical to the one in qv.c, except that it runs
+* only as long as QF_stop() has not been called. The mutex is held across
+* the scheduling decision and across the call to QV_onIdle(), exactly as
+* interrupts are disabled on the target.
+*
+* @returns 0 for success, which is passed on as return from main().
+*/
+int_t QF_run(void) {
+    bool tickStarted = false;
+
+    QF_INT_DISABLE();
+    l_isRunning = true;
+    __atomic_store_n(&l_tickCtr, (uint32_t)0, __ATOMIC_RELEASE);
+    QF_INT_ENABLE();
+
+    QF_onStartup(); /* application-specific startup callback */
+
+#ifndef QF_VIRTUAL_TIME /* the virtual clock needs no tick thread */
+    if (l_tickHz != (uint32_t)0) {
+        Q_ALLEGE_ID(100, pthread_create(&l_tickThread, (pthread_attr_t *)0,
+                                        &tickThread, (void *)0) == 0);
+        tickStarted = true;
+    }
+#endif
+
+    /* the combined event-loop and background-loop of the QV kernel */
+    QF_INT_DISABLE();
+    while (l_isRunning) {
+        QEvt const *e;
+        QActive *a;
+        uint_fast8_t p;
+
+        /* find the maximum priority AO ready to run */
+        if (QPSet64_notEmpty(&QV_readySet_)) {
+            QPSet64_findMax(&QV_readySet_, p);
+            a = QF_active_[p];
+            QF_INT_ENABLE();
+
+            /* perform the run-to-completion (RTC) step... */
+#ifdef QV_RTC_STEP_TIMING /* see NOTE6 in qf_port.h */
+            {
+                struct timespec t0;
+                struct timespec t1;
+                QSignal sig;
+
+                (void)clock_gettime(CLOCK_MONOTONIC, &t0);
+                e = QActive_get_(a);
+                sig = e->sig;
+                QMSM_DISPATCH(&a->super, e);
+                QF_gc(e);
+                (void)clock_gettime(CLOCK_MONOTONIC, &t1);
+                QV_onRtcStep(a, sig, (uint32_t)
+                    (((t1.tv_sec - t0.tv_sec) * 1000000000L)
+                     + (t1.tv_nsec - t0.tv_nsec)));
+            }
+#else
+            e = QActive_get_(a);
+            QMSM_DISPATCH(&a->super, e);
+            QF_gc(e);
+#endif
+        }
+        else {
+            QV_onIdle(); /* see NOTE1 in qv_port.h */
+        }
+        QF_INT_DISABLE();
+    }
+    QF_INT_ENABLE();
+
+#ifndef QF_VIRTUAL_TIME
+    if (tickStarted) {
+        (void)pthread_join(l_tickThread, (void **)0);
+    }
+#else
+    (void)tickStarted; /* avoid the "unused variable" compiler warning */
+#endif
+    QF_onCleanup(); /* application-specific cleanup callback */
+
+    return (int_t)0;
+}
+
+/****************************************************************************/
+void QActive_start_(QActive * const me, uint_fast8_t prio,
+                    QEvt const *qSto[], uint_fast16_t qLen,
+                    void *stkSto, uint_fast16_t stkSize,
+                    QEvt const *ie)
+{
+    /** @pre the priority must be in range and the stack storage must not
+    * be provided, because the QV kernel does not need per-AO stacks.
+    */
+    Q_REQUIRE_ID(400, ((uint_fast8_t)0 < prio)
+                 && (prio <= (uint_fast8_t)QF_MAX_ACTIVE)
+                 && (stkSto == (void *)0));
+
+    (void)stkSize; /* avoid the "unused parameter" compiler warning */
+
+    QEQueue_init(&me->eQueue, qSto, qLen);
+    me->prio = prio; /* set QF priority of this AO before adding it to QF */
+    QF_add_(me);     /* make QF aware of this active object */
+    QMSM_INIT(&me->super, ie); /* take the top-most initial tran. */
+
+    QS_FLUSH(); /* flush the QS trace buffer to the host */
+}
+
+/****************************************************************************/
+void QActive_stop(QActive * const me) {
+    QF_remove_(me);  /* remove the AO from the framework */
+}
+
+#ifdef QF_VIRTUAL_TIME
+/****************************************************************************/
+/**
+* @description
+* The CPU "sleep" of the virtual time (QV_CPU_SLEEP()), called from
+* QV_onIdle() with the QF_pThreadMutex_ locked when all the event queues
+* are empty, see NOTE5 in qf_port.h. Instead of waiting for the next clock
+* tick, the virtual clock jumps straight to the tick of the nearest time
+* event armed at the tick rate 0 (QF_ticksToNextX()), or to an earlier tick
+* returned from QF_onVirtualIdle(), such as the next scheduled stimulus of
+* the BSP. The ticks before it are accounted for with QF_tickSkipX() in one
+* pass and only the last one is processed with QF_onClockTick(). When
+* nothing at all is scheduled, QF_run() returns, because no other thread
+* can ever post an event.
+*/
+void QV_virtualSleep_(void) {
+    uint32_t const nTicks = (uint32_t)QF_ticksToNextX((uint_fast8_t)0);
+    uint32_t const ticks = QF_onVirtualIdle(nTicks);
+
+    /** @pre the BSP must not skip over the nearest time event */
+    Q_REQUIRE_ID(500, (nTicks == (uint32_t)0) || (ticks <= nTicks));
+
+    if (ticks == (uint32_t)0) { /* nothing scheduled, the system is idle */
+        l_isRunning = false;
+        QF_INT_ENABLE();
+    }
+    else {
+        if ((nTicks != (uint32_t)0) && (ticks > (uint32_t)1)) {
+            QF_tickSkipX((uint_fast8_t)0, (QTimeEvtCtr)(ticks - 1U));
+        }
+        __atomic_store_n(&l_tickCtr, l_tickCtr + ticks, __ATOMIC_RELEASE);
+        QF_INT_ENABLE();
+
+        QF_onClockTick(); /* the tick in which the nearest event happens */
+    }
+}
+
+#else /* the real-time clock ticks */
+
+/****************************************************************************/
+/* the "SysTick" thread, see NOTE3 in qf_port.h */
+static void *tickThread(void *arg) {
+    long const period = (long)(1000000000L / (long)l_tickHz);
+    struct timespec next;
+    bool running = true;
+
+    (void)arg; /* unused parameter */
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &next);
+    while (running) {
+        next.tv_nsec += period;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            ++next.tv_sec;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+                               (struct timespec *)0) == EINTR) {
+        }
+
+        QF_INT_DISABLE();
+        running = l_isRunning;
+        QF_INT_ENABLE();
+
+        if (running) {
+            (void)__atomic_add_fetch(&l_tickCtr, (uint32_t)1,
+                                     __ATOMIC_ACQ_REL);
+            QF_onClockTick(); /* the "ISR" provided by the application */
+        }
+    }
+    return (void *)0;
+}
+#endif /* QF_VIRTUAL_TIME */
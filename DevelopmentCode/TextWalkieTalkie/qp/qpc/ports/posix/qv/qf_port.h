@@ -0,0 +1,157 @@
+/**
+* @file
+* @brief QF/C port to POSIX, cooperative QV kernel, GNU-C99 compiler
+* @ingroup ports
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#ifndef qf_port_h
+#define qf_port_h
+
+/* The maximum number of active objects in the application, see NOTE1 */
+#define QF_MAX_ACTIVE           63
+
+/* The maximum number of system clock tick rates */
+#define QF_MAX_TICK_RATE        2
+
+/* QF "interrupt" disable/enable, see NOTE2 */
+#define QF_INT_DISABLE()        pthread_mutex_lock(&QF_pThreadMutex_)
+#define QF_INT_ENABLE()         pthread_mutex_unlock(&QF_pThreadMutex_)
+
+/* QF critical section entry/exit */
+/* QF_CRIT_STAT_TYPE not defined: unconditional interrupt disabling" policy */
+#define QF_CRIT_ENTRY(dummy)    QF_INT_DISABLE()
+#define QF_CRIT_EXIT(dummy)     QF_INT_ENABLE()
+#define QF_CRIT_EXIT_NOP()      ((void)0)
+
+/* GNU-C provides the count-leading-zeros builtin for fast LOG2 */
+#define QF_LOG2(n_) ((uint8_t)(32U - __builtin_clz((unsigned)(n_))))
+
+/* memory ordering for the lock-free QSpscQueue (qspscq.h), see NOTE4 */
+#define QF_MEM_FENCE()          __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define QF_LOAD_ACQ(var_, p_) \
+    ((var_) = __atomic_load_n((p_), __ATOMIC_ACQUIRE))
+#define QF_STORE_REL(p_, v_)    __atomic_store_n((p_), (v_), __ATOMIC_RELEASE)
+#define QF_CACHE_LINE_SIZE      64
+
+/* atomic read-modify-write for the lock-free QMpscQueue (qmpscq.h) */
+#define QF_CAS(p_, pExp_, new_) \
+    __atomic_compare_exchange_n((p_), (pExp_), (new_), false, \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define QF_FETCH_ADD(p_, v_)    __atomic_fetch_add((p_), (v_), __ATOMIC_ACQ_REL)
+
+#include <pthread.h>  /* POSIX-thread API */
+
+#include "qep_port.h" /* QEP port */
+#include "qv_port.h"  /* QV port cooperative kernel port */
+#include "qf.h"       /* QF platform-independent public interface */
+
+/* set the clock tick rate for the tick thread, see NOTE3 */
+void QF_setTickRate(uint32_t ticksPerSec);
+
+/* clock tick callback (provided in the app), called from the tick thread */
+void QF_onClockTick(void);
+
+/* clock ticks since QF_run(), the virtual time with QF_VIRTUAL_TIME */
+uint32_t QF_getTickCtr(void);
+
+#ifdef QF_VIRTUAL_TIME
+/* virtual-time idle callback (provided in the app), see NOTE5 */
+uint32_t QF_onVirtualIdle(uint32_t nTicks);
+#endif
+
+#ifdef QV_RTC_STEP_TIMING
+/* RTC step callback (provided in the app) with the duration, see NOTE6 */
+void QV_onRtcStep(QActive const *act, QSignal sig, uint32_t ns);
+#endif
+
+/* mutex for QF "interrupt" disabling and critical sections */
+extern pthread_mutex_t QF_pThreadMutex_;
+
+/*****************************************************************************
+* NOTE1:
+* On the host there is no reason to save RAM, so QF_MAX_ACTIVE is set to the
+* maximum of 63. The sizes of the event queue counters, memory pool counters
+* and time event counters are intentionally left at their defaults, so that
+* the data structures exercised on the host are the same as on the target.
+*
+* NOTE2:
+* The "interrupt disabling" policy of this port locks the single mutex
+* QF_pThreadMutex_. All threads that call QF services (the QV event loop in
+* QF_run(), the tick thread and any other "interrupt" threads in the BSP)
+* are serialized by this mutex, which gives the same semantics as disabling
+* interrupts on the target. The mutex is not recursive, so critical sections
+* must not nest, exactly as on the Cortex-M port.
+*
+* NOTE3:
+* The tick thread emulates the SysTick interrupt. It is started in QF_run()
+* after QF_onStartup() and calls QF_onClockTick() at the rate set with
+* QF_setTickRate() (typically BSP_TICKS_PER_SEC, called from QF_onStartup()).
+* The ticks are scheduled on absolute CLOCK_MONOTONIC deadlines, so the tick
+* rate does not drift with the time spent inside QF_onClockTick(). When the
+* tick rate is set to zero, no tick thread is started at all.
+*
+* NOTE4:
+* The lock-free QSpscQueue relies on the acquire/release ordering of its head
+* and tail indices, which on a multicore host requires the GCC __atomic
+* builtins rather than just the volatile accesses sufficient on a single-core
+* MCU. The producer and consumer indices are padded to separate cache lines
+* (QF_CACHE_LINE_SIZE) to avoid false sharing between the two cores.
+*
+* NOTE5:
+* When QF_VIRTUAL_TIME is defined, the port runs as a deterministic
+* discrete-event simulation. No tick thread is started and QF_onClockTick()
+* is called from the QV event loop itself, whenever all the event queues
+* are empty, for the tick of the nearest armed time event at the tick rate
+* 0. The ticks in-between are skipped at once, so long scenarios take only
+* as many iterations as there are events in them. The application provides
+* QF_onVirtualIdle(), called with the QF_pThreadMutex_ locked and the ticks
+* until the nearest time event (0 if none is armed), which returns the
+* number of ticks to advance: at most nTicks, fewer to stop at the next
+* scheduled stimulus (e.g., 1 while polling an input), or 0 when nothing
+* is scheduled at all, which returns from QF_run(). The application must
+* not use any other threads, so the runs are exactly reproducible.
+*
+* NOTE6:
+* When QV_RTC_STEP_TIMING is defined, the QV event loop measures every
+* run-to-completion step, from QActive_get_() to QF_gc() inclusive, on the
+* CLOCK_MONOTONIC and reports it to QV_onRtcStep() with the active object
+* and the signal of the event, outside of the measured interval and with
+* the QF_pThreadMutex_ unlocked. This is meant for the benchmark runs, e.g.
+* the replay of recorded stimuli in virtual time, where the wall-clock time
+* of the steps is the only thing that is not simulated.
+*/
+
+#endif /* qf_port_h */
@@ -0,0 +1,92 @@
+/**
+* @file
+* @brief QV/C port to POSIX, GNU-C99 compiler
+* @ingroup ports
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#ifndef qv_port_h
+#define qv_port_h
+
+#ifndef QF_VIRTUAL_TIME
+
+/* macro to put the CPU to "sleep" inside QV_onIdle(), see NOTE1 */
+#define QV_CPU_SLEEP() do { \
+    pthread_cond_wait(&QV_condVar_, &QF_pThreadMutex_); \
+    QF_INT_ENABLE(); \
+} while (0)
+
+#else
+
+/* the "sleep" advances the virtual clock instead, see NOTE2 */
+#define QV_CPU_SLEEP() QV_virtualSleep_()
+
+void QV_virtualSleep_(void);
+
+#endif /* QF_VIRTUAL_TIME */
+
+/* condition variable emulating the wake-up "interrupt" of the QV kernel */
+extern pthread_cond_t QV_condVar_;
+
+#include "qv.h" /* QV platform-independent public interface */
+
+#ifdef QP_IMPL
+
+    /* posting to an empty queue must also wake up the QV event loop */
+    #undef QACTIVE_EQUEUE_SIGNAL_
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) do { \
+        QPSet64_insert(&QV_readySet_, (me_)->prio); \
+        (void)pthread_cond_signal(&QV_condVar_); \
+    } while (0)
+
+#endif /* QP_IMPL */
+
+/*****************************************************************************
+* NOTE1:
+* QV_onIdle() is called with the QF_pThreadMutex_ locked ("interrupts
+* disabled"). The pthread_cond_wait() atomically releases the mutex and
+* blocks the QV thread, which is the host equivalent of the WFI instruction
+* with PRIMASK set on Cortex-M0+. Any event posted from another thread
+* signals QV_condVar_ and wakes the QV thread up. When pthread_cond_wait()
+* returns, the mutex is locked again, so it must be unlocked explicitly.
+*
+* NOTE2:
+* With QF_VIRTUAL_TIME (see NOTE5 in qf_port.h) no other thread can post
+* events, so instead of blocking QV_virtualSleep_() advances the virtual
+* clock to the next tick in which something happens and unlocks the mutex,
+* after which the QV event loop finds the events posted in that tick.
+*/
+
+#endif /* qv_port_h */
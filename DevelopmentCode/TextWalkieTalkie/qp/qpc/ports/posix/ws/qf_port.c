@@ -0,0 +1,457 @@
+/**
+* @file
+* @brief QF/C port to POSIX, work-stealing executor, implementation of
+* kernel-specific functions.
+* @ingroup ports
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qf_pkg.h"       /* QF package-scope interface */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+#include <time.h>         /* for clock_gettime() */
+#include <errno.h>        /* for ETIMEDOUT */
+#include <unistd.h>       /* for sysconf() */
+
+Q_DEFINE_THIS_MODULE("qf_port")
+
+/**
+* @note This module replaces qv.c in the host build. A fixed pool of worker
+* threads executes the RTC steps of any number of active objects, see NOTE3
+* and NOTE4 in qf_port.h.
+*/
+
+/*! worker thread of the executor with its ready "deque" */
+typedef struct {
+    pthread_mutex_t lock;   /* protects the deque of this worker */
+    QPSet64 readySet;       /* priority levels with ready active objects */
+    QActive *head[QF_MAX_ACTIVE + 1]; /* front of the FIFO at each level */
+    QActive *tail[QF_MAX_ACTIVE + 1]; /* back of the FIFO at each level */
+    pthread_t thread;       /* POSIX thread of this worker */
+    uint8_t id;             /* index of this worker in l_worker[] */
+    uint8_t pad[QF_CACHE_LINE_SIZE]; /* keep workers in separate lines */
+} QWsWorker;
+
+/* Global objects ==========================================================*/
+pthread_mutex_t QF_pThreadMutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+/* Local objects ===========================================================*/
+static bool     l_isRunning;  /* flag indicating when QF is running */
+static uint32_t l_tickHz = 100U; /* tick rate of QF_run() [Hz] */
+static uint32_t l_tickCtr;    /* clock ticks since QF_run() */
+static pthread_cond_t l_runCond;  /* wakes up QF_run() when QF is stopped */
+static pthread_cond_t l_workCond; /* wakes up the idle workers */
+
+static QWsWorker    l_worker[QF_WS_MAX_WORKERS];
+static uint_fast8_t l_nWorkers;   /* number of workers in the pool */
+static uint_fast8_t l_nIdle;      /* number of workers blocked on l_workCond */
+static uint32_t     l_nReady;     /* number of AOs in all deques (atomic) */
+static uint32_t     l_nStarted;   /* number of AOs started so far */
+
+/* index of the worker running in the current thread, or -1 */
+static __thread int l_self = -1;
+
+static void *worker(void *arg);
+
+/****************************************************************************/
+void QF_init(void) {
+    extern uint_fast8_t QF_maxPool_;
+    extern QTimeEvt QF_timeEvtHead_[QF_MAX_TICK_RATE];
+    pthread_condattr_t attr;
+    long nCpu = sysconf(_SC_NPROCESSORS_ONLN);
+    uint_fast8_t w;
+
+    QF_maxPool_ = (uint_fast8_t)0;
+    QF_bzero(&QF_timeEvtHead_[0], (uint_fast16_t)sizeof(QF_timeEvtHead_));
+    QF_bzero(&QF_active_[0],      (uint_fast16_t)sizeof(QF_active_));
+    QF_bzero(&l_worker[0],        (uint_fast16_t)sizeof(l_worker));
+
+    for (w = (uint_fast8_t)0; w < (uint_fast8_t)QF_WS_MAX_WORKERS; ++w) {
+        (void)pthread_mutex_init(&l_worker[w].lock,
+                                 (pthread_mutexattr_t *)0);
+        l_worker[w].id = (uint8_t)w;
+    }
+
+    /* by default one worker per online CPU */
+    if (nCpu < 1L) {
+        nCpu = 1L;
+    }
+    else if (nCpu > (long)QF_WS_MAX_WORKERS) {
+        nCpu = (long)QF_WS_MAX_WORKERS;
+    }
+    l_nWorkers = (uint_fast8_t)nCpu;
+    l_nIdle    = (uint_fast8_t)0;
+    l_nReady   = (uint32_t)0;
+    l_nStarted = (uint32_t)0;
+
+    /* the tick deadlines in QF_run() are on the monotonic clock */
+    (void)pthread_condattr_init(&attr);
+    (void)pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    (void)pthread_cond_init(&l_runCond, &attr);
+    (void)pthread_condattr_destroy(&attr);
+    (void)pthread_cond_init(&l_workCond, (pthread_condattr_t *)0);
+
+    l_isRunning = true;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Causes QF_run() to return after all workers have finished their current
+* RTC steps. Can be called from any thread, including from the RTC step of
+* an active object and from the QF_onClockTick() callback.
+*/
+void QF_stop(void) {
+    QF_INT_DISABLE();
+    l_isRunning = false;
+    (void)pthread_cond_signal(&l_runCond);
+    (void)pthread_cond_broadcast(&l_workCond);
+    QF_INT_ENABLE();
+}
+
+/****************************************************************************/
+void QF_setTickRate(uint32_t ticksPerSec) {
+    l_tickHz = ticksPerSec;
+}
+
+/****************************************************************************/
+/**
+* @description
+* The clock ticks counted since QF_run(), incremented right before every
+* call to QF_onClockTick(). It can be called from any thread.
+*/
+uint32_t QF_getTickCtr(void) {
+    return __atomic_load_n(&l_tickCtr, __ATOMIC_ACQUIRE);
+}
+
+/****************************************************************************/
+/**
+* @description
+* Sets the number of worker threads, which by default is the number of
+* online CPUs. Must be called after QF_init() and before starting any
+* active object.
+*/
+void QF_setWorkers(uint_fast8_t nWorkers) {
+    /** @pre the number of workers must be in range and no active object
+    * can be started yet, because the AOs are assigned to the workers
+    */
+    Q_REQUIRE_ID(300, ((uint_fast8_t)0 < nWorkers)
+                      && (nWorkers <= (uint_fast8_t)QF_WS_MAX_WORKERS)
+                      && (l_nStarted == (uint32_t)0));
+    l_nWorkers = nWorkers;
+}
+
+/****************************************************************************/
+/* append the AO to the back of the deque of the worker w (worker locked) */
+static void deque_pushBack(QWsWorker * const w, QActive * const act) {
+    uint_fast8_t p = act->prio;
+
+    act->osObject.next = (void *)0;
+    act->osObject.prev = w->tail[p];
+    if (w->tail[p] != (QActive *)0) {
+        w->tail[p]->osObject.next = act;
+    }
+    else {
+        w->head[p] = act;
+        QPSet64_insert(&w->readySet, p);
+    }
+    w->tail[p] = act;
+}
+/*..........................................................................*/
+/* take the highest-priority AO from the front or the back of the deque */
+static QActive *deque_pop(QWsWorker * const w, bool const isFront) {
+    QActive *act = (QActive *)0;
+
+    if (QPSet64_notEmpty(&w->readySet)) {
+        uint_fast8_t p;
+        QPSet64_findMax(&w->readySet, p);
+        if (isFront) { /* owner takes the oldest AO */
+            act = w->head[p];
+            w->head[p] = (QActive *)act->osObject.next;
+            if (w->head[p] != (QActive *)0) {
+                w->head[p]->osObject.prev = (void *)0;
+            }
+            else {
+                w->tail[p] = (QActive *)0;
+            }
+        }
+        else { /* thief takes the youngest AO */
+            act = w->tail[p];
+            w->tail[p] = (QActive *)act->osObject.prev;
+            if (w->tail[p] != (QActive *)0) {
+                w->tail[p]->osObject.next = (void *)0;
+            }
+            else {
+                w->head[p] = (QActive *)0;
+            }
+        }
+        if (w->head[p] == (QActive *)0) {
+            QPSet64_remove(&w->readySet, p);
+        }
+        (void)QF_FETCH_ADD(&l_nReady, (uint32_t)0xFFFFFFFFU); /* -1 */
+    }
+    return act;
+}
+/*..........................................................................*/
+/* append the AO to the deque of worker w, must be called inside the QF
+* critical section, because the idle workers are woken up here
+*/
+static void schedule(uint_fast8_t const w, QActive * const act) {
+    act->thread = (uint8_t)w; /* the AO's home worker */
+
+    (void)pthread_mutex_lock(&l_worker[w].lock);
+    deque_pushBack(&l_worker[w], act);
+    (void)pthread_mutex_unlock(&l_worker[w].lock);
+
+    (void)QF_FETCH_ADD(&l_nReady, (uint32_t)1);
+    if (l_nIdle != (uint_fast8_t)0) {
+        (void)pthread_cond_signal(&l_workCond);
+    }
+}
+
+/****************************************************************************/
+/**
+* @description
+* Called via QACTIVE_EQUEUE_SIGNAL_() inside the critical section when an
+* event is posted to the active object @p me. Only an idle active object
+* with an event ready to dispatch is scheduled, see NOTE3 in qf_port.h.
+*/
+void QF_wsSchedule_(QActive * const me) {
+    if ((me->osObject.isScheduled == (uint8_t)0)
+        && (!QACTIVE_EQUEUE_ISEMPTY_(me)))
+    {
+        me->osObject.isScheduled = (uint8_t)1;
+        schedule((l_self >= 0) ? (uint_fast8_t)l_self
+                               : (uint_fast8_t)me->thread, me);
+    }
+}
+
+/****************************************************************************/
+/**
+* @description
+* In this port the thread calling QF_run() starts the worker threads and
+* then becomes the "SysTick" thread, which calls QF_onClockTick() on
+* absolute CLOCK_MONOTONIC deadlines until QF_stop() is called. Then it
+* joins all workers.
+*
+* @returns 0 for success, which is passed on as return from main().
+*/
+int_t QF_run(void) {
+    struct timespec next;
+    long period = 0L;
+    uint_fast8_t w;
+
+    QF_onStartup(); /* application-specific startup callback */
+
+    for (w = (uint_fast8_t)0; w < l_nWorkers; ++w) {
+        Q_ALLEGE_ID(100, pthread_create(&l_worker[w].thread,
+                                        (pthread_attr_t *)0,
+                                        &worker, &l_worker[w]) == 0);
+    }
+
+    if (l_tickHz != (uint32_t)0) {
+        period = (long)(1000000000L / (long)l_tickHz);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &next);
+    __atomic_store_n(&l_tickCtr, (uint32_t)0, __ATOMIC_RELEASE);
+
+    QF_INT_DISABLE();
+    while (l_isRunning) {
+        if (period == 0L) { /* no clock tick? */
+            (void)pthread_cond_wait(&l_runCond, &QF_pThreadMutex_);
+        }
+        else {
+            next.tv_nsec += period;
+            if (next.tv_nsec >= 1000000000L) {
+                next.tv_nsec -= 1000000000L;
+                ++next.tv_sec;
+            }
+            if ((pthread_cond_timedwait(&l_runCond, &QF_pThreadMutex_,
+                                        &next) == ETIMEDOUT)
+                && l_isRunning)
+            {
+                QF_INT_ENABLE();
+                (void)__atomic_add_fetch(&l_tickCtr, (uint32_t)1,
+                                         __ATOMIC_ACQ_REL);
+                QF_onClockTick(); /* the "ISR" provided by the application */
+                QF_INT_DISABLE();
+            }
+        }
+    }
+    QF_INT_ENABLE();
+
+    for (w = (uint_fast8_t)0; w < l_nWorkers; ++w) {
+        (void)pthread_join(l_worker[w].thread, (void **)0);
+    }
+    (void)pthread_cond_destroy(&l_workCond);
+    (void)pthread_cond_destroy(&l_runCond);
+
+    QF_onCleanup(); /* application-specific cleanup callback */
+
+    return (int_t)0;
+}
+
+/****************************************************************************/
+void QActive_start_(QActive * const me, uint_fast8_t prio,
+                    QEvt const *qSto[], uint_fast16_t qLen,
+                    void *stkSto, uint_fast16_t stkSize,
+                    QEvt const *ie)
+{
+    /** @pre the priority must be in range and the stack storage must not
+    * be provided, because the active objects run on the worker threads.
+    */
+    Q_REQUIRE_ID(400, ((uint_fast8_t)0 < prio)
+                 && (prio <= (uint_fast8_t)QF_MAX_ACTIVE)
+                 && (stkSto == (void *)0));
+
+    (void)stkSize; /* avoid the "unused parameter" compiler warning */
+
+#ifdef QF_MPSC_EQUEUE
+    QMpscQueue_init(&me->eQueue, qSto, qLen);
+#else
+    QEQueue_init(&me->eQueue, qSto, qLen);
+#endif
+    QF_bzero(&me->osObject, (uint_fast16_t)sizeof(me->osObject));
+    (void)QACTIVE_EQUEUE_ISEMPTY_(me); /* the AO starts idle, see NOTE5 */
+    me->prio = prio; /* set QF priority of this AO before adding it to QF */
+
+    QF_INT_DISABLE();
+    me->thread = (uint8_t)(l_nStarted % (uint32_t)l_nWorkers);
+    ++l_nStarted;
+    QF_INT_ENABLE();
+
+    /* register only the first AO at this priority in QF, see NOTE4 */
+    if (QF_active_[prio] == (QActive *)0) {
+        QF_add_(me); /* make QF aware of this active object */
+    }
+    QMSM_INIT(&me->super, ie); /* take the top-most initial tran. */
+
+    QS_FLUSH(); /* flush the QS trace buffer to the host */
+}
+
+/****************************************************************************/
+/**
+* @description
+* Removes the AO from the framework (if it is registered in QF). The AO
+* is never scheduled again. Must be called only from the RTC step of
+* the active object @p me itself.
+*/
+void QActive_stop(QActive * const me) {
+    if (QF_active_[me->prio] == me) {
+        QF_remove_(me);  /* remove the AO from the framework */
+    }
+
+    QF_INT_DISABLE();
+    me->osObject.isStopped = (uint8_t)1;
+    QF_INT_ENABLE();
+}
+
+/****************************************************************************/
+/* the worker thread, see NOTE3 in qf_port.h */
+static void *worker(void *arg) {
+    QWsWorker *me = (QWsWorker *)arg;
+
+    l_self = (int)me->id;
+
+    for (;;) {
+        QActive *act;
+        QEvt const *e;
+        uint_fast8_t n;
+
+        /* take the highest-priority AO from the own deque... */
+        (void)pthread_mutex_lock(&me->lock);
+        act = deque_pop(me, true);
+        (void)pthread_mutex_unlock(&me->lock);
+
+        /* ...or steal one from the other workers */
+        for (n = (uint_fast8_t)1;
+             (act == (QActive *)0) && (n < l_nWorkers);
+             ++n)
+        {
+            QWsWorker *victim = &l_worker[(me->id + n) % l_nWorkers];
+            (void)pthread_mutex_lock(&victim->lock);
+            act = deque_pop(victim, false);
+            (void)pthread_mutex_unlock(&victim->lock);
+        }
+
+        if (act == (QActive *)0) { /* no ready AO anywhere? */
+            uint32_t nReady;
+
+            QF_INT_DISABLE();
+            QF_LOAD_ACQ(nReady, &l_nReady);
+            if ((nReady == (uint32_t)0) && l_isRunning) {
+                ++l_nIdle;
+                (void)pthread_cond_wait(&l_workCond, &QF_pThreadMutex_);
+                --l_nIdle;
+            }
+            if (!l_isRunning) {
+                QF_INT_ENABLE();
+                break; /* QF stopped */
+            }
+            QF_INT_ENABLE();
+            continue;
+        }
+
+        /* perform the run-to-completion (RTC) step, as in qv.c... */
+        e = QActive_get_(act); /* the queue is not empty, does not block */
+        QMSM_DISPATCH(&act->super, e);
+        QF_gc(e);
+
+        QF_INT_DISABLE();
+        if (act->osObject.isStopped != (uint8_t)0) {
+            /* leave the AO marked as scheduled, so it never runs again */
+        }
+        else if (QACTIVE_EQUEUE_ISEMPTY_(act)) {
+            act->osObject.isScheduled = (uint8_t)0; /* AO becomes idle */
+        }
+        else {
+            schedule((uint_fast8_t)me->id, act); /* more events to process */
+        }
+        if (!l_isRunning) {
+            QF_INT_ENABLE();
+            break; /* QF stopped */
+        }
+        QF_INT_ENABLE();
+    }
+
+    return (void *)0;
+}
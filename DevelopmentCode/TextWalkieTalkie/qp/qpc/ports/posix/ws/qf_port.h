@@ -0,0 +1,202 @@
+/**
+* @file
+* @brief QF/C port to POSIX, work-stealing executor, GNU-C99 compiler
+* @ingroup ports
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#ifndef qf_port_h
+#define qf_port_h
+
+/* POSIX event queue, OS object and thread types, see NOTE3 */
+#ifdef QF_MPSC_EQUEUE /* lock-free multiple-producer AO queues, see NOTE5 */
+    #define QF_EQUEUE_TYPE      QMpscQueue
+#else
+    #define QF_EQUEUE_TYPE      QEQueue
+#endif
+#define QF_OS_OBJECT_TYPE       QWsLink
+#define QF_THREAD_TYPE          uint8_t  /* worker, which last ran the AO */
+
+/* The maximum number of active objects in the application, see NOTE4 */
+#define QF_MAX_ACTIVE           63
+
+/* The maximum number of system clock tick rates */
+#define QF_MAX_TICK_RATE        2
+
+/* The maximum number of worker threads of the executor */
+#define QF_WS_MAX_WORKERS       64
+
+/* QF "interrupt" disable/enable, see NOTE1 */
+#define QF_INT_DISABLE()        pthread_mutex_lock(&QF_pThreadMutex_)
+#define QF_INT_ENABLE()         pthread_mutex_unlock(&QF_pThreadMutex_)
+
+/* QF critical section entry/exit */
+/* QF_CRIT_STAT_TYPE not defined: unconditional interrupt disabling" policy */
+#define QF_CRIT_ENTRY(dummy)    QF_INT_DISABLE()
+#define QF_CRIT_EXIT(dummy)     QF_INT_ENABLE()
+#define QF_CRIT_EXIT_NOP()      ((void)0)
+
+/* GNU-C provides the count-leading-zeros builtin for fast LOG2 */
+#define QF_LOG2(n_) ((uint8_t)(32U - __builtin_clz((unsigned)(n_))))
+
+/* memory ordering for the lock-free QSpscQueue (qspscq.h) */
+#define QF_MEM_FENCE()          __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define QF_LOAD_ACQ(var_, p_) \
+    ((var_) = __atomic_load_n((p_), __ATOMIC_ACQUIRE))
+#define QF_STORE_REL(p_, v_)    __atomic_store_n((p_), (v_), __ATOMIC_RELEASE)
+#define QF_CACHE_LINE_SIZE      64
+
+/* atomic read-modify-write for the lock-free QMpscQueue (qmpscq.h) */
+#define QF_CAS(p_, pExp_, new_) \
+    __atomic_compare_exchange_n((p_), (pExp_), (new_), false, \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define QF_FETCH_ADD(p_, v_)    __atomic_fetch_add((p_), (v_), __ATOMIC_ACQ_REL)
+
+#include <pthread.h>  /* POSIX-thread API */
+
+#include "qep_port.h" /* QEP port */
+#include "qequeue.h"  /* POSIX port needs event-queue */
+#ifdef QF_MPSC_EQUEUE
+#include "qmpscq.h"   /* lock-free MPSC event queue for active objects */
+#endif
+#include "qmpool.h"   /* POSIX port needs memory-pool */
+#include "qpset.h"    /* POSIX port needs priority-set */
+/*! scheduling data of an active object in the work-stealing executor */
+typedef struct {
+    void *next;          /*!< next ready AO at the same priority (QActive *) */
+    void *prev;          /*!< previous ready AO at the same priority */
+    uint8_t isScheduled; /*!< AO in a ready deque or in an RTC step */
+    uint8_t isStopped;   /*!< AO stopped with QActive_stop() */
+} QWsLink;
+
+#include "qf.h"       /* QF platform-independent public interface */
+
+/* set the clock tick rate, see NOTE2 */
+void QF_setTickRate(uint32_t ticksPerSec);
+
+/* set the number of worker threads (before starting active objects) */
+void QF_setWorkers(uint_fast8_t nWorkers);
+
+/* clock tick callback (provided in the app), called from QF_run() */
+void QF_onClockTick(void);
+
+/* clock ticks since QF_run() */
+uint32_t QF_getTickCtr(void);
+
+/* mutex for QF "interrupt" disabling and critical sections */
+extern pthread_mutex_t QF_pThreadMutex_;
+
+/****************************************************************************/
+/* interface used only inside QP implementation, but not in applications */
+#ifdef QP_IMPL
+
+    /* event queue operations, see NOTE3 */
+    #ifdef QF_MPSC_EQUEUE
+        /* also announces that the AO is going idle, see NOTE5 */
+        #define QACTIVE_EQUEUE_ISEMPTY_(me_) \
+            QMpscQueue_prepareWait_(&(me_)->eQueue)
+    #else
+        #define QACTIVE_EQUEUE_ISEMPTY_(me_) \
+            ((me_)->eQueue.frontEvt == (QEvt *)0)
+    #endif
+    #define QACTIVE_EQUEUE_WAIT_(me_) \
+        Q_ASSERT_ID(0, !QACTIVE_EQUEUE_ISEMPTY_(me_))
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) (QF_wsSchedule_((me_)))
+    #define QACTIVE_EQUEUE_ONEMPTY_(me_) ((void)0)
+
+    /* make an idle AO with events ready to run (inside critical section) */
+    void QF_wsSchedule_(QActive * const me);
+
+    /* native QF event pool operations */
+    #define QF_EPOOL_TYPE_            QMPool
+    #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
+        (QMPool_init(&(p_), (poolSto_), (poolSize_), (evtSize_)))
+    #define QF_EPOOL_EVENT_SIZE_(p_)  ((uint_fast16_t)(p_).blockSize)
+    #define QF_EPOOL_GET_(p_, e_, m_) ((e_) = (QEvt *)QMPool_get(&(p_), (m_)))
+    #define QF_EPOOL_PUT_(p_, e_)     (QMPool_put(&(p_), (e_)))
+
+#endif /* QP_IMPL */
+
+/*****************************************************************************
+* NOTE1:
+* As in the other POSIX ports, the "interrupt disabling" policy locks the
+* single mutex QF_pThreadMutex_, which protects only the short QF critical
+* sections. The RTC steps of different active objects run outside the
+* mutex, in parallel on all worker threads.
+*
+* NOTE2:
+* As in the ports/posix/mt port, the main thread that calls QF_run() calls
+* QF_onClockTick() at the rate set with QF_setTickRate(), until QF_stop()
+* is called. When the tick rate is set to zero, the main thread just waits
+* for QF_stop().
+*
+* NOTE3:
+* The active objects do not have threads of their own. Instead, a fixed
+* pool of worker threads (by default one per online CPU, see QF_setWorkers())
+* executes the RTC steps of the active objects, exactly as the QV loop in
+* qv.c does: QActive_get_(), QMSM_DISPATCH() and QF_gc(). Every worker has
+* a ready "deque" consisting of the QPSet64 ready-set of the priority levels
+* and a FIFO of ready active objects for each level. Posting an event to an
+* idle active object (QACTIVE_EQUEUE_SIGNAL_()) marks the AO as scheduled
+* and appends it to the deque of the posting worker (or of the worker that
+* ran the AO last, when posted from a non-worker thread). A worker always
+* takes the highest-priority AO from the front of its own deque, and when
+* its deque is empty, it steals the highest-priority AO from the back of
+* the deque of another worker. After one RTC step, the worker either
+* appends the AO to its own deque again (more events) or marks it idle.
+* An AO is marked scheduled while it is in a deque or in an RTC step, and
+* only an idle AO is ever appended to a deque, so one AO is never
+* dispatched on two workers at once. The QF priorities are therefore a
+* preference within each worker, not a global guarantee as in QV.
+*
+* NOTE4:
+* QF_MAX_ACTIVE cannot exceed 63 (QPSet64 and the publish-subscribe lists),
+* but simulations of many nodes need many more active objects. Therefore,
+* in this port several active objects can share the same priority level.
+* The first active object started at a given priority is registered in QF
+* (QF_active_[], publish-subscribe, QF_getQueueMin()), the other ones are
+* reachable only by direct event posting. QActive_stop() must be called only
+* from the RTC step of the active object being stopped.
+*
+* NOTE5:
+* When QF_MPSC_EQUEUE is defined (make MPSC=1), the active objects use the
+* lock-free QMpscQueue (see ports/posix/mt, NOTE5). The producers then take
+* the mutex only to schedule an active object that went idle. An active
+* object goes idle (also initially in QActive_start_()) by announcing in
+* QACTIVE_EQUEUE_ISEMPTY_() that its queue is empty, so that the next
+* published event calls QACTIVE_EQUEUE_SIGNAL_().
+*/
+
+#endif /* qf_port_h */
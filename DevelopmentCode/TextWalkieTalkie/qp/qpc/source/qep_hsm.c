@@ -52,10 +52,8 @@ Q_DEFINE_THIS_MODULE("qep_hsm")
 enum {
     QEP_EMPTY_SIG_ = 0, /*!< reserved empty signal for internal use only */
 
-    /*! maximum depth of state nesting in a HSM (including the top level),
-    * must be >= 3
-    */
-    QHSM_MAX_NEST_DEPTH_ = 6
+    /*! maximum depth of state nesting in a HSM, see #QHSM_MAX_NEST_DEPTH */
+    QHSM_MAX_NEST_DEPTH_ = QHSM_MAX_NEST_DEPTH
 };
 
 /**
@@ -99,6 +97,38 @@ static QEvt const QEP_reservedEvt_[] = {
 static int_fast8_t QHsm_tran_(QHsm * const me,
                               QStateHandler path[QHSM_MAX_NEST_DEPTH_]);
 
+#ifdef QHSM_TRAN_CACHE
+/*! helper function to execute a transition chain through the cache */
+static int_fast8_t QHsm_tranCached_(QHsm * const me,
+                                    QStateHandler path[QHSM_MAX_NEST_DEPTH_]);
+
+/*! helper function to find a transition in the cache */
+static QHsmTranEntry const *QHsm_cacheFind_(QHsm * const me,
+                                            QStateHandler const s,
+                                            QStateHandler const t);
+
+/*! helper function to add a transition to the cache */
+static void QHsm_cachePut_(QHsm * const me, QStateHandler const s,
+                           QStateHandler const path[QHSM_MAX_NEST_DEPTH_],
+                           int_fast8_t ip, uint_fast8_t nExit);
+
+#ifdef Q_SPY
+/*! helper function to report the statistics of the cache to QS */
+static void QHsm_cacheReport_(QHsm * const me, QStateHandler const s,
+                              QStateHandler const t);
+#endif /* Q_SPY */
+#endif /* QHSM_TRAN_CACHE */
+
+#ifdef QHSM_SIG_MAP
+/*! helper function to process an event hierarchically with the map */
+static QState QHsm_sigMapDispatch_(QHsm * const me, QEvt const * const e,
+                                   QStateHandler * const src);
+
+/*! helper function to find (or add) a state in the map */
+static uint_fast8_t QHsm_sigMapFind_(QHsmSigMap * const map,
+                                     QStateHandler const state);
+#endif /* QHSM_SIG_MAP */
+
 
 /****************************************************************************/
 /**
@@ -137,6 +167,12 @@ void QHsm_ctor(QHsm * const me, QStateHandler initial) {
     me->vptr  = &vtbl;
     me->state.fun = Q_STATE_CAST(&QHsm_top);
     me->temp.fun  = initial;
+#ifdef QHSM_TRAN_CACHE
+    me->tranCache = (QHsmTranCache *)0; /* no cache until attached */
+#endif
+#ifdef QHSM_SIG_MAP
+    me->sigMap = (QHsmSigMap *)0; /* no map until attached */
+#endif
 }
 
 /****************************************************************************/
@@ -271,26 +307,37 @@ void QHsm_dispatch_(QHsm * const me, QEvt const * const e) {
     QS_END_()
 
     /* process the event hierarchically... */
-    do {
-        s = me->temp.fun;
-        r = (*s)(me, e); /* invoke state handler s */
+#ifdef QHSM_SIG_MAP
+    if (me->sigMap != (QHsmSigMap *)0) {
+        r = QHsm_sigMapDispatch_(me, e, &s);
+    }
+    else
+#endif /* QHSM_SIG_MAP */
+    {
+        do {
+            s = me->temp.fun;
+            r = (*s)(me, e); /* invoke state handler s */
 
-        if (r == (QState)Q_RET_UNHANDLED) { /* unhandled due to a guard? */
+            if (r == (QState)Q_RET_UNHANDLED) { /* unhandled due to guard? */
 
-            QS_BEGIN_(QS_QEP_UNHANDLED, QS_priv_.smObjFilter, me)
-                QS_SIG_(e->sig); /* the signal of the event */
-                QS_OBJ_(me);     /* this state machine object */
-                QS_FUN_(s);      /* the current state */
-            QS_END_()
+                QS_BEGIN_(QS_QEP_UNHANDLED, QS_priv_.smObjFilter, me)
+                    QS_SIG_(e->sig); /* the signal of the event */
+                    QS_OBJ_(me);     /* this state machine object */
+                    QS_FUN_(s);      /* the current state */
+                QS_END_()
 
-            r = QEP_TRIG_(s, QEP_EMPTY_SIG_); /* find superstate of s */
-        }
-    } while (r == (QState)Q_RET_SUPER);
+                r = QEP_TRIG_(s, QEP_EMPTY_SIG_); /* find superstate of s */
+            }
+        } while (r == (QState)Q_RET_SUPER);
+    }
 
     /* transition taken? */
     if (r >= (QState)Q_RET_TRAN) {
         QStateHandler path[QHSM_MAX_NEST_DEPTH_];
         int_fast8_t ip;
+#ifdef QHSM_TRAN_CACHE
+        QHsmTranEntry const *x;
+#endif
 
         path[0] = me->temp.fun; /* save the target of the transition */
         path[1] = t;
@@ -308,7 +355,11 @@ void QHsm_dispatch_(QHsm * const me, QEvt const * const e) {
             }
         }
 
+#ifdef QHSM_TRAN_CACHE
+        ip = QHsm_tranCached_(me, path);
+#else
         ip = QHsm_tran_(me, path);
+#endif
 
 #ifdef Q_SPY
         if (r == (QState)Q_RET_TRAN_HIST) {
@@ -342,12 +393,27 @@ void QHsm_dispatch_(QHsm * const me, QEvt const * const e) {
             ip = (int_fast8_t)0;
             path[0] = me->temp.fun;
 
-            (void)QEP_TRIG_(me->temp.fun, QEP_EMPTY_SIG_);/*find superstate */
-
-            while (me->temp.fun != t) {
-                ++ip;
-                path[ip] = me->temp.fun;
-                (void)QEP_TRIG_(me->temp.fun, QEP_EMPTY_SIG_);/* find super */
+#ifdef QHSM_TRAN_CACHE
+            x = QHsm_cacheFind_(me, t, path[0]);
+            if (x != (QHsmTranEntry const *)0) { /* entry path cached? */
+                for (ip = x->ip; ip > (int_fast8_t)0; --ip) {
+                    path[ip] = x->path[ip];
+                }
+                ip = x->ip;
+            }
+            else
+#endif /* QHSM_TRAN_CACHE */
+            {
+                (void)QEP_TRIG_(me->temp.fun, QEP_EMPTY_SIG_);/*find super */
+
+                while (me->temp.fun != t) {
+                    ++ip;
+                    path[ip] = me->temp.fun;
+                    (void)QEP_TRIG_(me->temp.fun, QEP_EMPTY_SIG_);/* super */
+                }
+#ifdef QHSM_TRAN_CACHE
+                QHsm_cachePut_(me, t, path, ip, (uint_fast8_t)0);
+#endif
             }
             me->temp.fun = path[0];
 
@@ -547,6 +613,361 @@ static int_fast8_t QHsm_tran_(QHsm * const me,
     return ip;
 }
 
+#ifdef QHSM_SIG_MAP
+/****************************************************************************/
+/**
+* @description
+* Attaches the handled-signal map to a HSM, after which the events skip the
+* states known to pass their signals to the superstate (see ::QHsmSigMap).
+*
+* @param[in,out] me  pointer (see @ref oop)
+* @param[in,out] map pointer to the zero-initialized map, which can be
+*                    shared by the state machines dispatched in the same
+*                    thread, or 0 to detach the map
+*
+* @note Must be called after QHsm_ctor() (or the constructor of the derived
+* class) and before dispatching events to the state machine.
+*/
+void QHsm_setSigMap(QHsm * const me, QHsmSigMap * const map) {
+    me->sigMap = map;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Declares that the state @p state handles only the signals @p sigs (and
+* the reserved signals), so that it is skipped for all the other signals
+* below #QHSM_SIG_MAP_SIGS from the start, instead of being learned.
+*
+* @param[in,out] map   pointer to the handled-signal map
+* @param[in]     state the state-handler
+* @param[in]     sigs  the signals handled in @p state, which includes
+*                      the signals handled only under a guard
+* @param[in]     n     number of the signals in @p sigs
+*/
+void QHsmSigMap_declare(QHsmSigMap * const map, QStateHandler const state,
+                        QSignal const sigs[], uint_fast8_t const n)
+{
+    QHsmSigState * const st = &map->state[QHsm_sigMapFind_(map, state)];
+    uint_fast8_t i;
+
+    for (i = (uint_fast8_t)0; i < (uint_fast8_t)Q_DIM(st->skip); ++i) {
+        st->skip[i] = ~(uint32_t)0;
+    }
+    st->skip[0] &= ~(((uint32_t)1 << Q_USER_SIG) - (uint32_t)1);
+    for (i = (uint_fast8_t)0; i < n; ++i) {
+        if (sigs[i] < (QSignal)QHSM_SIG_MAP_SIGS) {
+            st->skip[sigs[i] >> 5] &= ~((uint32_t)1 << (sigs[i] & 0x1FU));
+        }
+    }
+}
+
+/****************************************************************************/
+/**
+* @description
+* Static helper function to process an event hierarchically, starting in
+* the current state, like QHsm_dispatch_() does, but skipping the states
+* that are known to pass the signal to the superstate, and learning the
+* superstates and the signals passed to them along the way.
+*
+* @param[in,out] me  pointer (see @ref oop)
+* @param[in]     e   pointer to the event to be dispatched to the HSM
+* @param[out]    src the state that handled the event (or the top state)
+*
+* @returns the status of the state-handler @p src.
+*/
+static QState QHsm_sigMapDispatch_(QHsm * const me, QEvt const * const e,
+                                   QStateHandler * const src)
+{
+    QHsmSigMap * const map = me->sigMap;
+    uint_fast8_t const w   = (uint_fast8_t)(e->sig >> 5);
+    uint32_t const bit     = (uint32_t)1 << (e->sig & 0x1FU);
+    bool const tracked     = (e->sig < (QSignal)QHSM_SIG_MAP_SIGS);
+    uint_fast8_t i = QHsm_sigMapFind_(map, me->temp.fun);
+    QHsmSigState *st;
+    QStateHandler s;
+    QState r;
+    QS_CRIT_STAT_
+
+    do {
+        st = &map->state[i];
+
+        /* skip the states known to pass the signal to the superstate... */
+        if (tracked) {
+            while (((st->skip[w] & bit) != (uint32_t)0)
+                   && (st->super != (uint8_t)QHSM_SIG_MAP))
+            {
+                ++map->skipped;
+                st = &map->state[st->super];
+            }
+        }
+
+        s = st->state;
+        r = (*s)(me, e); /* invoke state handler s */
+
+        if (r == (QState)Q_RET_UNHANDLED) { /* unhandled due to a guard? */
+
+            QS_BEGIN_(QS_QEP_UNHANDLED, QS_priv_.smObjFilter, me)
+                QS_SIG_(e->sig); /* the signal of the event */
+                QS_OBJ_(me);     /* this state machine object */
+                QS_FUN_(s);      /* the current state */
+            QS_END_()
+
+            r = QEP_TRIG_(s, QEP_EMPTY_SIG_); /* find superstate of s */
+        }
+        else if ((r == (QState)Q_RET_SUPER) && tracked) {
+            st->skip[w] |= bit; /* s passes this signal to the superstate */
+        }
+        else {
+            /* the signal is handled in s (or ignored in the top state) */
+        }
+
+        if (r == (QState)Q_RET_SUPER) {
+            i = (uint_fast8_t)st->super;
+            if ((i == (uint_fast8_t)QHSM_SIG_MAP)
+                || (map->state[i].state != me->temp.fun))
+            {
+                i = QHsm_sigMapFind_(map, me->temp.fun);
+                st->super = (uint8_t)i; /* learn the superstate of s */
+            }
+        }
+    } while (r == (QState)Q_RET_SUPER);
+
+    *src = s;
+    return r;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Static helper function to find the state @p state in the handled-signal
+* map, or to add it, if the state is not known yet.
+*
+* @returns the index of the state in the map.
+*/
+static uint_fast8_t QHsm_sigMapFind_(QHsmSigMap * const map,
+                                     QStateHandler const state)
+{
+    uint32_t h = (uint32_t)(uintptr_t)state; /* hash the handler address */
+    uint_fast8_t i;
+    uint_fast8_t n;
+
+    h ^= h >> 16;
+    h *= (uint32_t)0x45D9F3BU;
+    h ^= h >> 16;
+    i = (uint_fast8_t)(h & (uint32_t)(QHSM_SIG_MAP - 1));
+
+    for (n = (uint_fast8_t)0; map->state[i].state != state; ++n) {
+
+        /* the map must have room for all the states */
+        Q_ASSERT_ID(810, n < (uint_fast8_t)QHSM_SIG_MAP);
+
+        if (map->state[i].state == Q_STATE_CAST(0)) { /* free slot? */
+            map->state[i].state = state;
+            map->state[i].super = (uint8_t)QHSM_SIG_MAP; /* not known yet */
+        }
+        else {
+            i = (uint_fast8_t)((i + 1U) & (uint_fast8_t)(QHSM_SIG_MAP - 1));
+        }
+    }
+    return i;
+}
+#endif /* QHSM_SIG_MAP */
+
+#ifdef QHSM_TRAN_CACHE
+/****************************************************************************/
+/**
+* @description
+* Attaches the transition path cache to a HSM, after which the transitions
+* and the nested initial transitions already seen by the cache are replayed
+* from it without the search for the LCA (see NOTE1).
+*
+* @param[in,out] me    pointer (see @ref oop)
+* @param[in,out] cache pointer to the zero-initialized cache, which can be
+*                      shared by the state machines dispatched in the same
+*                      thread, or 0 to detach the cache
+*
+* @note Must be called after QHsm_ctor() (or the constructor of the derived
+* class) and before dispatching events to the state machine.
+*/
+void QHsm_setTranCache(QHsm * const me, QHsmTranCache * const cache) {
+    me->tranCache = cache;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Static helper function to execute the transition sequence of a HSM from
+* the transition path cache, or with QHsm_tran_() and add it to the cache.
+*
+* @param[in,out] me   pointer (see @ref oop)
+* @param[in,out] path array of pointers to state-handler functions
+*                     to execute the entry actions
+* @returns the depth of the entry path stored in the @p path parameter.
+*/
+static int_fast8_t QHsm_tranCached_(QHsm * const me,
+                                    QStateHandler path[QHSM_MAX_NEST_DEPTH_])
+{
+    QStateHandler const s = path[2]; /* the source, clobbered by tran_() */
+    QHsmTranEntry const *x;
+    QStateHandler t;
+    QStateHandler lca;
+    int_fast8_t ip;
+    uint_fast8_t n;
+    QS_CRIT_STAT_
+
+    /* the transition to self needs no search, see QHsm_tran_() case (a) */
+    x = (s != path[0]) ? QHsm_cacheFind_(me, s, path[0])
+                       : (QHsmTranEntry const *)0;
+
+    if (x != (QHsmTranEntry const *)0) { /* transition cached? */
+
+        /* exit the source and its superstates up to the LCA... */
+        t = s;
+        for (n = (uint_fast8_t)x->nExit; n != (uint_fast8_t)0; --n) {
+            if (QEP_TRIG_(t, Q_EXIT_SIG) == (QState)Q_RET_HANDLED) {
+                QS_BEGIN_(QS_QEP_STATE_EXIT, QS_priv_.smObjFilter, me)
+                    QS_OBJ_(me); /* this state machine object */
+                    QS_FUN_(t);  /* the exited state */
+                QS_END_()
+
+                /* find superstate of t, unless t is the last to exit */
+                if (n != (uint_fast8_t)1) {
+                    (void)QEP_TRIG_(t, QEP_EMPTY_SIG_);
+                }
+            }
+            t = me->temp.fun;
+        }
+
+        /* ...and replay the entry path */
+        for (ip = x->ip; ip > (int_fast8_t)0; --ip) {
+            path[ip] = x->path[ip];
+        }
+        ip = x->ip;
+    }
+    else if (s == path[0]) {
+        ip = QHsm_tran_(me, path);
+    }
+    else {
+        ip = QHsm_tran_(me, path);
+
+        /* the LCA is the superstate of the outermost entered state, or the
+        * target itself, if no state is entered (see QHsm_tran_() case (d))
+        */
+        if (ip >= (int_fast8_t)0) {
+            (void)QEP_TRIG_(path[ip], QEP_EMPTY_SIG_);
+            lca = me->temp.fun;
+        }
+        else {
+            lca = path[0];
+        }
+
+        /* count the states exited from the source up to the LCA... */
+        n = (uint_fast8_t)0;
+        for (t = s; t != lca; t = me->temp.fun) {
+            (void)QEP_TRIG_(t, QEP_EMPTY_SIG_); /* find superstate of t */
+            ++n;
+
+            /* the exit path must not overflow */
+            Q_ASSERT_ID(710, n < (uint_fast8_t)QHSM_MAX_NEST_DEPTH_);
+        }
+
+        QHsm_cachePut_(me, s, path, ip, n);
+    }
+    return ip;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Static helper function to find the transition from @p s to @p t in the
+* transition path cache of a HSM.
+*
+* @returns pointer to the cached transition, or 0 if the transition is not
+* cached (or the HSM has no cache).
+*/
+static QHsmTranEntry const *QHsm_cacheFind_(QHsm * const me,
+                                            QStateHandler const s,
+                                            QStateHandler const t)
+{
+    QHsmTranCache * const c = me->tranCache;
+    QHsmTranEntry const *x = (QHsmTranEntry const *)0;
+    uint_fast8_t i;
+
+    if (c != (QHsmTranCache *)0) {
+        for (i = (uint_fast8_t)0; i < (uint_fast8_t)QHSM_TRAN_CACHE; ++i) {
+            if ((c->entry[i].source == s) && (c->entry[i].target == t)) {
+                x = &c->entry[i];
+                ++c->hits;
+                i = (uint_fast8_t)QHSM_TRAN_CACHE; /* terminate the loop */
+#ifdef Q_SPY
+                if ((c->hits & (uint32_t)0xFF) == (uint32_t)0) {
+                    QHsm_cacheReport_(me, s, t); /* every 256 hits */
+                }
+#endif /* Q_SPY */
+            }
+        }
+    }
+    return x;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Static helper function to add the transition from @p s with the entry
+* path @p path[ip..0] and @p nExit exited states to the cache of a HSM,
+* replacing the entries round robin.
+*/
+static void QHsm_cachePut_(QHsm * const me, QStateHandler const s,
+                           QStateHandler const path[QHSM_MAX_NEST_DEPTH_],
+                           int_fast8_t ip, uint_fast8_t nExit)
+{
+    QHsmTranCache * const c = me->tranCache;
+
+    if (c != (QHsmTranCache *)0) {
+        QHsmTranEntry * const x = &c->entry[c->next];
+        int_fast8_t i;
+
+        x->source = s;
+        x->target = path[0];
+        x->nExit  = (uint8_t)nExit;
+        x->ip     = (int8_t)ip;
+        for (i = (int_fast8_t)0; i <= ip; ++i) {
+            x->path[i] = path[i];
+        }
+        ++c->misses;
+        c->next = (uint8_t)((c->next + 1U) % (uint8_t)QHSM_TRAN_CACHE);
+
+#ifdef Q_SPY
+        QHsm_cacheReport_(me, s, path[0]);
+#endif /* Q_SPY */
+    }
+}
+
+#ifdef Q_SPY
+/****************************************************************************/
+/**
+* @description
+* Static helper function to produce the QS_QEP_TRAN_CACHE record with the
+* transition from @p s to @p t and the hit and miss counts of the cache.
+*/
+static void QHsm_cacheReport_(QHsm * const me, QStateHandler const s,
+                              QStateHandler const t)
+{
+    QHsmTranCache const * const c = me->tranCache;
+    QS_CRIT_STAT_
+
+    QS_BEGIN_(QS_QEP_TRAN_CACHE, QS_priv_.smObjFilter, me)
+        QS_OBJ_(me);          /* this state machine object */
+        QS_FUN_(s);           /* the source of the transition */
+        QS_FUN_(t);           /* the target of the transition */
+        QS_U32_(c->hits);     /* transitions replayed from the cache */
+        QS_U32_(c->misses);   /* transitions added to the cache */
+    QS_END_()
+}
+#endif /* Q_SPY */
+#endif /* QHSM_TRAN_CACHE */
+
 /****************************************************************************/
 /**
 * @description
@@ -567,17 +988,74 @@ bool QHsm_isIn(QHsm * const me, QStateHandler const state) {
     /** @pre the state configuration must be stable */
     Q_REQUIRE_ID(600, me->temp.fun == me->state.fun);
 
-    do {
-        /* do the states match? */
-        if (me->temp.fun == state) {
-            inState = true;            /* match found, return 'true' */
-            r = (QState)Q_RET_IGNORED; /* break out of the loop */
-        }
-        else {
-            r = QEP_TRIG_(me->temp.fun, QEP_EMPTY_SIG_);
+#ifdef QHSM_SIG_MAP
+    if (me->sigMap != (QHsmSigMap *)0) {
+        QHsmSigMap * const map = me->sigMap;
+        uint_fast8_t i = QHsm_sigMapFind_(map, me->state.fun);
+
+        /* follow the superstate links, learning the missing ones */
+        while ((map->state[i].state != state)
+               && (map->state[i].state != Q_STATE_CAST(&QHsm_top)))
+        {
+            if (map->state[i].super == (uint8_t)QHSM_SIG_MAP) {
+                (void)QEP_TRIG_(map->state[i].state, QEP_EMPTY_SIG_);
+                map->state[i].super =
+                    (uint8_t)QHsm_sigMapFind_(map, me->temp.fun);
+            }
+            i = (uint_fast8_t)map->state[i].super;
         }
-    } while (r != (QState)Q_RET_IGNORED); /* QHsm_top state not reached */
+        inState = (map->state[i].state == state);
+    }
+    else
+#endif /* QHSM_SIG_MAP */
+    {
+        do {
+            /* do the states match? */
+            if (me->temp.fun == state) {
+                inState = true;            /* match found, return 'true' */
+                r = (QState)Q_RET_IGNORED; /* break out of the loop */
+            }
+            else {
+                r = QEP_TRIG_(me->temp.fun, QEP_EMPTY_SIG_);
+            }
+        } while (r != (QState)Q_RET_IGNORED); /* QHsm_top not reached */
+    }
     me->temp.fun = me->state.fun; /* restore the stable state configuration */
 
     return inState; /* return the status */
 }
+
+/*****************************************************************************
+* NOTE1:
+* The transition path cache (#QHSM_TRAN_CACHE) trades a linear search over
+* a few (source, target) pairs for the discovery of the hierarchy with the
+* empty signal in QHsm_tran_(). A cached transition still exits the source
+* with the exit actions (which need one more call of the state-handler with
+* the empty signal for every exit action executed), but it no longer calls
+* the state-handlers of the target and its superstates to find the LCA and
+* the entry path. The nested initial transitions are cached under the same
+* key (the source of the initial transition, its target) with no exited
+* states, which is exactly what a regular transition to that substate would
+* have. A state-handler must therefore always return the same superstate,
+* which the QHsm rules require anyway. The transitions to self are not
+* cached, because QHsm_tran_() resolves them without any search.
+*
+* The QS_QEP_TRAN_CACHE record is produced when a transition is added to
+* the cache and after every 256 hits, and reports the number of the hits
+* and the misses so far, from which the hit rate follows.
+*
+* NOTE2:
+* In a deep hierarchy most of the events are handled in the superstates,
+* so QHsm_dispatch_() calls every nested state-handler only to learn that
+* it returns Q_SUPER(). The handled-signal map (#QHSM_SIG_MAP) remembers
+* that answer per (state, signal) in a bitmap, together with the link to
+* the superstate, so that the next event with the same signal in the same
+* state goes straight to the first state that might handle it: an event
+* handled N levels above the current state costs one state-handler call
+* and N bitmap tests instead of N+1 calls. A learned bit is never cleared,
+* which is correct as long as a state-handler returns Q_SUPER() for a
+* signal only when it does not handle the signal in any extended state
+* (see ::QHsmSigMap). The superstate links also let QHsm_isIn() answer
+* without calling the state-handlers. The events with the signals above
+* #QHSM_SIG_MAP_SIGS are dispatched as without the map.
+*/
@@ -0,0 +1,271 @@
+/**
+* @file
+* @brief QActive_post_(), QActive_postLIFO_(), and QActive_get_() for
+* active objects with the lock-free ::QMpscQueue event queue
+* @ingroup qf
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qf_pkg.h"       /* QF package-scope interface */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+Q_DEFINE_THIS_MODULE("qf_actq_mpsc")
+
+/**
+* @note This module replaces qf_actq.c in the QF ports, in which the event
+* queue of active objects is the lock-free ::QMpscQueue (see qmpscq.h).
+* Such a QF port must define QF_MPSC_EQUEUE, define #QF_EQUEUE_TYPE as
+* ::QMpscQueue and provide the macro QACTIVE_EQUEUE_WAIT_(), which blocks
+* the calling AO thread while QMpscQueue_prepareWait_() reports an empty
+* queue. The macro QACTIVE_EQUEUE_SIGNAL_() is invoked (inside a critical
+* section) only when the AO thread is about to block.
+*/
+#ifndef QF_MPSC_EQUEUE
+    #error "qf_actq_mpsc.c requires the QMpscQueue event queue of active \
+objects (QF_MPSC_EQUEUE)"
+#endif
+
+/****************************************************************************/
+/**
+* @description
+* Lock-free direct event posting to the ::QMpscQueue of an active object,
+* which can be called concurrently from any number of threads. The
+* parameter @p margin has exactly the same semantics as in the QActive_post_()
+* implementation for the native ::QEQueue (qf_actq.c).
+*
+* @param[in,out] me     pointer (see @ref oop)
+* @param[in]     e      pointer to the event to be posted
+* @param[in]     margin number of required free slots in the queue
+*                       after posting the event.
+*
+* @note this function should be called only via the macro QACTIVE_POST()
+* or QACTIVE_POST_X().
+*
+* @sa QActive_postLIFO_(), QMpscQueue_post()
+*/
+#ifndef Q_SPY
+bool QActive_post_(QActive * const me, QEvt const * const e,
+                   uint_fast16_t const margin)
+#else
+bool QActive_post_(QActive * const me, QEvt const * const e,
+                   uint_fast16_t const margin, void const * const sender)
+#endif
+{
+    QEQueueCtr pos = (QEQueueCtr)0;
+    QEQueueCtr nFree;
+    bool status;
+    QF_CRIT_STAT_
+
+    /** @pre event pointer must be valid */
+    Q_REQUIRE_ID(100, e != (QEvt const *)0);
+
+    nFree = QMpscQueue_reserve_(&me->eQueue, margin, &pos);
+
+    /* slot reserved with the required margin? */
+    if (nFree > (QEQueueCtr)margin) {
+
+        QS_BEGIN_(QS_QF_ACTIVE_POST_FIFO, QS_priv_.aoObjFilter, me)
+            QS_TIME_();               /* timestamp */
+            QS_OBJ_(sender);          /* the sender object */
+            QS_SIG_(e->sig);          /* the signal of the event */
+            QS_OBJ_(me);              /* this active object (recipient) */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);           /* number of free entries */
+            QS_EQC_(me->eQueue.nMin); /* min number of free entries */
+        QS_END_()
+
+        /* is it a pool event? */
+        if (e->poolId_ != (uint8_t)0) {
+            QF_CRIT_ENTRY_();
+            QF_EVT_REF_CTR_INC_(e); /* increment the reference counter */
+            QF_CRIT_EXIT_();
+        }
+
+        /* publish the event and wake up the AO thread if it is blocking */
+        if (QMpscQueue_publish_(&me->eQueue, pos, e)) {
+            QF_CRIT_ENTRY_();
+            QACTIVE_EQUEUE_SIGNAL_(me); /* signal the event queue */
+            QF_CRIT_EXIT_();
+        }
+        status = true; /* event posted successfully */
+    }
+    else {
+        /** @note assert if event cannot be posted and dropping events is
+        * not acceptable
+        */
+        Q_ASSERT_ID(110, margin != (uint_fast16_t)0);
+
+        QS_BEGIN_(QS_QF_ACTIVE_POST_ATTEMPT, QS_priv_.aoObjFilter, me)
+            QS_TIME_();           /* timestamp */
+            QS_OBJ_(sender);      /* the sender object */
+            QS_SIG_(e->sig);      /* the signal of the event */
+            QS_OBJ_(me);          /* this active object (recipient) */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);       /* number of free entries */
+            QS_EQC_(margin);      /* margin requested */
+        QS_END_()
+
+        QF_gc(e); /* recycle the event to avoid a leak */
+        status = false; /* event not posted */
+    }
+
+    return status;
+}
+
+/****************************************************************************/
+/**
+* @description
+* posts an event to the event queue of the active object @p me using the
+* Last-In-First-Out (LIFO) policy.
+*
+* @note With the ::QMpscQueue the LIFO policy can be used only for
+* self-posting (including QActive_recall()), that is, only from the thread
+* of the active object @p me, and at most one LIFO event can be pending.
+*
+* @param[in] me pointer (see @ref oop)
+* @param[in  e  pointer to the event to post to the queue
+*
+* @sa QActive_post_(), QMpscQueue_postLIFO()
+*/
+void QActive_postLIFO_(QActive * const me, QEvt const * const e) {
+    QEQueueCtr nFree;
+    QF_CRIT_STAT_
+
+    /** @pre the front slot of the queue must be free */
+    Q_REQUIRE_ID(200, me->eQueue.frontEvt == (QEvt const *)0);
+
+    nFree = QMpscQueue_reserve_(&me->eQueue, (uint_fast16_t)0,
+                                (QEQueueCtr *)0);
+
+    /* the queue must be able to accept the event (cannot overflow) */
+    Q_ASSERT_ID(210, nFree != (QEQueueCtr)0);
+
+    QS_BEGIN_(QS_QF_ACTIVE_POST_LIFO, QS_priv_.aoObjFilter, me)
+        QS_TIME_();                  /* timestamp */
+        QS_SIG_(e->sig);             /* the signal of this event */
+        QS_OBJ_(me);                 /* this active object */
+        QS_2U8_(e->poolId_, e->refCtr_);/* pool Id & ref Count of the event */
+        QS_EQC_(nFree);              /* number of free entries */
+        QS_EQC_(me->eQueue.nMin);    /* min number of free entries */
+    QS_END_()
+
+    /* is it a pool event? */
+    if (e->poolId_ != (uint8_t)0) {
+        QF_CRIT_ENTRY_();
+        QF_EVT_REF_CTR_INC_(e);      /* increment the reference counter */
+        QF_CRIT_EXIT_();
+    }
+
+    /* the AO thread is running (it is the caller), so no signal needed */
+    me->eQueue.frontEvt = e;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Takes the next event from the ::QMpscQueue of the active object. When
+* the queue is empty, the function blocks the calling AO thread with
+* QACTIVE_EQUEUE_WAIT_() until a producer signals the arrival of an event.
+* When the queue is not empty, no critical section is used.
+*
+* @param[in,out] me  pointer (see @ref oop)
+*
+* @returns a pointer to the received event. The returned pointer is always
+* valid (can't be NULL).
+*/
+QEvt const *QActive_get_(QActive * const me) {
+    QEQueueCtr nFree = (QEQueueCtr)0;
+    QEvt const *e = QMpscQueue_take_(&me->eQueue, &nFree);
+    QS_CRIT_STAT_
+
+    /* queue empty (or the oldest event not yet published)? */
+    if (e == (QEvt const *)0) {
+        QF_CRIT_STAT_
+        QF_CRIT_ENTRY_();
+        QACTIVE_EQUEUE_WAIT_(me);  /* wait for event to arrive */
+        QF_CRIT_EXIT_();
+
+        e = QMpscQueue_take_(&me->eQueue, &nFree);
+
+        /* the queue cannot be empty after the wait */
+        Q_ASSERT_ID(310, e != (QEvt const *)0);
+    }
+
+    if (nFree < me->eQueue.end) { /* more events in the queue? */
+        QS_BEGIN_(QS_QF_ACTIVE_GET, QS_priv_.aoObjFilter, me)
+            QS_TIME_();                   /* timestamp */
+            QS_SIG_(e->sig);              /* the signal of this event */
+            QS_OBJ_(me);                  /* this active object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);               /* number of free entries */
+        QS_END_()
+    }
+    else {
+        QS_BEGIN_(QS_QF_ACTIVE_GET_LAST, QS_priv_.aoObjFilter, me)
+            QS_TIME_();                   /* timestamp */
+            QS_SIG_(e->sig);              /* the signal of this event */
+            QS_OBJ_(me);                  /* this active object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+        QS_END_()
+    }
+    return e;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Queries the minimum of free ever present in the given event queue of
+* an active object with priority @p prio, since the active object
+* was started.
+*
+* @param[in] prio  Priority of the active object, whose queue is queried
+*
+* @returns the minimum of free ever present in the given event
+* queue of an active object with priority @p prio, since the active object
+* was started.
+*/
+uint_fast16_t QF_getQueueMin(uint_fast8_t const prio) {
+    Q_REQUIRE_ID(400, (prio <= (uint_fast8_t)QF_MAX_ACTIVE)
+                      && (QF_active_[prio] != (QActive *)0));
+
+    return QMpscQueue_getNMin(&QF_active_[prio]->eQueue);
+}
@@ -152,13 +152,16 @@ void QMPool_init(QMPool * const me, void * const poolSto,
 void QMPool_put(QMPool * const me, void *b) {
     QF_CRIT_STAT_
 
+    QF_CRIT_ENTRY_();
+
     /** @pre # free blocks cannot exceed the total # blocks and
     * the block pointer must be from this pool.
+    * @note the precondition is checked inside the critical section, because
+    * on a multicore host other threads can update nFree concurrently.
     */
     Q_REQUIRE_ID(200, (me->nFree < me->nTot)
                       && QF_PTR_RANGE_(b, me->start, me->end));
 
-    QF_CRIT_ENTRY_();
     ((QFreeBlock *)b)->next = (QFreeBlock *)me->free_head;/* link into list */
     me->free_head = b;      /* set as new head of the free list */
     ++me->nFree;            /* one more free block in this pool */
@@ -0,0 +1,429 @@
+/**
+* @file
+* @brief QMpscQueue implementation
+* @ingroup qf
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qf_pkg.h"       /* QF package-scope interface */
+#include "qmpscq.h"       /* lock-free MPSC queue interface */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+Q_DEFINE_THIS_MODULE("qf_mpscq")
+
+/* packing of the head and the number of free slots in QMpscQueue::ctrl */
+#define QMPSC_CTRL_(head_, nFree_) \
+    (((uint32_t)(head_) << 16) | (uint32_t)(nFree_))
+#define QMPSC_HEAD_(ctrl_)  ((QEQueueCtr)((ctrl_) >> 16))
+#define QMPSC_NFREE_(ctrl_) ((QEQueueCtr)((ctrl_) & (uint32_t)0xFFFFU))
+
+/****************************************************************************/
+/**
+* @description
+* Initialize the MPSC event queue by giving it the storage for the ring
+* buffer.
+*
+* @param[in,out] me       pointer (see @ref oop)
+* @param[in]     qSto     an array of pointers to ::QEvt to serve as the
+*                         ring buffer for the event queue
+* @param[in]     qLen     the length of the qSto[] buffer (in ::QEvt pointers)
+*
+* @note The queue must be initialized before any producer or the consumer
+* accesses it. Unlike ::QEQueue, the capacity of the queue is qLen.
+*/
+void QMpscQueue_init(QMpscQueue * const me,
+                     QEvt const *qSto[], uint_fast16_t const qLen)
+{
+    uint_fast16_t i;
+    QS_CRIT_STAT_
+
+    /** @pre the ring must have at least one slot and its length must fit
+    * into the ::QEQueueCtr counters.
+    */
+    Q_REQUIRE_ID(100, ((uint_fast16_t)0 < qLen)
+                      && (qLen == (uint_fast16_t)(QEQueueCtr)qLen));
+
+    for (i = (uint_fast16_t)0; i < qLen; ++i) {
+        qSto[i] = (QEvt const *)0; /* all slots are free */
+    }
+    me->ring     = &qSto[0];
+    me->end      = (QEQueueCtr)qLen;
+    me->waiting  = (uint8_t)0;
+    me->ctrl     = QMPSC_CTRL_(0U, qLen);
+    me->nMin     = (QEQueueCtr)qLen;
+    me->frontEvt = (QEvt const *)0;
+    me->tail     = (QEQueueCtr)0;
+
+    QS_BEGIN_(QS_QF_EQUEUE_INIT, QS_priv_.eqObjFilter, me)
+        QS_OBJ_(me);          /* this QMpscQueue object */
+        QS_EQC_(me->end);     /* the length of the queue */
+    QS_END_()
+}
+
+/****************************************************************************/
+/**
+* @description
+* Reserves one free slot in the queue, provided that more than @p margin
+* slots are free, and claims the position of the slot in the ring buffer
+* in the same compare-and-swap operation. The caller then must publish the
+* event in the claimed position with QMpscQueue_publish_(). When @p pos is
+* NULL, only the free slot is reserved for the consumer's front slot.
+*
+* @returns the number of free slots before the reservation. The reservation
+* failed when the returned number is not greater than @p margin.
+*/
+QEQueueCtr QMpscQueue_reserve_(QMpscQueue * const me,
+                               uint_fast16_t const margin,
+                               QEQueueCtr * const pos)
+{
+    uint32_t ctrl;
+    QEQueueCtr nFree;
+
+    QF_LOAD_ACQ(ctrl, &me->ctrl);
+    for (;;) {
+        QEQueueCtr head = QMPSC_HEAD_(ctrl);
+        nFree = QMPSC_NFREE_(ctrl);
+
+        /* required margin not available? */
+        if (nFree <= (QEQueueCtr)margin) {
+            break;
+        }
+
+        /* claim the slot at the head, unless only the front slot is used */
+        if (pos != (QEQueueCtr *)0) {
+            ++head;
+            if (head == me->end) { /* need to wrap the head? */
+                head = (QEQueueCtr)0;
+            }
+        }
+
+        /* a failed CAS reloads ctrl, so the margin is checked again */
+        if (QF_CAS(&me->ctrl, &ctrl,
+                   QMPSC_CTRL_(head, nFree - (QEQueueCtr)1)))
+        {
+            QEQueueCtr nMin;
+
+            if (pos != (QEQueueCtr *)0) {
+                *pos = QMPSC_HEAD_(ctrl); /* the claimed position */
+            }
+
+            /* update the low-watermark lock-free */
+            QF_LOAD_ACQ(nMin, &me->nMin);
+            while ((nMin > (nFree - (QEQueueCtr)1))
+                   && (!QF_CAS(&me->nMin, &nMin, nFree - (QEQueueCtr)1)))
+            {
+            }
+            break;
+        }
+    }
+    return nFree;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Stores the event in the slot claimed by QMpscQueue_reserve_(), which
+* publishes the event to the consumer.
+*
+* @returns true when the consumer announced that it is about to block
+* (see QMpscQueue_prepareWait_()) and must be signalled, see NOTE2.
+*/
+bool QMpscQueue_publish_(QMpscQueue * const me, QEQueueCtr const pos,
+                         QEvt const * const e)
+{
+    uint8_t waiting;
+
+    QF_STORE_REL(&QF_PTR_AT_(me->ring, pos), e);
+    QF_MEM_FENCE(); /* the slot store before the waiting load, NOTE2 */
+    QF_LOAD_ACQ(waiting, &me->waiting);
+    return waiting != (uint8_t)0;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Removes the event from the front of the queue (the consumer's front slot
+* first, then the tail of the ring buffer) and returns the slot to the
+* producers.
+*
+* @param[in,out] me     pointer (see @ref oop)
+* @param[out]    nFree  the number of free slots after taking the event
+*
+* @returns the event or NULL when the queue is empty or the oldest event is
+* still being published by its producer.
+*/
+QEvt const *QMpscQueue_take_(QMpscQueue * const me,
+                             QEQueueCtr * const nFree)
+{
+    QEvt const *e = me->frontEvt;
+
+    if (e != (QEvt const *)0) { /* event in the front slot? */
+        me->frontEvt = (QEvt const *)0;
+    }
+    else {
+        QF_LOAD_ACQ(e, &QF_PTR_AT_(me->ring, me->tail));
+        if (e != (QEvt const *)0) { /* event published at the tail? */
+            /* free the slot, released to the producers by the ctrl update */
+            QF_PTR_AT_(me->ring, me->tail) = (QEvt const *)0;
+            ++me->tail;
+            if (me->tail == me->end) { /* need to wrap the tail? */
+                me->tail = (QEQueueCtr)0;
+            }
+        }
+    }
+
+    if (e != (QEvt const *)0) {
+        uint32_t ctrl = QF_FETCH_ADD(&me->ctrl, (uint32_t)1) + (uint32_t)1;
+        *nFree = QMPSC_NFREE_(ctrl);
+    }
+    return e;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Announces that the consumer is about to block and checks the queue once
+* more. Must be called by the consumer inside the critical section, in
+* which the consumer then blocks.
+*
+* @returns true when the queue is still empty, so the consumer may block
+* until signalled by a producer, false when the queue is not empty.
+*/
+bool QMpscQueue_prepareWait_(QMpscQueue * const me) {
+    bool isEmpty = false;
+
+    if (me->frontEvt == (QEvt const *)0) {
+        QEvt const *e;
+
+        QF_STORE_REL(&me->waiting, (uint8_t)1);
+        QF_MEM_FENCE(); /* the waiting store before the slot load, NOTE2 */
+        QF_LOAD_ACQ(e, &QF_PTR_AT_(me->ring, me->tail));
+        isEmpty = (e == (QEvt const *)0);
+    }
+    if (!isEmpty) {
+        QF_STORE_REL(&me->waiting, (uint8_t)0);
+    }
+    return isEmpty;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Post an event to the MPSC event queue using the First-In-First-Out order.
+* Can be called concurrently from any number of threads.
+*
+* @param[in,out] me     pointer (see @ref oop)
+* @param[in]     e      pointer to the event to be posted to the queue
+* @param[in]     margin number of unused slots in the queue that must
+*                       be still available after posting the event
+*
+* @note The zero value of the @p margin parameter is special and denotes
+* situation when event posting is assumed to succeed (event delivery
+* guarantee), exactly as in QEQueue_post().
+*
+* @returns 'true' (success) when the posting succeeded with the provided
+* margin and 'false' (failure) when the posting fails.
+*
+* @sa QMpscQueue_get(), QEQueue_post()
+*/
+bool QMpscQueue_post(QMpscQueue * const me, QEvt const * const e,
+                     uint_fast16_t const margin)
+{
+    QEQueueCtr pos = (QEQueueCtr)0;
+    QEQueueCtr nFree;
+    bool status;
+
+    /** @pre event must be valid */
+    Q_REQUIRE_ID(200, e != (QEvt const *)0);
+
+    nFree = QMpscQueue_reserve_(me, margin, &pos);
+
+    /* slot reserved with the required margin? */
+    if (nFree > (QEQueueCtr)margin) {
+
+        QS_BEGIN_(QS_QF_EQUEUE_POST_FIFO, QS_priv_.eqObjFilter, me)
+            QS_TIME_();                      /* timestamp */
+            QS_SIG_(e->sig);                 /* the signal of this event */
+            QS_OBJ_(me);                     /* this queue object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);                  /* number of free entries */
+            QS_EQC_(me->nMin);               /* min number of free entries */
+        QS_END_()
+
+        /* is it a pool event? */
+        if (e->poolId_ != (uint8_t)0) {
+            QF_CRIT_STAT_
+            QF_CRIT_ENTRY_();
+            QF_EVT_REF_CTR_INC_(e); /* increment the reference counter */
+            QF_CRIT_EXIT_();
+        }
+
+        (void)QMpscQueue_publish_(me, pos, e);
+        status = true; /* event posted successfully */
+    }
+    else {
+        /** @note If the @p margin is zero, assert that the queue can accept
+        * the event. This is to support the "guaranteed event delivery"
+        * policy for most events posted within the framework.
+        */
+        Q_ASSERT_ID(210, margin != (uint_fast16_t)0);
+
+        QS_BEGIN_(QS_QF_EQUEUE_POST_ATTEMPT, QS_priv_.eqObjFilter, me)
+            QS_TIME_();                      /* timestamp */
+            QS_SIG_(e->sig);                 /* the signal of this event */
+            QS_OBJ_(me);                     /* this queue object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);                  /* number of free entries */
+            QS_EQC_(margin);                 /* margin requested */
+        QS_END_()
+
+        status = false;
+    }
+
+    return status;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Post an event to the front of the MPSC event queue (Last-In-First-Out
+* order). Must be called only from the consumer of the queue, which is the
+* case for self-posting and for QActive_recall().
+*
+* @param[in,out] me     pointer (see @ref oop)
+* @param[in]     e      pointer to the event to be posted to the queue
+*
+* @note The LIFO event is stored in the single front slot of the consumer,
+* so at most one LIFO event can be pending at any given time.
+*
+* @sa QMpscQueue_post(), QEQueue_postLIFO()
+*/
+void QMpscQueue_postLIFO(QMpscQueue * const me, QEvt const * const e) {
+    QEQueueCtr nFree;
+
+    /** @pre the front slot must be free */
+    Q_REQUIRE_ID(300, me->frontEvt == (QEvt const *)0);
+
+    nFree = QMpscQueue_reserve_(me, (uint_fast16_t)0, (QEQueueCtr *)0);
+
+    /* the queue must be able to accept the event (cannot overflow) */
+    Q_ASSERT_ID(310, nFree != (QEQueueCtr)0);
+
+    QS_BEGIN_(QS_QF_EQUEUE_POST_LIFO, QS_priv_.eqObjFilter, me)
+        QS_TIME_();                      /* timestamp */
+        QS_SIG_(e->sig);                 /* the signal of this event */
+        QS_OBJ_(me);                     /* this queue object */
+        QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+        QS_EQC_(nFree);                  /* number of free entries */
+        QS_EQC_(me->nMin);               /* min number of free entries */
+    QS_END_()
+
+    /* is it a pool event? */
+    if (e->poolId_ != (uint8_t)0) {
+        QF_CRIT_STAT_
+        QF_CRIT_ENTRY_();
+        QF_EVT_REF_CTR_INC_(e); /* increment the reference counter */
+        QF_CRIT_EXIT_();
+    }
+
+    me->frontEvt = e; /* only the consumer accesses the front slot */
+}
+
+/****************************************************************************/
+/**
+* @description
+* Retrieves an event from the front of the MPSC queue and returns a pointer
+* to this event to the caller. Must be called only from the single consumer
+* of this queue.
+*
+* @param[in,out] me     pointer (see @ref oop)
+*
+* @returns pointer to event at the front of the queue, if the queue is
+* not empty and NULL if the queue is empty (including the case when the
+* oldest event is still being published by a concurrent producer).
+*
+* @note The consumer is responsible for calling QF_gc() on the events
+* obtained from the queue, exactly as with QEQueue_get().
+*
+* @sa QMpscQueue_post(), QEQueue_get()
+*/
+QEvt const *QMpscQueue_get(QMpscQueue * const me) {
+    QEQueueCtr nFree;
+    QEvt const *e = QMpscQueue_take_(me, &nFree);
+
+    if (e != (QEvt const *)0) {
+        QS_BEGIN_(QS_QF_EQUEUE_GET, QS_priv_.eqObjFilter, me)
+            QS_TIME_();                      /* timestamp */
+            QS_SIG_(e->sig);                 /* the signal of this event */
+            QS_OBJ_(me);                     /* this queue object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);                  /* number of free entries */
+        QS_END_()
+    }
+
+    return e;
+}
+
+/*****************************************************************************
+* NOTE1:
+* A producer can be preempted (or just slow) between reserving its slot in
+* QMpscQueue_reserve_() and storing the event in QMpscQueue_publish_(). The
+* slots are claimed in the ring-buffer order, but can be published out of
+* order, so the consumer sees the queue as empty until the oldest event is
+* published, even when younger events are already stored behind it. This
+* keeps the FIFO order among the events that are visible to the consumer.
+* A slot is always free when it is claimed, because the reservation count
+* in QMpscQueue::ctrl never exceeds the number of slots freed so far by the
+* consumer, which frees the slots strictly in the ring-buffer order.
+*
+* NOTE2:
+* The consumer must not miss the event that arrives just as it goes to
+* sleep. The consumer stores the QMpscQueue::waiting flag and then loads the
+* slot at the tail, while the producer stores the event into its slot and
+* then loads the waiting flag. The full memory fences between the store and
+* the load on both sides guarantee that at least one side sees the store of
+* the other side: either the consumer sees the event and does not block, or
+* the producer sees the waiting flag and signals the consumer (inside the
+* critical section in which the consumer blocks). As long as the consumer
+* is busy, the waiting flag is clear and the producers do not touch the
+* critical section at all, which lets the producers scale with the cores.
+*/
@@ -0,0 +1,282 @@
+/**
+* @file
+* @brief QSpscQueue implementation
+* @ingroup qf
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qf_pkg.h"       /* QF package-scope interface */
+#include "qspscq.h"       /* lock-free SPSC queue interface */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+Q_DEFINE_THIS_MODULE("qf_spscq")
+
+/* number of free slots for the given head and tail, one slot kept empty */
+#define QSPSC_NFREE_(me_, head_, tail_) ((QEQueueCtr)((tail_) > (head_) \
+    ? ((tail_) - (head_) - (QEQueueCtr)1) \
+    : (((me_)->end - (head_)) + (tail_) - (QEQueueCtr)1)))
+
+/****************************************************************************/
+/**
+* @description
+* Initialize the SPSC event queue by giving it the storage for the ring
+* buffer and optionally the active object to notify with a doorbell event.
+*
+* @param[in,out] me       pointer (see @ref oop)
+* @param[in]     qSto     an array of pointers to ::QEvt to serve as the
+*                         ring buffer for the event queue
+* @param[in]     qLen     the length of the qSto[] buffer (in ::QEvt pointers)
+* @param[in]     act      active object to notify (or NULL for a "raw" queue)
+* @param[in]     doorbell event to post to @p act when the queue becomes
+*                         not empty (must be NULL when @p act is NULL)
+*
+* @note The actual capacity of the queue is qLen - 1.
+*/
+void QSpscQueue_init(QSpscQueue * const me,
+                     QEvt const *qSto[], uint_fast16_t const qLen,
+                     QActive * const act,
+                     QEvt const * const doorbell)
+{
+    QS_CRIT_STAT_
+
+    /** @pre the ring must have at least two slots and the doorbell must be
+    * provided if and only if the active object to notify is provided.
+    */
+    Q_REQUIRE_ID(100, (qLen >= (uint_fast16_t)2)
+                      && ((act == (QActive *)0)
+                          == (doorbell == (QEvt const *)0)));
+
+    me->ring     = &qSto[0];
+    me->act      = act;
+    me->doorbell = doorbell;
+    me->end      = (QEQueueCtr)qLen;
+    me->nMin     = (QEQueueCtr)(qLen - (uint_fast16_t)1);
+    me->head     = (QEQueueCtr)0;
+    me->tail     = (QEQueueCtr)0;
+
+    QS_BEGIN_(QS_QF_EQUEUE_INIT, QS_priv_.eqObjFilter, me)
+        QS_OBJ_(me);          /* this QSpscQueue object */
+        QS_EQC_(me->end);     /* the length of the queue */
+    QS_END_()
+}
+
+/****************************************************************************/
+/**
+* @description
+* Post an event to the SPSC event queue using the First-In-First-Out order.
+* Must be called only from the single producer of this queue.
+*
+* @param[in,out] me     pointer (see @ref oop)
+* @param[in]     e      pointer to the event to be posted to the queue
+* @param[in]     margin number of unused slots in the queue that must
+*                       be still available after posting the event
+*
+* @note The zero value of the @p margin parameter is special and denotes
+* situation when event posting is assumed to succeed (event delivery
+* guarantee), exactly as in QEQueue_post().
+*
+* @returns 'true' (success) when the posting succeeded with the provided
+* margin and 'false' (failure) when the posting fails.
+*
+* @sa QSpscQueue_get(), QEQueue_post()
+*/
+bool QSpscQueue_post(QSpscQueue * const me, QEvt const * const e,
+                     uint_fast16_t const margin)
+{
+    QEQueueCtr head = me->head; /* only the producer writes the head */
+    QEQueueCtr tail;
+    QEQueueCtr nFree;
+    bool status;
+
+    /** @pre event must be valid */
+    Q_REQUIRE_ID(200, e != (QEvt const *)0);
+
+    QF_LOAD_ACQ(tail, &me->tail); /* the slots freed by the consumer */
+    nFree = QSPSC_NFREE_(me, head, tail);
+
+    /* required margin available? */
+    if (nFree > (QEQueueCtr)margin) {
+        QEQueueCtr next;
+
+        QS_BEGIN_(QS_QF_EQUEUE_POST_FIFO, QS_priv_.eqObjFilter, me)
+            QS_TIME_();                      /* timestamp */
+            QS_SIG_(e->sig);                 /* the signal of this event */
+            QS_OBJ_(me);                     /* this queue object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);                  /* number of free entries */
+            QS_EQC_(me->nMin);               /* min number of free entries */
+        QS_END_()
+
+        /* is it a pool event? */
+        if (e->poolId_ != (uint8_t)0) {
+            QF_CRIT_STAT_
+            QF_CRIT_ENTRY_();
+            QF_EVT_REF_CTR_INC_(e); /* increment the reference counter */
+            QF_CRIT_EXIT_();
+        }
+
+        --nFree; /* one free entry just used up */
+        if (me->nMin > nFree) {
+            me->nMin = nFree; /* update minimum so far */
+        }
+
+        QF_PTR_AT_(me->ring, head) = e; /* insert e into the buffer */
+        next = head + (QEQueueCtr)1;
+        if (next == me->end) { /* need to wrap the head? */
+            next = (QEQueueCtr)0;
+        }
+        QF_STORE_REL(&me->head, next); /* publish e to the consumer */
+
+        /* ring the doorbell when e found the queue empty, see NOTE1 */
+        if (me->act != (QActive *)0) {
+            QF_MEM_FENCE();
+            QF_LOAD_ACQ(tail, &me->tail);
+            if (tail == head) { /* consumer has taken all events before e? */
+                QACTIVE_POST(me->act, me->doorbell, me);
+            }
+        }
+        status = true; /* event posted successfully */
+    }
+    else {
+        /** @note If the @p margin is zero, assert that the queue can accept
+        * the event. This is to support the "guaranteed event delivery"
+        * policy for most events posted within the framework.
+        */
+        Q_ASSERT_ID(210, margin != (uint_fast16_t)0);
+
+        QS_BEGIN_(QS_QF_EQUEUE_POST_ATTEMPT, QS_priv_.eqObjFilter, me)
+            QS_TIME_();                      /* timestamp */
+            QS_SIG_(e->sig);                 /* the signal of this event */
+            QS_OBJ_(me);                     /* this queue object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(nFree);                  /* number of free entries */
+            QS_EQC_(margin);                 /* margin requested */
+        QS_END_()
+
+        status = false;
+    }
+
+    return status;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Retrieves an event from the front of the SPSC queue and returns a pointer
+* to this event to the caller. Must be called only from the single consumer
+* of this queue.
+*
+* @param[in,out] me     pointer (see @ref oop)
+*
+* @returns pointer to event at the front of the queue, if the queue is
+* not empty and NULL if the queue is empty.
+*
+* @note The consumer is responsible for calling QF_gc() on the events
+* obtained from the queue, exactly as with QEQueue_get().
+*
+* @sa QSpscQueue_post(), QEQueue_get()
+*/
+QEvt const *QSpscQueue_get(QSpscQueue * const me) {
+    QEQueueCtr tail = me->tail; /* only the consumer writes the tail */
+    QEQueueCtr head;
+    QEvt const *e = (QEvt const *)0;
+
+    QF_LOAD_ACQ(head, &me->head); /* the events published by the producer */
+
+    /* queue seen empty with a doorbell configured? re-check, see NOTE1 */
+    if ((head == tail) && (me->act != (QActive *)0)) {
+        QF_MEM_FENCE();
+        QF_LOAD_ACQ(head, &me->head);
+    }
+
+    /* is the queue not empty? */
+    if (head != tail) {
+        e = QF_PTR_AT_(me->ring, tail); /* get event from the tail */
+        ++tail;
+        if (tail == me->end) { /* need to wrap the tail? */
+            tail = (QEQueueCtr)0;
+        }
+
+        QS_BEGIN_(QS_QF_EQUEUE_GET, QS_priv_.eqObjFilter, me)
+            QS_TIME_();                      /* timestamp */
+            QS_SIG_(e->sig);                 /* the signal of this event */
+            QS_OBJ_(me);                     /* this queue object */
+            QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+            QS_EQC_(QSPSC_NFREE_(me, head, tail)); /* # free entries */
+        QS_END_()
+
+        QF_STORE_REL(&me->tail, tail); /* return the slot to the producer */
+    }
+
+    return e;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Returns the number of free slots in the queue as seen at the time of the
+* call. The number can change at any time when the other side is active,
+* so the value is only a snapshot.
+*/
+uint_fast16_t QSpscQueue_getNFree(QSpscQueue const * const me) {
+    QEQueueCtr head;
+    QEQueueCtr tail;
+
+    QF_LOAD_ACQ(head, &me->head);
+    QF_LOAD_ACQ(tail, &me->tail);
+    return (uint_fast16_t)QSPSC_NFREE_(me, head, tail);
+}
+
+/*****************************************************************************
+* NOTE1:
+* The doorbell must never be lost, but the producer and the consumer can run
+* truly concurrently on a multicore host. The producer stores the head and
+* then loads the tail, while the consumer (after storing the tail in the
+* previous QSpscQueue_get()) loads the head. The full memory fences between
+* the store and the load on both sides guarantee that at least one side sees
+* the store of the other side: either the producer sees that the consumer
+* has drained the queue and rings the doorbell, or the consumer sees the new
+* event and takes it. Occasionally both happen, which results only in a
+* spurious doorbell, after which the active object finds the queue empty.
+* On a single-core MCU, where the producer is an ISR, the fences are cheap
+* and the race cannot occur in the first place.
+*/
@@ -52,6 +52,8 @@ Q_DEFINE_THIS_MODULE("qf_time")
 /* Package-scope objects ****************************************************/
 QTimeEvt QF_timeEvtHead_[QF_MAX_TICK_RATE]; /* heads of time event lists */
 
+#ifndef QF_TIMEEVT_WHEEL_SIZE /* time event lists (not the timing wheel)? */
+
 /****************************************************************************/
 /**
 * @description
@@ -211,6 +213,83 @@ bool QF_noTimeEvtsActiveX(uint_fast8_t const tickRate) {
     return inactive;
 }
 
+/****************************************************************************/
+/**
+* @description
+* Find out the number of clock ticks until the nearest expiration of a time
+* event armed at the given clock tick rate. This is intended for the
+* "tickless" idle processing, in which the clock tick is stopped and the
+* CPU sleeps until the nearest time event expiration, see QF_tickSkipX().
+*
+* @param[in]  tickRate  system clock tick rate to find out about.
+*
+* @returns the number of calls to QF_tickX_() (at the given tick rate)
+* until the nearest time event expires, or 0 if no time events are armed.
+*
+* @note This function should be called in critical section.
+*/
+QTimeEvtCtr QF_ticksToNextX(uint_fast8_t const tickRate) {
+    QTimeEvtCtr next = (QTimeEvtCtr)0;
+    QTimeEvt *t;
+    uint_fast8_t n;
+
+    /** @pre the tick rate must be in range */
+    Q_REQUIRE_ID(700, tickRate < (uint_fast8_t)QF_MAX_TICK_RATE);
+
+    /* scan the time event list and the list of newly armed time events */
+    t = QF_timeEvtHead_[tickRate].next;
+    for (n = (uint_fast8_t)0; n < (uint_fast8_t)2; ++n) {
+        for (; t != (QTimeEvt *)0; t = t->next) {
+            if ((t->ctr != (QTimeEvtCtr)0) /* armed? */
+                && ((next == (QTimeEvtCtr)0) || (t->ctr < next)))
+            {
+                next = t->ctr;
+            }
+        }
+        t = (QTimeEvt *)QF_timeEvtHead_[tickRate].act;
+    }
+    return next;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Advance all time events armed at the given clock tick rate by the given
+* number of clock ticks, in which none of them expires. This function is
+* used in the "tickless" idle processing to catch up with the clock ticks
+* missed while the clock tick was stopped. It is equivalent to @p nTicks
+* calls to QF_tickX_(), but takes only one pass over the time events.
+*
+* @param[in]  tickRate  system clock tick rate to advance.
+* @param[in]  nTicks    number of clock ticks to advance, which must be
+*                       less than the value returned from QF_ticksToNextX().
+*
+* @note This function should be called in critical section.
+*/
+void QF_tickSkipX(uint_fast8_t const tickRate, QTimeEvtCtr const nTicks) {
+    QTimeEvt *t;
+    uint_fast8_t n;
+
+    /** @pre the tick rate must be in range */
+    Q_REQUIRE_ID(800, tickRate < (uint_fast8_t)QF_MAX_TICK_RATE);
+
+    QF_timeEvtHead_[tickRate].ctr += nTicks; /* the tick counter */
+
+    t = QF_timeEvtHead_[tickRate].next;
+    for (n = (uint_fast8_t)0; n < (uint_fast8_t)2; ++n) {
+        for (; t != (QTimeEvt *)0; t = t->next) {
+            if (t->ctr != (QTimeEvtCtr)0) { /* armed? */
+                /** @pre no time event can expire in the skipped ticks */
+                Q_REQUIRE_ID(810, t->ctr > nTicks);
+                t->ctr -= nTicks;
+            }
+        }
+        t = (QTimeEvt *)QF_timeEvtHead_[tickRate].act;
+    }
+}
+#endif /* QF_TIMEEVT_WHEEL_SIZE */
+
+
 /****************************************************************************/
 /**
 * @description
@@ -239,6 +318,10 @@ void QTimeEvt_ctorX(QTimeEvt * const me, QActive * const act,
     me->ctr       = (QTimeEvtCtr)0;
     me->interval  = (QTimeEvtCtr)0;
     me->super.sig = (QSignal)sig;
+#ifdef QF_TIMEEVT_WHEEL_SIZE
+    me->pprev     = (QTimeEvt * volatile *)0;
+    me->due       = (QTimeEvtCtr)0;
+#endif
 
     /* For backwards compatibility with QTimeEvt_ctor(), the active object
     * pointer can be uninitialized (NULL) and is NOT validated in the
@@ -262,6 +345,8 @@ void QTimeEvt_ctorX(QTimeEvt * const me, QActive * const act,
     me->super.refCtr_ = (uint8_t)tickRate;
 }
 
+#ifndef QF_TIMEEVT_WHEEL_SIZE /* time event lists (not the timing wheel)? */
+
 /****************************************************************************/
 /**
 * @description
@@ -510,3 +595,5 @@ QTimeEvtCtr QTimeEvt_ctr(QTimeEvt const * const me) {
     QF_CRIT_EXIT_();
     return ret;
 }
+
+#endif /* QF_TIMEEVT_WHEEL_SIZE */
@@ -0,0 +1,550 @@
+/**
+* @file
+* @brief QF/C time events with the hashed timing wheel
+* @ingroup qf
+* @cond
+******************************************************************************
+* Last Updated for Version: 5.4.0
+* Date of the Last Update:  2026-10-17
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, LLC. state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qf_pkg.h"       /* QF package-scope interface */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+/**
+* @note This module is used instead of the time event lists in qf_time.c
+* when the macro #QF_TIMEEVT_WHEEL_SIZE is defined (in qf_port.h or on the
+* command line). The module provides the same QTimeEvt API, see NOTE1.
+*/
+#ifdef QF_TIMEEVT_WHEEL_SIZE
+
+Q_DEFINE_THIS_MODULE("qf_twheel")
+
+/* slot of the timing wheel for the given tick */
+#define QF_TWHEEL_SLOT_(tickRate_, tick_) \
+    (&l_wheel[(tickRate_)][(tick_) & (QTimeEvtCtr)(QF_TIMEEVT_WHEEL_SIZE - 1)])
+
+/* Local objects ===========================================================*/
+/* the slots of the timing wheel of every tick rate */
+static QTimeEvt * volatile l_wheel[QF_MAX_TICK_RATE][QF_TIMEEVT_WHEEL_SIZE];
+
+/* the number of armed time events at every tick rate */
+static uint_fast16_t l_nArmed[QF_MAX_TICK_RATE];
+
+/*..........................................................................*/
+/* insert the time event into the list @p head (inside critical section) */
+static void QTimeEvt_link_(QTimeEvt * const me,
+                           QTimeEvt * volatile * const head)
+{
+    QTimeEvt *next = *head;
+    me->next  = next;
+    me->pprev = head;
+    if (next != (QTimeEvt *)0) {
+        next->pprev = &me->next;
+    }
+    *head = me;
+}
+/*..........................................................................*/
+/* remove the time event from its list (inside critical section) */
+static void QTimeEvt_unlink_(QTimeEvt * const me) {
+    QTimeEvt *next = me->next;
+    *me->pprev = next;
+    if (next != (QTimeEvt *)0) {
+        next->pprev = me->pprev;
+    }
+    me->pprev = (QTimeEvt * volatile *)0;
+}
+
+/****************************************************************************/
+/**
+* @description
+* This function must be called periodically from a time-tick ISR or from
+* a task so that QF can manage the timeout events assigned to the given
+* system clock tick rate. With the timing wheel, only the time events in
+* the wheel slot of the current tick are processed, see NOTE1.
+*
+* @param[in]  tickRate  system clock tick rate serviced in this call.
+*
+* @note this function should be called only via the macro QF_TICK_X()
+*
+* @sa ::QTimeEvt.
+*/
+#ifndef Q_SPY
+void QF_tickX_(uint_fast8_t const tickRate)
+#else
+void QF_tickX_(uint_fast8_t const tickRate, void const * const sender)
+#endif
+{
+    QTimeEvt *head = &QF_timeEvtHead_[tickRate];
+    QTimeEvt * volatile *slot;
+    QTimeEvtCtr now;
+    QF_CRIT_STAT_
+
+    QF_CRIT_ENTRY_();
+    now = ++head->ctr; /* the tick counter of this rate */
+
+    QS_BEGIN_NOCRIT_(QS_QF_TICK, (void *)0, (void *)0)
+        QS_TEC_(now);                        /* tick ctr */
+        QS_U8_((uint8_t)tickRate);           /* tick rate */
+    QS_END_NOCRIT_()
+
+    /* move the slot of this tick to the pending list, see NOTE2 */
+    slot = QF_TWHEEL_SLOT_(tickRate, now);
+    head->next = (QTimeEvt *)0;
+    if (*slot != (QTimeEvt *)0) {
+        head->next = *slot;
+        head->next->pprev = &head->next;
+        *slot = (QTimeEvt *)0;
+    }
+
+    /* process the pending time events one by one... */
+    for (;;) {
+        QTimeEvt *t = head->next;
+
+        /* all pending time events processed? */
+        if (t == (QTimeEvt *)0) {
+            break;
+        }
+        QTimeEvt_unlink_(t);
+
+        /* time event expires in a later revolution of the wheel? */
+        if (t->due != now) {
+            QTimeEvt_link_(t, slot); /* back to the same slot */
+            QF_CRIT_EXIT_(); /* exit crit. section to reduce latency */
+
+            /* prevent merging critical sections, see NOTE1 in qf_time.c */
+            QF_CRIT_EXIT_NOP();
+        }
+        else {
+            QActive *act = (QActive *)t->act; /* temporary for volatile */
+
+            /* periodic time evt? */
+            if (t->interval != (QTimeEvtCtr)0) {
+                t->ctr = t->interval; /* rearm the time event */
+                t->due = now + t->interval;
+                QTimeEvt_link_(t, QF_TWHEEL_SLOT_(tickRate, t->due));
+            }
+            /* one-shot time event: automatically disarm */
+            else {
+                t->ctr = (QTimeEvtCtr)0;
+                t->super.refCtr_ &= (uint8_t)0x7F; /* mark as unlinked */
+                --l_nArmed[tickRate];
+
+                QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_AUTO_DISARM,
+                                 QS_priv_.teObjFilter, t)
+                    QS_OBJ_(t);            /* this time event object */
+                    QS_OBJ_(act);          /* the target AO */
+                    QS_U8_((uint8_t)tickRate); /* tick rate */
+                QS_END_NOCRIT_()
+            }
+
+            QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_POST, QS_priv_.teObjFilter, t)
+                QS_TIME_();                /* timestamp */
+                QS_OBJ_(t);                /* the time event object */
+                QS_SIG_(t->super.sig);     /* signal of this time event */
+                QS_OBJ_(act);              /* the target AO */
+                QS_U8_((uint8_t)tickRate); /* tick rate */
+            QS_END_NOCRIT_()
+
+            QF_CRIT_EXIT_(); /* exit critical section before posting */
+
+            /* QACTIVE_POST() asserts internally if the queue overflows */
+            QACTIVE_POST(act, &t->super, sender);
+        }
+        QF_CRIT_ENTRY_(); /* re-enter crit. section to continue */
+    }
+    QF_CRIT_EXIT_();
+}
+
+/****************************************************************************/
+/**
+* @description
+* Find out if any time events are armed at the given clock tick rate.
+*
+* @param[in]  tickRate  system clock tick rate to find out about.
+*
+* @returns 'true' if no time events are armed at the given tick rate and
+* 'false' otherwise.
+*
+* @note This function should be called in critical section.
+*/
+bool QF_noTimeEvtsActiveX(uint_fast8_t const tickRate) {
+    /** @pre the tick rate must be in range */
+    Q_REQUIRE_ID(200, tickRate < (uint_fast8_t)QF_MAX_TICK_RATE);
+
+    return l_nArmed[tickRate] == (uint_fast16_t)0;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Find out the number of clock ticks until the nearest expiration of a time
+* event armed at the given clock tick rate. The slots of the timing wheel
+* are visited in the order of their ticks, so the search usually ends at
+* the first non-empty slot.
+*
+* @param[in]  tickRate  system clock tick rate to find out about.
+*
+* @returns the number of calls to QF_tickX_() (at the given tick rate)
+* until the nearest time event expires, or 0 if no time events are armed.
+*
+* @note This function should be called in critical section.
+*
+* @sa QF_ticksToNextX() in qf_time.c
+*/
+QTimeEvtCtr QF_ticksToNextX(uint_fast8_t const tickRate) {
+    QTimeEvtCtr now;
+    QTimeEvtCtr next = (QTimeEvtCtr)0;
+    QTimeEvtCtr d;
+    QTimeEvt *t;
+
+    /** @pre the tick rate must be in range */
+    Q_REQUIRE_ID(700, tickRate < (uint_fast8_t)QF_MAX_TICK_RATE);
+
+    now = QF_timeEvtHead_[tickRate].ctr;
+
+    /* time events pending in QF_tickX_() at this moment, see NOTE2 */
+    for (t = QF_timeEvtHead_[tickRate].next; t != (QTimeEvt *)0;
+         t = t->next)
+    {
+        d = (QTimeEvtCtr)(t->due - now);
+        if ((next == (QTimeEvtCtr)0) || (d < next)) {
+            next = d;
+        }
+    }
+
+    /* visit the slots in the order of their ticks, see NOTE3 */
+    for (d = (QTimeEvtCtr)1;
+         (d <= (QTimeEvtCtr)QF_TIMEEVT_WHEEL_SIZE)
+             && (l_nArmed[tickRate] != (uint_fast16_t)0);
+         ++d)
+    {
+        /* nearer than any time event in this or the following slots? */
+        if ((next != (QTimeEvtCtr)0) && (next <= d)) {
+            break;
+        }
+        for (t = *QF_TWHEEL_SLOT_(tickRate, now + d); t != (QTimeEvt *)0;
+             t = t->next)
+        {
+            QTimeEvtCtr dt = (QTimeEvtCtr)(t->due - now);
+            if ((next == (QTimeEvtCtr)0) || (dt < next)) {
+                next = dt;
+            }
+        }
+    }
+    return next;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Advance all time events armed at the given clock tick rate by the given
+* number of clock ticks, in which none of them expires. With the timing
+* wheel, only the tick counter is advanced, because the time events keep
+* their absolute expiration ticks. The slots of the skipped ticks are
+* checked for the time events that would expire.
+*
+* @param[in]  tickRate  system clock tick rate to advance.
+* @param[in]  nTicks    number of clock ticks to advance, which must be
+*                       less than the value returned from QF_ticksToNextX().
+*
+* @note This function should be called in critical section.
+*
+* @sa QF_tickSkipX() in qf_time.c
+*/
+void QF_tickSkipX(uint_fast8_t const tickRate, QTimeEvtCtr const nTicks) {
+    QTimeEvtCtr now;
+    QTimeEvtCtr d;
+
+    /** @pre the tick rate must be in range */
+    Q_REQUIRE_ID(800, tickRate < (uint_fast8_t)QF_MAX_TICK_RATE);
+
+    now = QF_timeEvtHead_[tickRate].ctr;
+    for (d = (QTimeEvtCtr)1;
+         (d <= nTicks) && (d <= (QTimeEvtCtr)QF_TIMEEVT_WHEEL_SIZE);
+         ++d)
+    {
+        QTimeEvt *t = *QF_TWHEEL_SLOT_(tickRate, now + d);
+        for (; t != (QTimeEvt *)0; t = t->next) {
+            /** @pre no time event can expire in the skipped ticks */
+            Q_REQUIRE_ID(810, (QTimeEvtCtr)(t->due - now) > nTicks);
+        }
+    }
+    QF_timeEvtHead_[tickRate].ctr = now + nTicks; /* the tick counter */
+}
+
+/****************************************************************************/
+/**
+* @description
+* Arms a time event to fire in a specified number of clock ticks and with
+* a specified interval. The time event is inserted directly into the slot
+* of the timing wheel, in which it expires, which takes constant time.
+*
+* @param[in,out] me       pointer (see @ref oop)
+* @param[in]     nTicks   number of clock ticks (at the associated rate)
+*                         to rearm the time event with.
+* @param[in]     interval interval (in clock ticks) for periodic time event.
+*
+* @sa QTimeEvt_armX() in qf_time.c
+*/
+void QTimeEvt_armX(QTimeEvt * const me,
+                   QTimeEvtCtr const nTicks, QTimeEvtCtr const interval)
+{
+    uint_fast8_t tickRate = (uint_fast8_t)me->super.refCtr_
+                                & (uint_fast8_t)0x7F;
+    QTimeEvtCtr ctr = me->ctr;
+    QF_CRIT_STAT_
+
+    /** @pre the host AO must be valid, time evnet must be disarmed,
+    * number of clock ticks cannot be zero, and the signal must be valid.
+    */
+    Q_REQUIRE_ID(400, (me->act != (void *)0)
+              && (ctr == (QTimeEvtCtr)0)
+              && (nTicks != (QTimeEvtCtr)0)
+              && (tickRate < (uint_fast8_t)QF_MAX_TICK_RATE)
+              && (me->super.sig >= (QSignal)Q_USER_SIG));
+
+    QF_CRIT_ENTRY_();
+    me->ctr = nTicks;
+    me->interval = interval;
+    me->due = QF_timeEvtHead_[tickRate].ctr + nTicks;
+
+    /* with the timing wheel a disarmed time event is always unlinked */
+    me->super.refCtr_ |= (uint8_t)0x80; /* mark as linked */
+    QTimeEvt_link_(me, QF_TWHEEL_SLOT_(tickRate, me->due));
+    ++l_nArmed[tickRate];
+
+    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_ARM, QS_priv_.teObjFilter, me)
+        QS_TIME_();                /* timestamp */
+        QS_OBJ_(me);               /* this time event object */
+        QS_OBJ_(me->act);          /* the active object */
+        QS_TEC_(nTicks);           /* the number of ticks */
+        QS_TEC_(interval);         /* the interval */
+        QS_U8_((uint8_t)tickRate); /* tick rate */
+    QS_END_NOCRIT_()
+
+    QF_CRIT_EXIT_();
+}
+
+/****************************************************************************/
+/**
+* @description
+* Disarm the time event so it can be safely reused. The time event is
+* unlinked from its slot of the timing wheel immediately, which takes
+* constant time.
+*
+* @param[in,out] me     pointer (see @ref oop)
+*
+* @returns 'true' if the time event was truly disarmed, that is, it
+* was running. The return of 'false' means that the time event was
+* not truly disarmed because it was not running.
+*/
+bool QTimeEvt_disarm(QTimeEvt * const me) {
+    bool wasArmed;
+    QF_CRIT_STAT_
+
+    QF_CRIT_ENTRY_();
+
+    /* is the time evt running? */
+    if (me->ctr != (QTimeEvtCtr)0) {
+        uint_fast8_t tickRate = (uint_fast8_t)me->super.refCtr_
+                                & (uint_fast8_t)0x7F;
+        wasArmed = true;
+
+        QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_DISARM, QS_priv_.teObjFilter, me)
+            QS_TIME_();            /* timestamp */
+            QS_OBJ_(me);           /* this time event object */
+            QS_OBJ_(me->act);      /* the target AO */
+            QS_TEC_(me->ctr);      /* the number of ticks */
+            QS_TEC_(me->interval); /* the interval */
+            QS_U8_((uint8_t)tickRate); /* tick rate */
+        QS_END_NOCRIT_()
+
+        QTimeEvt_unlink_(me);
+        me->ctr = (QTimeEvtCtr)0;
+        me->super.refCtr_ &= (uint8_t)0x7F; /* mark as unlinked */
+        --l_nArmed[tickRate];
+    }
+    /* the time event was already not running */
+    else {
+        wasArmed = false;
+
+        QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_DISARM_ATTEMPT,
+                         QS_priv_.teObjFilter, me)
+            QS_TIME_();            /* timestamp */
+            QS_OBJ_(me);           /* this time event object */
+            QS_OBJ_(me->act);      /* the target AO */
+            QS_U8_((uint8_t)(me->super.refCtr_ & (uint8_t)0x7F));/*tick rate*/
+        QS_END_NOCRIT_()
+
+    }
+    QF_CRIT_EXIT_();
+    return wasArmed;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Rearms a time event with a new number of clock ticks. The time event is
+* moved to the slot of the timing wheel, in which it now expires, which
+* takes constant time.
+*
+* @param[in,out] me     pointer (see @ref oop)
+* @param[in]     nTicks number of clock ticks (at the associated rate)
+*                       to rearm the time event with.
+*
+* @returns 'true' if the time event was running as it was re-armed. The
+* 'false' return means that the time event was not truly rearmed because
+* it was not running.
+*/
+bool QTimeEvt_rearm(QTimeEvt * const me, QTimeEvtCtr const nTicks) {
+    uint_fast8_t tickRate = (uint_fast8_t)me->super.refCtr_
+                            & (uint_fast8_t)0x7F;
+    bool isArmed;
+    QF_CRIT_STAT_
+
+    /** @pre AO must be valid, tick rate must be in range, nTicks must not
+    * be zero, and the signal of this time event must be valid
+    */
+    Q_REQUIRE_ID(600, (me->act != (void *)0)
+                      && (tickRate < (uint_fast8_t)QF_MAX_TICK_RATE)
+                      && (nTicks != (QTimeEvtCtr)0)
+                      && (me->super.sig >= (QSignal)Q_USER_SIG));
+
+    QF_CRIT_ENTRY_();
+
+    /* is the time evt not running? */
+    if (me->ctr == (QTimeEvtCtr)0) {
+        isArmed = false;
+        me->super.refCtr_ |= (uint8_t)0x80; /* mark as linked */
+        ++l_nArmed[tickRate];
+    }
+    /* the time event is armed */
+    else {
+        isArmed = true;
+        QTimeEvt_unlink_(me);
+    }
+    me->ctr = nTicks; /* re-load the tick counter (shift the phasing) */
+    me->due = QF_timeEvtHead_[tickRate].ctr + nTicks;
+    QTimeEvt_link_(me, QF_TWHEEL_SLOT_(tickRate, me->due));
+
+    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_REARM, QS_priv_.teObjFilter, me)
+        QS_TIME_();            /* timestamp */
+        QS_OBJ_(me);           /* this time event object */
+        QS_OBJ_(me->act);      /* the target AO */
+        QS_TEC_(me->ctr);      /* the number of ticks */
+        QS_TEC_(me->interval); /* the interval */
+        QS_2U8_((uint8_t)tickRate, (uint8_t)isArmed);
+    QS_END_NOCRIT_()
+
+    QF_CRIT_EXIT_();
+    return isArmed;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Useful for checking how many clock ticks (at the tick rate associated
+* with the time event) remain until the time event expires. With the timing
+* wheel the number is computed from the expiration tick of the time event.
+*
+* @param[in,out] me     pointer (see @ref oop)
+*
+* @returns For an armed time event, the function returns the current value
+* of the down-counter of the given time event. If the time event is not
+* armed, the function returns 0.
+*/
+QTimeEvtCtr QTimeEvt_ctr(QTimeEvt const * const me) {
+    QTimeEvtCtr ret;
+    QF_CRIT_STAT_
+
+    QF_CRIT_ENTRY_();
+    if (me->ctr != (QTimeEvtCtr)0) { /* armed? */
+        uint_fast8_t tickRate = (uint_fast8_t)me->super.refCtr_
+                                & (uint_fast8_t)0x7F;
+        ret = me->due - QF_timeEvtHead_[tickRate].ctr;
+    }
+    else {
+        ret = (QTimeEvtCtr)0;
+    }
+
+    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_CTR, QS_priv_.teObjFilter, me)
+        QS_TIME_();              /* timestamp */
+        QS_OBJ_(me);             /* this time event object */
+        QS_OBJ_(me->act);        /* the target AO */
+        QS_TEC_(ret);            /* the current counter */
+        QS_TEC_(me->interval);   /* the interval */
+        QS_U8_((uint8_t)(me->super.refCtr_ & (uint8_t)0x7F)); /* tick rate */
+    QS_END_NOCRIT_()
+
+    QF_CRIT_EXIT_();
+    return ret;
+}
+
+/*****************************************************************************
+* NOTE1:
+* The time events of every tick rate are hashed into QF_TIMEEVT_WHEEL_SIZE
+* slots by the tick at which they expire (QTimeEvt::due). QF_tickX_()
+* increments the tick counter of the tick rate (QF_timeEvtHead_[].ctr) and
+* processes only the time events in the slot of the new tick. A time event
+* armed for more than QF_TIMEEVT_WHEEL_SIZE ticks is visited once in every
+* revolution of the wheel before it expires, so the cost of a tick is
+* proportional to the number of armed time events divided by the size of
+* the wheel, instead of the number of all armed time events. Arming,
+* disarming and rearming take constant time, because the time events are
+* kept in doubly-linked lists (QTimeEvt::pprev).
+*
+* NOTE2:
+* As in qf_time.c, QF_tickX_() exits the critical section between the time
+* events to reduce the interrupt latency. Therefore, the time events of the
+* current slot are first moved to the pending list QF_timeEvtHead_[].next,
+* which makes them all reachable for a concurrent disarming or rearming.
+* Each pending time event is then either reinserted into the current slot
+* (expires in a later revolution), reinserted into its next slot (periodic)
+* or unlinked (one-shot). The time events armed during the processing go
+* directly into their slots, so none of them can expire in the same tick.
+*
+* NOTE3:
+* A time event in the slot of the tick (now + d) expires in d ticks or in
+* a later revolution of the wheel, so it can never expire sooner than in d
+* ticks. Therefore the search in QF_ticksToNextX() can stop at the first
+* slot d at which the nearest expiration found so far is not later than d.
+*/
+
+#endif /* QF_TIMEEVT_WHEEL_SIZE */
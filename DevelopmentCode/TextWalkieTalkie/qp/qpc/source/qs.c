@@ -227,8 +227,10 @@ void QS_endRec(void) {
 
     /* overrun over the old data? */
     if (QS_priv_.used > end) {
+        QS_priv_.dropped += (uint32_t)(QS_priv_.used - end); /* lost bytes */
         QS_priv_.used = end;   /* the whole buffer is used */
         QS_priv_.tail = head;  /* shift the tail to the old data */
+        QS_priv_.tx   = (QSCtr)0; /* the transmitted block overwritten */
     }
 }
 
@@ -531,6 +533,81 @@ uint8_t const *QS_getBlock(uint16_t *pNbytes) {
     return buf;
 }
 
+/****************************************************************************/
+/**
+* @description
+* This function starts the transmission of a contiguous block of data from
+* the QS data buffer, which is intended for the zero-copy output through
+* DMA. Unlike QS_getBlock(), the bytes of the block remain in the buffer
+* until the transmission is completed by calling QS_txDone(), so that the
+* block is protected from being overwritten by the new data until the QS
+* buffer overruns, see NOTE1.
+*
+* @param[in,out] pNbytes  on input, the maximum size of the block that the
+*                caller can accept; on output, the number of bytes in the
+*                block, or zero if no data is available.
+*
+* @returns pointer to the contiguous block of data or NULL pointer if no
+* data is available at the time of the call.
+*
+* @note QS_txBlock() is NOT protected with a critical section. Only one
+* block can be in transmission at a time, and the function must not be
+* mixed with QS_getByte() or QS_getBlock().
+*/
+uint8_t const *QS_txBlock(uint16_t *pNbytes) {
+    QSCtr used = QS_priv_.used; /* put in a temporary (register) */
+    uint8_t *buf;
+
+    /** @pre no other block can be in transmission */
+    Q_REQUIRE_ID(400, QS_priv_.tx == (QSCtr)0);
+
+    /* any bytes used in the ring buffer? */
+    if (used != (QSCtr)0) {
+        QSCtr tail = QS_priv_.tail;  /* put in a temporary (register) */
+        QSCtr n = (QSCtr)(QS_priv_.end - tail);
+        if (n > used) {
+            n = used;
+        }
+        if (n > (QSCtr)(*pNbytes)) {
+            n = (QSCtr)(*pNbytes);
+        }
+        *pNbytes = (uint16_t)n;      /* n-bytes available */
+        buf = QS_priv_.buf;
+        buf = QS_PTR_AT_(tail);      /* the bytes are at the tail */
+        QS_priv_.tx = n;             /* n-bytes in transmission */
+    }
+    else { /* no bytes available */
+        *pNbytes = (uint16_t)0;  /* no bytes available right now */
+        buf      = (uint8_t *)0; /* no bytes available right now */
+    }
+    return buf;
+}
+
+/****************************************************************************/
+/**
+* @description
+* This function completes the transmission of the block of data obtained
+* from QS_txBlock() and releases the block in the QS data buffer. It is
+* intended to be called from the DMA transfer-complete interrupt, which
+* can immediately start the transmission of the next block.
+*
+* @note QS_txDone() is NOT protected with a critical section.
+*/
+void QS_txDone(void) {
+    QSCtr tx = QS_priv_.tx;
+
+    /* not overwritten during the transmission? */
+    if (tx != (QSCtr)0) {
+        QSCtr tail = QS_priv_.tail + tx;
+        if (tail == QS_priv_.end) {
+            tail = (QSCtr)0;
+        }
+        QS_priv_.tail = tail;
+        QS_priv_.used -= tx;
+        QS_priv_.tx = (QSCtr)0;
+    }
+}
+
 /****************************************************************************/
 /** @note This function is only to be used through macro QS_SIG_DICTIONARY()
 */
@@ -683,3 +760,14 @@ void QS_str_ROM(char_t const Q_ROM *s) {
     QS_priv_.chksum = chksum;  /* save the checksum */
     QS_priv_.used   = used;    /* save # of used buffer space */
 }
+
+/*****************************************************************************
+* NOTE1:
+* The bytes of the block in transmission (QS_priv_.tx) are still counted in
+* QS_priv_.used, so the new data can overwrite them only when the whole QS
+* buffer overruns, in which case QS_endRec() moves the tail to the oldest
+* complete data and forgets the block in transmission. The already started
+* transmission then delivers some overwritten bytes, which the QSPY host
+* utility detects by the record sequence numbers and checksums, and which
+* are counted in QS_priv_.dropped together with all other overwritten bytes.
+*/